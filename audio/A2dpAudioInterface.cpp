@@ -23,6 +23,7 @@
 #include <utils/Timers.h>
 
 #include "A2dpAudioInterface.h"
+#include "AudioParameterScanner.h"
 #include "audio/liba2dp.h"
 #include <hardware_legacy/power.h>
 
@@ -93,6 +94,17 @@ AudioStreamOut* A2dpAudioInterface::openOutputStream(
     return mOutput;
 }
 
+AudioStreamOut* A2dpAudioInterface::openOutputStreamWithFlags(uint32_t devices,
+        audio_output_flags_t flags, int *format, uint32_t *channels, uint32_t *sampleRate,
+        status_t *status)
+{
+    if (!audio_is_a2dp_out_device(devices)) {
+        return mHardwareInterface->openOutputStreamWithFlags(devices, flags, format, channels,
+                sampleRate, status);
+    }
+    return openOutputStream(devices, format, channels, sampleRate, status);
+}
+
 void A2dpAudioInterface::closeOutputStream(AudioStreamOut* out) {
     if (mOutput == 0 || mOutput != out) {
         mHardwareInterface->closeOutputStream(out);
@@ -121,6 +133,33 @@ status_t A2dpAudioInterface::setMode(int mode)
     return mHardwareInterface->setMode(mode);
 }
 
+status_t A2dpAudioInterface::setMasterMute(bool muted)
+{
+    return mHardwareInterface->setMasterMute(muted);
+}
+
+int A2dpAudioInterface::createAudioPatch(unsigned int num_sources,
+        const struct audio_port_config *sources, unsigned int num_sinks,
+        const struct audio_port_config *sinks, audio_patch_handle_t *handle)
+{
+    return mHardwareInterface->createAudioPatch(num_sources, sources, num_sinks, sinks, handle);
+}
+
+int A2dpAudioInterface::releaseAudioPatch(audio_patch_handle_t handle)
+{
+    return mHardwareInterface->releaseAudioPatch(handle);
+}
+
+int A2dpAudioInterface::getAudioPort(struct audio_port *port)
+{
+    return mHardwareInterface->getAudioPort(port);
+}
+
+int A2dpAudioInterface::setAudioPortConfig(const struct audio_port_config *config)
+{
+    return mHardwareInterface->setAudioPortConfig(config);
+}
+
 status_t A2dpAudioInterface::setMicMute(bool state)
 {
     return mHardwareInterface->setMicMute(state);
@@ -133,32 +172,34 @@ status_t A2dpAudioInterface::getMicMute(bool* state)
 
 status_t A2dpAudioInterface::setParameters(const String8& keyValuePairs)
 {
-    AudioParameter param = AudioParameter(keyValuePairs);
-    String8 value;
-    String8 key;
+    AudioParameterScanner param(keyValuePairs.string());
+    // whatever is not for A2DP goes on to the hardware interface
+    String8 others;
     status_t status = NO_ERROR;
 
     ALOGV("setParameters() %s", keyValuePairs.string());
 
-    key = "bluetooth_enabled";
-    if (param.get(key, value) == NO_ERROR) {
-        mBluetoothEnabled = (value == "true");
-        if (mOutput) {
-            mOutput->setBluetoothEnabled(mBluetoothEnabled);
-        }
-        param.remove(key);
-    }
-    key = String8("A2dpSuspended");
-    if (param.get(key, value) == NO_ERROR) {
-        mSuspended = (value == "true");
-        if (mOutput) {
-            mOutput->setSuspended(mSuspended);
+    while (param.next()) {
+        if (param.keyIs("bluetooth_enabled")) {
+            mBluetoothEnabled = param.valueIs("true");
+            if (mOutput) {
+                mOutput->setBluetoothEnabled(mBluetoothEnabled);
+            }
+        } else if (param.keyIs("A2dpSuspended")) {
+            mSuspended = param.valueIs("true");
+            if (mOutput) {
+                mOutput->setSuspended(mSuspended);
+            }
+        } else {
+            if (others.length()) {
+                others.append(";");
+            }
+            others.append(param.pair(), param.pairLength());
         }
-        param.remove(key);
     }
 
-    if (param.size()) {
-        status_t hwStatus = mHardwareInterface->setParameters(param.toString());
+    if (others.length()) {
+        status_t hwStatus = mHardwareInterface->setParameters(others);
         if (status == NO_ERROR) {
             status = hwStatus;
         }
@@ -226,7 +267,11 @@ A2dpAudioInterface::A2dpAudioStreamOut::A2dpAudioStreamOut() :
     mFd(-1), mStandby(true), mStartCount(0), mRetryCount(0), mData(NULL),
     // assume BT enabled to start, this is safe because its only the
     // enabled->disabled transition we are worried about
-    mBluetoothEnabled(true), mDevice(0), mClosing(false), mSuspended(false)
+    mBluetoothEnabled(true), mDevice(0), mClosing(false), mSuspended(false),
+    mFormat(AudioSystem::PCM_16_BIT), mChannels(AudioSystem::CHANNEL_OUT_STEREO),
+    mConverter(0), mConvertBuffer(0), mJitter(kJitterBytes, kDeviceFrameSize),
+    mPositionTargetFrames(0), mTransportWaiting(false), mTransportActive(false),
+    mTransportError(NO_ERROR), mLinkDroppedFrames(0)
 {
     // use any address by default
     strcpy(mA2dpAddress, "00:00:00:00:00:00");
@@ -247,9 +292,9 @@ status_t A2dpAudioInterface::A2dpAudioStreamOut::set(
     if (lChannels == 0) lChannels = channels();
     if (lRate == 0) lRate = sampleRate();
 
-    // check values
-    if ((lFormat != format()) ||
-            (lChannels != channels()) ||
+    // check values; the stereo 16-bit the codec takes is converted from any
+    // format and channel mask the converter handles
+    if (!AudioFormatConverter::isSupported(lFormat, lChannels) ||
             (lRate != sampleRate())){
         if (pFormat) *pFormat = format();
         if (pChannels) *pChannels = channels();
@@ -262,25 +307,71 @@ status_t A2dpAudioInterface::A2dpAudioStreamOut::set(
     if (pRate) *pRate = lRate;
 
     mDevice = device;
-    mBufferDurationUs = ((bufferSize() * 1000 )/ frameSize() / sampleRate()) * 1000;
-    return NO_ERROR;
+    mFormat = lFormat;
+    mChannels = lChannels;
+    if (lFormat != AudioSystem::PCM_16_BIT || lChannels != AudioSystem::CHANNEL_OUT_STEREO) {
+        mConverter = new AudioFormatConverter(lFormat, lChannels, 2, false);
+        mConvertBuffer = new int16_t[kConvertFrames * 2];
+    }
+    // write() never blocks on the link, so this is what paces the mixer:
+    // a buffer of slack either way, and as long as the stack buffers to
+    // catch up after a stall
+    nsecs_t bufferNs = (nsecs_t)bufferSize() / frameSize() * 1000000000 / sampleRate();
+    mPacing.setTolerance(bufferNs, (nsecs_t)latency() * 1000000);
+
+    // the jitter buffer must cover at least a mixer buffer, since that is
+    // how much arrives at once
+    uint32_t stepFrames = sampleRate() * kJitterStepMs / 1000;
+    mJitter.setDepth(bufferSize() / frameSize() + stepFrames,
+            sampleRate() * kJitterMaxMs / 1000, stepFrames, kJitterAdaptNs);
+    updatePosition();
+    return mTransport == 0 ? startTransport() : NO_ERROR;
+}
+
+status_t A2dpAudioInterface::A2dpAudioStreamOut::startTransport()
+{
+    mTransport = new TransportThread(this);
+    status_t status = mTransport->run("A2dpTransport", ANDROID_PRIORITY_URGENT_AUDIO);
+    if (status != NO_ERROR) {
+        ALOGE("cannot start transport thread: %d", status);
+        mTransport.clear();
+    }
+    return status;
+}
+
+void A2dpAudioInterface::A2dpAudioStreamOut::updatePosition()
+{
+    mPositionTargetFrames = mJitter.targetFrames();
+    // the jitter buffer and the stack are downstream of write(); the rest of
+    // the latency is spent in the headset
+    mPosition.setup(sampleRate(), latencyMs(mPositionTargetFrames) * sampleRate() / 1000);
 }
 
 A2dpAudioInterface::A2dpAudioStreamOut::~A2dpAudioStreamOut()
 {
     ALOGV("A2dpAudioStreamOut destructor");
+    if (mTransport != 0) {
+        mTransport->requestExit();
+        {
+            Mutex::Autolock lock(mWaitLock);
+            mDataReady.signal();
+        }
+        mTransport->requestExitAndWait();
+        mTransport.clear();
+    }
     close();
+    delete mConverter;
+    delete[] mConvertBuffer;
     ALOGV("A2dpAudioStreamOut destructor returning from close()");
 }
 
 ssize_t A2dpAudioInterface::A2dpAudioStreamOut::write(const void* buffer, size_t bytes)
 {
     status_t status = -1;
+    nsecs_t deadline;
     {
         Mutex::Autolock lock(mLock);
 
-        size_t remaining = bytes;
-
         if (!mBluetoothEnabled || mClosing || mSuspended) {
             ALOGV("A2dpAudioStreamOut::write(), but bluetooth disabled \
                    mBluetoothEnabled %d, mClosing %d, mSuspended %d",
@@ -288,54 +379,123 @@ ssize_t A2dpAudioInterface::A2dpAudioStreamOut::write(const void* buffer, size_t
             goto Error;
         }
 
+        // a2dp_write() failed on the transport thread
+        status = mTransportError.load();
+        if (status < 0)
+            goto Error;
+
         if (mStandby) {
             acquire_wake_lock (PARTIAL_WAKE_LOCK, sA2dpWakeLock);
             mStandby = false;
-            mLastWriteTime = systemTime();
+            mTransportActive.store(true);
         }
 
         status = init();
         if (status < 0)
             goto Error;
 
-        int retries = MAX_WRITE_RETRIES;
-        while (remaining > 0 && retries) {
-            status = a2dp_write(mData, buffer, remaining);
-            if (status < 0) {
-                ALOGE("a2dp_write failed err: %d\n", status);
-                goto Error;
+        const char *in = (const char *)buffer;
+        size_t frames = bytes / frameSize();
+        while (frames > 0) {
+            // other client formats go through mConvertBuffer a piece at a time
+            size_t n = frames;
+            const char *data = in;
+            if (mConverter != 0) {
+                if (n > kConvertFrames) n = kConvertFrames;
+                mConverter->convert(mConvertBuffer, in, n);
+                data = (const char *)mConvertBuffer;
             }
-            if (status == 0) {
-                retries--;
-            }
-            remaining -= status;
-            buffer = (char *)buffer + status;
-        }
+            in += n * frameSize();
+            frames -= n;
 
-        // if A2DP sink runs abnormally fast, sleep a little so that audioflinger mixer thread
-        // does no spin and starve other threads.
-        // NOTE: It is likely that the A2DP headset is being disconnected
-        nsecs_t now = systemTime();
-        if ((uint32_t)ns2us(now - mLastWriteTime) < (mBufferDurationUs >> 2)) {
-            ALOGV("A2DP sink runs too fast");
-            usleep(mBufferDurationUs - (uint32_t)ns2us(now - mLastWriteTime));
+            // drops what does not fit rather than wait for the link
+            mJitter.write(data, n);
+        }
+        // mJitter.write() raises the target on an underrun, the transport
+        // thread lowers it
+        if (mJitter.targetFrames() != mPositionTargetFrames) {
+            updatePosition();
+        }
+        if (mTransportWaiting.load()) {
+            Mutex::Autolock lock(mWaitLock);
+            mDataReady.signal();
         }
-        mLastWriteTime = now;
-        return bytes;
 
+        mPosition.advance(bytes / frameSize(), systemTime());
+        deadline = mPacing.advance(bytes / frameSize(), sampleRate());
     }
+    // without mLock, so standby() and parameter changes are not held up
+    mPacing.sleepUntil(deadline);
+    return bytes;
+
 Error:
 
     standby();
 
-    // Simulate audio output timing in case of error
-    usleep(mBufferDurationUs);
+    // Simulate audio output timing in case of error, on the same timeline so
+    // a run of failed writes neither drifts nor spins
+    {
+        Mutex::Autolock lock(mLock);
+        deadline = mPacing.advance(bytes / frameSize(), sampleRate());
+    }
+    mPacing.sleepUntil(deadline);
 
     return status;
 }
 
+bool A2dpAudioInterface::A2dpAudioStreamOut::TransportThread::threadLoop()
+{
+    return mStream->transportLoop();
+}
+
+bool A2dpAudioInterface::A2dpAudioStreamOut::transportLoop()
+{
+    size_t queued = mJitter.queuedFrames();
+    {
+        // standby() holds this while it stops the stack and empties mJitter
+        Mutex::Autolock lock(mTransportLock);
+        size_t frames = 0;
+        if (mData != NULL && mTransportActive.load() && mTransportError.load() == NO_ERROR) {
+            frames = mJitter.read(mSendBuffer, kTransportFrames, systemTime());
+        }
+        if (frames > 0) {
+            size_t remaining = frames * kDeviceFrameSize;
+            const char *data = (const char *)mSendBuffer;
+            int retries = MAX_WRITE_RETRIES;
+            while (remaining > 0 && retries) {
+                int status = a2dp_write(mData, data, remaining);
+                if (status < 0) {
+                    ALOGE("a2dp_write failed err: %d\n", status);
+                    mTransportError.store(status);
+                    return true;
+                }
+                if (status == 0) {
+                    retries--;
+                }
+                remaining -= status;
+                data += status;
+            }
+            if (remaining) {
+                mLinkDroppedFrames.fetch_add(remaining / kDeviceFrameSize,
+                        std::memory_order_relaxed);
+            }
+            return true;
+        }
+    }
+
+    // in standby, or rebuffering to the target depth
+    Mutex::Autolock lock(mWaitLock);
+    mTransportWaiting.store(true);
+    if (mJitter.queuedFrames() == queued) {
+        mDataReady.waitRelative(mWaitLock, kTransportWaitNs);
+    }
+    mTransportWaiting.store(false);
+    return true;
+}
+
 status_t A2dpAudioInterface::A2dpAudioStreamOut::init()
 {
+    Mutex::Autolock lock(mTransportLock);
     if (!mData) {
         status_t status = a2dp_init(44100, 2, &mData);
         if (status < 0) {
@@ -362,11 +522,18 @@ status_t A2dpAudioInterface::A2dpAudioStreamOut::standby_l()
     if (!mStandby) {
         ALOGV_IF(mClosing || !mBluetoothEnabled, "Standby skip stop: closing %d enabled %d",
                 mClosing, mBluetoothEnabled);
+        mTransportActive.store(false);
+        // waits out an a2dp_write() in progress on the transport thread
+        Mutex::Autolock lock(mTransportLock);
         if (!mClosing && mBluetoothEnabled) {
             result = a2dp_stop(mData);
         }
+        mJitter.reset();
+        mTransportError.store(NO_ERROR);
         release_wake_lock(sA2dpWakeLock);
         mStandby = true;
+        mPacing.reset();
+        mPosition.standby();
     }
 
     return result;
@@ -374,42 +541,33 @@ status_t A2dpAudioInterface::A2dpAudioStreamOut::standby_l()
 
 status_t A2dpAudioInterface::A2dpAudioStreamOut::setParameters(const String8& keyValuePairs)
 {
-    AudioParameter param = AudioParameter(keyValuePairs);
-    String8 value;
-    String8 key = String8("a2dp_sink_address");
+    AudioParameterScanner param(keyValuePairs.string());
     status_t status = NO_ERROR;
     int device;
     ALOGV("A2dpAudioStreamOut::setParameters() %s", keyValuePairs.string());
 
-    if (param.get(key, value) == NO_ERROR) {
-        if (value.length() != strlen("00:00:00:00:00:00")) {
-            status = BAD_VALUE;
-        } else {
-            setAddress(value.string());
-        }
-        param.remove(key);
-    }
-    key = String8("closing");
-    if (param.get(key, value) == NO_ERROR) {
-        mClosing = (value == "true");
-        if (mClosing) {
-            standby();
-        }
-        param.remove(key);
-    }
-    key = AudioParameter::keyRouting;
-    if (param.getInt(key, device) == NO_ERROR) {
-        if (audio_is_a2dp_out_device(device)) {
+    while (param.next()) {
+        if (param.keyIs("a2dp_sink_address")) {
+            if (param.valueLength() != strlen("00:00:00:00:00:00")) {
+                status = BAD_VALUE;
+            } else {
+                // NUL terminated for setAddress()
+                char address[sizeof("00:00:00:00:00:00")];
+                memcpy(address, param.value(), param.valueLength());
+                address[param.valueLength()] = '\0';
+                setAddress(address);
+            }
+        } else if (param.keyIs("closing")) {
+            mClosing = param.valueIs("true");
+            if (mClosing) {
+                standby();
+            }
+        } else if (param.keyIs(AudioParameter::keyRouting) &&
+                param.valueInt(&device) == NO_ERROR && audio_is_a2dp_out_device(device)) {
             mDevice = device;
-            status = NO_ERROR;
         } else {
             status = BAD_VALUE;
         }
-        param.remove(key);
-    }
-
-    if (param.size()) {
-        status = BAD_VALUE;
     }
     return status;
 }
@@ -441,6 +599,7 @@ status_t A2dpAudioInterface::A2dpAudioStreamOut::setAddress(const char* address)
         return -EINVAL;
 
     strcpy(mA2dpAddress, address);
+    Mutex::Autolock transportLock(mTransportLock);
     if (mData)
         a2dp_set_sink(mData, mA2dpAddress);
 
@@ -478,6 +637,7 @@ status_t A2dpAudioInterface::A2dpAudioStreamOut::close()
 status_t A2dpAudioInterface::A2dpAudioStreamOut::close_l()
 {
     standby_l();
+    Mutex::Autolock lock(mTransportLock);
     if (mData) {
         ALOGV("A2dpAudioStreamOut::close_l() calling a2dp_cleanup(mData)");
         a2dp_cleanup(mData);
@@ -488,13 +648,53 @@ status_t A2dpAudioInterface::A2dpAudioStreamOut::close_l()
 
 status_t A2dpAudioInterface::A2dpAudioStreamOut::dump(int fd, const Vector<String16>& args)
 {
+    const size_t SIZE = 256;
+    char buffer[SIZE];
+    String8 result;
+    uint32_t rate = sampleRate();
+    uint32_t queued = (uint32_t)mJitter.queuedFrames();
+    snprintf(buffer, SIZE, "A2dpAudioStreamOut::dump\n");
+    result.append(buffer);
+    snprintf(buffer, SIZE, "\tsink: %s, device: %#x\n", mA2dpAddress, mDevice);
+    result.append(buffer);
+    snprintf(buffer, SIZE, "\tformat: %d, channels: %#x, latency: %u ms\n",
+            format(), channels(), latency());
+    result.append(buffer);
+    snprintf(buffer, SIZE, "\tstandby: %d, bluetooth enabled: %d, suspended: %d, closing: %d\n",
+            mStandby, mBluetoothEnabled, mSuspended, mClosing);
+    result.append(buffer);
+    snprintf(buffer, SIZE, "\tjitter buffer: %u ms queued, %u ms target (%u to %u ms)\n",
+            queued * 1000 / rate, mJitter.targetFrames() * 1000 / rate,
+            mJitter.minFrames() * 1000 / rate, mJitter.maxFrames() * 1000 / rate);
+    result.append(buffer);
+    snprintf(buffer, SIZE, "\tunderruns: %u\n", mJitter.underruns());
+    result.append(buffer);
+    snprintf(buffer, SIZE, "\tdropped: %llu frames with the jitter buffer full or too deep, "
+            "%llu refused by a2dp_write()\n",
+            (unsigned long long)mJitter.droppedFrames(),
+            (unsigned long long)mLinkDroppedFrames.load());
+    result.append(buffer);
+    snprintf(buffer, SIZE, "\tframes written: %llu\n",
+            (unsigned long long)mPosition.framesWritten());
+    result.append(buffer);
+    ::write(fd, result.string(), result.size());
     return NO_ERROR;
 }
 
 status_t A2dpAudioInterface::A2dpAudioStreamOut::getRenderPosition(uint32_t *driverFrames)
 {
-    //TODO: enable when supported by driver
-    return INVALID_OPERATION;
+    return mPosition.getRenderPosition(driverFrames, systemTime());
+}
+
+status_t A2dpAudioInterface::A2dpAudioStreamOut::getNextWriteTimestamp(int64_t *timestamp)
+{
+    return mPosition.getNextWriteTimestamp(timestamp);
+}
+
+status_t A2dpAudioInterface::A2dpAudioStreamOut::getPresentationPosition(uint64_t *frames,
+        struct timespec *timestamp)
+{
+    return mPosition.getPresentationPosition(frames, timestamp);
 }
 
 }; // namespace android
@@ -22,8 +22,15 @@
 
 #include <utils/threads.h>
 
+#include <atomic>
+
 #include <hardware_legacy/AudioHardwareBase.h>
 
+#include "AudioFormatConverter.h"
+#include "AudioJitterBuffer.h"
+#include "AudioPacingClock.h"
+#include "AudioPositionTracker.h"
+
 
 namespace android_audio_legacy {
     using android::Mutex;
@@ -58,6 +65,14 @@ public:
                                 uint32_t *channels=0,
                                 uint32_t *sampleRate=0,
                                 status_t *status=0);
+    // there is one A2DP profile; flags only matter to the hardware interface
+    virtual AudioStreamOut* openOutputStreamWithFlags(
+                                uint32_t devices,
+                                audio_output_flags_t flags,
+                                int *format=0,
+                                uint32_t *channels=0,
+                                uint32_t *sampleRate=0,
+                                status_t *status=0);
     virtual    void        closeOutputStream(AudioStreamOut* out);
 
     virtual AudioStreamIn* openInputStream(
@@ -70,6 +85,17 @@ public:
     virtual    void        closeInputStream(AudioStreamIn* in);
 //    static AudioHardwareInterface* createA2dpInterface();
 
+    // master mute, audio patches and ports are the hardware interface's
+    virtual status_t    setMasterMute(bool muted);
+    virtual int         createAudioPatch(unsigned int num_sources,
+                                         const struct audio_port_config *sources,
+                                         unsigned int num_sinks,
+                                         const struct audio_port_config *sinks,
+                                         audio_patch_handle_t *handle);
+    virtual int         releaseAudioPatch(audio_patch_handle_t handle);
+    virtual int         getAudioPort(struct audio_port *port);
+    virtual int         setAudioPortConfig(const struct audio_port_config *config);
+
 protected:
     virtual status_t    dump(int fd, const Vector<String16>& args);
 
@@ -83,11 +109,14 @@ private:
                                 uint32_t *pChannels,
                                 uint32_t *pRate);
         virtual uint32_t    sampleRate() const { return 44100; }
-        // SBC codec wants a multiple of 512
-        virtual size_t      bufferSize() const { return 512 * 20; }
-        virtual uint32_t    channels() const { return AudioSystem::CHANNEL_OUT_STEREO; }
-        virtual int         format() const { return AudioSystem::PCM_16_BIT; }
-        virtual uint32_t    latency() const { return ((1000*bufferSize())/frameSize())/sampleRate() + 200; }
+        // SBC codec wants a multiple of 512 bytes of 16-bit stereo
+        virtual size_t      bufferSize() const { return 512 * 20 / kDeviceFrameSize * frameSize(); }
+        virtual uint32_t    channels() const { return mChannels; }
+        virtual int         format() const { return mFormat; }
+        // at the deepest jitter target, since AudioFlinger only reads it once
+        virtual uint32_t    latency() const {
+                                return latencyMs(sampleRate() * kJitterMaxMs / 1000);
+                            }
         virtual status_t    setVolume(float left, float right) { return INVALID_OPERATION; }
         virtual ssize_t     write(const void* buffer, size_t bytes);
                 status_t    standby();
@@ -95,6 +124,8 @@ private:
         virtual status_t    setParameters(const String8& keyValuePairs);
         virtual String8     getParameters(const String8& keys);
         virtual status_t    getRenderPosition(uint32_t *dspFrames);
+        virtual status_t    getNextWriteTimestamp(int64_t *timestamp);
+        virtual status_t    getPresentationPosition(uint64_t *frames, struct timespec *timestamp);
 
     private:
         friend class A2dpAudioInterface;
@@ -106,6 +137,38 @@ private:
                 status_t    setSuspended(bool onOff);
                 status_t    standby_l();
 
+        class TransportThread : public android::Thread {
+        public:
+                            TransportThread(A2dpAudioStreamOut *stream)
+                                : Thread(false), mStream(stream) {}
+        private:
+            virtual bool    threadLoop();
+
+            A2dpAudioStreamOut *mStream;
+        };
+
+                status_t    startTransport();
+                bool        transportLoop();
+                void        updatePosition();
+                uint32_t    latencyMs(uint32_t jitterFrames) const {
+                                return ((1000*bufferSize())/frameSize())/sampleRate() + 200 +
+                                        jitterFrames * 1000 / sampleRate();
+                            }
+
+        // what a2dp_write() takes; other client formats are converted
+        static const size_t kDeviceFrameSize = 2 * sizeof(int16_t);
+        static const size_t kConvertFrames = 512;
+        // a2dp_write() unit of the transport thread, a multiple of what SBC wants
+        static const size_t kTransportFrames = 512;
+        // about 370ms: the deepest target plus a mixer buffer
+        static const size_t kJitterBytes = 64 * 1024;
+        static const uint32_t kJitterStepMs = 20;
+        static const uint32_t kJitterMaxMs = 300;
+        // how long the depth must stay a step clear of running dry before the
+        // target is lowered
+        static const nsecs_t kJitterAdaptNs = 10000000000LL;
+        static const nsecs_t kTransportWaitNs = 5000000;
+
     private:
                 int         mFd;
                 bool        mStandby;
@@ -118,8 +181,29 @@ private:
                 uint32_t    mDevice;
                 bool        mClosing;
                 bool        mSuspended;
-                nsecs_t     mLastWriteTime;
-                uint32_t    mBufferDurationUs;
+                AudioPacingClock mPacing;
+                AudioPositionTracker mPosition;
+                int         mFormat;
+                uint32_t    mChannels;
+                AudioFormatConverter *mConverter;
+                int16_t     *mConvertBuffer;    // kConvertFrames
+
+        // write() converts into mJitter and returns; the transport thread
+        // sends from it to a2dp_write(), so a congested link never holds up
+        // the mixer.
+                AudioJitterBuffer mJitter;
+                uint32_t    mPositionTargetFrames; // mJitter target mPosition is set up for
+                android::sp<TransportThread> mTransport;
+                Mutex       mTransportLock;     // a2dp_*() calls, mData and mJitter reads
+                Mutex       mWaitLock;
+                android::Condition mDataReady;
+                std::atomic<bool> mTransportWaiting;
+                std::atomic<bool> mTransportActive; // out of standby
+                std::atomic<status_t> mTransportError; // of a2dp_write(), until standby
+                std::atomic<uint64_t> mLinkDroppedFrames; // a2dp_write() kept returning 0
+
+        // transport thread only
+                int16_t     mSendBuffer[kTransportFrames * 2];
     };
 
     friend class A2dpAudioStreamOut;
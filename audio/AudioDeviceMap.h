@@ -0,0 +1,148 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef ANDROID_AUDIO_DEVICE_MAP_H
+#define ANDROID_AUDIO_DEVICE_MAP_H
+
+#include <stdint.h>
+
+#include <system/audio.h>
+
+#include <hardware_legacy/AudioSystemLegacy.h>
+
+namespace android_audio_legacy {
+
+// ----------------------------------------------------------------------------
+
+// Device masks of the legacy AudioSystem (1.0) and of audio.h (2.0), as the
+// HAL shim converts between them for stream opens and routing.
+enum {
+    HAL_API_REV_1_0,
+    HAL_API_REV_2_0,
+    HAL_API_REV_NUM
+};
+
+static constexpr uint32_t audio_device_conv_table[][HAL_API_REV_NUM] =
+{
+    /* output devices */
+    { AudioSystem::DEVICE_OUT_EARPIECE, AUDIO_DEVICE_OUT_EARPIECE },
+    { AudioSystem::DEVICE_OUT_SPEAKER, AUDIO_DEVICE_OUT_SPEAKER },
+    { AudioSystem::DEVICE_OUT_WIRED_HEADSET, AUDIO_DEVICE_OUT_WIRED_HEADSET },
+    { AudioSystem::DEVICE_OUT_WIRED_HEADPHONE, AUDIO_DEVICE_OUT_WIRED_HEADPHONE },
+    { AudioSystem::DEVICE_OUT_BLUETOOTH_SCO, AUDIO_DEVICE_OUT_BLUETOOTH_SCO },
+    { AudioSystem::DEVICE_OUT_BLUETOOTH_SCO_HEADSET, AUDIO_DEVICE_OUT_BLUETOOTH_SCO_HEADSET },
+    { AudioSystem::DEVICE_OUT_BLUETOOTH_SCO_CARKIT, AUDIO_DEVICE_OUT_BLUETOOTH_SCO_CARKIT },
+    { AudioSystem::DEVICE_OUT_BLUETOOTH_A2DP, AUDIO_DEVICE_OUT_BLUETOOTH_A2DP },
+    { AudioSystem::DEVICE_OUT_BLUETOOTH_A2DP_HEADPHONES, AUDIO_DEVICE_OUT_BLUETOOTH_A2DP_HEADPHONES },
+    { AudioSystem::DEVICE_OUT_BLUETOOTH_A2DP_SPEAKER, AUDIO_DEVICE_OUT_BLUETOOTH_A2DP_SPEAKER },
+    { AudioSystem::DEVICE_OUT_AUX_DIGITAL, AUDIO_DEVICE_OUT_AUX_DIGITAL },
+    { AudioSystem::DEVICE_OUT_ANLG_DOCK_HEADSET, AUDIO_DEVICE_OUT_ANLG_DOCK_HEADSET },
+    { AudioSystem::DEVICE_OUT_DGTL_DOCK_HEADSET, AUDIO_DEVICE_OUT_DGTL_DOCK_HEADSET },
+    { AudioSystem::DEVICE_OUT_DEFAULT, AUDIO_DEVICE_OUT_DEFAULT },
+    /* input devices */
+    { AudioSystem::DEVICE_IN_COMMUNICATION, AUDIO_DEVICE_IN_COMMUNICATION },
+    { AudioSystem::DEVICE_IN_AMBIENT, AUDIO_DEVICE_IN_AMBIENT },
+    { AudioSystem::DEVICE_IN_BUILTIN_MIC, AUDIO_DEVICE_IN_BUILTIN_MIC },
+    { AudioSystem::DEVICE_IN_BLUETOOTH_SCO_HEADSET, AUDIO_DEVICE_IN_BLUETOOTH_SCO_HEADSET },
+    { AudioSystem::DEVICE_IN_WIRED_HEADSET, AUDIO_DEVICE_IN_WIRED_HEADSET },
+    { AudioSystem::DEVICE_IN_AUX_DIGITAL, AUDIO_DEVICE_IN_AUX_DIGITAL },
+    { AudioSystem::DEVICE_IN_VOICE_CALL, AUDIO_DEVICE_IN_VOICE_CALL },
+    { AudioSystem::DEVICE_IN_BACK_MIC, AUDIO_DEVICE_IN_BACK_MIC },
+    { AudioSystem::DEVICE_IN_DEFAULT, AUDIO_DEVICE_IN_DEFAULT },
+};
+
+static constexpr uint32_t k_num_devices =
+        sizeof(audio_device_conv_table) / sizeof(audio_device_conv_table[0]);
+
+// What each bit of a device mask converts to, from the first row of
+// audio_device_conv_table it matches; 0 for bits in no row. 2.0 masks carry
+// AUDIO_DEVICE_BIT_IN for the whole mask rather than per device, so they
+// have one map for outputs and one for inputs.
+struct audio_device_bit_map {
+    uint32_t to[32];
+};
+
+static constexpr audio_device_bit_map make_device_bit_map(int from_rev, int to_rev,
+                                                          uint32_t in_bit)
+{
+    audio_device_bit_map map = {};
+    for (uint32_t bit = 0; bit < 32; bit++) {
+        for (uint32_t i = 0; i < k_num_devices; i++) {
+            if (audio_device_conv_table[i][from_rev] == ((1u << bit) | in_bit)) {
+                map.to[bit] = audio_device_conv_table[i][to_rev];
+                break;
+            }
+        }
+    }
+    return map;
+}
+
+static constexpr audio_device_bit_map k_legacy_to_hal =
+        make_device_bit_map(HAL_API_REV_1_0, HAL_API_REV_2_0, 0);
+static constexpr audio_device_bit_map k_hal_out_to_legacy =
+        make_device_bit_map(HAL_API_REV_2_0, HAL_API_REV_1_0, 0);
+static constexpr audio_device_bit_map k_hal_in_to_legacy =
+        make_device_bit_map(HAL_API_REV_2_0, HAL_API_REV_1_0, AUDIO_DEVICE_BIT_IN);
+
+/**
+ * Converts a device mask between HAL_API_REV_1_0 and HAL_API_REV_2_0, one
+ * table lookup per device; devices with no equivalent are dropped.
+ */
+static constexpr audio_devices_t convert_audio_device(uint32_t from_device, int from_rev,
+                                                      int to_rev)
+{
+    const audio_device_bit_map *map = &k_legacy_to_hal;
+    if (from_rev != HAL_API_REV_1_0) {
+        map = (from_device & AUDIO_DEVICE_BIT_IN) ? &k_hal_in_to_legacy : &k_hal_out_to_legacy;
+        from_device &= ~AUDIO_DEVICE_BIT_IN;
+    }
+
+    uint32_t to_device = AUDIO_DEVICE_NONE;
+    for (; from_device; from_device &= from_device - 1) {
+        to_device |= map->to[__builtin_ctz(from_device)];
+    }
+    return (audio_devices_t)to_device;
+}
+
+// Every row must be a single device on both sides, so that the bit maps
+// cover it, and convert to its other side and back unchanged.
+static constexpr bool device_table_is_consistent()
+{
+    for (uint32_t i = 0; i < k_num_devices; i++) {
+        const uint32_t legacy = audio_device_conv_table[i][HAL_API_REV_1_0];
+        const uint32_t hal = audio_device_conv_table[i][HAL_API_REV_2_0];
+        const uint32_t hal_bits = hal & ~(uint32_t)AUDIO_DEVICE_BIT_IN;
+        if (legacy == 0 || (legacy & (legacy - 1)) != 0 ||
+                hal_bits == 0 || (hal_bits & (hal_bits - 1)) != 0) {
+            return false;
+        }
+        if (convert_audio_device(legacy, HAL_API_REV_1_0, HAL_API_REV_2_0) != hal ||
+                convert_audio_device(hal, HAL_API_REV_2_0, HAL_API_REV_1_0) != legacy) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(device_table_is_consistent(),
+              "audio_device_conv_table rows must be single devices that round-trip");
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
+
+#endif // ANDROID_AUDIO_DEVICE_MAP_H
@@ -0,0 +1,293 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LOG_TAG "AudioDumpFormat"
+#include <utils/Log.h>
+
+#include "AudioDumpFormat.h"
+
+namespace android_audio_legacy {
+
+// ----------------------------------------------------------------------------
+
+static const uint32_t kMaxChannels = 8;
+static const uint32_t kMaxFrameSize = kMaxChannels * sizeof(int32_t);
+// residuals of the order 2 predictor need 18 bits after zigzag
+static const uint32_t kMaxRiceParameter = 18;
+// quotients this large are sent as kEscapeBits plain bits instead
+static const uint32_t kEscapeQuotient = 32;
+static const uint32_t kEscapeBits = 20;
+
+static int64_t clockNs(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+void audioDumpInitHeader(AudioDumpHeader *header)
+{
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, kAudioDumpMagic, sizeof(header->magic));
+    header->version = kAudioDumpVersion;
+    header->size = sizeof(*header);
+    header->byteOrder = kAudioDumpByteOrder;
+    header->startRealtimeNs = clockNs(CLOCK_REALTIME);
+    header->startMonotonicNs = clockNs(CLOCK_MONOTONIC);
+}
+
+// Most significant bit first.
+class BitWriter {
+public:
+    BitWriter(uint8_t *dst, size_t capacity)
+        : mDst(dst), mCapacity(capacity), mSize(0), mBits(0), mCount(0), mOverflow(false) {}
+
+    // n up to 57
+    void put(uint64_t value, uint32_t n) {
+        mBits = (mBits << n) | value;
+        mCount += n;
+        while (mCount >= 8) {
+            mCount -= 8;
+            putByte((uint8_t)(mBits >> mCount));
+        }
+    }
+    void align() {
+        if (mCount) put(0, 8 - mCount);
+    }
+    void putByte(uint8_t byte) {
+        if (mSize == mCapacity) {
+            mOverflow = true;
+            return;
+        }
+        mDst[mSize++] = byte;
+    }
+    size_t size() const { return mSize; }
+    bool overflow() const { return mOverflow; }
+
+private:
+    uint8_t *mDst;
+    size_t mCapacity;
+    size_t mSize;
+    uint64_t mBits;
+    uint32_t mCount;
+    bool mOverflow;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t *src, size_t size)
+        : mSrc(src), mSize(size), mPos(0), mBits(0), mCount(0), mOverrun(false) {}
+
+    // n up to 32
+    uint32_t get(uint32_t n) {
+        while (mCount < n) {
+            if (mPos == mSize) {
+                mOverrun = true;
+                return 0;
+            }
+            mBits = (mBits << 8) | mSrc[mPos++];
+            mCount += 8;
+        }
+        mCount -= n;
+        return (uint32_t)(mBits >> mCount) & (uint32_t)((1ull << n) - 1);
+    }
+    void align() { mCount -= mCount % 8; }
+    // whole bytes consumed so far, once aligned
+    size_t position() const { return mPos - mCount / 8; }
+    bool overrun() const { return mOverrun; }
+
+private:
+    const uint8_t *mSrc;
+    size_t mSize;
+    size_t mPos;
+    uint64_t mBits;
+    uint32_t mCount;
+    bool mOverrun;
+};
+
+size_t audioDumpEncodeRice(uint8_t *dst, size_t capacity, const int16_t *src, size_t frames,
+        uint32_t channelCount)
+{
+    if (frames == 0 || frames > kAudioDumpMaxRecordFrames || channelCount == 0 ||
+            channelCount > kMaxChannels || capacity <= sizeof(uint32_t)) {
+        return 0;
+    }
+    uint32_t count = frames;
+    memcpy(dst, &count, sizeof(count));
+    BitWriter writer(dst + sizeof(count), capacity - sizeof(count));
+
+    for (uint32_t c = 0; c < channelCount; c++) {
+        // what each predictor would leave, to pick the order
+        uint64_t sum[3] = {0, 0, 0};
+        int32_t x1 = 0, x2 = 0;
+        for (size_t i = 0; i < frames; i++) {
+            int32_t x = src[i * channelCount + c];
+            sum[0] += abs(x);
+            sum[1] += abs(x - x1);
+            sum[2] += abs(x - 2 * x1 + x2);
+            x2 = x1;
+            x1 = x;
+        }
+        uint32_t order = 0;
+        if (sum[1] < sum[order]) order = 1;
+        if (sum[2] < sum[order]) order = 2;
+        // 2^k near the mean zigzagged residual, about twice the mean magnitude
+        uint32_t k = 0;
+        while (k < kMaxRiceParameter && ((uint64_t)frames << k) < sum[order]) k++;
+        writer.put((order << 5) | k, 8);
+
+        x1 = x2 = 0;
+        for (size_t i = 0; i < frames; i++) {
+            int32_t x = src[i * channelCount + c];
+            int32_t r = order == 0 ? x : order == 1 ? x - x1 : x - 2 * x1 + x2;
+            x2 = x1;
+            x1 = x;
+            uint32_t u = ((uint32_t)r << 1) ^ (uint32_t)(r >> 31);
+            uint32_t q = u >> k;
+            if (q < kEscapeQuotient) {
+                // q ones, a zero, then the low k bits
+                writer.put((((1ull << q) - 1) << (k + 1)) | (u & ((1u << k) - 1)), q + 1 + k);
+            } else {
+                writer.put((((1ull << kEscapeQuotient) - 1) << kEscapeBits) | u,
+                        kEscapeQuotient + kEscapeBits);
+            }
+        }
+        writer.align();
+        if (writer.overflow()) return 0;
+    }
+    return sizeof(count) + writer.size();
+}
+
+bool audioDumpDecodeRice(int16_t *dst, size_t maxFrames, size_t *frames, uint32_t channelCount,
+        const uint8_t *src, size_t size)
+{
+    uint32_t count;
+    if (size < sizeof(count) || channelCount == 0 || channelCount > kMaxChannels) return false;
+    memcpy(&count, src, sizeof(count));
+    if (count > maxFrames) return false;
+    BitReader reader(src + sizeof(count), size - sizeof(count));
+
+    for (uint32_t c = 0; c < channelCount; c++) {
+        uint32_t byte = reader.get(8);
+        uint32_t order = byte >> 5, k = byte & 0x1f;
+        if (order > 2 || k > kMaxRiceParameter) return false;
+        int32_t x1 = 0, x2 = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t q = 0;
+            while (q < kEscapeQuotient && reader.get(1)) q++;
+            uint32_t u = q < kEscapeQuotient ? (q << k) | reader.get(k) : reader.get(kEscapeBits);
+            if (reader.overrun()) return false;
+            int32_t r = (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+            int32_t x = order == 0 ? r : order == 1 ? r + x1 : r + 2 * x1 - x2;
+            if (x < -32768 || x > 32767) return false;
+            dst[i * channelCount + c] = (int16_t)x;
+            x2 = x1;
+            x1 = x;
+        }
+        reader.align();
+    }
+    *frames = count;
+    return reader.position() == size - sizeof(count);
+}
+
+AudioDumpReader::AudioDumpReader()
+    : mFile(0), mPayload(0), mPcm(0), mFrames(0), mFramesRead(0)
+{
+    memset(&mHeader, 0, sizeof(mHeader));
+    memset(&mSync, 0, sizeof(mSync));
+}
+
+AudioDumpReader::~AudioDumpReader()
+{
+    if (mFile != 0) fclose(mFile);
+    free(mPayload);
+    free(mPcm);
+}
+
+status_t AudioDumpReader::open(const char *path)
+{
+    mFile = fopen(path, "rb");
+    if (mFile == 0) return NAME_NOT_FOUND;
+    if (fread(&mHeader, sizeof(mHeader), 1, mFile) != 1 ||
+            memcmp(mHeader.magic, kAudioDumpMagic, sizeof(mHeader.magic)) != 0) {
+        return BAD_VALUE;
+    }
+    // files from before byteOrder was recorded came from little-endian devices
+    uint32_t byteOrder = mHeader.byteOrder;
+    if (byteOrder == 0) {
+        const uint32_t one = 1;
+        byteOrder = *(const uint8_t *)&one ? kAudioDumpByteOrder : 0;
+    }
+    if (byteOrder != kAudioDumpByteOrder) {
+        ALOGE("%s was written in the other byte order", path);
+        return BAD_VALUE;
+    }
+    if (mHeader.version != kAudioDumpVersion || mHeader.size < sizeof(mHeader) ||
+            mHeader.frameSize == 0 || mHeader.frameSize > kMaxFrameSize) {
+        return BAD_VALUE;
+    }
+    // skip what a later version appended
+    if (fseek(mFile, mHeader.size, SEEK_SET) != 0) return BAD_VALUE;
+
+    size_t pcmBytes = kAudioDumpMaxRecordFrames * mHeader.frameSize;
+    mPayload = (uint8_t *)malloc(pcmBytes);
+    mPcm = (uint8_t *)malloc(pcmBytes);
+    return mPayload != 0 && mPcm != 0 ? NO_ERROR : NO_MEMORY;
+}
+
+status_t AudioDumpReader::next(uint32_t *type)
+{
+    AudioDumpRecord record;
+    mFrames = 0;
+    if (fread(&record, sizeof(record), 1, mFile) != 1) return NOT_ENOUGH_DATA;
+    if (record.size > kAudioDumpMaxRecordFrames * mHeader.frameSize) return BAD_VALUE;
+    // a record cut short by the end of the file ends it
+    if (record.size && fread(mPayload, record.size, 1, mFile) != 1) return NOT_ENOUGH_DATA;
+
+    switch (record.type) {
+    case AUDIO_DUMP_RECORD_PCM:
+        if (record.size % mHeader.frameSize) return BAD_VALUE;
+        memcpy(mPcm, mPayload, record.size);
+        mFrames = record.size / mHeader.frameSize;
+        break;
+    case AUDIO_DUMP_RECORD_RICE:
+        if (mHeader.frameSize != mHeader.channelCount * sizeof(int16_t) ||
+                !audioDumpDecodeRice((int16_t *)mPcm, kAudioDumpMaxRecordFrames, &mFrames,
+                        mHeader.channelCount, mPayload, record.size)) {
+            return BAD_VALUE;
+        }
+        break;
+    case AUDIO_DUMP_RECORD_SYNC:
+        if (record.size < sizeof(mSync)) return BAD_VALUE;
+        memcpy(&mSync, mPayload, sizeof(mSync));
+        break;
+    default:
+        // newer record types are skipped
+        break;
+    }
+    mFramesRead += mFrames;
+    *type = record.type;
+    return NO_ERROR;
+}
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
@@ -0,0 +1,154 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef ANDROID_AUDIO_DUMP_FORMAT_H
+#define ANDROID_AUDIO_DUMP_FORMAT_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/types.h>
+
+#include <hardware_legacy/AudioSystemLegacy.h>
+
+namespace android_audio_legacy {
+
+// ----------------------------------------------------------------------------
+
+// Self-describing audio dump, as written by AudioDumpWriter and read by the
+// audio_dump tool:
+//
+//   header:  AudioDumpHeader
+//   records: AudioDumpRecord, then size bytes of payload
+//     RECORD_PCM   frames as the stream carried them
+//     RECORD_RICE  uint32_t frames, then per channel one byte of
+//                  (predictor order << 5 | Rice parameter) and that
+//                  channel's residuals, padded to a byte; 16 bit PCM only
+//     RECORD_SYNC  AudioDumpSync
+//
+// Each record decodes on its own, so a file cut short loses at most its
+// last record. All integers are in the byte order of the device that wrote
+// them, which the header records in byteOrder; readers refuse the other one.
+
+static const char kAudioDumpMagic[4] = {'A', 'D', 'M', 'P'};
+static const uint16_t kAudioDumpVersion = 1;
+// byteOrder as written by a device of the reader's byte order
+static const uint32_t kAudioDumpByteOrder = 0x01020304;
+
+struct AudioDumpHeader {
+    char        magic[4];
+    uint16_t    version;
+    uint16_t    size;           // of the header, so fields can be added at the end
+    uint32_t    format;         // audio_format_t
+    uint32_t    sampleRate;
+    uint32_t    channelMask;
+    uint32_t    channelCount;
+    uint32_t    frameSize;
+    uint32_t    device;
+    uint32_t    flags;
+    uint32_t    byteOrder;      // kAudioDumpByteOrder; 0 before it was recorded, little-endian
+    int64_t     startRealtimeNs;    // CLOCK_REALTIME when the file was opened
+    int64_t     startMonotonicNs;   // CLOCK_MONOTONIC at the same time
+};
+
+enum {
+    AUDIO_DUMP_FLAG_INPUT       = 0x1,
+    AUDIO_DUMP_FLAG_COMPRESSED  = 0x2, // 16 bit PCM goes in RECORD_RICE when smaller
+};
+
+enum {
+    AUDIO_DUMP_RECORD_PCM   = 1,
+    AUDIO_DUMP_RECORD_RICE  = 2,
+    AUDIO_DUMP_RECORD_SYNC  = 3,
+};
+
+struct AudioDumpRecord {
+    uint32_t    type;
+    uint32_t    size;
+};
+
+// Where the stream was at a given time. position counts frames the stream
+// carried, including any the dump had to drop, so comparing it with the
+// frames in the file so far shows where gaps are.
+struct AudioDumpSync {
+    uint64_t    position;
+    int64_t     timeNs;         // CLOCK_MONOTONIC
+};
+
+// fills in magic, version, size, byteOrder and both start times
+void audioDumpInitHeader(AudioDumpHeader *header);
+
+// Most frames one record holds, and the largest record payload.
+static const size_t kAudioDumpMaxRecordFrames = 4096;
+
+/**
+ * Lossless coding of 16 bit PCM: each channel through the fixed predictor of
+ * order 0, 1 or 2 that suits it best, and the residuals Rice coded with a
+ * parameter picked for the record. Typically halves speech and music.
+ *
+ * Returns the payload size, or 0 if it would not be smaller than capacity,
+ * in which case the frames are better stored as they are.
+ */
+size_t audioDumpEncodeRice(uint8_t *dst, size_t capacity, const int16_t *src, size_t frames,
+        uint32_t channelCount);
+
+/** the reverse; false if the payload is corrupt */
+bool audioDumpDecodeRice(int16_t *dst, size_t maxFrames, size_t *frames, uint32_t channelCount,
+        const uint8_t *src, size_t size);
+
+/**
+ * Reads a dump back, one record at a time, decoding RECORD_RICE to PCM.
+ */
+class AudioDumpReader {
+public:
+                        AudioDumpReader();
+                        ~AudioDumpReader();
+
+            /** opens path and checks its header */
+            status_t    open(const char *path);
+            const AudioDumpHeader& header() const { return mHeader; }
+
+            /**
+             * The next record: its type, and for audio the decoded frames in
+             * pcm(); for RECORD_SYNC, sync(). NOT_ENOUGH_DATA at the end of
+             * the file, BAD_VALUE if the record is corrupt.
+             */
+            status_t    next(uint32_t *type);
+            const void* pcm() const { return mPcm; }
+            size_t      frames() const { return mFrames; }
+            const AudioDumpSync& sync() const { return mSync; }
+
+            /** frames returned so far */
+            uint64_t    framesRead() const { return mFramesRead; }
+
+private:
+                        AudioDumpReader(const AudioDumpReader &);
+            AudioDumpReader& operator=(const AudioDumpReader &);
+
+    FILE                *mFile;
+    AudioDumpHeader     mHeader;
+    uint8_t             *mPayload;
+    uint8_t             *mPcm;
+    size_t              mFrames;
+    AudioDumpSync       mSync;
+    uint64_t            mFramesRead;
+};
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
+
+#endif // ANDROID_AUDIO_DUMP_FORMAT_H
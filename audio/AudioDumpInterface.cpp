@@ -27,12 +27,91 @@
 
 #include "AudioDumpInterface.h"
 
-namespace android {
+namespace android_audio_legacy {
 
 // ----------------------------------------------------------------------------
 
+// Dump data the I/O thread may fall behind by before writes are dropped:
+// ~2.7s of 48kHz 16-bit stereo.
+static const size_t kDumpRingBytes = 512 * 1024;
+
+// Where flight recordings go when test_cmd_file_name is not set.
+static const char * const kFlightRecorderPrefix = "/data/misc/audioserver/flight";
+
+// Longest flight recorder history accepted, per stream.
+static const uint32_t kMaxFlightSeconds = 60;
+
+// The AudioDumpFormat header of a stream's dumps and flight recordings.
+static void initDumpHeader(android_audio_legacy::AudioDumpHeader *header, bool input,
+        int format, uint32_t sampleRate, uint32_t channelMask, size_t frameSize,
+        uint32_t device, uint32_t flags)
+{
+    android_audio_legacy::audioDumpInitHeader(header);
+    header->format = format;
+    header->sampleRate = sampleRate;
+    header->channelMask = channelMask;
+    header->channelCount = AudioSystem::popCount(channelMask);
+    header->frameSize = frameSize;
+    header->device = device;
+    header->flags = (input ? android_audio_legacy::AUDIO_DUMP_FLAG_INPUT : 0) | flags;
+}
+
+// Opens dump number count of a stream: "<test_cmd_file_name>_<kind>_<id>_<count>"
+// with .pcm for raw dumps, or .adump for an AudioDumpFormat container that
+// records the stream's configuration.
+static void openDumpFile(AudioDumpInterface *interface,
+        android_audio_legacy::AudioDumpWriter *dump, bool input, int id, int count,
+        int format, uint32_t sampleRate, uint32_t channelMask, size_t frameSize,
+        uint32_t device)
+{
+    int dumpFormat = interface->dumpFormat();
+    char name[255];
+    snprintf(name, sizeof(name), "%s_%s_%d_%d.%s", interface->fileName().string(),
+            input ? "in" : "out", id, count,
+            dumpFormat == AudioDumpInterface::DUMP_FORMAT_PCM ? "pcm" : "adump");
+    ALOGV("Opening dump file %s", name);
+    if (dumpFormat == AudioDumpInterface::DUMP_FORMAT_PCM) {
+        dump->open(name);
+        return;
+    }
+    android_audio_legacy::AudioDumpHeader header;
+    initDumpHeader(&header, input, format, sampleRate, channelMask, frameSize, device,
+            dumpFormat == AudioDumpInterface::DUMP_FORMAT_COMPRESSED ?
+                    android_audio_legacy::AUDIO_DUMP_FLAG_COMPRESSED : 0);
+    dump->open(name, &header);
+}
+
+// Builds "<test_cmd_file_name or default>_<kind>_<id>_flight" and creates the
+// recorder, saving to .pcm if test_cmd_dump_format is pcm and to .adump
+// containers otherwise; returns 0 if it can't be set up.
+static android_audio_legacy::AudioFlightRecorder *createFlightRecorder(
+        AudioDumpInterface *interface, bool input, int id, int format, uint32_t sampleRate,
+        uint32_t channelMask, size_t frameSize, uint32_t device)
+{
+    uint32_t seconds = interface->flightRecorderSeconds();
+    if (seconds == 0 || frameSize == 0) return 0;
+    char prefix[android_audio_legacy::AudioFlightRecorder::kMaxPath];
+    snprintf(prefix, sizeof(prefix), "%s_%s_%d_flight",
+            interface->fileName() != "" ? interface->fileName().string() : kFlightRecorderPrefix,
+            input ? "in" : "out", id);
+    android_audio_legacy::AudioDumpHeader header;
+    initDumpHeader(&header, input, format, sampleRate, channelMask, frameSize, device, 0);
+    android_audio_legacy::AudioFlightRecorder *recorder =
+            new android_audio_legacy::AudioFlightRecorder(
+                    (size_t)seconds * sampleRate * frameSize, frameSize);
+    if (recorder->init(prefix, interface->dumpFormat() == AudioDumpInterface::DUMP_FORMAT_PCM ?
+            0 : &header) != NO_ERROR) {
+        ALOGE("cannot set up flight recorder %s", prefix);
+        delete recorder;
+        return 0;
+    }
+    return recorder;
+}
+
 AudioDumpInterface::AudioDumpInterface(AudioHardwareInterface* hw)
-    : mPolicyCommands(String8("")), mFileName(String8(""))
+    : mPolicyCommands(String8("")), mFileName(String8("")), mDirectDump(false),
+      mDumpFormat(DUMP_FORMAT_CONTAINER), mFlightSeconds(0),
+      mInputSignal(android_audio_legacy::AudioTestSignal::SIGNAL_FILE)
 {
     if(hw == 0) {
         ALOGE("Dump construct hw = 0");
@@ -44,12 +123,13 @@ AudioDumpInterface::AudioDumpInterface(AudioHardwareInterface* hw)
 
 AudioDumpInterface::~AudioDumpInterface()
 {
-    for (size_t i = 0; i < mOutputs.size(); i++) {
-        closeOutputStream((AudioStreamOut *)mOutputs[i]);
+    // each close removes the stream
+    while (mOutputs.size()) {
+        closeOutputStream((AudioStreamOut *)mOutputs[0]);
     }
 
-    for (size_t i = 0; i < mInputs.size(); i++) {
-        closeInputStream((AudioStreamIn *)mInputs[i]);
+    while (mInputs.size()) {
+        closeInputStream((AudioStreamIn *)mInputs[0]);
     }
 
     if(mFinalInterface) delete mFinalInterface;
@@ -96,6 +176,8 @@ AudioStreamOut* AudioDumpInterface::openOutputStream(
     }
     ALOGV("openOutputStream(), outFinal %p", outFinal);
 
+    // triggerFlightRecorders() may be walking mOutputs
+    Mutex::Autolock _l(mLock);
     AudioStreamOutDump *dumOutput = new AudioStreamOutDump(this, mOutputs.size(), outFinal,
             devices, lFormat, lChannels, lRate);
     mOutputs.add(dumOutput);
@@ -107,9 +189,14 @@ void AudioDumpInterface::closeOutputStream(AudioStreamOut* out)
 {
     AudioStreamOutDump *dumpOut = (AudioStreamOutDump *)out;
 
-    if (mOutputs.indexOf(dumpOut) < 0) {
-        ALOGW("Attempt to close invalid output stream");
-        return;
+    {
+        // the stream is closed and freed once triggerFlightRecorders() can't see it
+        Mutex::Autolock _l(mLock);
+        if (mOutputs.indexOf(dumpOut) < 0) {
+            ALOGW("Attempt to close invalid output stream");
+            return;
+        }
+        mOutputs.remove(dumpOut);
     }
 
     ALOGV("closeOutputStream() output %p", out);
@@ -119,7 +206,6 @@ void AudioDumpInterface::closeOutputStream(AudioStreamOut* out)
         mFinalInterface->closeOutputStream(dumpOut->finalStream());
     }
 
-    mOutputs.remove(dumpOut);
     delete dumpOut;
 }
 
@@ -162,6 +248,7 @@ AudioStreamIn* AudioDumpInterface::openInputStream(uint32_t devices, int *format
     }
     ALOGV("openInputStream(), inFinal %p", inFinal);
 
+    Mutex::Autolock _l(mLock);
     AudioStreamInDump *dumInput = new AudioStreamInDump(this, mInputs.size(), inFinal,
             devices, lFormat, lChannels, lRate);
     mInputs.add(dumInput);
@@ -172,16 +259,19 @@ void AudioDumpInterface::closeInputStream(AudioStreamIn* in)
 {
     AudioStreamInDump *dumpIn = (AudioStreamInDump *)in;
 
-    if (mInputs.indexOf(dumpIn) < 0) {
-        ALOGW("Attempt to close invalid input stream");
-        return;
+    {
+        Mutex::Autolock _l(mLock);
+        if (mInputs.indexOf(dumpIn) < 0) {
+            ALOGW("Attempt to close invalid input stream");
+            return;
+        }
+        mInputs.remove(dumpIn);
     }
     dumpIn->standby();
     if (dumpIn->finalStream() != NULL) {
         mFinalInterface->closeInputStream(dumpIn->finalStream());
     }
 
-    mInputs.remove(dumpIn);
     delete dumpIn;
 }
 
@@ -197,6 +287,44 @@ status_t AudioDumpInterface::setParameters(const String8& keyValuePairs)
         mFileName = value;
         param.remove(String8("test_cmd_file_name"));
     }
+    // applies to streams opened afterwards
+    if (param.getInt(String8("test_cmd_dump_direct"), valueInt) == NO_ERROR) {
+        mDirectDump = valueInt != 0;
+        param.remove(String8("test_cmd_dump_direct"));
+    }
+    // pcm, container or compressed, for dump files opened afterwards
+    if (param.get(String8("test_cmd_dump_format"), value) == NO_ERROR) {
+        if (value == "pcm") {
+            mDumpFormat = DUMP_FORMAT_PCM;
+        } else if (value == "container") {
+            mDumpFormat = DUMP_FORMAT_CONTAINER;
+        } else if (value == "compressed") {
+            mDumpFormat = DUMP_FORMAT_COMPRESSED;
+        } else {
+            ALOGW("unknown test_cmd_dump_format %s", value.string());
+        }
+        param.remove(String8("test_cmd_dump_format"));
+    }
+    // seconds of history kept per stream opened afterwards, 0 for continuous dumps
+    if (param.getInt(String8("test_cmd_flight_recorder"), valueInt) == NO_ERROR) {
+        mFlightSeconds = valueInt > 0 ? (uint32_t)valueInt : 0;
+        if (mFlightSeconds > kMaxFlightSeconds) mFlightSeconds = kMaxFlightSeconds;
+        param.remove(String8("test_cmd_flight_recorder"));
+    }
+    if (param.get(String8("test_cmd_flight_dump"), value) == NO_ERROR) {
+        triggerFlightRecorders("test_cmd_flight_dump");
+        param.remove(String8("test_cmd_flight_dump"));
+    }
+    // what inputs opened afterwards capture without a final stream
+    if (param.get(String8("test_cmd_input_signal"), value) == NO_ERROR) {
+        int type = android_audio_legacy::AudioTestSignal::typeFromString(value.string());
+        if (type != android_audio_legacy::AudioTestSignal::SIGNAL_NONE) {
+            mInputSignal = type;
+        } else {
+            ALOGW("unknown test_cmd_input_signal %s", value.string());
+        }
+        param.remove(String8("test_cmd_input_signal"));
+    }
     if (param.get(String8("test_cmd_policy"), value) == NO_ERROR) {
         Mutex::Autolock _l(mLock);
         param.remove(String8("test_cmd_policy"));
@@ -253,6 +381,24 @@ size_t AudioDumpInterface::getInputBufferSize(uint32_t sampleRate, int format, i
     return mFinalInterface->getInputBufferSize(sampleRate, format, channelCount);
 }
 
+void AudioDumpInterface::triggerFlightRecorders(const char *reason)
+{
+    Mutex::Autolock _l(mLock);
+    for (size_t i = 0; i < mOutputs.size(); i++) {
+        mOutputs[i]->triggerFlightRecorder(reason);
+    }
+    for (size_t i = 0; i < mInputs.size(); i++) {
+        mInputs[i]->triggerFlightRecorder(reason);
+    }
+}
+
+status_t AudioDumpInterface::dump(int fd, const Vector<String16>& args)
+{
+    // a bug report wants the audio leading up to it
+    triggerFlightRecorders("dump");
+    return mFinalInterface->dumpState(fd, args);
+}
+
 // ----------------------------------------------------------------------------
 
 AudioStreamOutDump::AudioStreamOutDump(AudioDumpInterface *interface,
@@ -264,9 +410,15 @@ AudioStreamOutDump::AudioStreamOutDump(AudioDumpInterface *interface,
                                         uint32_t sampleRate)
     : mInterface(interface), mId(id),
       mSampleRate(sampleRate), mFormat(format), mChannels(channels), mLatency(0), mDevice(devices),
-      mBufferSize(1024), mFinalStream(finalStream), mFile(0), mFileCount(0)
+      mBufferSize(1024), mFinalStream(finalStream),
+      mDump(kDumpRingBytes, interface->directDump()), mFileCount(0), mFlight(0), mLastWriteNs(0)
 {
     ALOGV("AudioStreamOutDump Constructor %p, mInterface %p, mFinalStream %p", this, mInterface, mFinalStream);
+    mFlight = createFlightRecorder(interface, false, id, this->format(), this->sampleRate(),
+            this->channels(), frameSize(), mDevice);
+    if (mFlight == 0) {
+        mDump.init();
+    }
 }
 
 
@@ -274,37 +426,55 @@ AudioStreamOutDump::~AudioStreamOutDump()
 {
     ALOGV("AudioStreamOutDump destructor");
     Close();
+    delete mFlight;
 }
 
 ssize_t AudioStreamOutDump::write(const void* buffer, size_t bytes)
 {
     ssize_t ret;
 
+    if (mFlight != 0 && mLastWriteNs != 0) {
+        // the device drains its buffer, latency() worth, while the client is
+        // away; coming back later than that means it ran dry
+        nsecs_t allowedNs = (nsecs_t)latency() * 1000000;
+        if (allowedNs == 0) {
+            allowedNs = 2 * (nsecs_t)(bufferSize() / frameSize()) * 1000000000 / sampleRate();
+        }
+        if (systemTime() - mLastWriteNs > allowedNs) {
+            mFlight->trigger("underrun");
+        }
+    }
     if (mFinalStream) {
         ret = mFinalStream->write(buffer, bytes);
     } else {
-        usleep((((bytes * 1000) / frameSize()) / sampleRate()) * 1000);
+        mPacing.pace(bytes / frameSize(), sampleRate());
         ret = bytes;
     }
-    if(!mFile) {
+    if (mFlight != 0) {
+        mFlight->write(buffer, bytes);
+        mLastWriteNs = systemTime();
+        return ret;
+    }
+    if (!mDump.isOpen()) {
         if (mInterface->fileName() != "") {
-            char name[255];
-            sprintf(name, "%s_out_%d_%d.pcm", mInterface->fileName().string(), mId, ++mFileCount);
-            mFile = fopen(name, "wb");
-            ALOGV("Opening dump file %s, fh %p", name, mFile);
+            openDumpFile(mInterface, &mDump, false, mId, ++mFileCount, format(), sampleRate(),
+                    channels(), frameSize(), mDevice);
         }
     }
-    if (mFile) {
-        fwrite(buffer, bytes, 1, mFile);
+    if (mDump.isOpen()) {
+        mDump.write(buffer, bytes);
     }
     return ret;
 }
 
 status_t AudioStreamOutDump::standby()
 {
-    ALOGV("AudioStreamOutDump standby(), mFile %p, mFinalStream %p", mFile, mFinalStream);
+    ALOGV("AudioStreamOutDump standby(), mFinalStream %p", mFinalStream);
 
     Close();
+    mPacing.reset();
+    // a pause is not an underrun
+    mLastWriteNs = 0;
     if (mFinalStream != 0 ) return mFinalStream->standby();
     return NO_ERROR;
 }
@@ -359,7 +529,7 @@ status_t AudioStreamOutDump::setParameters(const String8& keyValuePairs)
     }
 
     if (param.getInt(String8("format"), valueInt) == NO_ERROR) {
-        if (mFile == 0) {
+        if (!mDump.isOpen()) {
             mFormat = valueInt;
         } else {
             status = INVALID_OPERATION;
@@ -374,7 +544,7 @@ status_t AudioStreamOutDump::setParameters(const String8& keyValuePairs)
     }
     if (param.getInt(String8("sampling_rate"), valueInt) == NO_ERROR) {
         if (valueInt > 0 && valueInt <= 48000) {
-            if (mFile == 0) {
+            if (!mDump.isOpen()) {
                 mSampleRate = valueInt;
             } else {
                 status = INVALID_OPERATION;
@@ -396,16 +566,18 @@ String8 AudioStreamOutDump::getParameters(const String8& keys)
 
 status_t AudioStreamOutDump::dump(int fd, const Vector<String16>& args)
 {
+    if (mFlight != 0) {
+        mFlight->dump(fd);
+    } else {
+        mDump.dump(fd);
+    }
     if (mFinalStream != 0 ) return mFinalStream->dump(fd, args);
     return NO_ERROR;
 }
 
 void AudioStreamOutDump::Close()
 {
-    if(mFile) {
-        fclose(mFile);
-        mFile = 0;
-    }
+    mDump.close();
 }
 
 status_t AudioStreamOutDump::getRenderPosition(uint32_t *dspFrames)
@@ -414,6 +586,11 @@ status_t AudioStreamOutDump::getRenderPosition(uint32_t *dspFrames)
     return INVALID_OPERATION;
 }
 
+void AudioStreamOutDump::triggerFlightRecorder(const char *reason)
+{
+    if (mFlight != 0) mFlight->trigger(reason);
+}
+
 // ----------------------------------------------------------------------------
 
 AudioStreamInDump::AudioStreamInDump(AudioDumpInterface *interface,
@@ -425,72 +602,102 @@ AudioStreamInDump::AudioStreamInDump(AudioDumpInterface *interface,
                                         uint32_t sampleRate)
     : mInterface(interface), mId(id),
       mSampleRate(sampleRate), mFormat(format), mChannels(channels), mDevice(devices),
-      mBufferSize(1024), mFinalStream(finalStream), mFile(0), mFileCount(0)
+      mBufferSize(1024), mFinalStream(finalStream),
+      mSignal(sampleRate, AudioSystem::popCount(channels), format),
+      mDump(kDumpRingBytes, interface->directDump()), mFileCount(0), mFlight(0), mLastReadNs(0)
 {
     ALOGV("AudioStreamInDump Constructor %p, mInterface %p, mFinalStream %p", this, mInterface, mFinalStream);
+    if (mFinalStream != 0) {
+        mFlight = createFlightRecorder(interface, true, id, this->format(), this->sampleRate(),
+                this->channels(), frameSize(), mDevice);
+        if (mFlight == 0) {
+            mDump.init();
+        }
+    } else {
+        openTestSignal();
+    }
+}
+
+// Sets up the injected input here rather than in read(), so that capture
+// never touches storage: /sdcard/music/sine440_<mo|st>_<16b|8b>_<rate>.wav
+// if asked for and present, a generated signal otherwise.
+void AudioStreamInDump::openTestSignal()
+{
+    int type = mInterface->inputSignal();
+    if (type == android_audio_legacy::AudioTestSignal::SIGNAL_FILE) {
+        char name[255];
+        strcpy(name, "/sdcard/music/sine440");
+        if (channels() == AudioSystem::CHANNEL_IN_MONO) {
+            strcat(name, "_mo");
+        } else {
+            strcat(name, "_st");
+        }
+        if (format() == AudioSystem::PCM_16_BIT) {
+            strcat(name, "_16b");
+        } else {
+            strcat(name, "_8b");
+        }
+        if (sampleRate() < 16000) {
+            strcat(name, "_8k");
+        } else if (sampleRate() < 32000) {
+            strcat(name, "_22k");
+        } else if (sampleRate() < 48000) {
+            strcat(name, "_44k");
+        } else {
+            strcat(name, "_48k");
+        }
+        strcat(name, ".wav");
+        if (mSignal.openFile(name) == NO_ERROR) {
+            ALOGV("Injecting input file %s", name);
+            return;
+        }
+        type = android_audio_legacy::AudioTestSignal::SIGNAL_SWEEP;
+    }
+    if (mSignal.generate(type) != NO_ERROR) {
+        ALOGW("cannot generate test signal %d, injecting silence", type);
+    }
 }
 
 
 AudioStreamInDump::~AudioStreamInDump()
 {
     Close();
+    delete mFlight;
 }
 
 ssize_t AudioStreamInDump::read(void* buffer, ssize_t bytes)
 {
     ssize_t ret;
 
-    if (mFinalStream) {
+    if (mFinalStream && mFlight != 0) {
+        // the driver holds about a buffer or two; a client that comes back
+        // later than that has lost input
+        nsecs_t now = systemTime();
+        if (mLastReadNs != 0 && now - mLastReadNs >
+                2 * (nsecs_t)(bufferSize() / frameSize()) * 1000000000 / sampleRate()) {
+            mFlight->trigger("overrun");
+        }
+        ret = mFinalStream->read(buffer, bytes);
+        if (ret > 0) {
+            mFlight->write(buffer, ret);
+        }
+        mLastReadNs = systemTime();
+    } else if (mFinalStream) {
         ret = mFinalStream->read(buffer, bytes);
-        if(!mFile) {
+        if (!mDump.isOpen()) {
             if (mInterface->fileName() != "") {
-                char name[255];
-                sprintf(name, "%s_in_%d_%d.pcm", mInterface->fileName().string(), mId, ++mFileCount);
-                mFile = fopen(name, "wb");
-                ALOGV("Opening input dump file %s, fh %p", name, mFile);
+                openDumpFile(mInterface, &mDump, true, mId, ++mFileCount, format(),
+                        sampleRate(), channels(), frameSize(), mDevice);
             }
         }
-        if (mFile) {
-            fwrite(buffer, bytes, 1, mFile);
+        if (mDump.isOpen() && ret > 0) {
+            mDump.write(buffer, ret);
         }
     } else {
-        usleep((((bytes * 1000) / frameSize()) / sampleRate()) * 1000);
+        mPacing.pace(bytes / frameSize(), sampleRate());
         ret = bytes;
-        if(!mFile) {
-            char name[255];
-            strcpy(name, "/sdcard/music/sine440");
-            if (channels() == AudioSystem::CHANNEL_IN_MONO) {
-                strcat(name, "_mo");
-            } else {
-                strcat(name, "_st");
-            }
-            if (format() == AudioSystem::PCM_16_BIT) {
-                strcat(name, "_16b");
-            } else {
-                strcat(name, "_8b");
-            }
-            if (sampleRate() < 16000) {
-                strcat(name, "_8k");
-            } else if (sampleRate() < 32000) {
-                strcat(name, "_22k");
-            } else if (sampleRate() < 48000) {
-                strcat(name, "_44k");
-            } else {
-                strcat(name, "_48k");
-            }
-            strcat(name, ".wav");
-            mFile = fopen(name, "rb");
-            ALOGV("Opening input read file %s, fh %p", name, mFile);
-            if (mFile) {
-                fseek(mFile, AUDIO_DUMP_WAVE_HDR_SIZE, SEEK_SET);
-            }
-        }
-        if (mFile) {
-            ssize_t bytesRead = fread(buffer, bytes, 1, mFile);
-            if (bytesRead >=0 && bytesRead < bytes) {
-                fseek(mFile, AUDIO_DUMP_WAVE_HDR_SIZE, SEEK_SET);
-                fread((uint8_t *)buffer+bytesRead, bytes-bytesRead, 1, mFile);
-            }
+        if (mSignal.read(buffer, bytes) == 0) {
+            memset(buffer, 0, bytes);
         }
     }
 
@@ -499,9 +706,11 @@ ssize_t AudioStreamInDump::read(void* buffer, ssize_t bytes)
 
 status_t AudioStreamInDump::standby()
 {
-    ALOGV("AudioStreamInDump standby(), mFile %p, mFinalStream %p", mFile, mFinalStream);
+    ALOGV("AudioStreamInDump standby(), mFinalStream %p", mFinalStream);
 
     Close();
+    mPacing.reset();
+    mLastReadNs = 0;
     if (mFinalStream != 0 ) return mFinalStream->standby();
     return NO_ERROR;
 }
@@ -559,15 +768,36 @@ unsigned int AudioStreamInDump::getInputFramesLost() const
 
 status_t AudioStreamInDump::dump(int fd, const Vector<String16>& args)
 {
+    if (mFlight != 0) {
+        mFlight->dump(fd);
+    } else {
+        mDump.dump(fd);
+    }
     if (mFinalStream != 0 ) return mFinalStream->dump(fd, args);
     return NO_ERROR;
 }
 
+status_t AudioStreamInDump::addAudioEffect(effect_handle_t effect)
+{
+    if (mFinalStream != 0 ) return mFinalStream->addAudioEffect(effect);
+    return NO_ERROR;
+}
+
+status_t AudioStreamInDump::removeAudioEffect(effect_handle_t effect)
+{
+    if (mFinalStream != 0 ) return mFinalStream->removeAudioEffect(effect);
+    return NO_ERROR;
+}
+
+void AudioStreamInDump::triggerFlightRecorder(const char *reason)
+{
+    if (mFlight != 0) mFlight->trigger(reason);
+}
+
 void AudioStreamInDump::Close()
 {
-    if(mFile) {
-        fclose(mFile);
-        mFile = 0;
-    }
+    mDump.close();
+    // capture restarts from the top of the injected signal
+    mSignal.rewind();
 }
-}; // namespace android
+}; // namespace android_audio_legacy
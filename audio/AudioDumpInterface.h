@@ -25,9 +25,14 @@
 
 #include <hardware_legacy/AudioHardwareBase.h>
 
-namespace android {
+#include "AudioDumpWriter.h"
+#include "AudioFlightRecorder.h"
+#include "AudioPacingClock.h"
+#include "AudioTestSignal.h"
 
-#define AUDIO_DUMP_WAVE_HDR_SIZE 44
+namespace android_audio_legacy {
+    using android::Mutex;
+    using android::SortedVector;
 
 class AudioDumpInterface;
 
@@ -58,6 +63,8 @@ public:
     uint32_t            device() { return mDevice; }
     int                 getId()  { return mId; }
     virtual status_t    getRenderPosition(uint32_t *dspFrames);
+    // save the flight recording, if there is one
+    void                triggerFlightRecorder(const char *reason);
 
 private:
     AudioDumpInterface *mInterface;
@@ -69,8 +76,12 @@ private:
     uint32_t mDevice;                   // current device this output is routed to
     size_t  mBufferSize;
     AudioStreamOut      *mFinalStream;
-    FILE                *mFile;      // output file
+    android_audio_legacy::AudioDumpWriter mDump; // output file, written off the audio thread
     int                 mFileCount;
+    android_audio_legacy::AudioPacingClock mPacing; // timing when there is no final stream
+    // flight recorder mode, instead of mDump
+    android_audio_legacy::AudioFlightRecorder *mFlight;
+    nsecs_t             mLastWriteNs;   // when the previous write() returned
 };
 
 class AudioStreamInDump : public AudioStreamIn {
@@ -96,11 +107,17 @@ public:
     virtual String8     getParameters(const String8& keys);
     virtual unsigned int  getInputFramesLost() const;
     virtual status_t    dump(int fd, const Vector<String16>& args);
+    virtual status_t    addAudioEffect(effect_handle_t effect);
+    virtual status_t    removeAudioEffect(effect_handle_t effect);
     void                Close(void);
     AudioStreamIn*     finalStream() { return mFinalStream; }
     uint32_t            device() { return mDevice; }
+    // save the flight recording, if there is one
+    void                triggerFlightRecorder(const char *reason);
 
 private:
+    void                openTestSignal();
+
     AudioDumpInterface *mInterface;
     int                  mId;
     uint32_t mSampleRate;               //
@@ -109,14 +126,26 @@ private:
     uint32_t mDevice;                   // current device this output is routed to
     size_t  mBufferSize;
     AudioStreamIn      *mFinalStream;
-    FILE                *mFile;      // output file
+    android_audio_legacy::AudioTestSignal mSignal; // input when there is no final stream
+    android_audio_legacy::AudioDumpWriter mDump; // output file, written off the audio thread
     int                 mFileCount;
+    android_audio_legacy::AudioPacingClock mPacing; // timing when there is no final stream
+    // flight recorder mode, instead of mDump
+    android_audio_legacy::AudioFlightRecorder *mFlight;
+    nsecs_t             mLastReadNs;    // when the previous read() returned
 };
 
 class AudioDumpInterface : public AudioHardwareBase
 {
 
 public:
+    // what dump files hold
+    enum {
+        DUMP_FORMAT_PCM,            // the stream's bytes, nothing else
+        DUMP_FORMAT_CONTAINER,      // AudioDumpFormat, with header and sync records
+        DUMP_FORMAT_COMPRESSED,     // the same, 16 bit PCM Rice coded
+    };
+
                         AudioDumpInterface(AudioHardwareInterface* hw);
     virtual AudioStreamOut* openOutputStream(
                                 uint32_t devices,
@@ -124,6 +153,16 @@ public:
                                 uint32_t *channels=0,
                                 uint32_t *sampleRate=0,
                                 status_t *status=0);
+    virtual AudioStreamOut* openOutputStreamWithFlags(
+                                uint32_t devices,
+                                audio_output_flags_t flags,
+                                int *format=0,
+                                uint32_t *channels=0,
+                                uint32_t *sampleRate=0,
+                                status_t *status=0) {
+                                return openOutputStream(devices, format, channels, sampleRate,
+                                        status);
+                            }
     virtual    void        closeOutputStream(AudioStreamOut* out);
 
     virtual             ~AudioDumpInterface();
@@ -142,6 +181,22 @@ public:
                             {return mFinalInterface->setMicMute(state);}
     virtual status_t    getMicMute(bool* state)
                             {return mFinalInterface->getMicMute(state);}
+    virtual status_t    setMasterMute(bool muted)
+                            {return mFinalInterface->setMasterMute(muted);}
+
+    virtual int         createAudioPatch(unsigned int num_sources,
+                                         const struct audio_port_config *sources,
+                                         unsigned int num_sinks,
+                                         const struct audio_port_config *sinks,
+                                         audio_patch_handle_t *handle)
+                            {return mFinalInterface->createAudioPatch(num_sources, sources,
+                                    num_sinks, sinks, handle);}
+    virtual int         releaseAudioPatch(audio_patch_handle_t handle)
+                            {return mFinalInterface->releaseAudioPatch(handle);}
+    virtual int         getAudioPort(struct audio_port *port)
+                            {return mFinalInterface->getAudioPort(port);}
+    virtual int         setAudioPortConfig(const struct audio_port_config *config)
+                            {return mFinalInterface->setAudioPortConfig(config);}
 
     virtual status_t    setParameters(const String8& keyValuePairs);
     virtual String8     getParameters(const String8& keys);
@@ -152,19 +207,31 @@ public:
             uint32_t *sampleRate, status_t *status, AudioSystem::audio_in_acoustics acoustics);
     virtual    void        closeInputStream(AudioStreamIn* in);
 
-    virtual status_t    dump(int fd, const Vector<String16>& args) { return mFinalInterface->dumpState(fd, args); }
+    virtual status_t    dump(int fd, const Vector<String16>& args);
 
             String8     fileName() const { return mFileName; }
+            bool        directDump() const { return mDirectDump; }
+            // one of the DUMP_FORMAT_ values
+            int         dumpFormat() const { return mDumpFormat; }
+            uint32_t    flightRecorderSeconds() const { return mFlightSeconds; }
+            // AudioTestSignal type injected by inputs without a final stream
+            int         inputSignal() const { return mInputSignal; }
+            // ask every stream with a flight recorder to save it
+            void        triggerFlightRecorders(const char *reason);
 protected:
 
     AudioHardwareInterface          *mFinalInterface;
     SortedVector<AudioStreamOutDump *>   mOutputs;
     SortedVector<AudioStreamInDump *>    mInputs;
-    Mutex                           mLock;
+    Mutex                           mLock;  // mOutputs, mInputs and mPolicyCommands
     String8                         mPolicyCommands;
     String8                         mFileName;
+    bool                            mDirectDump;    // open dump files with O_DIRECT
+    int                             mDumpFormat;
+    uint32_t                        mFlightSeconds; // history per stream; 0 dumps continuously
+    int                             mInputSignal;
 };
 
-}; // namespace android
+}; // namespace android_audio_legacy
 
 #endif // ANDROID_AUDIO_DUMP_INTERFACE_H
@@ -0,0 +1,387 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define LOG_TAG "AudioDumpWriter"
+#include <utils/Log.h>
+#include <utils/String8.h>
+
+#include "AudioDumpWriter.h"
+
+namespace android_audio_legacy {
+    using android::String8;
+
+// ----------------------------------------------------------------------------
+
+// O_DIRECT wants buffers aligned to the logical block size; a page covers it.
+static const size_t kBlockAlign = 4096;
+
+const size_t AudioDumpWriter::kBlockSize;
+const size_t AudioDumpWriter::kMaxPath;
+
+AudioDumpWriter::AudioDumpWriter(size_t ringBytes, bool direct)
+    : mDirect(direct), mRing(ringBytes), mCommands(kMaxCommands * sizeof(Command)),
+      mOpen(false), mFrameSize(0), mPosition(0), mLastSyncNs(0), mNeedSync(false),
+      mHaveCommand(false), mBlock(0), mFill(0), mFd(-1), mFdDirect(false),
+      mContainer(false), mCompressed(false), mRecord(0), mEncoded(0), mRecordCapacity(0),
+      mDroppedBytes(0), mDrops(0), mWrittenBytes(0), mRecordedBytes(0), mFiles(0)
+{
+    if (posix_memalign((void **)&mBlock, kBlockAlign, kBlockSize) != 0) {
+        mBlock = 0;
+    }
+}
+
+AudioDumpWriter::~AudioDumpWriter()
+{
+    if (mThread != 0) {
+        mThread->requestExitAndWait();
+        mThread.clear();
+    }
+    // finish what is queued from here, now nothing else touches the rings
+    close();
+    while (drain()) {
+    }
+    closeFile();
+    free(mBlock);
+    free(mRecord);
+    free(mEncoded);
+}
+
+status_t AudioDumpWriter::init()
+{
+    if (mBlock == 0) return NO_MEMORY;
+    mThread = new IoThread(this);
+    status_t status = mThread->run("AudioDumpWriter", ANDROID_PRIORITY_BACKGROUND);
+    if (status != NO_ERROR) {
+        ALOGE("cannot start dump thread: %d", status);
+        mThread.clear();
+    }
+    return status;
+}
+
+status_t AudioDumpWriter::open(const char *path, const AudioDumpHeader *header)
+{
+    if (mCommands.availableToWrite() < sizeof(Command)) return WOULD_BLOCK;
+    Command command;
+    command.position = mRing.totalWritten();
+    command.type = CMD_OPEN;
+    command.container = header != 0;
+    if (header != 0) command.header = *header;
+    strncpy(command.path, path, kMaxPath - 1);
+    command.path[kMaxPath - 1] = '\0';
+    mCommands.write(&command, sizeof(command));
+    mOpen = true;
+    mFrameSize = header != 0 ? header->frameSize : 0;
+    mPosition = 0;
+    mNeedSync = true;
+    return NO_ERROR;
+}
+
+void AudioDumpWriter::close()
+{
+    if (!mOpen) return;
+    // the command ring only fills if the thread is stuck; the next open()
+    // then ends this file instead
+    if (mCommands.availableToWrite() >= sizeof(Command)) {
+        Command command;
+        command.position = mRing.totalWritten();
+        command.type = CMD_CLOSE;
+        command.path[0] = '\0';
+        mCommands.write(&command, sizeof(command));
+    }
+    mOpen = false;
+    mFrameSize = 0;
+}
+
+void AudioDumpWriter::queueSync(nsecs_t now)
+{
+    // skipped while the thread is behind; the next write() tries again
+    if (mCommands.availableToWrite() < sizeof(Command)) return;
+    Command command;
+    command.position = mRing.totalWritten();
+    command.type = CMD_SYNC;
+    command.sync.position = mPosition;
+    command.sync.timeNs = now;
+    mCommands.write(&command, sizeof(command));
+    mLastSyncNs = now;
+    mNeedSync = false;
+}
+
+size_t AudioDumpWriter::write(const void *buffer, size_t bytes)
+{
+    if (mFrameSize != 0) {
+        nsecs_t now = systemTime();
+        if (mNeedSync || now - mLastSyncNs >= kSyncIntervalNs) {
+            queueSync(now);
+        }
+        mPosition += bytes / mFrameSize;
+    }
+    // never split a buffer, so a drop loses whole frames
+    if (mRing.availableToWrite() < bytes) {
+        mDroppedBytes.fetch_add(bytes, std::memory_order_relaxed);
+        mDrops.fetch_add(1, std::memory_order_relaxed);
+        // so the file shows where the gap is
+        mNeedSync = true;
+        return 0;
+    }
+    return mRing.write(buffer, bytes);
+}
+
+bool AudioDumpWriter::IoThread::threadLoop()
+{
+    if (!mWriter->drain()) {
+        usleep(kPollNs / 1000);
+    }
+    return true;
+}
+
+// Moves data from the ring into the block buffer up to the next command,
+// writing each block as it fills, and carries out the command once reached.
+// Returns false when there was nothing to do.
+bool AudioDumpWriter::drain()
+{
+    if (!mHaveCommand && mCommands.availableToRead() >= sizeof(Command)) {
+        mCommands.read(&mCommand, sizeof(mCommand));
+        mHaveCommand = true;
+    }
+
+    size_t avail = mRing.availableToRead();
+    bool toCommand = false;
+    if (mHaveCommand) {
+        uint64_t left = mCommand.position - mRing.totalRead();
+        if (left <= avail) {
+            avail = (size_t)left;
+            toCommand = true;
+        }
+    }
+    bool busy = avail != 0;
+    if (mContainer) {
+        busy = drainRecords(avail, toCommand);
+        avail = 0;
+    }
+    while (avail) {
+        size_t n = kBlockSize - mFill < avail ? kBlockSize - mFill : avail;
+        if (mFd >= 0) {
+            mRing.read(mBlock + mFill, n);
+            mFill += n;
+        } else {
+            // data queued while no file was open goes nowhere
+            mRing.skip(n);
+        }
+        avail -= n;
+        if (mFill == kBlockSize) {
+            writeBlock(mFill);
+            mFill = 0;
+        }
+    }
+
+    if (mHaveCommand && mRing.totalRead() == mCommand.position) {
+        if (mCommand.type == CMD_SYNC) {
+            if (mContainer) {
+                emitRecord(AUDIO_DUMP_RECORD_SYNC, &mCommand.sync, sizeof(mCommand.sync));
+            }
+        } else {
+            closeFile();
+            if (mCommand.type == CMD_OPEN) {
+                openFile(mCommand);
+            }
+        }
+        mHaveCommand = false;
+        busy = true;
+    }
+    return busy;
+}
+
+// Packs avail bytes from the ring into audio records of at most
+// kAudioDumpMaxRecordFrames. A partial frame, which only a caller writing
+// odd sizes can leave, is dropped once nothing else comes before the next
+// command. Returns false if there was not a whole frame to pack.
+bool AudioDumpWriter::drainRecords(size_t avail, bool toCommand)
+{
+    bool busy = false;
+    size_t frameSize = mHeader.frameSize;
+    size_t maxBytes = kAudioDumpMaxRecordFrames * frameSize;
+    while (avail >= frameSize) {
+        size_t n = avail < maxBytes ? avail : maxBytes;
+        n -= n % frameSize;
+        mRing.read(mRecord, n);
+        emitAudio(n);
+        avail -= n;
+        busy = true;
+    }
+    if (avail && toCommand) {
+        mRing.skip(avail);
+        busy = true;
+    }
+    return busy;
+}
+
+void AudioDumpWriter::emitAudio(size_t bytes)
+{
+    mRecordedBytes.fetch_add(bytes, std::memory_order_relaxed);
+    if (mCompressed) {
+        size_t size = audioDumpEncodeRice(mEncoded, bytes, (const int16_t *)mRecord,
+                bytes / mHeader.frameSize, mHeader.channelCount);
+        if (size != 0) {
+            emitRecord(AUDIO_DUMP_RECORD_RICE, mEncoded, size);
+            return;
+        }
+    }
+    emitRecord(AUDIO_DUMP_RECORD_PCM, mRecord, bytes);
+}
+
+void AudioDumpWriter::emitRecord(uint32_t type, const void *payload, size_t bytes)
+{
+    AudioDumpRecord record;
+    record.type = type;
+    record.size = bytes;
+    emit(&record, sizeof(record));
+    emit(payload, bytes);
+}
+
+// Appends to the block buffer, writing each block as it fills.
+void AudioDumpWriter::emit(const void *data, size_t bytes)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    while (bytes && mFd >= 0) {
+        size_t n = kBlockSize - mFill < bytes ? kBlockSize - mFill : bytes;
+        memcpy(mBlock + mFill, p, n);
+        mFill += n;
+        p += n;
+        bytes -= n;
+        if (mFill == kBlockSize) {
+            writeBlock(mFill);
+            mFill = 0;
+        }
+    }
+}
+
+void AudioDumpWriter::writeBlock(size_t bytes)
+{
+    if (mFd < 0) return;
+    // a short tail can't go through O_DIRECT
+    if (mFdDirect && bytes % kBlockAlign) {
+        fcntl(mFd, F_SETFL, fcntl(mFd, F_GETFL) & ~O_DIRECT);
+        mFdDirect = false;
+    }
+    const uint8_t *p = mBlock;
+    while (bytes) {
+        ssize_t ret = ::write(mFd, p, bytes);
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            ALOGE("dump write failed: %s, closing the file", strerror(errno));
+            ::close(mFd);
+            mFd = -1;
+            return;
+        }
+        p += ret;
+        bytes -= ret;
+        mWrittenBytes.fetch_add(ret, std::memory_order_relaxed);
+    }
+}
+
+void AudioDumpWriter::openFile(const Command &command)
+{
+    const char *path = command.path;
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+    mFdDirect = false;
+    if (mDirect) {
+        mFd = ::open(path, flags | O_DIRECT, 0644);
+        // e.g. tmpfs does not support it
+        if (mFd >= 0) {
+            mFdDirect = true;
+        } else if (errno == EINVAL) {
+            ALOGW("no O_DIRECT for %s, using the page cache", path);
+        }
+    }
+    if (mFd < 0) {
+        mFd = ::open(path, flags, 0644);
+    }
+    if (mFd < 0) {
+        ALOGE("cannot open dump file %s: %s", path, strerror(errno));
+        return;
+    }
+    mFiles.fetch_add(1, std::memory_order_relaxed);
+    ALOGV("opened dump file %s%s", path, mFdDirect ? " with O_DIRECT" : "");
+
+    if (!command.container || command.header.frameSize == 0) return;
+    size_t capacity = kAudioDumpMaxRecordFrames * command.header.frameSize;
+    if (capacity > mRecordCapacity) {
+        free(mRecord);
+        free(mEncoded);
+        mRecord = (uint8_t *)malloc(capacity);
+        mEncoded = (uint8_t *)malloc(capacity);
+        mRecordCapacity = mRecord != 0 && mEncoded != 0 ? capacity : 0;
+    }
+    if (mRecordCapacity == 0) {
+        ALOGE("no memory for dump records, closing %s", path);
+        ::close(mFd);
+        mFd = -1;
+        return;
+    }
+    mHeader = command.header;
+    mContainer = true;
+    mCompressed = (mHeader.flags & AUDIO_DUMP_FLAG_COMPRESSED) &&
+            mHeader.format == AudioSystem::PCM_16_BIT &&
+            mHeader.frameSize == mHeader.channelCount * sizeof(int16_t);
+    emit(&mHeader, sizeof(mHeader));
+}
+
+void AudioDumpWriter::closeFile()
+{
+    mContainer = false;
+    if (mFd < 0) return;
+    if (mFill) {
+        writeBlock(mFill);
+        mFill = 0;
+    }
+    if (mFd >= 0) {
+        ::close(mFd);
+        mFd = -1;
+    }
+}
+
+status_t AudioDumpWriter::dump(int fd)
+{
+    const size_t SIZE = 256;
+    char buffer[SIZE];
+    String8 result;
+    snprintf(buffer, SIZE, "\tdump writer: %s, ring %zu bytes%s, %u files\n",
+            mOpen ? "open" : "closed", mRing.capacity(), mDirect ? ", O_DIRECT" : "",
+            mFiles.load(std::memory_order_relaxed));
+    result.append(buffer);
+    snprintf(buffer, SIZE, "\t\t%llu bytes written, %u drops (%llu bytes)\n",
+            (unsigned long long)writtenBytes(), drops(), (unsigned long long)droppedBytes());
+    result.append(buffer);
+    if (recordedBytes() != 0) {
+        snprintf(buffer, SIZE, "\t\t%llu bytes of audio recorded in containers\n",
+                (unsigned long long)recordedBytes());
+        result.append(buffer);
+    }
+    ::write(fd, result.string(), result.size());
+    return NO_ERROR;
+}
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
@@ -0,0 +1,168 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef ANDROID_AUDIO_DUMP_WRITER_H
+#define ANDROID_AUDIO_DUMP_WRITER_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <atomic>
+
+#include <utils/threads.h>
+
+#include <hardware_legacy/AudioSystemLegacy.h>
+
+#include "AudioDumpFormat.h"
+#include "AudioRingBuffer.h"
+
+namespace android_audio_legacy {
+
+// ----------------------------------------------------------------------------
+
+/**
+ * Writes PCM dumps without blocking the audio thread.
+ *
+ * write() only copies into a lock-free ring; a background thread drains it
+ * to disk in kBlockSize writes from an aligned buffer, optionally with
+ * O_DIRECT so dumps don't churn the page cache. A buffer that does not fit
+ * in the ring is dropped whole and counted, never waited for.
+ *
+ * open() and close() are just as cheap: they queue a marker at the current
+ * ring position and the thread opens or closes the file when it gets there,
+ * so a file holds exactly the writes made between the two calls.
+ *
+ * Given an AudioDumpHeader, open() makes the file an AudioDumpFormat
+ * container: the thread packs the audio into records, Rice coded if the
+ * header asks for it, and write() adds a sync record every kSyncIntervalNs
+ * and after every drop.
+ *
+ * All calls except the destructor and dump() come from the one audio thread.
+ */
+class AudioDumpWriter {
+public:
+    // file write unit, a multiple of any O_DIRECT alignment
+    static const size_t kBlockSize = 64 * 1024;
+    static const size_t kMaxPath = 256;
+
+                        AudioDumpWriter(size_t ringBytes, bool direct);
+                        ~AudioDumpWriter();
+
+            /** start the I/O thread */
+            status_t    init();
+
+            /** send what write() queues from now on to a new file at path */
+            status_t    open(const char *path, const AudioDumpHeader *header = 0);
+            /** end the current file after what was queued so far */
+            void        close();
+            bool        isOpen() const { return mOpen; }
+
+            /** queue a buffer; returns bytes, or 0 if it was dropped */
+            size_t      write(const void *buffer, size_t bytes);
+
+            uint64_t    droppedBytes() const { return mDroppedBytes.load(std::memory_order_relaxed); }
+            uint32_t    drops() const { return mDrops.load(std::memory_order_relaxed); }
+            uint64_t    writtenBytes() const { return mWrittenBytes.load(std::memory_order_relaxed); }
+            // audio put in container records, before any compression
+            uint64_t    recordedBytes() const { return mRecordedBytes.load(std::memory_order_relaxed); }
+
+            status_t    dump(int fd);
+
+private:
+    // poll interval of the I/O thread, which the audio thread never wakes
+    static const nsecs_t kPollNs = 10000000;
+    static const size_t kMaxCommands = 8;
+    static const nsecs_t kSyncIntervalNs = 1000000000;
+
+    enum {
+        CMD_OPEN,
+        CMD_CLOSE,
+        CMD_SYNC,
+    };
+    struct Command {
+        uint64_t        position;       // ring position it applies at
+        uint32_t        type;
+        bool            container;      // CMD_OPEN: header is valid
+        AudioDumpHeader header;
+        AudioDumpSync   sync;           // CMD_SYNC
+        char            path[kMaxPath];
+    };
+
+    class IoThread : public android::Thread {
+    public:
+                        IoThread(AudioDumpWriter *writer)
+                            : Thread(false), mWriter(writer) {}
+    private:
+        virtual bool    threadLoop();
+
+        AudioDumpWriter *mWriter;
+    };
+
+                        AudioDumpWriter(const AudioDumpWriter &);
+            AudioDumpWriter& operator=(const AudioDumpWriter &);
+
+            // I/O thread, or the destructor once it has stopped
+            bool        drain();
+            bool        drainRecords(size_t avail, bool toCommand);
+            void        emit(const void *data, size_t bytes);
+            void        emitRecord(uint32_t type, const void *payload, size_t bytes);
+            void        emitAudio(size_t bytes);
+            void        writeBlock(size_t bytes);
+            void        openFile(const Command &command);
+            void        closeFile();
+
+            // audio thread
+            void        queueSync(nsecs_t now);
+
+    const bool                  mDirect;
+    AudioRingBuffer             mRing;
+    AudioRingBuffer             mCommands;      // of Command
+    android::sp<IoThread>       mThread;
+
+    // audio thread only
+    bool                        mOpen;
+    uint32_t                    mFrameSize;     // of the open container, else 0
+    uint64_t                    mPosition;      // frames written since open()
+    nsecs_t                     mLastSyncNs;
+    bool                        mNeedSync;
+
+    // I/O thread only
+    Command                     mCommand;
+    bool                        mHaveCommand;
+    uint8_t                     *mBlock;        // kBlockSize, page aligned
+    size_t                      mFill;
+    int                         mFd;
+    bool                        mFdDirect;
+    bool                        mContainer;
+    bool                        mCompressed;
+    AudioDumpHeader             mHeader;        // of the open container
+    uint8_t                     *mRecord;       // one record of audio
+    uint8_t                     *mEncoded;      // and the same compressed
+    size_t                      mRecordCapacity;
+
+    std::atomic<uint64_t>       mDroppedBytes;
+    std::atomic<uint32_t>       mDrops;
+    std::atomic<uint64_t>       mWrittenBytes;
+    std::atomic<uint64_t>       mRecordedBytes;
+    std::atomic<uint32_t>       mFiles;
+};
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
+
+#endif // ANDROID_AUDIO_DUMP_WRITER_H
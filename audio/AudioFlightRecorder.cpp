@@ -0,0 +1,282 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LOG_TAG "AudioFlightRecorder"
+#include <utils/Log.h>
+#include <utils/String8.h>
+
+#include "AudioFlightRecorder.h"
+
+namespace android_audio_legacy {
+    using android::AutoMutex;
+    using android::String8;
+
+// ----------------------------------------------------------------------------
+
+const size_t AudioFlightRecorder::kMaxPath;
+
+AudioFlightRecorder::AudioFlightRecorder(size_t bytes, size_t frameSize)
+    : mCapacity(frameSize ? bytes / frameSize * frameSize : bytes),
+      mFrameSize(frameSize ? frameSize : 1), mData(0), mChunk(0), mContainer(false),
+      mTotal(0), mWriteEnd(0), mTriggered(false), mReason(0), mTriggers(0), mFiles(0),
+      mLostBytes(0)
+{
+    mPrefix[0] = '\0';
+    mPath[0] = '\0';
+    memset(&mHeader, 0, sizeof(mHeader));
+}
+
+AudioFlightRecorder::~AudioFlightRecorder()
+{
+    if (mThread != 0) {
+        mThread->requestExitAndWait();
+        mThread.clear();
+    }
+    free(mData);
+    free(mChunk);
+}
+
+// Writes all of size bytes, or returns the error.
+static status_t writeAll(int fd, const void *data, size_t size)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    while (size) {
+        ssize_t ret = ::write(fd, p, size);
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            ALOGE("flight recording write failed: %s", strerror(errno));
+            return -errno;
+        }
+        p += ret;
+        size -= ret;
+    }
+    return NO_ERROR;
+}
+
+static int64_t monotonicNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+status_t AudioFlightRecorder::init(const char *pathPrefix, const AudioDumpHeader *header)
+{
+    // leave room for the longest "_<n>.adump" persist() appends
+    if (mCapacity == 0 || strlen(pathPrefix) + strlen("_4294967295.adump") >= kMaxPath) {
+        return BAD_VALUE;
+    }
+    if (header != 0) {
+        if (header->frameSize != mFrameSize) return BAD_VALUE;
+        mHeader = *header;
+        // history is saved as it was written
+        mHeader.flags &= ~AUDIO_DUMP_FLAG_COMPRESSED;
+        mContainer = true;
+    }
+    mData = (uint8_t *)malloc(mCapacity);
+    mChunk = (uint8_t *)malloc(kChunkSize);
+    if (mData == 0 || mChunk == 0) return NO_MEMORY;
+    // fault the pages in now rather than on the audio thread
+    memset(mData, 0, mCapacity);
+    strcpy(mPrefix, pathPrefix);
+
+    mThread = new SaveThread(this);
+    status_t status = mThread->run("AudioFlightRecorder", ANDROID_PRIORITY_BACKGROUND);
+    if (status != NO_ERROR) {
+        ALOGE("cannot start flight recorder thread: %d", status);
+        mThread.clear();
+    }
+    return status;
+}
+
+void AudioFlightRecorder::write(const void *buffer, size_t bytes)
+{
+    if (mData == 0 || bytes == 0) return;
+    uint64_t total = mTotal.load(std::memory_order_relaxed);
+    // tell persist() what is about to be overwritten before touching it
+    mWriteEnd.store(total + bytes, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const uint8_t *p = (const uint8_t *)buffer;
+    // only the newest mCapacity bytes of a huge write can survive
+    if (bytes > mCapacity) {
+        total += bytes - mCapacity;
+        p += bytes - mCapacity;
+        bytes = mCapacity;
+    }
+    size_t pos = (size_t)(total % mCapacity);
+    size_t first = bytes < mCapacity - pos ? bytes : mCapacity - pos;
+    memcpy(mData + pos, p, first);
+    memcpy(mData, p + first, bytes - first);
+    mTotal.store(total + bytes, std::memory_order_release);
+}
+
+void AudioFlightRecorder::trigger(const char *reason)
+{
+    mReason.store(reason, std::memory_order_relaxed);
+    if (!mTriggered.exchange(true)) {
+        mTriggers.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool AudioFlightRecorder::SaveThread::threadLoop()
+{
+    if (mRecorder->mTriggered.load()) {
+        mRecorder->persist();
+    } else {
+        usleep(kPollNs / 1000);
+    }
+    return true;
+}
+
+status_t AudioFlightRecorder::persist()
+{
+    AutoMutex lock(mPersistLock);
+    mTriggered.store(false);
+    if (mData == 0) return NO_INIT;
+
+    int len = snprintf(mPath, kMaxPath, "%s_%u.%s", mPrefix,
+            mFiles.load(std::memory_order_relaxed) + 1, mContainer ? "adump" : "pcm");
+    if (len < 0 || (size_t)len >= kMaxPath) {
+        // init() leaves room, so this is never a truncated name
+        ALOGE("flight recording path too long");
+        mPath[0] = '\0';
+        return BAD_VALUE;
+    }
+    int fd = ::open(mPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        ALOGE("cannot open flight recording %s: %s", mPath, strerror(errno));
+        return -errno;
+    }
+    const char *reason = mReason.load(std::memory_order_relaxed);
+    ALOGI("saving flight recording to %s (%s)", mPath, reason ? reason : "?");
+
+    // the history as of now, oldest first
+    uint64_t end = mTotal.load(std::memory_order_acquire);
+    int64_t endNs = monotonicNs();
+    uint64_t pos = end > mCapacity ? end - mCapacity : 0;
+    status_t status = NO_ERROR;
+    if (mContainer) {
+        // the stream as set up by init(), opened now
+        AudioDumpHeader header;
+        audioDumpInitHeader(&header);
+        mHeader.startRealtimeNs = header.startRealtimeNs;
+        mHeader.startMonotonicNs = header.startMonotonicNs;
+        status = writeAll(fd, &mHeader, sizeof(mHeader));
+    }
+    // where the file resumes after a gap: the start, or history lost to the
+    // audio thread while it was copied
+    bool gap = true;
+    // whole frames, so every record is
+    size_t chunkSize = kChunkSize / mFrameSize * mFrameSize;
+    while (status == NO_ERROR && pos < end) {
+        size_t n = end - pos < chunkSize ? (size_t)(end - pos) : chunkSize;
+        size_t at = (size_t)(pos % mCapacity);
+        size_t first = n < mCapacity - at ? n : mCapacity - at;
+        memcpy(mChunk, mData + at, first);
+        memcpy(mChunk + first, mData, n - first);
+
+        // Anything below this may have been overwritten while it was copied,
+        // including by a write() still in progress.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t valid = mWriteEnd.load(std::memory_order_relaxed);
+        valid = valid > mCapacity ? valid - mCapacity : 0;
+        size_t skip = 0;
+        if (valid > pos) {
+            skip = valid - pos < n ? (size_t)(valid - pos) : n;
+            // keep frames whole
+            skip = (skip + mFrameSize - 1) / mFrameSize * mFrameSize;
+            if (skip > n) skip = n;
+            mLostBytes.fetch_add(skip, std::memory_order_relaxed);
+            gap = true;
+        }
+        if (!mContainer) {
+            status = writeAll(fd, mChunk + skip, n - skip);
+        } else if (skip < n) {
+            if (gap) {
+                // timed back from the end at the nominal rate
+                uint64_t frames = (end - pos - skip) / mFrameSize;
+                int64_t timeNs = mHeader.sampleRate ?
+                        endNs - (int64_t)(frames * 1000000000 / mHeader.sampleRate) : endNs;
+                status = writeSync(fd, (pos + skip) / mFrameSize, timeNs);
+                gap = false;
+            }
+            size_t maxRecord = kAudioDumpMaxRecordFrames * mFrameSize;
+            for (size_t i = skip; status == NO_ERROR && i < n; i += maxRecord) {
+                size_t size = n - i < maxRecord ? n - i : maxRecord;
+                status = writeRecord(fd, AUDIO_DUMP_RECORD_PCM, mChunk + i, size);
+            }
+        }
+        pos += n;
+    }
+    // where the history ends
+    if (mContainer && status == NO_ERROR) {
+        status = writeSync(fd, end / mFrameSize, endNs);
+    }
+    ::close(fd);
+    mFiles.fetch_add(1, std::memory_order_release);
+    return status;
+}
+
+status_t AudioFlightRecorder::writeRecord(int fd, uint32_t type, const void *data, size_t size)
+{
+    AudioDumpRecord record;
+    record.type = type;
+    record.size = size;
+    status_t status = writeAll(fd, &record, sizeof(record));
+    return status == NO_ERROR ? writeAll(fd, data, size) : status;
+}
+
+status_t AudioFlightRecorder::writeSync(int fd, uint64_t position, int64_t timeNs)
+{
+    AudioDumpSync sync;
+    sync.position = position;
+    sync.timeNs = timeNs;
+    return writeRecord(fd, AUDIO_DUMP_RECORD_SYNC, &sync, sizeof(sync));
+}
+
+status_t AudioFlightRecorder::dump(int fd)
+{
+    const size_t SIZE = 256;
+    char buffer[SIZE];
+    String8 result;
+    snprintf(buffer, SIZE, "\tflight recorder: %zu bytes of history, %u triggers, %u files\n",
+            mCapacity, triggers(), files());
+    result.append(buffer);
+    if (files()) {
+        // the path may be longer than buffer
+        result.append("\t\tlast saved to ");
+        result.append(mPath);
+        snprintf(buffer, SIZE, ", %llu bytes lost while saving\n",
+                (unsigned long long)lostBytes());
+        result.append(buffer);
+    }
+    ::write(fd, result.string(), result.size());
+    return NO_ERROR;
+}
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
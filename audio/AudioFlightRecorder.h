@@ -0,0 +1,131 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef ANDROID_AUDIO_FLIGHT_RECORDER_H
+#define ANDROID_AUDIO_FLIGHT_RECORDER_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <atomic>
+
+#include <utils/threads.h>
+
+#include <hardware_legacy/AudioSystemLegacy.h>
+
+#include "AudioDumpFormat.h"
+
+namespace android_audio_legacy {
+
+// ----------------------------------------------------------------------------
+
+/**
+ * Keeps the last few seconds of a stream in memory and saves them only when
+ * something interesting happens.
+ *
+ * write() copies into a preallocated history that is overwritten in a
+ * circle; it never blocks and never does I/O. trigger() only sets a flag,
+ * so it is safe from the audio thread too, e.g. on an underrun. A low
+ * priority thread notices the flag and writes the history, oldest first,
+ * to <prefix>_<n>.adump, an AudioDumpFormat container the audio_dump tool
+ * replays, or to <prefix>_<n>.pcm without a header.
+ *
+ * The history keeps being written while it is saved. Each chunk is checked
+ * after it is copied out, and anything the audio thread may have overwritten
+ * meanwhile is left out rather than saved torn.
+ */
+class AudioFlightRecorder {
+public:
+    static const size_t kMaxPath = 256;
+
+            /** history of bytes, rounded down to whole frames of frameSize */
+                        AudioFlightRecorder(size_t bytes, size_t frameSize);
+                        ~AudioFlightRecorder();
+
+            /**
+             * allocate and start the saving thread; BAD_VALUE if pathPrefix
+             * leaves no room in kMaxPath for the file number. Recordings are
+             * containers with header, whose frameSize must match, or raw PCM
+             * if it is 0.
+             */
+            status_t    init(const char *pathPrefix, const AudioDumpHeader *header = 0);
+
+            /** audio thread only */
+            void        write(const void *buffer, size_t bytes);
+
+            /** ask for the history to be saved; reason must be a string literal */
+            void        trigger(const char *reason);
+
+            /** save the history now, from any thread but the audio thread */
+            status_t    persist();
+
+            size_t      capacity() const { return mCapacity; }
+            uint32_t    triggers() const { return mTriggers.load(std::memory_order_relaxed); }
+            // acquire, so lastPath() is that of the files()th recording
+            uint32_t    files() const { return mFiles.load(std::memory_order_acquire); }
+            // history lost to the audio thread while it was saved
+            uint64_t    lostBytes() const { return mLostBytes.load(std::memory_order_relaxed); }
+            const char* lastPath() const { return mPath; }
+
+            status_t    dump(int fd);
+
+private:
+    static const size_t kChunkSize = 64 * 1024;
+    // how quickly a trigger from the audio thread is acted on
+    static const nsecs_t kPollNs = 50000000;
+
+    class SaveThread : public android::Thread {
+    public:
+                        SaveThread(AudioFlightRecorder *recorder)
+                            : Thread(false), mRecorder(recorder) {}
+    private:
+        virtual bool    threadLoop();
+
+        AudioFlightRecorder *mRecorder;
+    };
+
+                        AudioFlightRecorder(const AudioFlightRecorder &);
+            AudioFlightRecorder& operator=(const AudioFlightRecorder &);
+
+            status_t    writeRecord(int fd, uint32_t type, const void *data, size_t size);
+            status_t    writeSync(int fd, uint64_t position, int64_t timeNs);
+
+    const size_t                mCapacity;
+    const size_t                mFrameSize;
+    uint8_t                     *mData;
+    uint8_t                     *mChunk;        // kChunkSize, for persist()
+    char                        mPrefix[kMaxPath];
+    char                        mPath[kMaxPath];
+    bool                        mContainer;
+    AudioDumpHeader             mHeader;
+    android::sp<SaveThread>     mThread;
+    android::Mutex              mPersistLock;   // one persist() at a time
+
+    std::atomic<uint64_t>       mTotal;         // bytes ever written
+    std::atomic<uint64_t>       mWriteEnd;      // mTotal once the current write() is done
+    std::atomic<bool>           mTriggered;
+    std::atomic<const char *>   mReason;
+    std::atomic<uint32_t>       mTriggers;
+    std::atomic<uint32_t>       mFiles;
+    std::atomic<uint64_t>       mLostBytes;
+};
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
+
+#endif // ANDROID_AUDIO_FLIGHT_RECORDER_H
@@ -0,0 +1,167 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#include <string.h>
+
+#define LOG_TAG "AudioFormatConverter"
+#include <utils/Log.h>
+
+#include "AudioFormatConverter.h"
+
+namespace android_audio_legacy {
+
+// ----------------------------------------------------------------------------
+
+// Positional channels folded into the left or right device channel; the
+// ones in neither (centres, LFE) go to both.
+static const uint32_t kLeftChannels = AudioSystem::CHANNEL_OUT_FRONT_LEFT |
+        AudioSystem::CHANNEL_OUT_BACK_LEFT | AudioSystem::CHANNEL_OUT_FRONT_LEFT_OF_CENTER |
+        AudioSystem::CHANNEL_OUT_SIDE_LEFT | AudioSystem::CHANNEL_OUT_TOP_FRONT_LEFT |
+        AudioSystem::CHANNEL_OUT_TOP_BACK_LEFT;
+static const uint32_t kRightChannels = AudioSystem::CHANNEL_OUT_FRONT_RIGHT |
+        AudioSystem::CHANNEL_OUT_BACK_RIGHT | AudioSystem::CHANNEL_OUT_FRONT_RIGHT_OF_CENTER |
+        AudioSystem::CHANNEL_OUT_SIDE_RIGHT | AudioSystem::CHANNEL_OUT_TOP_FRONT_RIGHT |
+        AudioSystem::CHANNEL_OUT_TOP_BACK_RIGHT;
+
+// Downmix weights in Q13, see remix16().
+static const int16_t kUnityQ13 = 8192;
+static const int16_t kMinus3dBQ13 = 5793;
+
+AudioFormatConverter::AudioFormatConverter(int format, uint32_t channelMask,
+        uint32_t deviceChannels, bool dither)
+    : mFormat(format), mChannelMask(channelMask),
+      mChannels(__builtin_popcount(channelMask)), mDeviceChannels(deviceChannels),
+      mFrameSize(mChannels * audio_bytes_per_sample((audio_format_t)format)),
+      mDither(dither), mWide(new int32_t[kChunkSamples]), mNarrow(new int16_t[kChunkSamples])
+{
+    memset(mMatrix, 0, sizeof(mMatrix));
+    uint32_t c = 0;
+    for (uint32_t bit = 1; bit != 0 && c < kMaxChannels; bit <<= 1) {
+        if (!(channelMask & bit)) continue;
+        int16_t left = 0, right = 0;
+        if (bit == AudioSystem::CHANNEL_OUT_FRONT_LEFT) {
+            left = kUnityQ13;
+        } else if (bit == AudioSystem::CHANNEL_OUT_FRONT_RIGHT) {
+            right = kUnityQ13;
+        } else if (bit & kLeftChannels) {
+            left = kMinus3dBQ13;
+        } else if (bit & kRightChannels) {
+            right = kMinus3dBQ13;
+        } else {
+            left = right = kMinus3dBQ13;
+        }
+        if (deviceChannels == 1) {
+            mMatrix[0][c] = (int16_t)((left + right) / 2);
+        } else {
+            mMatrix[0][c] = left;
+            mMatrix[1][c] = right;
+        }
+        c++;
+    }
+}
+
+AudioFormatConverter::~AudioFormatConverter()
+{
+    delete[] mWide;
+    delete[] mNarrow;
+}
+
+bool AudioFormatConverter::isSupported(int format, uint32_t channelMask)
+{
+    switch (format) {
+    case AUDIO_FORMAT_PCM_16_BIT:
+    case AUDIO_FORMAT_PCM_8_24_BIT:
+    case AUDIO_FORMAT_PCM_32_BIT:
+    case AUDIO_FORMAT_PCM_FLOAT:
+    case AUDIO_FORMAT_PCM_24_BIT_PACKED:
+        break;
+    default:
+        return false;
+    }
+    uint32_t channels = __builtin_popcount(channelMask);
+    return channels >= 1 && channels <= kMaxChannels &&
+            (channelMask & ~(uint32_t)AudioSystem::CHANNEL_OUT_ALL) == 0;
+}
+
+void AudioFormatConverter::convert(int16_t *dst, const void *src, size_t frames)
+{
+    const uint8_t *in = (const uint8_t *)src;
+    const size_t chunkFrames = kChunkSamples / mChannels;
+    while (frames) {
+        size_t n = frames < chunkFrames ? frames : chunkFrames;
+        convertChunk(dst, in, n);
+        dst += n * mDeviceChannels;
+        in += n * mFrameSize;
+        frames -= n;
+    }
+}
+
+void AudioFormatConverter::convertChunk(int16_t *dst, const uint8_t *src, size_t frames)
+{
+    const size_t samples = frames * mChannels;
+    // the channel layout already matches the device, so narrow straight into dst
+    const bool direct = mChannels == mDeviceChannels &&
+            (mChannels == 1 || mChannelMask == AudioSystem::CHANNEL_OUT_STEREO);
+
+    const int32_t *wide = mWide;
+    switch (mFormat) {
+    case AUDIO_FORMAT_PCM_16_BIT:
+        if (direct) {
+            memcpy(dst, src, samples * sizeof(int16_t));
+        } else {
+            remix(dst, (const int16_t *)src, frames);
+        }
+        return;
+    case AUDIO_FORMAT_PCM_8_24_BIT:
+        wide = (const int32_t *)src;
+        break;
+    case AUDIO_FORMAT_PCM_32_BIT:
+        convert32To8_24(mWide, (const int32_t *)src, samples);
+        break;
+    case AUDIO_FORMAT_PCM_FLOAT:
+        convertFloatTo8_24(mWide, (const float *)src, samples);
+        break;
+    case AUDIO_FORMAT_PCM_24_BIT_PACKED:
+        convertPacked24To8_24(mWide, src, samples);
+        break;
+    }
+
+    AudioDither *dither = mDither ? &mDitherState : 0;
+    if (direct) {
+        convert8_24To16(dst, wide, samples, dither);
+    } else {
+        convert8_24To16(mNarrow, wide, samples, dither);
+        remix(dst, mNarrow, frames);
+    }
+}
+
+void AudioFormatConverter::remix(int16_t *dst, const int16_t *src, size_t frames)
+{
+    if (mChannels == 1 && mDeviceChannels == 2) {
+        upmixMonoToStereo16(dst, src, frames);
+        return;
+    }
+    if (mChannelMask == AudioSystem::CHANNEL_OUT_STEREO && mDeviceChannels == 1) {
+        downmixStereoToMono16(dst, src, frames);
+        return;
+    }
+    remix16(dst, mDeviceChannels, src, mChannels, mMatrix, frames);
+}
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
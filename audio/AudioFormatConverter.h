@@ -0,0 +1,88 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef ANDROID_AUDIO_FORMAT_CONVERTER_H
+#define ANDROID_AUDIO_FORMAT_CONVERTER_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <hardware_legacy/AudioSystemLegacy.h>
+
+#include "AudioMixOps.h"
+
+namespace android_audio_legacy {
+
+// ----------------------------------------------------------------------------
+
+/**
+ * Converts what a client writes to the 16-bit mono or stereo a device takes.
+ *
+ * Accepted sample formats are 16-bit, 8.24, 32-bit, float and 24-bit packed
+ * PCM; wide formats go through Q8.23 and are rounded to 16 bits once,
+ * optionally with TPDF dither. Accepted channel masks are any positional
+ * output mask of up to kMaxChannels channels: mono is copied to both device
+ * channels and stereo is averaged for a mono device, both with SIMD kernels
+ * from AudioMixOps.h; anything else is folded down with a fixed matrix
+ * (left and right side channels to their side, centre and LFE to both,
+ * everything but the front pair at -3dB) and saturated.
+ */
+class AudioFormatConverter {
+public:
+    static const uint32_t kMaxChannels = 8;
+
+                        AudioFormatConverter(int format, uint32_t channelMask,
+                                             uint32_t deviceChannels, bool dither);
+                        ~AudioFormatConverter();
+
+    static  bool        isSupported(int format, uint32_t channelMask);
+
+            int         format() const { return mFormat; }
+            uint32_t    channelMask() const { return mChannelMask; }
+            size_t      frameSize() const { return mFrameSize; }
+            bool        dither() const { return mDither; }
+
+            /** frames of the client format from src to 16-bit device frames in dst */
+            void        convert(int16_t *dst, const void *src, size_t frames);
+
+private:
+    // client samples converted per pass, so the scratch buffers stay small
+    static const size_t kChunkSamples = 1024;
+
+                        AudioFormatConverter(const AudioFormatConverter &);
+            AudioFormatConverter& operator=(const AudioFormatConverter &);
+
+            void        convertChunk(int16_t *dst, const uint8_t *src, size_t frames);
+            void        remix(int16_t *dst, const int16_t *src, size_t frames);
+
+    const int           mFormat;
+    const uint32_t      mChannelMask;
+    const uint32_t      mChannels;
+    const uint32_t      mDeviceChannels;
+    const size_t        mFrameSize;
+    const bool          mDither;
+    AudioDither         mDitherState;
+    int32_t             *mWide;         // kChunkSamples of Q8.23
+    int16_t             *mNarrow;       // kChunkSamples at the client channel count
+    int16_t             mMatrix[2][kMaxChannels];  // Q13, device channel by client channel
+};
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
+
+#endif // ANDROID_AUDIO_FORMAT_CONVERTER_H
@@ -0,0 +1,103 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef ANDROID_AUDIO_GAIN_RAMP_H
+#define ANDROID_AUDIO_GAIN_RAMP_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "AudioMixOps.h"
+
+namespace android_audio_legacy {
+
+// ----------------------------------------------------------------------------
+
+/**
+ * Stereo gain that moves to a new target along a linear ramp instead of
+ * jumping, which would click. A target set while a ramp is under way starts
+ * a new ramp from wherever the gain got to.
+ *
+ * Not thread safe: it belongs to whoever processes the audio, which picks up
+ * new targets between buffers.
+ */
+class AudioGainRamp {
+public:
+                        AudioGainRamp() : mRemaining(0) {
+                            mGain[0] = mGain[1] = (int32_t)kUnityGainQ15 << 16;
+                            mTarget[0] = mTarget[1] = kUnityGainQ15;
+                            mStep[0] = mStep[1] = 0;
+                        }
+
+            /** ramp to the Q15 gains over rampFrames, or jump there if 0 */
+            void        setTarget(int16_t left, int16_t right, size_t rampFrames) {
+                            if (left == mTarget[0] && right == mTarget[1]) return;
+                            mTarget[0] = left;
+                            mTarget[1] = right;
+                            // the kernel steps 4 frames at a time and must not overflow
+                            if (rampFrames < 4) rampFrames = 0;
+                            mRemaining = rampFrames;
+                            for (int c = 0; c < 2; c++) {
+                                int32_t to = (int32_t)mTarget[c] << 16;
+                                if (rampFrames == 0) {
+                                    mGain[c] = to;
+                                    mStep[c] = 0;
+                                } else {
+                                    mStep[c] = (int32_t)(((int64_t)to - mGain[c]) / (int64_t)rampFrames);
+                                }
+                            }
+                        }
+
+            /** nothing to do: no ramp under way and both targets at unity */
+            bool        isUnity() const {
+                            return mRemaining == 0 && mTarget[0] == kUnityGainQ15 &&
+                                    mTarget[1] == kUnityGainQ15;
+                        }
+            bool        isRamping() const { return mRemaining != 0; }
+            int16_t     left() const { return (int16_t)(mGain[0] >> 16); }
+            int16_t     right() const { return (int16_t)(mGain[1] >> 16); }
+
+            /** scale frames of interleaved stereo in place */
+            void        apply(int16_t *buf, size_t frames) {
+                            if (mRemaining) {
+                                size_t n = frames < mRemaining ? frames : mRemaining;
+                                applyGainStereo16(buf, n, mGain[0], mGain[1], mStep[0], mStep[1]);
+                                mRemaining -= n;
+                                for (int c = 0; c < 2; c++) {
+                                    mGain[c] = mRemaining ? mGain[c] + (int32_t)n * mStep[c] :
+                                            (int32_t)mTarget[c] << 16;
+                                }
+                                buf += 2 * n;
+                                frames -= n;
+                            }
+                            if (frames && !isUnity()) {
+                                applyGainStereo16(buf, frames, mGain[0], mGain[1], 0, 0);
+                            }
+                        }
+
+private:
+    int32_t             mGain[2];       // Q15 << 16, where the ramp has got to
+    int32_t             mStep[2];       // per frame, same units
+    int16_t             mTarget[2];     // Q15
+    size_t              mRemaining;     // frames left in the ramp
+};
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
+
+#endif // ANDROID_AUDIO_GAIN_RAMP_H
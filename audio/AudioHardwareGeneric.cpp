@@ -20,16 +20,22 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <errno.h>
 #include <unistd.h>
 #include <sched.h>
 #include <fcntl.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 
 #define LOG_TAG "AudioHardware"
 #include <utils/Log.h>
 #include <utils/String8.h>
+#include <cutils/ashmem.h>
+#include <cutils/properties.h>
 
 #include "AudioHardwareGeneric.h"
+#include "AudioParameterScanner.h"
 #include <media/AudioRecord.h>
 
 #include <hardware_legacy/AudioSystemLegacy.h>
@@ -40,19 +46,72 @@ namespace android_audio_legacy {
 
 static char const * const kAudioDeviceName = "/dev/eac";
 
+// Size of the async write ring in ms of output; 0 keeps the blocking write path.
+static char const * const kAsyncWriteProperty = "audio.generic.async_write_ms";
+
+// Number of outputs that may be open at once; above 1 they are mixed in
+// software by AudioMixerGeneric.
+static char const * const kMixerOutputsProperty = "audio.generic.mixer_outputs";
+
+// Size of the capture ring in ms of input; 0 keeps the blocking read path.
+static char const * const kCaptureProperty = "audio.generic.capture_ms";
+
+// SCHED_FIFO priority of the async writer, mixer and capture threads.
+static const int kWriterThreadPriority = 2;
+
+// Longest standby() waits for the capture thread to finish its period.
+static const nsecs_t kCaptureStopWaitNs = 100000000;
+
+// How long read() waits on the capture ring before checking for a device
+// error again: two capture periods.
+static const nsecs_t kCaptureWaitNs = 2 * (nsecs_t)AudioStreamInGeneric::kDeviceBufferSize /
+        sizeof(int16_t) * 1000000000 / AudioStreamInGeneric::kDeviceRate;
+
+// The normal output profile writes a whole device buffer at a time.
+static const uint32_t kOutputPeriodUs = (uint32_t)((uint64_t)AudioStreamOutGeneric::kDeviceBufferSize /
+        AudioStreamOutGeneric::kDeviceFrameSize * 1000000 / AudioStreamOutGeneric::kDeviceRate);
+
+// Audio the driver holds once a write() returns; it sets how far the
+// presentation position lags what was written.
+static const uint32_t kDeviceLatencyMs = 20;
+
+// Whether wide client formats get TPDF dither when they are rounded to 16 bits.
+static char const * const kDitherProperty = "audio.generic.dither";
+
+// Length of the ramp to a new stream or master volume.
+static const uint32_t kVolumeRampMs = 10;
+
+// Burst the mmap "DMA" consumes at a time: 128 frames is ~3ms at 44.1kHz.
+static const size_t kMmapBurstFrames = 128;
+
+const uint32_t AudioStreamOutGeneric::kDeviceRate;
+const size_t AudioStreamOutGeneric::kDeviceBufferSize;
+const size_t AudioStreamOutGeneric::kDeviceFrameSize;
+// 64 frames is as short as a blocking write to /dev/eac keeps up with
+const AudioPeriodConstraints AudioStreamOutGeneric::kPeriodConstraints = {
+    kDeviceRate, 64, kDeviceBufferSize / kDeviceFrameSize, 16 };
+const uint32_t AudioStreamInGeneric::kDeviceRate;
+const size_t AudioStreamInGeneric::kDeviceBufferSize;
+
 // ----------------------------------------------------------------------------
 
 AudioHardwareGeneric::AudioHardwareGeneric()
-    : mOutput(0), mInput(0),  mFd(-1), mMicMute(false)
+    : mInput(0),  mFd(-1), mMicMute(false), mMaxOutputs(1), mMixer(0), mMasterVolume(1.0f)
 {
     mFd = ::open(kAudioDeviceName, O_RDWR);
+    int maxOutputs = property_get_int32(kMixerOutputsProperty, 1);
+    if (maxOutputs > 1) mMaxOutputs = maxOutputs;
 }
 
 AudioHardwareGeneric::~AudioHardwareGeneric()
 {
-    if (mFd >= 0) ::close(mFd);
-    closeOutputStream((AudioStreamOut *)mOutput);
+    while (mOutputs.size()) {
+        closeOutputStream((AudioStreamOut *)mOutputs[0]);
+    }
     closeInputStream((AudioStreamIn *)mInput);
+    // the mixer thread writes to mFd
+    delete mMixer;
+    if (mFd >= 0) ::close(mFd);
 }
 
 status_t AudioHardwareGeneric::initCheck()
@@ -66,11 +125,19 @@ status_t AudioHardwareGeneric::initCheck()
 
 AudioStreamOut* AudioHardwareGeneric::openOutputStream(
         uint32_t devices, int *format, uint32_t *channels, uint32_t *sampleRate, status_t *status)
+{
+    return openOutputStreamWithFlags(devices, AUDIO_OUTPUT_FLAG_NONE, format, channels,
+            sampleRate, status);
+}
+
+AudioStreamOut* AudioHardwareGeneric::openOutputStreamWithFlags(
+        uint32_t devices, audio_output_flags_t flags, int *format, uint32_t *channels,
+        uint32_t *sampleRate, status_t *status)
 {
     AutoMutex lock(mLock);
 
-    // only one output stream allowed
-    if (mOutput) {
+    // only one output stream allowed unless they are mixed here
+    if (mOutputs.size() >= mMaxOutputs) {
         if (status) {
             *status = INVALID_OPERATION;
         }
@@ -79,22 +146,43 @@ AudioStreamOut* AudioHardwareGeneric::openOutputStream(
 
     // create new output stream
     AudioStreamOutGeneric* out = new AudioStreamOutGeneric();
-    status_t lStatus = out->set(this, mFd, devices, format, channels, sampleRate);
+    status_t lStatus = out->set(this, mFd, devices, format, channels, sampleRate, flags);
+    out->setMasterVolume(mMasterVolume);
+    int asyncMs = property_get_int32(kAsyncWriteProperty, 0);
+    size_t ringBytes = asyncMs > 0 ? (size_t)asyncMs * AudioStreamOutGeneric::kDeviceRate / 1000 *
+            AudioStreamOutGeneric::kDeviceFrameSize : 0;
+    if (lStatus == NO_ERROR && mMaxOutputs > 1) {
+        if (mMixer == 0) {
+            mMixer = new AudioMixerGeneric(mFd,
+                    AudioStreamOutGeneric::kDeviceBufferSize / AudioStreamOutGeneric::kDeviceFrameSize);
+            lStatus = mMixer->start();
+            if (lStatus != NO_ERROR) {
+                delete mMixer;
+                mMixer = 0;
+            }
+        }
+        if (lStatus == NO_ERROR) {
+            lStatus = out->attachMixer(mMixer, ringBytes);
+        }
+    } else if (lStatus == NO_ERROR && ringBytes) {
+        lStatus = out->enableAsyncWrite(ringBytes);
+    }
     if (status) {
         *status = lStatus;
     }
     if (lStatus == NO_ERROR) {
-        mOutput = out;
+        mOutputs.add(out);
     } else {
         delete out;
+        out = 0;
     }
-    return mOutput;
+    return out;
 }
 
 void AudioHardwareGeneric::closeOutputStream(AudioStreamOut* out) {
-    if (mOutput && out == mOutput) {
-        delete mOutput;
-        mOutput = 0;
+    AutoMutex lock(mLock);
+    if (mOutputs.remove((AudioStreamOutGeneric *)out) >= 0) {
+        delete out;
     }
 }
 
@@ -120,6 +208,11 @@ AudioStreamIn* AudioHardwareGeneric::openInputStream(
     // create new output stream
     AudioStreamInGeneric* in = new AudioStreamInGeneric();
     status_t lStatus = in->set(this, mFd, devices, format, channels, sampleRate, acoustics);
+    int captureMs = property_get_int32(kCaptureProperty, 0);
+    if (lStatus == NO_ERROR && captureMs > 0) {
+        lStatus = in->enableCaptureThread((size_t)captureMs * AudioStreamInGeneric::kDeviceRate /
+                1000 * sizeof(int16_t));
+    }
     if (status) {
         *status = lStatus;
     }
@@ -146,9 +239,38 @@ status_t AudioHardwareGeneric::setVoiceVolume(float v)
 
 status_t AudioHardwareGeneric::setMasterVolume(float v)
 {
-    // Implement: set master volume
-    // return error - software mixer will handle it
-    return INVALID_OPERATION;
+    if (v < 0.0f) v = 0.0f;
+    if (v > 1.0f) v = 1.0f;
+    AutoMutex lock(mLock);
+    mMasterVolume = v;
+    for (size_t i = 0; i < mOutputs.size(); i++) {
+        mOutputs[i]->setMasterVolume(v);
+    }
+    return NO_ERROR;
+}
+
+status_t AudioHardwareGeneric::getMasterVolume(float *volume)
+{
+    AutoMutex lock(mLock);
+    *volume = mMasterVolume;
+    return NO_ERROR;
+}
+
+size_t AudioHardwareGeneric::getInputBufferSize(uint32_t sampleRate, int format, int channelCount)
+{
+    if (!AudioResampler::isSupported(AudioStreamInGeneric::kDeviceRate, sampleRate, 1)) {
+        ALOGW("getInputBufferSize bad sampling rate: %d", sampleRate);
+        return 0;
+    }
+    if (format != AudioSystem::PCM_16_BIT) {
+        ALOGW("getInputBufferSize bad format: %d", format);
+        return 0;
+    }
+    if (channelCount != 1) {
+        ALOGW("getInputBufferSize bad channel count: %d", channelCount);
+        return 0;
+    }
+    return AudioStreamInGeneric::bufferSizeFor(sampleRate);
 }
 
 status_t AudioHardwareGeneric::setMicMute(bool state)
@@ -171,6 +293,8 @@ status_t AudioHardwareGeneric::dumpInternals(int fd, const Vector<String16>& arg
     result.append("AudioHardwareGeneric::dumpInternals\n");
     snprintf(buffer, SIZE, "\tmFd: %d mMicMute: %s\n",  mFd, mMicMute? "true": "false");
     result.append(buffer);
+    snprintf(buffer, SIZE, "\tmMasterVolume: %.4f\n", mMasterVolume);
+    result.append(buffer);
     ::write(fd, result.string(), result.size());
     return NO_ERROR;
 }
@@ -181,8 +305,11 @@ status_t AudioHardwareGeneric::dump(int fd, const Vector<String16>& args)
     if (mInput) {
         mInput->dump(fd, args);
     }
-    if (mOutput) {
-        mOutput->dump(fd, args);
+    for (size_t i = 0; i < mOutputs.size(); i++) {
+        mOutputs[i]->dump(fd, args);
+    }
+    if (mMixer) {
+        mMixer->dump(fd, args);
     }
     return NO_ERROR;
 }
@@ -195,7 +322,8 @@ status_t AudioStreamOutGeneric::set(
         uint32_t devices,
         int *pFormat,
         uint32_t *pChannels,
-        uint32_t *pRate)
+        uint32_t *pRate,
+        audio_output_flags_t flags)
 {
     int lFormat = pFormat ? *pFormat : 0;
     uint32_t lChannels = pChannels ? *pChannels : 0;
@@ -204,15 +332,15 @@ status_t AudioStreamOutGeneric::set(
     // fix up defaults
     if (lFormat == 0) lFormat = format();
     if (lChannels == 0) lChannels = channels();
-    if (lRate == 0) lRate = sampleRate();
+    if (lRate == 0) lRate = kDeviceRate;
 
-    // check values
-    if ((lFormat != format()) ||
-            (lChannels != channels()) ||
-            (lRate != sampleRate())) {
+    // check values; any format, channel mask and rate that can be converted
+    // to what the device plays is accepted
+    if (!AudioFormatConverter::isSupported(lFormat, lChannels) ||
+            !AudioResampler::isSupported(lRate, kDeviceRate, 2)) {
         if (pFormat) *pFormat = format();
         if (pChannels) *pChannels = channels();
-        if (pRate) *pRate = sampleRate();
+        if (pRate) *pRate = kDeviceRate;
         return BAD_VALUE;
     }
 
@@ -223,25 +351,626 @@ status_t AudioStreamOutGeneric::set(
     mAudioHardware = hw;
     mFd = fd;
     mDevice = devices;
+    mSampleRate = lRate;
+    mFormat = lFormat;
+    mChannels = lChannels;
+    mPeriodUs = AudioHardwareBase::periodUsFor(flags, kOutputPeriodUs);
+    mPeriodFrames = AudioHardwareBase::bufferFrames(kDeviceRate, mPeriodUs, kPeriodConstraints);
+    if (lFormat != AudioSystem::PCM_16_BIT || lChannels != AudioSystem::CHANNEL_OUT_STEREO) {
+        mConverter = new AudioFormatConverter(lFormat, lChannels, 2,
+                property_get_bool(kDitherProperty, false));
+    }
+    // also where volume is applied
+    mConvertBuffer = new int16_t[kDeviceBufferSize / sizeof(int16_t)];
+    if (lRate != kDeviceRate) {
+        mResampler = new AudioResampler(lRate, kDeviceRate, 2);
+        mSrcBuffer = new int16_t[kDeviceBufferSize / sizeof(int16_t)];
+    }
+    mPosition.setup(kDeviceRate, kDeviceLatencyMs * kDeviceRate / 1000);
     return NO_ERROR;
 }
 
 AudioStreamOutGeneric::~AudioStreamOutGeneric()
 {
+    if (mMixer != 0) {
+        mMixer->removeStream(this);
+    }
+    if (mWriterThread != 0) {
+        mWriterThread->requestExit();
+        {
+            AutoMutex lock(mWaitLock);
+            mWriterExiting = true;
+            mDataReady.signal();
+        }
+        mWriterThread->requestExitAndWait();
+        mWriterThread.clear();
+    }
+    delete mRing;
+    delete[] mWriteBuffer;
+    delete mConverter;
+    delete[] mConvertBuffer;
+    delete mResampler;
+    delete[] mSrcBuffer;
+    if (mMmapBuffer != 0) {
+        munmap(mMmapBuffer, mMmapFrames * kDeviceFrameSize);
+        close(mMmapFd);
+    }
+}
+
+status_t AudioStreamOutGeneric::startWriterThread()
+{
+    mWriterThread = new WriterThread(this);
+    status_t status = mWriterThread->run("AudioOutWriter", ANDROID_PRIORITY_URGENT_AUDIO);
+    if (status != NO_ERROR) {
+        ALOGE("cannot start writer thread: %d", status);
+        mWriterThread.clear();
+    }
+    return status;
+}
+
+status_t AudioStreamOutGeneric::enableAsyncWrite(size_t ringBytes)
+{
+    if (mRing != 0 || mMmapBuffer != 0) return INVALID_OPERATION;
+    if (ringBytes < mPeriodFrames * kDeviceFrameSize) ringBytes = mPeriodFrames * kDeviceFrameSize;
+
+    mRing = new AudioRingBuffer(ringBytes);
+    mWriteBuffer = new uint8_t[kDeviceBufferSize];
+    status_t status = startWriterThread();
+    if (status != NO_ERROR) {
+        delete mRing;
+        mRing = 0;
+        return status;
+    }
+    ALOGV("async write enabled, ring %zu bytes", mRing->capacity());
+    return NO_ERROR;
+}
+
+status_t AudioStreamOutGeneric::attachMixer(AudioMixerGeneric *mixer, size_t ringBytes)
+{
+    if (mRing != 0 || mMmapBuffer != 0) return INVALID_OPERATION;
+    // two periods, so the client can queue the next one while the mixer
+    // writes the current one
+    if (ringBytes < 2 * kDeviceBufferSize) ringBytes = 2 * kDeviceBufferSize;
+
+    mRing = new AudioRingBuffer(ringBytes);
+    mWriteBuffer = new uint8_t[kDeviceBufferSize];
+    status_t status = mixer->addStream(this);
+    if (status != NO_ERROR) {
+        delete mRing;
+        mRing = 0;
+        return status;
+    }
+    mMixer = mixer;
+    ALOGV("attached to mixer, ring %zu bytes", mRing->capacity());
+    return NO_ERROR;
+}
+
+status_t AudioStreamOutGeneric::setVolume(float left, float right)
+{
+    // mmap clients write device frames directly, there is no write() to scale them in
+    if (mMmapBuffer != 0) return INVALID_OPERATION;
+    mGain.store(((uint32_t)(uint16_t)gainToQ15(right) << 16) | (uint16_t)gainToQ15(left));
+    return NO_ERROR;
+}
+
+void AudioStreamOutGeneric::setMasterVolume(float volume)
+{
+    mMasterGain.store(gainToQ15(volume));
+}
+
+size_t AudioStreamOutGeneric::bufferSize() const
+{
+    // a period at the client rate
+    return AudioHardwareBase::bufferFrames(mSampleRate, mPeriodUs, kPeriodConstraints) * frameSize();
+}
+
+uint32_t AudioStreamOutGeneric::latency() const
+{
+    uint32_t ringMs = 0;
+    if (mRing != 0) {
+        ringMs = (uint32_t)(mRing->capacity() / kDeviceFrameSize * 1000 / kDeviceRate);
+    }
+    return kDeviceLatencyMs + ringMs;
 }
 
 ssize_t AudioStreamOutGeneric::write(const void* buffer, size_t bytes)
 {
-    Mutex::Autolock _l(mLock);
-    return ssize_t(::write(mFd, buffer, bytes));
+    if (mMmapBuffer != 0) {
+        return INVALID_OPERATION;
+    }
+    // keeps reconfigure() and standby() from changing the conversion under us
+    AutoMutex lock(mLock);
+    if (mTailFrames) {
+        ssize_t ret = writeTail();
+        if (ret <= 0) return ret;
+    }
+    // Pick up volume changes once per write(). The first write() starts at
+    // the volume set before it rather than ramping from unity.
+    uint32_t gain = mGain.load(std::memory_order_relaxed);
+    int16_t master = mMasterGain.load(std::memory_order_relaxed);
+    mRamp.setTarget(mulGainQ15((int16_t)(gain & 0xffff), master),
+            mulGainQ15((int16_t)(gain >> 16), master),
+            mFirstWrite ? 0 : mSampleRate * kVolumeRampMs / 1000);
+    mFirstWrite = false;
+
+    if (mConverter == 0 && mResampler == 0 && mRamp.isUnity()) {
+        return writeDevice(buffer, bytes);
+    }
+
+    // Convert in device-buffer sized pieces: first to 16-bit stereo, scaled
+    // by the volume, then to kDeviceRate.
+    const uint8_t *in = (const uint8_t *)buffer;
+    const size_t clientFrameSize = frameSize();
+    size_t frames = bytes / clientFrameSize;
+    while (frames) {
+        size_t n = kDeviceBufferSize / kDeviceFrameSize;
+        if (n > frames) n = frames;
+        const int16_t *pcm = (const int16_t *)in;
+        if (mConverter != 0 || !mRamp.isUnity()) {
+            if (mConverter != 0) {
+                mConverter->convert(mConvertBuffer, in, n);
+            } else {
+                memcpy(mConvertBuffer, in, n * kDeviceFrameSize);
+            }
+            mRamp.apply(mConvertBuffer, n);
+            pcm = mConvertBuffer;
+        }
+        in += n * clientFrameSize;
+        frames -= n;
+
+        if (mResampler == 0) {
+            ssize_t ret = writeDeviceFully(pcm, n);
+            if (ret <= 0) return ret;
+            continue;
+        }
+        while (n) {
+            size_t consumed = n;
+            size_t produced = mResampler->resample(mSrcBuffer,
+                    kDeviceBufferSize / kDeviceFrameSize, pcm, &consumed);
+            pcm += consumed * 2;
+            n -= consumed;
+            ssize_t ret = writeDeviceFully(mSrcBuffer, produced);
+            if (ret <= 0) return ret;
+        }
+    }
+    return bytes;
+}
+
+ssize_t AudioStreamOutGeneric::writeDeviceFully(const int16_t *frames, size_t count)
+{
+    const uint8_t *p = (const uint8_t *)frames;
+    size_t left = count * kDeviceFrameSize;
+    while (left) {
+        ssize_t ret = writeDevice(p, left);
+        if (ret <= 0) return ret;
+        p += ret;
+        left -= ret;
+    }
+    return count * kDeviceFrameSize;
+}
+
+ssize_t AudioStreamOutGeneric::writeDevice(const void* buffer, size_t bytes)
+{
+    if (mRing != 0) {
+        return writeAsync(buffer, bytes);
+    }
+    ssize_t ret = ::write(mFd, buffer, bytes);
+    if (ret > 0) {
+        mPosition.advance(ret / kDeviceFrameSize, systemTime());
+    }
+    return ret;
+}
+
+ssize_t AudioStreamOutGeneric::writeAsync(const void* buffer, size_t bytes)
+{
+    const uint8_t *p = (const uint8_t *)buffer;
+    size_t remaining = bytes;
+    bool overrun = false;
+
+    // a device write the writer thread could not make since the last call
+    status_t error = mWriteError.exchange(NO_ERROR);
+    if (error != NO_ERROR) return error;
+
+    mStarted.store(true, std::memory_order_relaxed);
+    while (remaining) {
+        size_t written = mRing->write(p, remaining);
+        p += written;
+        remaining -= written;
+        if (written) {
+            // Either the writer sees the flag it set before checking the
+            // ring, or its check sees what was just written.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (mMixer != 0) {
+                mMixer->wake();
+            } else if (mWriterWaiting.load()) {
+                AutoMutex lock(mWaitLock);
+                mDataReady.signal();
+            }
+        }
+        if (remaining == 0) break;
+
+        // Ring full: the device is behind, wait for the writer to make room.
+        overrun = true;
+        AutoMutex lock(mWaitLock);
+        mSpaceWaiters.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (mRing->availableToWrite() == 0) {
+            mSpaceReady.wait(mWaitLock);
+        }
+        mSpaceWaiters.fetch_sub(1);
+    }
+    if (overrun) {
+        mOverruns.fetch_add(1, std::memory_order_relaxed);
+    }
+    mQueuedFrames += bytes / kDeviceFrameSize;
+    return ssize_t(bytes);
+}
+
+status_t AudioStreamOutGeneric::WriterThread::readyToRun()
+{
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = kWriterThreadPriority;
+    if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
+        ALOGW("cannot set SCHED_FIFO for writer thread: %s", strerror(errno));
+    }
+    return NO_ERROR;
+}
+
+bool AudioStreamOutGeneric::WriterThread::threadLoop()
+{
+    return mStream->mMmapBuffer != 0 ? mStream->pumpMmapBuffer() : mStream->drainRing();
+}
+
+void AudioStreamOutGeneric::checkUnderrun(size_t bytes)
+{
+    if (bytes == 0) {
+        if (mDryStartNs == 0) mDryStartNs = systemTime();
+        return;
+    }
+
+    // The ring running dry is normal when the device keeps up; it is only an
+    // underrun if the device went a whole period without new data while the
+    // client was still active.
+    if (mDryStartNs != 0) {
+        nsecs_t bufferNs = (nsecs_t)mPeriodFrames * 1000000000 / kDeviceRate;
+        if (mStarted.load(std::memory_order_relaxed) &&
+                systemTime() - mDryStartNs > bufferNs) {
+            mUnderruns.fetch_add(1, std::memory_order_relaxed);
+        }
+        mDryStartNs = 0;
+    }
+}
+
+// After taking from the ring: wakes write() if it is waiting for room, and
+// standby() if it is waiting for the ring to play out.
+void AudioStreamOutGeneric::signalSpace()
+{
+    // pairs with the fences in writeAsync() and waitForDrain(), as for
+    // mWriterWaiting
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (mSpaceWaiters.load()) {
+        AutoMutex lock(mWaitLock);
+        mSpaceReady.broadcast();
+    }
+}
+
+bool AudioStreamOutGeneric::drainRing()
+{
+    size_t bytes = mRing->read(mWriteBuffer, mPeriodFrames * kDeviceFrameSize);
+    checkUnderrun(bytes);
+    if (bytes == 0) {
+        // nothing to do until write() or the destructor signals
+        AutoMutex lock(mWaitLock);
+        mWriterWaiting.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (mRing->availableToRead() == 0 && !mWriterExiting) {
+            mDataReady.wait(mWaitLock);
+        }
+        mWriterWaiting.store(false);
+        return true;
+    }
+
+    signalSpace();
+
+    const uint8_t *p = mWriteBuffer;
+    status_t error = NO_ERROR;
+    while (bytes) {
+        ssize_t ret = ::write(mFd, p, bytes);
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            error = -errno;
+            ALOGE("async write to device failed: %s", strerror(errno));
+            break;
+        }
+        p += ret;
+        bytes -= ret;
+    }
+    mPosition.advance((p - mWriteBuffer) / kDeviceFrameSize, systemTime());
+
+    if (error != NO_ERROR) {
+        // The rest of the period is dropped, and write() returns the error.
+        // A failed write does not block, so this thread, being SCHED_FIFO,
+        // takes from the ring no faster than the device would have.
+        mWriteError.store(error);
+        mErrorPacing.pace(bytes / kDeviceFrameSize, kDeviceRate);
+    } else {
+        mErrorPacing.reset();
+    }
+    return true;
+}
+
+size_t AudioStreamOutGeneric::mixInto(int16_t *mix, size_t frames)
+{
+    size_t bytes = mRing->read(mWriteBuffer, frames * kDeviceFrameSize);
+    checkUnderrun(bytes);
+    mMixedFrames = bytes / kDeviceFrameSize;
+    if (bytes == 0) return 0;
+
+    signalSpace();
+    mixStereo16(mix, (const int16_t *)mWriteBuffer, mMixedFrames, kUnityGainQ15, kUnityGainQ15);
+    return mMixedFrames;
+}
+
+void AudioStreamOutGeneric::mixed(nsecs_t nowNs)
+{
+    if (mMixedFrames) {
+        mPosition.advance(mMixedFrames, nowNs);
+        mMixedFrames = 0;
+    }
+}
+
+status_t AudioStreamOutGeneric::createMmapBuffer(int32_t minSizeFrames, void **buffer, int *fd,
+        int32_t *bufferSizeFrames, int32_t *burstSizeFrames)
+{
+    // the client writes device frames directly, so there is nowhere to convert
+    if (mRing != 0 || mMmapBuffer != 0 || mConverter != 0 || mResampler != 0) {
+        return INVALID_OPERATION;
+    }
+
+    // Whole bursts only, so a burst never wraps and goes out in one write().
+    size_t frames = minSizeFrames > 0 ? (size_t)minSizeFrames : 0;
+    if (frames < 2 * kMmapBurstFrames) frames = 2 * kMmapBurstFrames;
+    frames = (frames + kMmapBurstFrames - 1) / kMmapBurstFrames * kMmapBurstFrames;
+    size_t bytes = frames * kDeviceFrameSize;
+
+    int shmFd = ashmem_create_region("AudioStreamOutGeneric", bytes);
+    if (shmFd < 0) {
+        ALOGE("cannot create mmap buffer: %s", strerror(errno));
+        return NO_INIT;
+    }
+    void *addr = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+    if (addr == MAP_FAILED) {
+        ALOGE("cannot map mmap buffer: %s", strerror(errno));
+        close(shmFd);
+        return NO_INIT;
+    }
+    memset(addr, 0, bytes);
+
+    mMmapBuffer = (uint8_t *)addr;
+    mMmapFd = shmFd;
+    mMmapFrames = frames;
+    mBurstFrames = kMmapBurstFrames;
+    status_t status = startWriterThread();
+    if (status != NO_ERROR) {
+        munmap(mMmapBuffer, bytes);
+        close(mMmapFd);
+        mMmapBuffer = 0;
+        mMmapFd = -1;
+        return status;
+    }
+
+    *buffer = mMmapBuffer;
+    *fd = mMmapFd;
+    *bufferSizeFrames = (int32_t)mMmapFrames;
+    *burstSizeFrames = (int32_t)mBurstFrames;
+    ALOGV("mmap buffer %zu frames, burst %zu", mMmapFrames, mBurstFrames);
+    return NO_ERROR;
+}
+
+status_t AudioStreamOutGeneric::getMmapPosition(int64_t *timeNs, int32_t *positionFrames)
+{
+    if (mMmapBuffer == 0) return INVALID_OPERATION;
+    AutoMutex lock(mLock);
+    *timeNs = mMmapTimeNs;
+    *positionFrames = (int32_t)mMmapPosition;
+    // the position keeps going at real time while the device fails
+    return mMmapError.load();
+}
+
+status_t AudioStreamOutGeneric::start()
+{
+    if (mMmapBuffer == 0) return INVALID_OPERATION;
+    {
+        AutoMutex lock(mLock);
+        mMmapTimeNs = systemTime();
+    }
+    mMmapActive.store(true);
+    AutoMutex lock(mWaitLock);
+    mDataReady.signal();
+    return NO_ERROR;
+}
+
+status_t AudioStreamOutGeneric::stop()
+{
+    if (mMmapBuffer == 0) return INVALID_OPERATION;
+    mMmapActive.store(false);
+    return NO_ERROR;
+}
+
+bool AudioStreamOutGeneric::pumpMmapBuffer()
+{
+    if (!mMmapActive.load()) {
+        // start() and the destructor signal under mWaitLock
+        AutoMutex lock(mWaitLock);
+        if (!mMmapActive.load() && !mWriterExiting) {
+            mDataReady.wait(mWaitLock);
+        }
+        return true;
+    }
+
+    // The client owns the buffer contents; whatever is there at the read
+    // position goes out, as a DMA engine would do.
+    const size_t burstBytes = mBurstFrames * kDeviceFrameSize;
+    const uint8_t *p = mMmapBuffer + (size_t)(mMmapPosition % mMmapFrames) * kDeviceFrameSize;
+    size_t bytes = burstBytes;
+    status_t error = NO_ERROR;
+    while (bytes) {
+        ssize_t ret = ::write(mFd, p, bytes);
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            error = -errno;
+            break;
+        }
+        p += ret;
+        bytes -= ret;
+    }
+
+    if (error != NO_ERROR) {
+        if (mMmapError.exchange(error) != error) {
+            ALOGE("mmap burst write to device failed: %s", strerror(-error));
+        }
+        // Keep the position advancing so the client does not stall, but at
+        // the rate the device would have taken the burst: a failed write
+        // does not block, and this thread is SCHED_FIFO.
+        mErrorPacing.pace(mBurstFrames, kDeviceRate);
+    } else if (mMmapError.load() != NO_ERROR) {
+        mMmapError.store(NO_ERROR);
+        mErrorPacing.reset();
+    }
+
+    nsecs_t now = systemTime();
+    mPosition.advance(mBurstFrames, now);
+    AutoMutex lock(mLock);
+    mMmapPosition += mBurstFrames;
+    mMmapTimeNs = now;
+    return true;
+}
+
+// Follow what the resampler holds for its lookahead with silence, so the
+// last frames written come out of it into mSrcBuffer, then start it afresh.
+// The lookahead is at most half the longest filter, so one pass takes it.
+void AudioStreamOutGeneric::flushResampler()
+{
+    memset(mConvertBuffer, 0, kDeviceBufferSize);
+    size_t consumed = mResampler->delayFrames();
+    mTailFrames = mResampler->resample(mSrcBuffer, kDeviceBufferSize / kDeviceFrameSize,
+            mConvertBuffer, &consumed);
+    mResampler->reset();
+}
+
+// What flushResampler() left goes to the device ahead of anything newer.
+ssize_t AudioStreamOutGeneric::writeTail()
+{
+    size_t frames = mTailFrames;
+    mTailFrames = 0;
+    return writeDeviceFully(mSrcBuffer, frames);
+}
+
+status_t AudioStreamOutGeneric::reconfigure(int format, uint32_t sampleRate)
+{
+    // mmap clients write device frames directly, there is nowhere to convert
+    if (mMmapBuffer != 0) return INVALID_OPERATION;
+    // waits for a write() in progress
+    AutoMutex lock(mLock);
+    if (format == 0) format = mFormat;
+    if (sampleRate == 0) sampleRate = mSampleRate;
+    if (!AudioFormatConverter::isSupported(format, mChannels) ||
+            !AudioResampler::isSupported(sampleRate, kDeviceRate, 2)) {
+        return BAD_VALUE;
+    }
+    if (format == mFormat && sampleRate == mSampleRate) return NO_ERROR;
+    ALOGV("reconfigure() format %#x -> %#x, %u -> %u Hz", mFormat, format, mSampleRate,
+            sampleRate);
+
+    // Only the conversion in front of the device is rebuilt. The ring and
+    // the device only ever see device frames, so they keep playing across
+    // the switch; the resampler tail goes out with the next write() rather
+    // than holding up the switch on the device.
+    if (mTailFrames) {
+        writeTail();
+    }
+    if (mResampler != 0) {
+        flushResampler();
+    }
+
+    AudioFormatConverter *converter = 0;
+    if (format != AudioSystem::PCM_16_BIT || mChannels != AudioSystem::CHANNEL_OUT_STEREO) {
+        converter = new AudioFormatConverter(format, mChannels, 2,
+                property_get_bool(kDitherProperty, false));
+    }
+    delete mConverter;
+    mConverter = converter;
+    if (sampleRate != mSampleRate) {
+        delete mResampler;
+        mResampler = 0;
+        if (sampleRate != kDeviceRate) {
+            mResampler = new AudioResampler(sampleRate, kDeviceRate, 2);
+            if (mSrcBuffer == 0) mSrcBuffer = new int16_t[kDeviceBufferSize / sizeof(int16_t)];
+        }
+    }
+
+    // the presentation position carries on from the tail at the new rate
+    uint64_t deviceFrames = (mRing != 0 ? mQueuedFrames : mPosition.framesWritten()) + mTailFrames;
+    uint64_t clientFrames = toClientFrames(deviceFrames);
+    AutoMutex rateLock(mRateLock);
+    mClientBase = clientFrames;
+    mDeviceBase = deviceFrames;
+    mSampleRate = sampleRate;
+    mFormat = format;
+    return NO_ERROR;
 }
 
 status_t AudioStreamOutGeneric::standby()
 {
+    if (mRing == 0) {
+        AutoMutex lock(mLock);
+        if (mTailFrames) {
+            writeTail();
+        }
+        if (mResampler != 0) {
+            mResampler->reset();
+        }
+    } else {
+        // Never wait on the device under mLock. A write() holding it is
+        // waiting for room in the ring and keeps its conversion state, since
+        // it is playing again anyway.
+        if (mLock.tryLock() == NO_ERROR) {
+            // the tail only goes out if it does not have to wait either
+            if (mTailFrames && mRing->availableToWrite() >= mTailFrames * kDeviceFrameSize) {
+                writeTail();
+            }
+            mTailFrames = 0;
+            if (mResampler != 0) {
+                mResampler->reset();
+            }
+            mLock.unlock();
+        }
+        // Let what was already queued play out before reporting standby.
+        waitForDrain((nsecs_t)latency() * 2000000);
+        mStarted.store(false, std::memory_order_relaxed);
+    }
+    mPosition.standby();
     // Implement: audio hardware to standby mode
     return NO_ERROR;
 }
 
+// Wait for the writer thread or mixer to empty the ring, for at most limitNs.
+void AudioStreamOutGeneric::waitForDrain(nsecs_t limitNs)
+{
+    nsecs_t deadline = systemTime() + limitNs;
+    AutoMutex lock(mWaitLock);
+    mSpaceWaiters.fetch_add(1);
+    // pairs with the fence in signalSpace()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (mRing->availableToRead()) {
+        nsecs_t left = deadline - systemTime();
+        if (left <= 0) break;
+        mSpaceReady.waitRelative(mWaitLock, left);
+    }
+    mSpaceWaiters.fetch_sub(1);
+}
+
 status_t AudioStreamOutGeneric::dump(int fd, const Vector<String16>& args)
 {
     const size_t SIZE = 256;
@@ -251,7 +980,9 @@ status_t AudioStreamOutGeneric::dump(int fd, const Vector<String16>& args)
     result.append(buffer);
     snprintf(buffer, SIZE, "\tsample rate: %d\n", sampleRate());
     result.append(buffer);
-    snprintf(buffer, SIZE, "\tbuffer size: %d\n", bufferSize());
+    snprintf(buffer, SIZE, "\tbuffer size: %zu\n", bufferSize());
+    result.append(buffer);
+    snprintf(buffer, SIZE, "\tperiod: %zu device frames, %u us target\n", mPeriodFrames, mPeriodUs);
     result.append(buffer);
     snprintf(buffer, SIZE, "\tchannels: %d\n", channels());
     result.append(buffer);
@@ -263,25 +994,59 @@ status_t AudioStreamOutGeneric::dump(int fd, const Vector<String16>& args)
     result.append(buffer);
     snprintf(buffer, SIZE, "\tmFd: %d\n", mFd);
     result.append(buffer);
+    snprintf(buffer, SIZE, "\tframes written: %llu\n",
+            (unsigned long long)mPosition.framesWritten());
+    result.append(buffer);
+    if (mConverter != 0) {
+        snprintf(buffer, SIZE, "\tconverting format %#x channels %#x to 16-bit stereo%s\n",
+                mConverter->format(), mConverter->channelMask(),
+                mConverter->dither() ? ", dithered" : "");
+        result.append(buffer);
+    }
+    if (mResampler != 0) {
+        snprintf(buffer, SIZE, "\tresampling %u -> %u Hz\n",
+                mResampler->inRate(), mResampler->outRate());
+        result.append(buffer);
+    }
+    if (mRing != 0) {
+        snprintf(buffer, SIZE, "\tasync ring: %zu/%zu bytes queued\n",
+                mRing->availableToRead(), mRing->capacity());
+        result.append(buffer);
+        snprintf(buffer, SIZE, "\tunderruns: %u overruns: %u\n", underruns(), overruns());
+        result.append(buffer);
+    }
+    uint32_t gain = mGain.load(std::memory_order_relaxed);
+    snprintf(buffer, SIZE, "\tvolume: left %.4f right %.4f master %.4f\n",
+            (int16_t)(gain & 0xffff) / 32768.0, (int16_t)(gain >> 16) / 32768.0,
+            mMasterGain.load(std::memory_order_relaxed) / 32768.0);
+    result.append(buffer);
+    if (mMmapBuffer != 0) {
+        int64_t timeNs;
+        int32_t position;
+        getMmapPosition(&timeNs, &position);
+        snprintf(buffer, SIZE, "\tmmap buffer: %zu frames, burst %zu, %s\n",
+                mMmapFrames, mBurstFrames, mMmapActive.load() ? "active" : "stopped");
+        result.append(buffer);
+        snprintf(buffer, SIZE, "\tmmap position: %d at %lld ns\n", position, (long long)timeNs);
+        result.append(buffer);
+    }
     ::write(fd, result.string(), result.size());
     return NO_ERROR;
 }
 
 status_t AudioStreamOutGeneric::setParameters(const String8& keyValuePairs)
 {
-    AudioParameter param = AudioParameter(keyValuePairs);
-    String8 key = String8(AudioParameter::keyRouting);
+    AudioParameterScanner param(keyValuePairs.string());
     status_t status = NO_ERROR;
     int device;
     ALOGV("setParameters() %s", keyValuePairs.string());
 
-    if (param.getInt(key, device) == NO_ERROR) {
-        mDevice = device;
-        param.remove(key);
-    }
-
-    if (param.size()) {
-        status = BAD_VALUE;
+    while (param.next()) {
+        if (param.keyIs(AudioParameter::keyRouting) && param.valueInt(&device) == NO_ERROR) {
+            mDevice = device;
+        } else {
+            status = BAD_VALUE;
+        }
     }
     return status;
 }
@@ -300,9 +1065,210 @@ String8 AudioStreamOutGeneric::getParameters(const String8& keys)
     return param.toString();
 }
 
+// Device frames since the stream was opened to client frames, each stretch
+// between reconfigure()s at the rate it was written at.
+uint64_t AudioStreamOutGeneric::toClientFrames(uint64_t deviceFrames) const
+{
+    AutoMutex lock(mRateLock);
+    int64_t since = (int64_t)(deviceFrames - mDeviceBase);
+    return mClientBase + since * (int64_t)mSampleRate / (int64_t)kDeviceRate;
+}
+
 status_t AudioStreamOutGeneric::getRenderPosition(uint32_t *dspFrames)
 {
-    return INVALID_OPERATION;
+    status_t status = mPosition.getRenderPosition(dspFrames, systemTime());
+    if (status == NO_ERROR) {
+        // counted from the last standby at the current rate, so only
+        // approximate across a reconfigure(); the presentation position is exact
+        AutoMutex lock(mRateLock);
+        *dspFrames = (uint32_t)((uint64_t)*dspFrames * mSampleRate / kDeviceRate);
+    }
+    return status;
+}
+
+status_t AudioStreamOutGeneric::getNextWriteTimestamp(int64_t *timestamp)
+{
+    status_t status = mPosition.getNextWriteTimestamp(timestamp);
+    if (status == NO_ERROR && mRing != 0) {
+        // a new write queues behind whatever the writer thread has not sent yet
+        *timestamp += (int64_t)(mRing->availableToRead() / kDeviceFrameSize) * 1000000 / kDeviceRate;
+    }
+    return status;
+}
+
+status_t AudioStreamOutGeneric::getPresentationPosition(uint64_t *frames,
+        struct timespec *timestamp)
+{
+    status_t status = mPosition.getPresentationPosition(frames, timestamp);
+    if (status == NO_ERROR) {
+        *frames = toClientFrames(*frames);
+    }
+    return status;
+}
+
+// ----------------------------------------------------------------------------
+
+AudioMixerGeneric::AudioMixerGeneric(int fd, size_t periodFrames)
+    : mFd(fd), mPeriodFrames(periodFrames), mMixBuffer(new int16_t[periodFrames * 2]),
+      mWaiting(false), mExiting(false), mCycles(0), mMixNs(0)
+{
+}
+
+AudioMixerGeneric::~AudioMixerGeneric()
+{
+    if (mThread != 0) {
+        mThread->requestExit();
+        {
+            AutoMutex lock(mWaitLock);
+            mExiting = true;
+            mDataReady.signal();
+        }
+        mThread->requestExitAndWait();
+        mThread.clear();
+    }
+    delete[] mMixBuffer;
+}
+
+status_t AudioMixerGeneric::start()
+{
+    mThread = new MixerThread(this);
+    status_t status = mThread->run("AudioOutMixer", ANDROID_PRIORITY_URGENT_AUDIO);
+    if (status != NO_ERROR) {
+        ALOGE("cannot start mixer thread: %d", status);
+        mThread.clear();
+    }
+    return status;
+}
+
+status_t AudioMixerGeneric::addStream(AudioStreamOutGeneric *out)
+{
+    // streams convert to 16-bit stereo before their ring, so any can be mixed
+    {
+        AutoMutex lock(mLock);
+        mStreams.add(out);
+    }
+    wake();
+    return NO_ERROR;
+}
+
+void AudioMixerGeneric::removeStream(AudioStreamOutGeneric *out)
+{
+    // waits for a mix in progress, which may still be using out
+    AutoMutex lock(mLock);
+    mStreams.remove(out);
+}
+
+size_t AudioMixerGeneric::streamCount()
+{
+    AutoMutex lock(mLock);
+    return mStreams.size();
+}
+
+void AudioMixerGeneric::wake()
+{
+    if (mWaiting.load()) {
+        AutoMutex lock(mWaitLock);
+        mDataReady.signal();
+    }
+}
+
+status_t AudioMixerGeneric::MixerThread::readyToRun()
+{
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = kWriterThreadPriority;
+    if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
+        ALOGW("cannot set SCHED_FIFO for mixer thread: %s", strerror(errno));
+    }
+    return NO_ERROR;
+}
+
+bool AudioMixerGeneric::MixerThread::threadLoop()
+{
+    if (!mMixer->mixOnce()) {
+        mMixer->waitForData();
+    }
+    return true;
+}
+
+// Mixer thread only: whether any stream has something queued.
+bool AudioMixerGeneric::hasData()
+{
+    AutoMutex lock(mLock);
+    for (size_t i = 0; i < mStreams.size(); i++) {
+        if (mStreams[i]->mRing->availableToRead() != 0) return true;
+    }
+    return false;
+}
+
+void AudioMixerGeneric::waitForData()
+{
+    AutoMutex lock(mWaitLock);
+    mWaiting.store(true);
+    // pairs with the fence in AudioStreamOutGeneric::writeAsync(): either
+    // wake() sees mWaiting or hasData() sees what was written
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!hasData() && !mExiting) {
+        mDataReady.wait(mWaitLock);
+    }
+    mWaiting.store(false);
+}
+
+bool AudioMixerGeneric::mixOnce()
+{
+    {
+        AutoMutex lock(mLock);
+        nsecs_t start = systemTime();
+        size_t frames = 0;
+        memset(mMixBuffer, 0, mPeriodFrames * 2 * sizeof(int16_t));
+        for (size_t i = 0; i < mStreams.size(); i++) {
+            size_t n = mStreams[i]->mixInto(mMixBuffer, mPeriodFrames);
+            if (n > frames) frames = n;
+        }
+        if (frames == 0) return false;
+        mMixNs += systemTime() - start;
+        mCycles++;
+    }
+
+    // Without mLock, so a stream being added or removed does not wait on
+    // the device. Always a whole period: streams that were short are padded
+    // with silence.
+    const uint8_t *p = (const uint8_t *)mMixBuffer;
+    size_t bytes = mPeriodFrames * 2 * sizeof(int16_t);
+    while (bytes) {
+        ssize_t ret = ::write(mFd, p, bytes);
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            ALOGE("mixer write to device failed: %s", strerror(errno));
+            break;
+        }
+        p += ret;
+        bytes -= ret;
+    }
+    // a stream removed since was mixed, but has no position left to update
+    nsecs_t now = systemTime();
+    AutoMutex lock(mLock);
+    for (size_t i = 0; i < mStreams.size(); i++) {
+        mStreams[i]->mixed(now);
+    }
+    return true;
+}
+
+status_t AudioMixerGeneric::dump(int fd, const Vector<String16>& args)
+{
+    const size_t SIZE = 256;
+    char buffer[SIZE];
+    String8 result;
+    AutoMutex lock(mLock);
+    snprintf(buffer, SIZE, "AudioMixerGeneric::dump\n");
+    result.append(buffer);
+    snprintf(buffer, SIZE, "\tstreams: %zu period: %zu frames\n", mStreams.size(), mPeriodFrames);
+    result.append(buffer);
+    snprintf(buffer, SIZE, "\tmix cycles: %llu average mix time: %lld ns\n",
+            (unsigned long long)mCycles, mCycles ? (long long)(mMixNs / mCycles) : 0LL);
+    result.append(buffer);
+    ::write(fd, result.string(), result.size());
+    return NO_ERROR;
 }
 
 // ----------------------------------------------------------------------------
@@ -319,25 +1285,78 @@ status_t AudioStreamInGeneric::set(
 {
     if (pFormat == 0 || pChannels == 0 || pRate == 0) return BAD_VALUE;
     ALOGV("AudioStreamInGeneric::set(%p, %d, %d, %d, %u)", hw, fd, *pFormat, *pChannels, *pRate);
-    // check values
+    // check values; any rate the resampler handles is accepted
     if ((*pFormat != format()) ||
         (*pChannels != channels()) ||
-        (*pRate != sampleRate())) {
+        !AudioResampler::isSupported(kDeviceRate, *pRate, 1)) {
         ALOGE("Error opening input channel");
         *pFormat = format();
         *pChannels = channels();
-        *pRate = sampleRate();
+        *pRate = kDeviceRate;
         return BAD_VALUE;
     }
 
     mAudioHardware = hw;
     mFd = fd;
     mDevice = devices;
+    mSampleRate = *pRate;
+    if (mSampleRate != kDeviceRate) {
+        mResampler = new AudioResampler(kDeviceRate, mSampleRate, 1);
+        mReadBuffer = new int16_t[kDeviceBufferSize / sizeof(int16_t)];
+    }
     return NO_ERROR;
 }
 
 AudioStreamInGeneric::~AudioStreamInGeneric()
 {
+    if (mCaptureThread != 0) {
+        mCaptureThread->requestExit();
+        {
+            AutoMutex lock(mWaitLock);
+            mCaptureExiting = true;
+            mStateChanged.broadcast();
+        }
+        mCaptureThread->requestExitAndWait();
+        mCaptureThread.clear();
+    }
+    delete mRing;
+    delete mStamps;
+    delete[] mCaptureBuffer;
+    delete mResampler;
+    delete[] mReadBuffer;
+}
+
+status_t AudioStreamInGeneric::enableCaptureThread(size_t ringBytes)
+{
+    if (mRing != 0) return INVALID_OPERATION;
+    // room for one period to be read while the next one arrives
+    if (ringBytes < 2 * kDeviceBufferSize) ringBytes = 2 * kDeviceBufferSize;
+
+    mRing = new AudioRingBuffer(ringBytes);
+    mStamps = new AudioRingBuffer((mRing->capacity() / kDeviceBufferSize + 1) * sizeof(PeriodStamp));
+    mCaptureBuffer = new uint8_t[kDeviceBufferSize];
+    mStamp.position = 0;
+    mStamp.timeNs = 0;
+    mStamp.frames = 0;
+    mCaptureThread = new CaptureThread(this);
+    status_t status = mCaptureThread->run("AudioInCapture", ANDROID_PRIORITY_URGENT_AUDIO);
+    if (status != NO_ERROR) {
+        ALOGE("cannot start capture thread: %d", status);
+        mCaptureThread.clear();
+        delete mRing;
+        mRing = 0;
+        delete mStamps;
+        mStamps = 0;
+        return status;
+    }
+    ALOGV("capture thread enabled, ring %zu bytes", mRing->capacity());
+    return NO_ERROR;
+}
+
+size_t AudioStreamInGeneric::bufferSizeFor(uint32_t sampleRate)
+{
+    return AudioHardwareBase::bufferFrames(sampleRate, AudioHardwareBase::kNormalPeriodUs,
+            AudioHardwareBase::kDefaultPeriodConstraints) * sizeof(int16_t);
 }
 
 ssize_t AudioStreamInGeneric::read(void* buffer, ssize_t bytes)
@@ -347,7 +1366,275 @@ ssize_t AudioStreamInGeneric::read(void* buffer, ssize_t bytes)
         ALOGE("Attempt to read from unopened device");
         return NO_INIT;
     }
-    return ::read(mFd, buffer, bytes);
+    if (mResampler == 0 && mReadOffset == mReadFrames) {
+        ssize_t ret = readDevice((int16_t *)buffer, bytes / frameSize());
+        return ret > 0 ? ret * frameSize() : ret;
+    }
+
+    int16_t *out = (int16_t *)buffer;
+    size_t frames = bytes / frameSize();
+    size_t done = 0;
+    while (done < frames) {
+        if (mReadOffset == mReadFrames) {
+            ssize_t ret = readDevice(mReadBuffer, kDeviceBufferSize / sizeof(int16_t));
+            if (ret <= 0) {
+                return done ? (ssize_t)(done * frameSize()) : ret;
+            }
+            mReadFrames = ret;
+            mReadOffset = 0;
+        }
+        size_t n = mReadFrames - mReadOffset;
+        if (mResampler == 0) {
+            // left over from before a reconfigure() to the device rate
+            if (n > frames - done) n = frames - done;
+            memcpy(out + done, mReadBuffer + mReadOffset, n * sizeof(int16_t));
+            done += n;
+        } else {
+            done += mResampler->resample(out + done, frames - done, mReadBuffer + mReadOffset, &n);
+        }
+        mReadOffset += n;
+    }
+    return done * frameSize();
+}
+
+// Device frames, from the capture ring if there is one.
+ssize_t AudioStreamInGeneric::readDevice(int16_t *buffer, size_t frames)
+{
+    if (mRing != 0) {
+        return readRing(buffer, frames);
+    }
+    ssize_t ret = ::read(mFd, buffer, frames * sizeof(int16_t));
+    return ret > 0 ? ret / (ssize_t)sizeof(int16_t) : ret;
+}
+
+ssize_t AudioStreamInGeneric::readRing(int16_t *buffer, size_t frames)
+{
+    if (!mCapturing.load()) {
+        AutoMutex lock(mWaitLock);
+        mCapturing.store(true);
+        mStateChanged.broadcast();
+    }
+
+    size_t done = 0;
+    while (done < frames) {
+        if (mStampLeft == 0) {
+            // a period's frames are in mRing before its stamp is in mStamps
+            if (mStamps->availableToRead() < sizeof(PeriodStamp)) {
+                // what was captured before the device failed goes out first
+                status_t error = mCaptureError.exchange(NO_ERROR);
+                if (error != NO_ERROR) {
+                    return done ? (ssize_t)done : (ssize_t)error;
+                }
+                AutoMutex lock(mWaitLock);
+                mReaderWaiting.store(true);
+                // pairs with the fence in capturePeriod()
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (mStamps->availableToRead() < sizeof(PeriodStamp) &&
+                        mCaptureError.load() == NO_ERROR) {
+                    mDataReady.waitRelative(mWaitLock, kCaptureWaitNs);
+                }
+                mReaderWaiting.store(false);
+                continue;
+            }
+            mStamps->read(&mStamp, sizeof(mStamp));
+            mStampLeft = mStamp.frames;
+        }
+        size_t n = frames - done < mStampLeft ? frames - done : mStampLeft;
+        mRing->read(buffer + done, n * sizeof(int16_t));
+        done += n;
+        mStampLeft -= n;
+    }
+    return done;
+}
+
+status_t AudioStreamInGeneric::CaptureThread::readyToRun()
+{
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = kWriterThreadPriority;
+    if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
+        ALOGW("cannot set SCHED_FIFO for capture thread: %s", strerror(errno));
+    }
+    return NO_ERROR;
+}
+
+bool AudioStreamInGeneric::CaptureThread::threadLoop()
+{
+    return mStream->capturePeriod();
+}
+
+bool AudioStreamInGeneric::capturePeriod()
+{
+    {
+        AutoMutex lock(mWaitLock);
+        if (!mCapturing.load()) {
+            if (!mCaptureIdle.load()) {
+                // stopCapture() empties the rings, so nothing follows it
+                mCaptureKept = 0;
+                mCaptureIdle.store(true);
+                mStateChanged.broadcast();
+            }
+            // in standby until read() or the destructor signals
+            if (!mCaptureExiting) {
+                mStateChanged.wait(mWaitLock);
+            }
+            return true;
+        }
+        mCaptureIdle.store(false);
+    }
+
+    size_t got = mCaptureKept;
+    status_t error = NO_ERROR;
+    while (got < kDeviceBufferSize) {
+        ssize_t ret = ::read(mFd, mCaptureBuffer + got, kDeviceBufferSize - got);
+        if (ret < 0 && errno == EINTR) continue;
+        if (ret <= 0) {
+            if (ret < 0) {
+                error = -errno;
+                ALOGE("capture read from device failed: %s", strerror(errno));
+            } else {
+                // the device went away
+                error = -EIO;
+            }
+            break;
+        }
+        got += ret;
+    }
+    nsecs_t now = systemTime();
+    uint32_t frames = got / sizeof(int16_t);
+    // half a sample is kept for the next period rather than shifting the
+    // rest of the capture by a byte
+    mCaptureKept = got - frames * sizeof(int16_t);
+    if (frames == 0) {
+        if (mCaptureKept) mCaptureBuffer[0] = mCaptureBuffer[got - 1];
+        reportCaptureError(error);
+        // give a failing driver a period to recover rather than spin
+        usleep(kDeviceBufferSize / sizeof(int16_t) * 1000000 / kDeviceRate);
+        return true;
+    }
+
+    PeriodStamp stamp;
+    stamp.position = mCapturedFrames;
+    stamp.timeNs = now;
+    stamp.frames = frames;
+    mCapturedFrames += frames;
+    if (mRing->availableToWrite() < frames * sizeof(int16_t) ||
+            mStamps->availableToWrite() < sizeof(stamp)) {
+        // read() is more than a ring behind: this period is lost whole, and
+        // its stamp's absence tells read() where the gap is
+        mFramesLost.fetch_add(frames, std::memory_order_relaxed);
+        mOverruns.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        mRing->write(mCaptureBuffer, frames * sizeof(int16_t));
+        mStamps->write(&stamp, sizeof(stamp));
+    }
+    if (mCaptureKept) mCaptureBuffer[0] = mCaptureBuffer[got - 1];
+    reportCaptureError(error);
+    return true;
+}
+
+// Wake read() for the period just queued, or for error if it is not NO_ERROR.
+void AudioStreamInGeneric::reportCaptureError(status_t error)
+{
+    if (error != NO_ERROR) mCaptureError.store(error);
+    // Either read() sees the stamp or error just stored when it checks, or
+    // this sees the flag it set first.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (mReaderWaiting.load()) {
+        AutoMutex lock(mWaitLock);
+        mDataReady.signal();
+    }
+}
+
+// Park the capture thread between periods so the rings can be emptied.
+void AudioStreamInGeneric::stopCapture()
+{
+    AutoMutex lock(mWaitLock);
+    mCapturing.store(false);
+    while (!mCaptureIdle.load()) {
+        if (mStateChanged.waitRelative(mWaitLock, kCaptureStopWaitNs) == TIMED_OUT) {
+            ALOGW("capture thread stuck in the driver, keeping its ring");
+            return;
+        }
+    }
+    mRing->reset();
+    mStamps->reset();
+    mStampLeft = 0;
+    mStamp.timeNs = 0;
+    mCaptureError.store(NO_ERROR);
+}
+
+unsigned int AudioStreamInGeneric::getInputFramesLost() const
+{
+    uint64_t lost = mFramesLost.exchange(0);
+    return (unsigned int)(lost * mSampleRate / kDeviceRate);
+}
+
+status_t AudioStreamInGeneric::getCapturePosition(int64_t *frames, int64_t *time)
+{
+    if (frames == 0 || time == 0) return BAD_VALUE;
+    AutoMutex lock(mLock);
+    if (mRing == 0 || mStamp.timeNs == 0) return INVALID_OPERATION;
+
+    // The last frame of a period was captured just before its read returned.
+    int64_t position = devicePosition_l();
+    int64_t ahead = mStamp.position + mStamp.frames - position;
+    *frames = mClientBase + (position - mDeviceBase) * mSampleRate / kDeviceRate;
+    *time = mStamp.timeNs - ahead * 1000000000 / kDeviceRate;
+    return NO_ERROR;
+}
+
+// Device frames read() has handed on, lost ones included: the next one is
+// either still in the ring or already taken from it and waiting for the
+// resampler.
+int64_t AudioStreamInGeneric::devicePosition_l() const
+{
+    int64_t ahead = (int64_t)mStampLeft - (int64_t)(mReadFrames - mReadOffset);
+    return mStamp.position + mStamp.frames - ahead;
+}
+
+status_t AudioStreamInGeneric::reconfigure(int format, uint32_t sampleRate)
+{
+    if (format == 0) format = this->format();
+    if (sampleRate == 0) sampleRate = mSampleRate;
+    if (format != this->format() || !AudioResampler::isSupported(kDeviceRate, sampleRate, 1)) {
+        return BAD_VALUE;
+    }
+    // waits for a read() in progress
+    AutoMutex lock(mLock);
+    if (sampleRate == mSampleRate) return NO_ERROR;
+    ALOGV("reconfigure() %u -> %u Hz", mSampleRate, sampleRate);
+
+    // the capture position carries on from here at the new rate
+    if (mRing != 0) {
+        int64_t position = devicePosition_l();
+        mClientBase += (position - mDeviceBase) * mSampleRate / kDeviceRate;
+        mDeviceBase = position;
+    }
+    // Capture itself is not interrupted. Only the few ms of input the old
+    // resampler held for its lookahead are dropped.
+    delete mResampler;
+    mResampler = 0;
+    if (sampleRate != kDeviceRate) {
+        mResampler = new AudioResampler(kDeviceRate, sampleRate, 1);
+        if (mReadBuffer == 0) mReadBuffer = new int16_t[kDeviceBufferSize / sizeof(int16_t)];
+    }
+    mSampleRate = sampleRate;
+    return NO_ERROR;
+}
+
+status_t AudioStreamInGeneric::standby()
+{
+    AutoMutex lock(mLock);
+    // don't hand out stale capture after the input restarts
+    if (mRing != 0) {
+        stopCapture();
+    }
+    mReadFrames = mReadOffset = 0;
+    if (mResampler != 0) {
+        mResampler->reset();
+    }
+    return NO_ERROR;
 }
 
 status_t AudioStreamInGeneric::dump(int fd, const Vector<String16>& args)
@@ -359,7 +1646,7 @@ status_t AudioStreamInGeneric::dump(int fd, const Vector<String16>& args)
     result.append(buffer);
     snprintf(buffer, SIZE, "\tsample rate: %d\n", sampleRate());
     result.append(buffer);
-    snprintf(buffer, SIZE, "\tbuffer size: %d\n", bufferSize());
+    snprintf(buffer, SIZE, "\tbuffer size: %zu\n", bufferSize());
     result.append(buffer);
     snprintf(buffer, SIZE, "\tchannels: %d\n", channels());
     result.append(buffer);
@@ -371,25 +1658,34 @@ status_t AudioStreamInGeneric::dump(int fd, const Vector<String16>& args)
     result.append(buffer);
     snprintf(buffer, SIZE, "\tmFd: %d\n", mFd);
     result.append(buffer);
+    if (mResampler != 0) {
+        snprintf(buffer, SIZE, "\tresampling %u -> %u Hz\n",
+                mResampler->inRate(), mResampler->outRate());
+        result.append(buffer);
+    }
+    if (mRing != 0) {
+        snprintf(buffer, SIZE, "\tcapture ring: %zu bytes, %s, %u overruns, %u frames lost\n",
+                mRing->capacity(), mCapturing.load() ? "capturing" : "idle",
+                overruns(), mFramesLost.load(std::memory_order_relaxed));
+        result.append(buffer);
+    }
     ::write(fd, result.string(), result.size());
     return NO_ERROR;
 }
 
 status_t AudioStreamInGeneric::setParameters(const String8& keyValuePairs)
 {
-    AudioParameter param = AudioParameter(keyValuePairs);
-    String8 key = String8(AudioParameter::keyRouting);
+    AudioParameterScanner param(keyValuePairs.string());
     status_t status = NO_ERROR;
     int device;
     ALOGV("setParameters() %s", keyValuePairs.string());
 
-    if (param.getInt(key, device) == NO_ERROR) {
-        mDevice = device;
-        param.remove(key);
-    }
-
-    if (param.size()) {
-        status = BAD_VALUE;
+    while (param.next()) {
+        if (param.keyIs(AudioParameter::keyRouting) && param.valueInt(&device) == NO_ERROR) {
+            mDevice = device;
+        } else {
+            status = BAD_VALUE;
+        }
     }
     return status;
 }
@@ -21,22 +21,61 @@
 #include <stdint.h>
 #include <sys/types.h>
 
+#include <atomic>
+
+#include <utils/SortedVector.h>
 #include <utils/threads.h>
 
 #include <hardware_legacy/AudioSystemLegacy.h>
 #include <hardware_legacy/AudioHardwareBase.h>
 
+#include "AudioFormatConverter.h"
+#include "AudioGainRamp.h"
+#include "AudioMixOps.h"
+#include "AudioPacingClock.h"
+#include "AudioPositionTracker.h"
+#include "AudioResampler.h"
+#include "AudioRingBuffer.h"
+
 namespace android_audio_legacy {
     using android::Mutex;
     using android::AutoMutex;
+    using android::Condition;
+    using android::SortedVector;
 
 // ----------------------------------------------------------------------------
 
 class AudioHardwareGeneric;
+class AudioMixerGeneric;
 
 class AudioStreamOutGeneric : public AudioStreamOut {
 public:
-                        AudioStreamOutGeneric() : mAudioHardware(0), mFd(-1) {}
+    // what /dev/eac plays, 16-bit stereo; other client rates, formats and
+    // channel masks are converted in write()
+    static const uint32_t kDeviceRate = 44100;
+    static const size_t kDeviceBufferSize = 4096;
+    static const size_t kDeviceFrameSize = 2 * sizeof(int16_t);
+    // device frames per write the buffer size is derived from
+    static const AudioPeriodConstraints kPeriodConstraints;
+
+                        AudioStreamOutGeneric()
+                            : mAudioHardware(0), mFd(-1), mSampleRate(kDeviceRate),
+                              mFormat(AudioSystem::PCM_16_BIT),
+                              mChannels(AudioSystem::CHANNEL_OUT_STEREO),
+                              mPeriodUs(0), mPeriodFrames(kDeviceBufferSize / kDeviceFrameSize),
+                              mClientBase(0), mDeviceBase(0),
+                              mConverter(0), mConvertBuffer(0),
+                              mGain(kUnityGain), mMasterGain(kUnityGainQ15), mFirstWrite(true),
+                              mResampler(0), mSrcBuffer(0), mTailFrames(0),
+                              mRing(0), mWriteBuffer(0), mQueuedFrames(0), mDryStartNs(0),
+                              mStarted(false),
+                              mWriterWaiting(false), mSpaceWaiters(0), mWriterExiting(false),
+                              mWriteError(NO_ERROR),
+                              mUnderruns(0), mOverruns(0),
+                              mMmapBuffer(0), mMmapFd(-1), mMmapFrames(0), mBurstFrames(0),
+                              mMmapActive(false), mMmapPosition(0), mMmapTimeNs(0),
+                              mMmapError(NO_ERROR),
+                              mMixer(0), mMixedFrames(0) {}
     virtual             ~AudioStreamOutGeneric();
 
     virtual status_t    set(
@@ -45,31 +84,172 @@ public:
             uint32_t devices,
             int *pFormat,
             uint32_t *pChannels,
-            uint32_t *pRate);
+            uint32_t *pRate,
+            audio_output_flags_t flags = AUDIO_OUTPUT_FLAG_NONE);
 
-    virtual uint32_t    sampleRate() const { return 44100; }
-    virtual size_t      bufferSize() const { return 4096; }
-    virtual uint32_t    channels() const { return AudioSystem::CHANNEL_OUT_STEREO; }
-    virtual int         format() const { return AudioSystem::PCM_16_BIT; }
-    virtual uint32_t    latency() const { return 20; }
-    virtual status_t    setVolume(float left, float right) { return INVALID_OPERATION; }
+    virtual uint32_t    sampleRate() const { return mSampleRate; }
+    virtual size_t      bufferSize() const;
+    virtual uint32_t    channels() const { return mChannels; }
+    virtual int         format() const { return mFormat; }
+    virtual uint32_t    latency() const;
+    virtual status_t    setVolume(float left, float right);
     virtual ssize_t     write(const void* buffer, size_t bytes);
     virtual status_t    standby();
     virtual status_t    dump(int fd, const Vector<String16>& args);
     virtual status_t    setParameters(const String8& keyValuePairs);
     virtual String8     getParameters(const String8& keys);
     virtual status_t    getRenderPosition(uint32_t *dspFrames);
+    virtual status_t    getNextWriteTimestamp(int64_t *timestamp);
+    virtual status_t    getPresentationPosition(uint64_t *frames, struct timespec *timestamp);
+    virtual status_t    createMmapBuffer(int32_t minSizeFrames, void **buffer, int *fd,
+                                         int32_t *bufferSizeFrames, int32_t *burstSizeFrames);
+    // The position keeps advancing at real time while the device fails, and
+    // the device's error is returned until it takes a burst again.
+    virtual status_t    getMmapPosition(int64_t *timeNs, int32_t *positionFrames);
+    virtual status_t    start();
+    virtual status_t    stop();
+    // What the resampler still holds is flushed and goes out ahead of the
+    // next write(), so no audio is lost, and the ring keeps playing
+    // throughout.
+    virtual status_t    reconfigure(int format, uint32_t sampleRate);
+
+    // Decouple write() from the driver: write() only copies into a lock-free
+    // ring of ringBytes and a SCHED_FIFO thread drains it to the device, so a
+    // driver stall no longer blocks the caller, standby() or dump(). A failed
+    // device write is returned by the next write().
+    // Must be called after set() and before the first write().
+            status_t    enableAsyncWrite(size_t ringBytes);
+
+    // Like enableAsyncWrite(), but the ring is drained by a mixer shared with
+    // other streams instead of a writer thread of our own.
+            status_t    attachMixer(AudioMixerGeneric *mixer, size_t ringBytes);
+
+    // Set by AudioHardwareGeneric::setMasterVolume(); scales setVolume().
+            void        setMasterVolume(float volume);
+
+            // write() found the ring full and had to wait for the writer thread
+            uint32_t    overruns() const { return mOverruns.load(std::memory_order_relaxed); }
+            // the device went a whole buffer without data while the stream was active
+            uint32_t    underruns() const { return mUnderruns.load(std::memory_order_relaxed); }
 
 private:
+    friend class AudioMixerGeneric;
+
+    static const uint32_t kUnityGain = ((uint32_t)kUnityGainQ15 << 16) | kUnityGainQ15;
+
+    class WriterThread : public android::Thread {
+    public:
+                        WriterThread(AudioStreamOutGeneric *stream)
+                            : Thread(false), mStream(stream) {}
+    private:
+        virtual status_t readyToRun();
+        virtual bool    threadLoop();
+
+        AudioStreamOutGeneric *mStream;
+    };
+
+            ssize_t     writeDevice(const void* buffer, size_t bytes);
+            ssize_t     writeDeviceFully(const int16_t *frames, size_t count);
+            uint64_t    toClientFrames(uint64_t deviceFrames) const;
+            void        flushResampler();
+            ssize_t     writeTail();
+            status_t    startWriterThread();
+            bool        drainRing();
+            bool        pumpMmapBuffer();
+            ssize_t     writeAsync(const void* buffer, size_t bytes);
+            void        checkUnderrun(size_t bytes);
+            void        signalSpace();
+            void        waitForDrain(nsecs_t limitNs);
+            // mixer thread only: add up to frames from the ring into mix,
+            // then account for them once the mix has gone to the device
+            size_t      mixInto(int16_t *mix, size_t frames);
+            void        mixed(nsecs_t nowNs);
+
     AudioHardwareGeneric *mAudioHardware;
+    // held by write() and reconfigure(); standby() only takes it when it is
+    // free if write() may be waiting on the ring
     Mutex   mLock;
     int     mFd;
     uint32_t mDevice;
+    uint32_t mSampleRate;
+    int     mFormat;
+    uint32_t mChannels;
+    uint32_t mPeriodUs;                 // of the latency profile set() picked
+    size_t  mPeriodFrames;              // mPeriodUs in device frames
+    AudioPositionTracker mPosition;     // in device frames
+    // where the presentation position stood at the last reconfigure(),
+    // protected by mRateLock along with mSampleRate
+    uint64_t    mClientBase;
+    uint64_t    mDeviceBase;
+    mutable Mutex mRateLock;
+
+    // set when the client format or channel mask is not 16-bit stereo
+    AudioFormatConverter        *mConverter;
+    // kDeviceBufferSize of converted and volume scaled client frames
+    int16_t                     *mConvertBuffer;
+
+    // Volume is applied in write(), after conversion to 16-bit stereo and
+    // before resampling, ramping to each new setting over kVolumeRampMs.
+    std::atomic<uint32_t>       mGain;          // Q15 right << 16 | Q15 left
+    std::atomic<int16_t>        mMasterGain;    // Q15
+    AudioGainRamp               mRamp;          // write() only
+    bool                        mFirstWrite;    // write() only
+
+    // set when the client rate is not kDeviceRate
+    AudioResampler              *mResampler;
+    int16_t                     *mSrcBuffer;    // kDeviceBufferSize
+    size_t                      mTailFrames;    // in mSrcBuffer, from before a reconfigure()
+
+    // async write mode, only used once enableAsyncWrite() succeeded
+    AudioRingBuffer             *mRing;
+    android::sp<WriterThread>   mWriterThread;
+    uint8_t                     *mWriteBuffer;
+    uint64_t                    mQueuedFrames;  // put in the ring, write() only
+    nsecs_t                     mDryStartNs;    // writer thread only
+    Mutex                       mWaitLock;
+    Condition                   mDataReady;
+    Condition                   mSpaceReady;
+    std::atomic<bool>           mStarted;
+    std::atomic<bool>           mWriterWaiting;
+    std::atomic<uint32_t>       mSpaceWaiters;  // write() and standby(), on mSpaceReady
+    bool                        mWriterExiting; // protected by mWaitLock
+    // the writer thread's last failed device write, for write() to return
+    std::atomic<status_t>       mWriteError;
+    AudioPacingClock            mErrorPacing;   // writer thread only, after a failed write
+    std::atomic<uint32_t>       mUnderruns;
+    std::atomic<uint32_t>       mOverruns;
+
+    // mmap mode: the writer thread plays the DMA engine, copying bursts from
+    // the shared buffer to the device, since /dev/eac itself cannot be mapped
+    uint8_t                     *mMmapBuffer;
+    int                         mMmapFd;
+    size_t                      mMmapFrames;
+    size_t                      mBurstFrames;
+    std::atomic<bool>           mMmapActive;
+    int64_t                     mMmapPosition;  // protected by mLock
+    int64_t                     mMmapTimeNs;    // protected by mLock
+    // the last burst's write error, NO_ERROR once the device takes one again
+    std::atomic<status_t>       mMmapError;
+
+    // mixed mode, only used once attachMixer() succeeded
+    AudioMixerGeneric           *mMixer;
+    size_t                      mMixedFrames;   // mixer thread only
 };
 
 class AudioStreamInGeneric : public AudioStreamIn {
 public:
-                        AudioStreamInGeneric() : mAudioHardware(0), mFd(-1) {}
+    // what /dev/eac captures; other client rates are converted in read()
+    static const uint32_t kDeviceRate = 8000;
+    static const size_t kDeviceBufferSize = 320;
+
+                        AudioStreamInGeneric()
+                            : mAudioHardware(0), mFd(-1), mSampleRate(kDeviceRate),
+                              mResampler(0), mReadBuffer(0), mReadFrames(0), mReadOffset(0),
+                              mClientBase(0), mDeviceBase(0),
+                              mRing(0), mStamps(0), mStampLeft(0), mCaptureBuffer(0),
+                              mCapturedFrames(0), mCaptureKept(0), mCapturing(false),
+                              mCaptureIdle(true), mReaderWaiting(false), mCaptureExiting(false),
+                              mCaptureError(NO_ERROR), mFramesLost(0), mOverruns(0) {}
     virtual             ~AudioStreamInGeneric();
 
     virtual status_t    set(
@@ -81,27 +261,158 @@ public:
             uint32_t *pRate,
             AudioSystem::audio_in_acoustics acoustics);
 
-    virtual uint32_t    sampleRate() const { return 8000; }
-    virtual size_t      bufferSize() const { return 320; }
+    virtual uint32_t    sampleRate() const { return mSampleRate; }
+    virtual size_t      bufferSize() const { return bufferSizeFor(mSampleRate); }
     virtual uint32_t    channels() const { return AudioSystem::CHANNEL_IN_MONO; }
     virtual int         format() const { return AudioSystem::PCM_16_BIT; }
     virtual status_t    setGain(float gain) { return INVALID_OPERATION; }
     virtual ssize_t     read(void* buffer, ssize_t bytes);
     virtual status_t    dump(int fd, const Vector<String16>& args);
-    virtual status_t    standby() { return NO_ERROR; }
+    virtual status_t    standby();
     virtual status_t    setParameters(const String8& keyValuePairs);
     virtual String8     getParameters(const String8& keys);
-    virtual unsigned int  getInputFramesLost() const { return 0; }
+    virtual unsigned int  getInputFramesLost() const;
+    virtual status_t    getCapturePosition(int64_t *frames, int64_t *time);
+    // Only the rate can change; device frames read but not yet converted
+    // are kept, so capture carries on from where read() left off.
+    virtual status_t    reconfigure(int format, uint32_t sampleRate);
     virtual status_t addAudioEffect(effect_handle_t effect) { return NO_ERROR; }
     virtual status_t removeAudioEffect(effect_handle_t effect) { return NO_ERROR; }
 
+    // 20ms at sampleRate, in whole 16-frame blocks
+    static  size_t      bufferSizeFor(uint32_t sampleRate);
+
+    // Decouple capture from read(): a SCHED_FIFO thread reads the device a
+    // period at a time into a lock-free ring of ringBytes, stamping each
+    // period with the time it arrived, and read() is served from the ring.
+    // A period that finds the ring full is dropped and counted as lost; a
+    // failed device read is returned by read() once the ring is empty.
+    // Must be called after set() and before the first read().
+            status_t    enableCaptureThread(size_t ringBytes);
+
+            // periods the capture thread dropped because the ring was full
+            uint32_t    overruns() const { return mOverruns.load(std::memory_order_relaxed); }
+
 private:
+    class CaptureThread : public android::Thread {
+    public:
+                        CaptureThread(AudioStreamInGeneric *stream)
+                            : Thread(false), mStream(stream) {}
+    private:
+        virtual status_t readyToRun();
+        virtual bool    threadLoop();
+
+        AudioStreamInGeneric *mStream;
+    };
+
+    // One per period in mRing, queued through mStamps in the same order.
+    struct PeriodStamp {
+        int64_t         position;   // device frames captured before it, lost ones included
+        int64_t         timeNs;     // when the read of it returned
+        uint32_t        frames;
+    };
+
+            ssize_t     readDevice(int16_t *buffer, size_t frames);
+            ssize_t     readRing(int16_t *buffer, size_t frames);
+            bool        capturePeriod();
+            void        reportCaptureError(status_t error);
+            void        stopCapture();
+            int64_t     devicePosition_l() const;
+
     AudioHardwareGeneric *mAudioHardware;
     Mutex   mLock;
     int     mFd;
     uint32_t mDevice;
+    uint32_t mSampleRate;
+
+    // set when the client rate is not kDeviceRate; device frames read but
+    // not yet converted are kept for the next read()
+    AudioResampler  *mResampler;
+    int16_t         *mReadBuffer;   // kDeviceBufferSize
+    size_t          mReadFrames;
+    size_t          mReadOffset;
+    // where the capture position stood at the last reconfigure()
+    int64_t         mClientBase;
+    int64_t         mDeviceBase;
+
+    // capture thread mode, only used once enableCaptureThread() succeeded
+    AudioRingBuffer             *mRing;
+    AudioRingBuffer             *mStamps;       // of PeriodStamp
+    PeriodStamp                 mStamp;         // the period read() is in, protected by mLock
+    uint32_t                    mStampLeft;     // frames of it still in mRing, protected by mLock
+    android::sp<CaptureThread>  mCaptureThread;
+    uint8_t                     *mCaptureBuffer;
+    int64_t                     mCapturedFrames;    // capture thread only
+    size_t                      mCaptureKept;   // bytes of a split sample, capture thread only
+    Mutex                       mWaitLock;
+    Condition                   mDataReady;
+    Condition                   mStateChanged;
+    std::atomic<bool>           mCapturing;
+    std::atomic<bool>           mCaptureIdle;
+    std::atomic<bool>           mReaderWaiting;
+    bool                        mCaptureExiting; // protected by mWaitLock
+    // the device read that failed, until read() returns it
+    std::atomic<status_t>       mCaptureError;
+    mutable std::atomic<uint32_t> mFramesLost;  // since the last getInputFramesLost()
+    std::atomic<uint32_t>       mOverruns;
 };
 
+/**
+ * Software mixer for several AudioStreamOutGeneric sharing /dev/eac.
+ *
+ * Attached streams run in async mode, but rather than a writer thread each,
+ * one SCHED_FIFO thread takes up to a period from every stream's ring,
+ * sums with saturation and writes the mix; stream volume was already
+ * applied in write(). A stream that is short of data is mixed as silence
+ * for the rest of the period; the mixer only waits when no stream has
+ * anything queued, until a stream is added or queues data.
+ */
+class AudioMixerGeneric {
+public:
+                        AudioMixerGeneric(int fd, size_t periodFrames);
+                        ~AudioMixerGeneric();
+
+            status_t    start();
+            status_t    addStream(AudioStreamOutGeneric *out);
+            void        removeStream(AudioStreamOutGeneric *out);
+            size_t      streamCount();
+            // a stream queued data
+            void        wake();
+            status_t    dump(int fd, const Vector<String16>& args);
+
+private:
+    class MixerThread : public android::Thread {
+    public:
+                        MixerThread(AudioMixerGeneric *mixer)
+                            : Thread(false), mMixer(mixer) {}
+    private:
+        virtual status_t readyToRun();
+        virtual bool    threadLoop();
+
+        AudioMixerGeneric *mMixer;
+    };
+
+            bool        mixOnce();
+            bool        hasData();
+            void        waitForData();
+
+                        AudioMixerGeneric(const AudioMixerGeneric &);
+            AudioMixerGeneric& operator=(const AudioMixerGeneric &);
+
+    // held while mixing, but not while the mix goes to the device
+    Mutex                       mLock;
+    SortedVector<AudioStreamOutGeneric *> mStreams;
+    const int                   mFd;
+    const size_t                mPeriodFrames;
+    int16_t                     *mMixBuffer;
+    android::sp<MixerThread>    mThread;
+    Mutex                       mWaitLock;
+    Condition                   mDataReady;
+    std::atomic<bool>           mWaiting;
+    bool                        mExiting;       // protected by mWaitLock
+    uint64_t                    mCycles;        // protected by mLock
+    nsecs_t                     mMixNs;         // protected by mLock
+};
 
 class AudioHardwareGeneric : public AudioHardwareBase
 {
@@ -111,6 +422,8 @@ public:
     virtual status_t    initCheck();
     virtual status_t    setVoiceVolume(float volume);
     virtual status_t    setMasterVolume(float volume);
+    virtual status_t    getMasterVolume(float *volume);
+    virtual size_t      getInputBufferSize(uint32_t sampleRate, int format, int channelCount);
 
     // mic mute
     virtual status_t    setMicMute(bool state);
@@ -125,6 +438,15 @@ public:
             status_t *status=0);
     virtual    void        closeOutputStream(AudioStreamOut* out);
 
+    // AUDIO_OUTPUT_FLAG_FAST gets the short period profile
+    virtual AudioStreamOut* openOutputStreamWithFlags(
+            uint32_t devices,
+            audio_output_flags_t flags,
+            int *format=0,
+            uint32_t *channels=0,
+            uint32_t *sampleRate=0,
+            status_t *status=0);
+
     virtual AudioStreamIn* openInputStream(
             uint32_t devices,
             int *format,
@@ -143,10 +465,13 @@ private:
     status_t                dumpInternals(int fd, const Vector<String16>& args);
 
     Mutex                   mLock;
-    AudioStreamOutGeneric   *mOutput;
+    SortedVector<AudioStreamOutGeneric *> mOutputs;
     AudioStreamInGeneric    *mInput;
     int                     mFd;
     bool                    mMicMute;
+    size_t                  mMaxOutputs;
+    AudioMixerGeneric       *mMixer;
+    float                   mMasterVolume;
 };
 
 // ----------------------------------------------------------------------------
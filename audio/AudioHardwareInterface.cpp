@@ -76,8 +76,49 @@ status_t AudioStreamOut::getNextWriteTimestamp(int64_t *timestamp)
     return INVALID_OPERATION;
 }
 
+status_t AudioStreamOut::getPresentationPosition(uint64_t *frames, struct timespec *timestamp)
+{
+    return INVALID_OPERATION;
+}
+
+status_t AudioStreamOut::createMmapBuffer(int32_t minSizeFrames, void **buffer, int *fd,
+                                          int32_t *bufferSizeFrames, int32_t *burstSizeFrames)
+{
+    return INVALID_OPERATION;
+}
+
+status_t AudioStreamOut::getMmapPosition(int64_t *timeNs, int32_t *positionFrames)
+{
+    return INVALID_OPERATION;
+}
+
+status_t AudioStreamOut::start()
+{
+    return INVALID_OPERATION;
+}
+
+status_t AudioStreamOut::stop()
+{
+    return INVALID_OPERATION;
+}
+
+status_t AudioStreamOut::reconfigure(int format, uint32_t sampleRate)
+{
+    return INVALID_OPERATION;
+}
+
 AudioStreamIn::~AudioStreamIn() {}
 
+status_t AudioStreamIn::getCapturePosition(int64_t *frames, int64_t *time)
+{
+    return INVALID_OPERATION;
+}
+
+status_t AudioStreamIn::reconfigure(int format, uint32_t sampleRate)
+{
+    return INVALID_OPERATION;
+}
+
 AudioHardwareBase::AudioHardwareBase()
 {
     mMode = 0;
@@ -110,22 +151,50 @@ String8 AudioHardwareBase::getParameters(const String8& keys)
 }
 
 // default implementation
+const uint32_t AudioHardwareBase::kNormalPeriodUs;
+const uint32_t AudioHardwareBase::kFastPeriodUs;
+const AudioPeriodConstraints AudioHardwareBase::kDefaultPeriodConstraints = { 0, 16, 0, 16 };
+
+size_t AudioHardwareBase::bufferFrames(uint32_t sampleRate, uint32_t periodUs,
+                                       const AudioPeriodConstraints& constraints)
+{
+    if (sampleRate == 0) return 0;
+    uint64_t frames = ((uint64_t)sampleRate * periodUs + 999999) / 1000000;
+    uint64_t minFrames = constraints.minFrames;
+    uint64_t maxFrames = constraints.maxFrames;
+    if (constraints.rate != 0 && constraints.rate != sampleRate) {
+        // the stream is resampled to the device rate
+        minFrames = (minFrames * sampleRate + constraints.rate - 1) / constraints.rate;
+        maxFrames = maxFrames * sampleRate / constraints.rate;
+    }
+    if (frames < minFrames) frames = minFrames;
+    if (maxFrames != 0 && frames > maxFrames) frames = maxFrames;
+
+    uint64_t align = constraints.alignFrames ? constraints.alignFrames : 1;
+    frames = (frames + align - 1) / align * align;
+    // rounding up must not take it past the longest period
+    if (maxFrames >= align && frames > maxFrames) frames -= align;
+    return (size_t)frames;
+}
+
 size_t AudioHardwareBase::getInputBufferSize(uint32_t sampleRate, int format, int channelCount)
 {
-    if (sampleRate != 8000) {
+    if (sampleRate < 4000 || sampleRate > 192000) {
         ALOGW("getInputBufferSize bad sampling rate: %d", sampleRate);
         return 0;
     }
-    if (format != AudioSystem::PCM_16_BIT) {
+    size_t sampleSize = audio_bytes_per_sample((audio_format_t)format);
+    if (sampleSize == 0) {
         ALOGW("getInputBufferSize bad format: %d", format);
         return 0;
     }
-    if (channelCount != 1) {
+    if (channelCount < 1 || channelCount > 2) {
         ALOGW("getInputBufferSize bad channel count: %d", channelCount);
         return 0;
     }
 
-    return 320;
+    return bufferFrames(sampleRate, kNormalPeriodUs, kDefaultPeriodConstraints) *
+            channelCount * sampleSize;
 }
 
 // default implementation is unsupported
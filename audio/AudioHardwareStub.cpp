@@ -118,23 +118,35 @@ status_t AudioHardwareStub::dump(int fd, const Vector<String16>& args)
 
 status_t AudioStreamOutStub::set(int *pFormat, uint32_t *pChannels, uint32_t *pRate)
 {
+    // nothing is played, so any format the real outputs convert is taken
+    // as is; anything else still gets the defaults
+    int lFormat = pFormat && *pFormat ? *pFormat : format();
+    uint32_t lChannels = pChannels && *pChannels ? *pChannels : channels();
+    if (AudioFormatConverter::isSupported(lFormat, lChannels)) {
+        mFormat = lFormat;
+        mChannels = lChannels;
+    }
     if (pFormat) *pFormat = format();
     if (pChannels) *pChannels = channels();
     if (pRate) *pRate = sampleRate();
 
+    // nothing is buffered after the fake device, frames play as they are written
+    mPosition.setup(sampleRate(), 0);
     return NO_ERROR;
 }
 
 ssize_t AudioStreamOutStub::write(const void* buffer, size_t bytes)
 {
     // fake timing for audio output
-    usleep(bytes * 1000000 / sizeof(int16_t) /
-               audio_channel_count_from_out_mask(channels()) / sampleRate());
+    mPacing.pace(bytes / frameSize(), sampleRate());
+    mPosition.advance(bytes / frameSize(), systemTime());
     return bytes;
 }
 
 status_t AudioStreamOutStub::standby()
 {
+    mPacing.reset();
+    mPosition.standby();
     return NO_ERROR;
 }
 
@@ -145,7 +157,7 @@ status_t AudioStreamOutStub::dump(int fd, const Vector<String16>& args)
     String8 result;
     snprintf(buffer, SIZE, "AudioStreamOutStub::dump\n");
     snprintf(buffer, SIZE, "\tsample rate: %d\n", sampleRate());
-    snprintf(buffer, SIZE, "\tbuffer size: %d\n", bufferSize());
+    snprintf(buffer, SIZE, "\tbuffer size: %zu\n", bufferSize());
     snprintf(buffer, SIZE, "\tchannels: %d\n", channels());
     snprintf(buffer, SIZE, "\tformat: %d\n", format());
     result.append(buffer);
@@ -161,7 +173,17 @@ String8 AudioStreamOutStub::getParameters(const String8& keys)
 
 status_t AudioStreamOutStub::getRenderPosition(uint32_t *dspFrames)
 {
-    return INVALID_OPERATION;
+    return mPosition.getRenderPosition(dspFrames, systemTime());
+}
+
+status_t AudioStreamOutStub::getNextWriteTimestamp(int64_t *timestamp)
+{
+    return mPosition.getNextWriteTimestamp(timestamp);
+}
+
+status_t AudioStreamOutStub::getPresentationPosition(uint64_t *frames, struct timespec *timestamp)
+{
+    return mPosition.getPresentationPosition(frames, timestamp);
 }
 
 // ----------------------------------------------------------------------------
@@ -175,8 +197,7 @@ status_t AudioStreamInStub::set(int *pFormat, uint32_t *pChannels, uint32_t *pRa
 ssize_t AudioStreamInStub::read(void* buffer, ssize_t bytes)
 {
     // fake timing for audio input
-    usleep(bytes * 1000000 / sizeof(int16_t) /
-           audio_channel_count_from_in_mask(channels()) / sampleRate());
+    mPacing.pace(bytes / frameSize(), sampleRate());
     memset(buffer, 0, bytes);
     return bytes;
 }
@@ -190,7 +211,7 @@ status_t AudioStreamInStub::dump(int fd, const Vector<String16>& args)
     result.append(buffer);
     snprintf(buffer, SIZE, "\tsample rate: %d\n", sampleRate());
     result.append(buffer);
-    snprintf(buffer, SIZE, "\tbuffer size: %d\n", bufferSize());
+    snprintf(buffer, SIZE, "\tbuffer size: %zu\n", bufferSize());
     result.append(buffer);
     snprintf(buffer, SIZE, "\tchannels: %d\n", channels());
     result.append(buffer);
@@ -23,17 +23,24 @@
 
 #include <hardware_legacy/AudioHardwareBase.h>
 
+#include "AudioFormatConverter.h"
+#include "AudioPacingClock.h"
+#include "AudioPositionTracker.h"
+
 namespace android_audio_legacy {
 
 // ----------------------------------------------------------------------------
 
 class AudioStreamOutStub : public AudioStreamOut {
 public:
+                        AudioStreamOutStub()
+                            : mFormat(AudioSystem::PCM_16_BIT),
+                              mChannels(AudioSystem::CHANNEL_OUT_STEREO) {}
     virtual status_t    set(int *pFormat, uint32_t *pChannels, uint32_t *pRate);
     virtual uint32_t    sampleRate() const { return 44100; }
-    virtual size_t      bufferSize() const { return 4096; }
-    virtual uint32_t    channels() const { return AudioSystem::CHANNEL_OUT_STEREO; }
-    virtual int         format() const { return AudioSystem::PCM_16_BIT; }
+    virtual size_t      bufferSize() const { return 1024 * frameSize(); }
+    virtual uint32_t    channels() const { return mChannels; }
+    virtual int         format() const { return mFormat; }
     virtual uint32_t    latency() const { return 0; }
     virtual status_t    setVolume(float left, float right) { return NO_ERROR; }
     virtual ssize_t     write(const void* buffer, size_t bytes);
@@ -42,6 +49,14 @@ public:
     virtual status_t    setParameters(const String8& keyValuePairs) { return NO_ERROR;}
     virtual String8     getParameters(const String8& keys);
     virtual status_t    getRenderPosition(uint32_t *dspFrames);
+    virtual status_t    getNextWriteTimestamp(int64_t *timestamp);
+    virtual status_t    getPresentationPosition(uint64_t *frames, struct timespec *timestamp);
+
+private:
+    int                 mFormat;
+    uint32_t            mChannels;
+    AudioPacingClock    mPacing;
+    AudioPositionTracker mPosition;
 };
 
 class AudioStreamInStub : public AudioStreamIn {
@@ -54,12 +69,15 @@ public:
     virtual status_t    setGain(float gain) { return NO_ERROR; }
     virtual ssize_t     read(void* buffer, ssize_t bytes);
     virtual status_t    dump(int fd, const Vector<String16>& args);
-    virtual status_t    standby() { return NO_ERROR; }
+    virtual status_t    standby() { mPacing.reset(); return NO_ERROR; }
     virtual status_t    setParameters(const String8& keyValuePairs) { return NO_ERROR;}
     virtual String8     getParameters(const String8& keys);
     virtual unsigned int  getInputFramesLost() const { return 0; }
     virtual status_t addAudioEffect(effect_handle_t effect) { return NO_ERROR; }
     virtual status_t removeAudioEffect(effect_handle_t effect) { return NO_ERROR; }
+
+private:
+    AudioPacingClock    mPacing;
 };
 
 class AudioHardwareStub : public  AudioHardwareBase
@@ -82,6 +100,16 @@ public:
                                 uint32_t *channels=0,
                                 uint32_t *sampleRate=0,
                                 status_t *status=0);
+    virtual AudioStreamOut* openOutputStreamWithFlags(
+                                uint32_t devices,
+                                audio_output_flags_t flags,
+                                int *format=0,
+                                uint32_t *channels=0,
+                                uint32_t *sampleRate=0,
+                                status_t *status=0) {
+                                return openOutputStream(devices, format, channels, sampleRate,
+                                        status);
+                            }
     virtual    void        closeOutputStream(AudioStreamOut* out);
 
     virtual AudioStreamIn* openInputStream(
@@ -93,6 +121,19 @@ public:
                                 AudioSystem::audio_in_acoustics acoustics);
     virtual    void        closeInputStream(AudioStreamIn* in);
 
+    virtual status_t    setMasterMute(bool muted) { return NO_ERROR; }
+    // no audio patches or ports
+    virtual int         createAudioPatch(unsigned int num_sources,
+                                         const struct audio_port_config *sources,
+                                         unsigned int num_sinks,
+                                         const struct audio_port_config *sinks,
+                                         audio_patch_handle_t *handle) { return INVALID_OPERATION; }
+    virtual int         releaseAudioPatch(audio_patch_handle_t handle) { return INVALID_OPERATION; }
+    virtual int         getAudioPort(struct audio_port *port) { return INVALID_OPERATION; }
+    virtual int         setAudioPortConfig(const struct audio_port_config *config) {
+                            return INVALID_OPERATION;
+                        }
+
 protected:
     virtual status_t    dump(int fd, const Vector<String16>& args);
 
@@ -0,0 +1,196 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef ANDROID_AUDIO_JITTER_BUFFER_H
+#define ANDROID_AUDIO_JITTER_BUFFER_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <atomic>
+
+#include <utils/Timers.h>
+
+#include "AudioRingBuffer.h"
+
+namespace android_audio_legacy {
+
+// ----------------------------------------------------------------------------
+
+/**
+ * Adaptive-depth jitter buffer between a writer that must never block and a
+ * sender whose sink stalls now and then, like the A2DP link.
+ *
+ * The writer's write() only copies in; a full buffer means the sink has been
+ * stalled for the whole capacity, and the newest audio is dropped. The
+ * sender's read() hands out nothing until the target depth is queued, both
+ * at the start and after running dry, so a stall does not leave it sending
+ * a frame at a time.
+ *
+ * The target rises a step each time the sender runs dry while the writer is
+ * still writing: running dry sets a flag that the next write() counts as an
+ * underrun, so a writer that stopped is not mistaken for a stall. The target
+ * falls a step after an adapt window without the depth coming within a step
+ * of running dry; if the depth stayed above the target for that whole
+ * window, the excess is dropped, so a stall the sink never makes up does not
+ * keep the latency high.
+ *
+ * One thread may write and one other thread may read concurrently, as with
+ * AudioRingBuffer; reset() needs both sides stopped.
+ */
+class AudioJitterBuffer {
+public:
+                        AudioJitterBuffer(size_t capacity, size_t frameSize)
+                            : mRing(capacity), mFrameSize(frameSize), mMinFrames(0),
+                              mMaxFrames(0), mStepFrames(0), mAdaptNs(0), mTargetFrames(0),
+                              mStarved(false), mUnderruns(0), mDroppedFrames(0),
+                              mRebuffering(true), mLowFrames(0), mWindowStartNs(0) {}
+
+            /**
+             * depth limits, the step it moves by and how long it must stay a
+             * step clear of running dry before it falls; starts two steps
+             * above the minimum. Call before either side is active.
+             */
+            void        setDepth(uint32_t minFrames, uint32_t maxFrames, uint32_t stepFrames,
+                                 nsecs_t adaptNs) {
+                            mMinFrames = minFrames;
+                            mMaxFrames = maxFrames > minFrames ? maxFrames : minFrames;
+                            mStepFrames = stepFrames;
+                            mAdaptNs = adaptNs;
+                            uint32_t target = minFrames + 2 * stepFrames;
+                            mTargetFrames.store(target < mMaxFrames ? target : mMaxFrames);
+                        }
+
+            uint32_t    targetFrames() const { return mTargetFrames.load(); }
+            uint32_t    minFrames() const { return mMinFrames; }
+            uint32_t    maxFrames() const { return mMaxFrames; }
+            size_t      capacityFrames() const { return mRing.capacity() / mFrameSize; }
+            /** frames queued now; exact from the reader, a snapshot elsewhere */
+            size_t      queuedFrames() const {
+                            uint64_t read = mRing.totalRead();
+                            return (size_t)(mRing.totalWritten() - read) / mFrameSize;
+                        }
+            uint32_t    underruns() const { return mUnderruns.load(std::memory_order_relaxed); }
+            /** frames dropped because the buffer was full or trimmed */
+            uint64_t    droppedFrames() const {
+                            return mDroppedFrames.load(std::memory_order_relaxed);
+                        }
+
+            /** writer: copy in frames; returns how many fitted */
+            size_t      write(const void *buffer, size_t frames) {
+                            // the sender ran dry and the writer is still going,
+                            // so it was heard
+                            if (mStarved.exchange(false)) {
+                                mUnderruns.fetch_add(1, std::memory_order_relaxed);
+                                stepTarget(true);
+                            }
+                            size_t written = mRing.write(buffer, frames * mFrameSize) / mFrameSize;
+                            if (written < frames) {
+                                mDroppedFrames.fetch_add(frames - written,
+                                        std::memory_order_relaxed);
+                            }
+                            return written;
+                        }
+
+            /**
+             * reader: copy out up to frames at time now; returns 0 while
+             * rebuffering to the target depth
+             */
+            size_t      read(void *buffer, size_t frames, nsecs_t now) {
+                            size_t queued = queuedFrames();
+                            if (queued == 0) {
+                                // write() tells this from the writer having stopped
+                                if (!mRebuffering) mStarved.store(true);
+                                mRebuffering = true;
+                                return 0;
+                            }
+                            if (mRebuffering && queued < mTargetFrames.load()) return 0;
+
+                            if (mRebuffering || now - mWindowStartNs > mAdaptNs) {
+                                size_t trim = 0;
+                                if (!mRebuffering) {
+                                    uint32_t target = mTargetFrames.load();
+                                    // a whole window a step clear of running dry
+                                    if (mLowFrames > mStepFrames) stepTarget(false);
+                                    // never down to the target, left over from a
+                                    // stall the sink did not make up
+                                    if (mLowFrames > target) trim = mLowFrames - target;
+                                }
+                                if (trim) {
+                                    trim = mRing.skip(trim * mFrameSize) / mFrameSize;
+                                    mDroppedFrames.fetch_add(trim, std::memory_order_relaxed);
+                                    queued -= trim;
+                                }
+                                mRebuffering = false;
+                                mWindowStartNs = now;
+                                mLowFrames = queued;
+                            }
+                            if (queued < mLowFrames) mLowFrames = queued;
+
+                            if (frames > queued) frames = queued;
+                            return mRing.read(buffer, frames * mFrameSize) / mFrameSize;
+                        }
+
+            /** empty and start over rebuffering; only while neither side is active */
+            void        reset() {
+                            mRing.reset();
+                            mStarved.store(false);
+                            mRebuffering = true;
+                        }
+
+private:
+            void        stepTarget(bool up) {
+                            uint32_t target = mTargetFrames.load();
+                            uint32_t next;
+                            do {
+                                if (up) {
+                                    next = mMaxFrames - target > mStepFrames ?
+                                            target + mStepFrames : mMaxFrames;
+                                } else {
+                                    next = target - mMinFrames > mStepFrames ?
+                                            target - mStepFrames : mMinFrames;
+                                }
+                            } while (next != target &&
+                                    !mTargetFrames.compare_exchange_weak(target, next));
+                        }
+
+                        AudioJitterBuffer(const AudioJitterBuffer &);
+            AudioJitterBuffer& operator=(const AudioJitterBuffer &);
+
+    AudioRingBuffer     mRing;
+    const size_t        mFrameSize;
+    uint32_t            mMinFrames;
+    uint32_t            mMaxFrames;
+    uint32_t            mStepFrames;
+    nsecs_t             mAdaptNs;
+    // raised by the writer, lowered by the reader
+    std::atomic<uint32_t> mTargetFrames;
+    std::atomic<bool>   mStarved;
+    std::atomic<uint32_t> mUnderruns;
+    std::atomic<uint64_t> mDroppedFrames;
+
+    // reader only
+    bool                mRebuffering;
+    uint32_t            mLowFrames;     // least queued since mWindowStartNs
+    nsecs_t             mWindowStartNs;
+};
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
+
+#endif // ANDROID_AUDIO_JITTER_BUFFER_H
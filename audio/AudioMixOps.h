@@ -0,0 +1,686 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef ANDROID_AUDIO_MIX_OPS_H
+#define ANDROID_AUDIO_MIX_OPS_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AUDIO_MIX_OPS_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define AUDIO_MIX_OPS_SSE2 1
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define AUDIO_MIX_OPS_SSSE3 1
+#endif
+#endif
+
+#include <math.h>
+#include <string.h>
+
+namespace android_audio_legacy {
+
+// ----------------------------------------------------------------------------
+
+// Gains are Q1.15; kUnityGainQ15 is treated as exactly 1.0 so that a
+// channel at full volume passes through bit-exact.
+static const int16_t kUnityGainQ15 = 0x7fff;
+
+static inline int16_t clamp16(int32_t sample)
+{
+    if (sample > 32767) return 32767;
+    if (sample < -32768) return -32768;
+    return (int16_t)sample;
+}
+
+static inline int16_t gainToQ15(float gain)
+{
+    if (!(gain > 0.0f)) return 0;
+    if (gain >= 1.0f) return kUnityGainQ15;
+    int32_t q = (int32_t)(gain * 32768.0f + 0.5f);
+    return q >= kUnityGainQ15 ? kUnityGainQ15 : (int16_t)q;
+}
+
+/** product of two Q15 gains, keeping kUnityGainQ15 exact */
+static inline int16_t mulGainQ15(int16_t a, int16_t b)
+{
+    if (a == kUnityGainQ15) return b;
+    if (b == kUnityGainQ15) return a;
+    return (int16_t)((a * b + 0x4000) >> 15);
+}
+
+/**
+ * dst[i] = sat16(dst[i] + round(src[i] * gain)) over interleaved stereo,
+ * with gainLeft applied to even samples and gainRight to odd ones.
+ * Reference version; the vector paths below match it bit for bit.
+ */
+static inline void mixStereo16Scalar(int16_t *dst, const int16_t *src, size_t frames,
+        int16_t gainLeft, int16_t gainRight)
+{
+    for (size_t i = 0; i < frames * 2; i += 2) {
+        int32_t l = src[i], r = src[i + 1];
+        if (gainLeft != kUnityGainQ15) l = (l * gainLeft + 0x4000) >> 15;
+        if (gainRight != kUnityGainQ15) r = (r * gainRight + 0x4000) >> 15;
+        dst[i] = clamp16(dst[i] + l);
+        dst[i + 1] = clamp16(dst[i + 1] + r);
+    }
+}
+
+/** mixStereo16Scalar() using saturating SIMD adds, 4 frames per step. */
+static inline void mixStereo16(int16_t *dst, const int16_t *src, size_t frames,
+        int16_t gainLeft, int16_t gainRight)
+{
+    size_t i = 0;
+    const size_t samples = frames * 2;
+    const bool unity = gainLeft == kUnityGainQ15 && gainRight == kUnityGainQ15;
+#if defined(AUDIO_MIX_OPS_NEON)
+    const int16_t g[8] = { gainLeft, gainRight, gainLeft, gainRight,
+                           gainLeft, gainRight, gainLeft, gainRight };
+    const int16x8_t gain = vld1q_s16(g);
+    const uint16x8_t keep = vceqq_s16(gain, vdupq_n_s16(kUnityGainQ15));
+    for (; i + 8 <= samples; i += 8) {
+        int16x8_t s = vld1q_s16(src + i);
+        // vqrdmulh computes sat((2*s*g + 0x8000) >> 16), the same rounding
+        // as the scalar path; it only saturates for s == g == -32768.
+        if (!unity) s = vbslq_s16(keep, s, vqrdmulhq_s16(s, gain));
+        vst1q_s16(dst + i, vqaddq_s16(vld1q_s16(dst + i), s));
+    }
+#elif defined(AUDIO_MIX_OPS_SSE2)
+    const __m128i gain = _mm_set_epi16(gainRight, gainLeft, gainRight, gainLeft,
+                                       gainRight, gainLeft, gainRight, gainLeft);
+    const __m128i round = _mm_set1_epi32(0x4000);
+    const __m128i keep = _mm_cmpeq_epi16(gain, _mm_set1_epi16(kUnityGainQ15));
+    for (; i + 8 <= samples; i += 8) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        if (!unity) {
+            // full 32-bit products, rounded and narrowed back with saturation
+            __m128i lo = _mm_mullo_epi16(s, gain);
+            __m128i hi = _mm_mulhi_epi16(s, gain);
+            __m128i p0 = _mm_srai_epi32(_mm_add_epi32(_mm_unpacklo_epi16(lo, hi), round), 15);
+            __m128i p1 = _mm_srai_epi32(_mm_add_epi32(_mm_unpackhi_epi16(lo, hi), round), 15);
+            __m128i p = _mm_packs_epi32(p0, p1);
+            s = _mm_or_si128(_mm_and_si128(keep, s), _mm_andnot_si128(keep, p));
+        }
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_adds_epi16(d, s));
+    }
+#endif
+    if (i < samples) {
+        mixStereo16Scalar(dst + i, src + i, (samples - i) / 2, gainLeft, gainRight);
+    }
+}
+
+/**
+ * In-place gain over interleaved stereo, ramping linearly: frame i is scaled
+ * by (left + (i + 1) * stepLeft) >> 16 on the left, likewise on the right.
+ * left, right and the gains along the ramp are Q15 << 16; a Q15 gain of
+ * kUnityGainQ15 passes samples through unchanged, as in mixStereo16Scalar().
+ * Steps of 0 apply a fixed gain.
+ */
+static inline void applyGainStereo16Scalar(int16_t *buf, size_t frames,
+        int32_t left, int32_t right, int32_t stepLeft, int32_t stepRight)
+{
+    for (size_t i = 0; i < frames; i++) {
+        left += stepLeft;
+        right += stepRight;
+        int32_t gl = left >> 16, gr = right >> 16;
+        if (gl != kUnityGainQ15) buf[2 * i] = (int16_t)((buf[2 * i] * gl + 0x4000) >> 15);
+        if (gr != kUnityGainQ15) buf[2 * i + 1] = (int16_t)((buf[2 * i + 1] * gr + 0x4000) >> 15);
+    }
+}
+
+/** applyGainStereo16Scalar() with the gains of 4 frames computed per step. */
+static inline void applyGainStereo16(int16_t *buf, size_t frames,
+        int32_t left, int32_t right, int32_t stepLeft, int32_t stepRight)
+{
+    size_t i = 0;
+#if defined(AUDIO_MIX_OPS_NEON)
+    const int32_t g0[4] = { left + stepLeft, right + stepRight,
+                            left + 2 * stepLeft, right + 2 * stepRight };
+    const int32_t d[4] = { 4 * stepLeft, 4 * stepRight, 4 * stepLeft, 4 * stepRight };
+    int32x4_t gain01 = vld1q_s32(g0);
+    const int32x4_t step4 = vld1q_s32(d);
+    int32x4_t gain23 = vaddq_s32(gain01, vshrq_n_s32(step4, 1));
+    const int16x8_t unity = vdupq_n_s16(kUnityGainQ15);
+    for (; i + 4 <= frames; i += 4) {
+        int16x8_t gain = vcombine_s16(vshrn_n_s32(gain01, 16), vshrn_n_s32(gain23, 16));
+        int16x8_t s = vld1q_s16(buf + 2 * i);
+        // vqrdmulh rounds like the scalar path, see mixStereo16()
+        vst1q_s16(buf + 2 * i, vbslq_s16(vceqq_s16(gain, unity), s, vqrdmulhq_s16(s, gain)));
+        gain01 = vaddq_s32(gain01, step4);
+        gain23 = vaddq_s32(gain23, step4);
+    }
+#elif defined(AUDIO_MIX_OPS_SSE2)
+    __m128i gain01 = _mm_set_epi32(right + 2 * stepRight, left + 2 * stepLeft,
+                                   right + stepRight, left + stepLeft);
+    const __m128i step4 = _mm_set_epi32(4 * stepRight, 4 * stepLeft, 4 * stepRight, 4 * stepLeft);
+    __m128i gain23 = _mm_add_epi32(gain01, _mm_srai_epi32(step4, 1));
+    const __m128i unity = _mm_set1_epi16(kUnityGainQ15);
+    const __m128i round = _mm_set1_epi32(0x4000);
+    for (; i + 4 <= frames; i += 4) {
+        // gains are at most 0x7fff << 16, so the signed pack never saturates
+        __m128i gain = _mm_packs_epi32(_mm_srai_epi32(gain01, 16), _mm_srai_epi32(gain23, 16));
+        __m128i s = _mm_loadu_si128((const __m128i *)(buf + 2 * i));
+        __m128i lo = _mm_mullo_epi16(s, gain);
+        __m128i hi = _mm_mulhi_epi16(s, gain);
+        __m128i p0 = _mm_srai_epi32(_mm_add_epi32(_mm_unpacklo_epi16(lo, hi), round), 15);
+        __m128i p1 = _mm_srai_epi32(_mm_add_epi32(_mm_unpackhi_epi16(lo, hi), round), 15);
+        __m128i keep = _mm_cmpeq_epi16(gain, unity);
+        __m128i p = _mm_packs_epi32(p0, p1);
+        _mm_storeu_si128((__m128i *)(buf + 2 * i),
+                _mm_or_si128(_mm_and_si128(keep, s), _mm_andnot_si128(keep, p)));
+        gain01 = _mm_add_epi32(gain01, step4);
+        gain23 = _mm_add_epi32(gain23, step4);
+    }
+#endif
+    if (i < frames) {
+        applyGainStereo16Scalar(buf + 2 * i, frames - i, left + (int32_t)i * stepLeft,
+                right + (int32_t)i * stepRight, stepLeft, stepRight);
+    }
+}
+
+/**
+ * Two dot products of x against h0 and h1 at once, e.g. adjacent phases of
+ * a polyphase filter, so x is only loaded once. n must be a multiple of 8.
+ */
+static inline void dot16x2Scalar(const int16_t *x, const int16_t *h0, const int16_t *h1,
+        size_t n, int32_t *r0, int32_t *r1)
+{
+    int32_t a0 = 0, a1 = 0;
+    for (size_t i = 0; i < n; i++) {
+        a0 += x[i] * h0[i];
+        a1 += x[i] * h1[i];
+    }
+    *r0 = a0;
+    *r1 = a1;
+}
+
+static inline void dot16x2(const int16_t *x, const int16_t *h0, const int16_t *h1,
+        size_t n, int32_t *r0, int32_t *r1)
+{
+#if defined(AUDIO_MIX_OPS_NEON)
+    int32x4_t a0 = vdupq_n_s32(0), a1 = vdupq_n_s32(0);
+    for (size_t i = 0; i < n; i += 8) {
+        int16x8_t v = vld1q_s16(x + i);
+        int16x8_t c0 = vld1q_s16(h0 + i);
+        int16x8_t c1 = vld1q_s16(h1 + i);
+        a0 = vmlal_s16(a0, vget_low_s16(v), vget_low_s16(c0));
+        a0 = vmlal_s16(a0, vget_high_s16(v), vget_high_s16(c0));
+        a1 = vmlal_s16(a1, vget_low_s16(v), vget_low_s16(c1));
+        a1 = vmlal_s16(a1, vget_high_s16(v), vget_high_s16(c1));
+    }
+    int32x2_t s = vpadd_s32(vadd_s32(vget_low_s32(a0), vget_high_s32(a0)),
+                            vadd_s32(vget_low_s32(a1), vget_high_s32(a1)));
+    *r0 = vget_lane_s32(s, 0);
+    *r1 = vget_lane_s32(s, 1);
+#elif defined(AUDIO_MIX_OPS_SSE2)
+    __m128i a0 = _mm_setzero_si128(), a1 = _mm_setzero_si128();
+    for (size_t i = 0; i < n; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(x + i));
+        a0 = _mm_add_epi32(a0, _mm_madd_epi16(v, _mm_loadu_si128((const __m128i *)(h0 + i))));
+        a1 = _mm_add_epi32(a1, _mm_madd_epi16(v, _mm_loadu_si128((const __m128i *)(h1 + i))));
+    }
+    // interleave the two accumulators, then fold twice: lane 0 is r0, lane 1 r1
+    __m128i s = _mm_add_epi32(_mm_unpacklo_epi32(a0, a1), _mm_unpackhi_epi32(a0, a1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    *r0 = _mm_cvtsi128_si32(s);
+    *r1 = _mm_cvtsi128_si32(_mm_shuffle_epi32(s, _MM_SHUFFLE(1, 1, 1, 1)));
+#else
+    dot16x2Scalar(x, h0, h1, n, r0, r1);
+#endif
+}
+
+// Format conversion. Wide formats are first brought to AUDIO_FORMAT_PCM_8_24_BIT
+// (Q8.23: 1.0 is 1 << 23, with 8 bits of headroom) and then narrowed to 16
+// bits in a single place, so rounding and dither are the same for all of them.
+
+/** float to Q8.23, rounding to nearest; out of range input clamps at +/-127.0 */
+static inline void convertFloatTo8_24Scalar(int32_t *dst, const float *src, size_t samples)
+{
+    for (size_t i = 0; i < samples; i++) {
+        float f = src[i];
+        // written so that NaN goes to the positive rail, like the SSE2 path
+        if (!(f < 127.0f)) f = 127.0f;
+        else if (f < -127.0f) f = -127.0f;
+        dst[i] = (int32_t)lrintf(f * 8388608.0f);
+    }
+}
+
+static inline void convertFloatTo8_24(int32_t *dst, const float *src, size_t samples)
+{
+    size_t i = 0;
+#if defined(AUDIO_MIX_OPS_NEON)
+    const float32x4_t hi = vdupq_n_f32(127.0f), lo = vdupq_n_f32(-127.0f);
+    for (; i + 4 <= samples; i += 4) {
+        float32x4_t f = vmulq_n_f32(vmaxq_f32(vminq_f32(vld1q_f32(src + i), hi), lo), 8388608.0f);
+#if defined(__aarch64__)
+        vst1q_s32(dst + i, vcvtnq_s32_f32(f));
+#else
+        // ARMv7 only truncates; the difference is below 2^-23
+        vst1q_s32(dst + i, vcvtq_s32_f32(f));
+#endif
+    }
+#elif defined(AUDIO_MIX_OPS_SSE2)
+    const __m128 hi = _mm_set1_ps(127.0f), lo = _mm_set1_ps(-127.0f);
+    const __m128 scale = _mm_set1_ps(8388608.0f);
+    for (; i + 4 <= samples; i += 4) {
+        __m128 f = _mm_max_ps(_mm_min_ps(_mm_loadu_ps(src + i), hi), lo);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_cvtps_epi32(_mm_mul_ps(f, scale)));
+    }
+#endif
+    if (i < samples) convertFloatTo8_24Scalar(dst + i, src + i, samples - i);
+}
+
+/** AUDIO_FORMAT_PCM_32_BIT (Q0.31) to Q8.23, truncating */
+static inline void convert32To8_24Scalar(int32_t *dst, const int32_t *src, size_t samples)
+{
+    for (size_t i = 0; i < samples; i++) {
+        dst[i] = src[i] >> 8;
+    }
+}
+
+static inline void convert32To8_24(int32_t *dst, const int32_t *src, size_t samples)
+{
+    size_t i = 0;
+#if defined(AUDIO_MIX_OPS_NEON)
+    for (; i + 4 <= samples; i += 4) {
+        vst1q_s32(dst + i, vshrq_n_s32(vld1q_s32(src + i), 8));
+    }
+#elif defined(AUDIO_MIX_OPS_SSE2)
+    for (; i + 4 <= samples; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_srai_epi32(v, 8));
+    }
+#endif
+    if (i < samples) convert32To8_24Scalar(dst + i, src + i, samples - i);
+}
+
+/** little endian 24-bit packed to Q8.23, which is just a sign extension */
+static inline void convertPacked24To8_24Scalar(int32_t *dst, const uint8_t *src, size_t samples)
+{
+    for (size_t i = 0; i < samples; i++, src += 3) {
+        dst[i] = (int32_t)((uint32_t)src[0] << 8 | (uint32_t)src[1] << 16 |
+                (uint32_t)src[2] << 24) >> 8;
+    }
+}
+
+static inline void convertPacked24To8_24(int32_t *dst, const uint8_t *src, size_t samples)
+{
+    size_t i = 0;
+#if defined(AUDIO_MIX_OPS_NEON)
+    for (; i + 8 <= samples; i += 8) {
+        uint8x8x3_t b = vld3_u8(src + i * 3);
+        // top 16 bits as a signed value, then the low byte below them
+        int16x8_t top = vreinterpretq_s16_u16(vorrq_u16(vmovl_u8(b.val[1]), vshll_n_u8(b.val[2], 8)));
+        uint16x8_t low = vmovl_u8(b.val[0]);
+        vst1q_s32(dst + i, vorrq_s32(vshll_n_s16(vget_low_s16(top), 8),
+                vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(low)))));
+        vst1q_s32(dst + i + 4, vorrq_s32(vshll_n_s16(vget_high_s16(top), 8),
+                vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(low)))));
+    }
+#elif defined(AUDIO_MIX_OPS_SSSE3)
+    // each sample's three bytes to the top of a 32-bit lane, then shift down
+    const __m128i shuffle = _mm_set_epi8(11, 10, 9, -1, 8, 7, 6, -1, 5, 4, 3, -1, 2, 1, 0, -1);
+    // 16-byte loads for 12 bytes of input: stop before reading past the end
+    for (; i + 6 <= samples; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + i * 3));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_srai_epi32(_mm_shuffle_epi8(v, shuffle), 8));
+    }
+#endif
+    if (i < samples) convertPacked24To8_24Scalar(dst + i, src + i * 3, samples - i);
+}
+
+/**
+ * TPDF dither for convert8_24To16(): four xorshift32 generators, one per
+ * vector lane, so the scalar and SIMD paths produce the same sequence.
+ */
+struct AudioDither {
+    uint32_t state[4];
+
+    AudioDither() { seed(0x9e3779b9); }
+    void seed(uint32_t s) {
+        for (int i = 0; i < 4; i++) {
+            s = s * 1664525 + 1013904223;
+            state[i] = s ? s : 1;
+        }
+    }
+    void step() {
+        for (int i = 0; i < 4; i++) {
+            uint32_t x = state[i];
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            state[i] = x;
+        }
+    }
+    // two 8-bit uniform values summed: triangular, +/-1 LSB of 16-bit in Q8.23
+    int32_t tpdf(int lane) const {
+        return (int32_t)(state[lane] >> 24) + (int32_t)((state[lane] >> 16) & 0xff) - 255;
+    }
+};
+
+/**
+ * Q8.23 to 16-bit, rounding to nearest with saturation. With dither, TPDF
+ * noise of +/-1 LSB is added first; the generators step once per 4 samples.
+ */
+static inline void convert8_24To16Scalar(int16_t *dst, const int32_t *src, size_t samples,
+        AudioDither *dither)
+{
+    for (size_t i = 0; i < samples; i++) {
+        int32_t x = src[i];
+        if (dither != 0) {
+            if ((i & 3) == 0) dither->step();
+            x += dither->tpdf(i & 3);
+        }
+        // (x + 128) >> 8 without the add overflowing
+        dst[i] = clamp16(((x >> 7) + 1) >> 1);
+    }
+}
+
+static inline void convert8_24To16(int16_t *dst, const int32_t *src, size_t samples,
+        AudioDither *dither)
+{
+    size_t i = 0;
+#if defined(AUDIO_MIX_OPS_NEON)
+    uint32x4_t state = dither != 0 ? vld1q_u32(dither->state) : vdupq_n_u32(0);
+    const int32x4_t bias = vdupq_n_s32(255);
+    for (; i + 8 <= samples; i += 8) {
+        int32x4_t x0 = vld1q_s32(src + i), x1 = vld1q_s32(src + i + 4);
+        if (dither != 0) {
+            for (int k = 0; k < 2; k++) {
+                state = veorq_u32(state, vshlq_n_u32(state, 13));
+                state = veorq_u32(state, vshrq_n_u32(state, 17));
+                state = veorq_u32(state, vshlq_n_u32(state, 5));
+                int32x4_t d = vsubq_s32(vreinterpretq_s32_u32(vaddq_u32(vshrq_n_u32(state, 24),
+                        vandq_u32(vshrq_n_u32(state, 16), vdupq_n_u32(0xff)))), bias);
+                if (k == 0) x0 = vaddq_s32(x0, d); else x1 = vaddq_s32(x1, d);
+            }
+        }
+        // rounding, saturating narrow: exactly clamp16((x + 128) >> 8)
+        vst1q_s16(dst + i, vcombine_s16(vqrshrn_n_s32(x0, 8), vqrshrn_n_s32(x1, 8)));
+    }
+    if (dither != 0) vst1q_u32(dither->state, state);
+#elif defined(AUDIO_MIX_OPS_SSE2)
+    __m128i state = dither != 0 ?
+            _mm_loadu_si128((const __m128i *)dither->state) : _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i mask = _mm_set1_epi32(0xff);
+    const __m128i bias = _mm_set1_epi32(255);
+    for (; i + 8 <= samples; i += 8) {
+        __m128i x[2];
+        x[0] = _mm_loadu_si128((const __m128i *)(src + i));
+        x[1] = _mm_loadu_si128((const __m128i *)(src + i + 4));
+        for (int k = 0; k < 2; k++) {
+            if (dither != 0) {
+                state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+                state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+                state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+                __m128i d = _mm_add_epi32(_mm_srli_epi32(state, 24),
+                        _mm_and_si128(_mm_srli_epi32(state, 16), mask));
+                x[k] = _mm_add_epi32(x[k], _mm_sub_epi32(d, bias));
+            }
+            x[k] = _mm_srai_epi32(_mm_add_epi32(_mm_srai_epi32(x[k], 7), one), 1);
+        }
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packs_epi32(x[0], x[1]));
+    }
+    if (dither != 0) _mm_storeu_si128((__m128i *)dither->state, state);
+#endif
+    if (i < samples) convert8_24To16Scalar(dst + i, src + i, samples - i, dither);
+}
+
+/** mono to interleaved stereo, both channels the same */
+static inline void upmixMonoToStereo16Scalar(int16_t *dst, const int16_t *src, size_t frames)
+{
+    for (size_t i = 0; i < frames; i++) {
+        dst[2 * i] = dst[2 * i + 1] = src[i];
+    }
+}
+
+static inline void upmixMonoToStereo16(int16_t *dst, const int16_t *src, size_t frames)
+{
+    size_t i = 0;
+#if defined(AUDIO_MIX_OPS_NEON)
+    for (; i + 8 <= frames; i += 8) {
+        int16x8x2_t v;
+        v.val[0] = v.val[1] = vld1q_s16(src + i);
+        vst2q_s16(dst + 2 * i, v);
+    }
+#elif defined(AUDIO_MIX_OPS_SSE2)
+    for (; i + 8 <= frames; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+        _mm_storeu_si128((__m128i *)(dst + 2 * i), _mm_unpacklo_epi16(v, v));
+        _mm_storeu_si128((__m128i *)(dst + 2 * i + 8), _mm_unpackhi_epi16(v, v));
+    }
+#endif
+    if (i < frames) upmixMonoToStereo16Scalar(dst + 2 * i, src + i, frames - i);
+}
+
+/** interleaved stereo to mono as (left + right) >> 1, which cannot clip */
+static inline void downmixStereoToMono16Scalar(int16_t *dst, const int16_t *src, size_t frames)
+{
+    for (size_t i = 0; i < frames; i++) {
+        dst[i] = (int16_t)(((int32_t)src[2 * i] + src[2 * i + 1]) >> 1);
+    }
+}
+
+static inline void downmixStereoToMono16(int16_t *dst, const int16_t *src, size_t frames)
+{
+    size_t i = 0;
+#if defined(AUDIO_MIX_OPS_NEON)
+    for (; i + 8 <= frames; i += 8) {
+        int16x8x2_t v = vld2q_s16(src + 2 * i);
+        vst1q_s16(dst + i, vhaddq_s16(v.val[0], v.val[1]));
+    }
+#elif defined(AUDIO_MIX_OPS_SSE2)
+    const __m128i ones = _mm_set1_epi16(1);
+    for (; i + 8 <= frames; i += 8) {
+        // madd against 1s sums each left/right pair into 32 bits
+        __m128i s0 = _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(src + 2 * i)), ones);
+        __m128i s1 = _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(src + 2 * i + 8)), ones);
+        _mm_storeu_si128((__m128i *)(dst + i),
+                _mm_packs_epi32(_mm_srai_epi32(s0, 1), _mm_srai_epi32(s1, 1)));
+    }
+#endif
+    if (i < frames) downmixStereoToMono16Scalar(dst + i, src + 2 * i, frames - i);
+}
+
+/**
+ * Fold srcChannels (at most 8) interleaved channels to dstChannels (1 or 2)
+ * with Q13 weights: matrix[d][c] is the weight of source channel c in
+ * device channel d, and must be 0 for c >= srcChannels. The weights of a
+ * row must sum to less than 8.0 so the 32-bit accumulator cannot overflow.
+ */
+static inline void remix16Scalar(int16_t *dst, uint32_t dstChannels, const int16_t *src,
+        uint32_t srcChannels, const int16_t matrix[2][8], size_t frames)
+{
+    for (size_t i = 0; i < frames; i++, src += srcChannels) {
+        for (uint32_t d = 0; d < dstChannels; d++) {
+            int32_t acc = 0;
+            for (uint32_t c = 0; c < srcChannels; c++) {
+                acc += src[c] * matrix[d][c];
+            }
+            *dst++ = clamp16((acc + (1 << 12)) >> 13);
+        }
+    }
+}
+
+/** remix16Scalar() one frame per step: a whole frame is one vector load. */
+static inline void remix16(int16_t *dst, uint32_t dstChannels, const int16_t *src,
+        uint32_t srcChannels, const int16_t matrix[2][8], size_t frames)
+{
+    size_t i = 0;
+#if defined(AUDIO_MIX_OPS_NEON)
+    const int16x8_t wl = vld1q_s16(matrix[0]), wr = vld1q_s16(matrix[1]);
+    // the 8-sample load runs past the frame, so stop short of the end
+    for (; i * srcChannels + 8 <= frames * srcChannels; i++) {
+        int16x8_t v = vld1q_s16(src + i * srcChannels);
+        int32x4_t l = vmlal_s16(vmull_s16(vget_low_s16(v), vget_low_s16(wl)),
+                vget_high_s16(v), vget_high_s16(wl));
+        int32x4_t r = vmlal_s16(vmull_s16(vget_low_s16(v), vget_low_s16(wr)),
+                vget_high_s16(v), vget_high_s16(wr));
+        int32x2_t lr = vpadd_s32(vadd_s32(vget_low_s32(l), vget_high_s32(l)),
+                                 vadd_s32(vget_low_s32(r), vget_high_s32(r)));
+        int16x4_t out = vqrshrn_n_s32(vcombine_s32(lr, lr), 13);
+        dst[i * dstChannels] = vget_lane_s16(out, 0);
+        if (dstChannels == 2) dst[i * 2 + 1] = vget_lane_s16(out, 1);
+    }
+#elif defined(AUDIO_MIX_OPS_SSE2)
+    const __m128i wl = _mm_loadu_si128((const __m128i *)matrix[0]);
+    const __m128i wr = _mm_loadu_si128((const __m128i *)matrix[1]);
+    const __m128i round = _mm_set1_epi32(1 << 12);
+    for (; i * srcChannels + 8 <= frames * srcChannels; i++) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + i * srcChannels));
+        __m128i l = _mm_madd_epi16(v, wl);
+        __m128i r = _mm_madd_epi16(v, wr);
+        // as in dot16x2(): lanes 0 and 1 end up holding the left and right sums
+        __m128i s = _mm_add_epi32(_mm_unpacklo_epi32(l, r), _mm_unpackhi_epi32(l, r));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+        s = _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(s, round), 13), s);
+        int32_t out = _mm_cvtsi128_si32(s);
+        dst[i * dstChannels] = (int16_t)out;
+        if (dstChannels == 2) dst[i * 2 + 1] = (int16_t)(out >> 16);
+    }
+#endif
+    if (i < frames) {
+        remix16Scalar(dst + i * dstChannels, dstChannels, src + i * srcChannels, srcChannels,
+                matrix, frames - i);
+    }
+}
+
+// Test signal generation.
+
+/**
+ * sin(2 * pi * phase) to 16 bits at the given amplitude (at most 1.0),
+ * rounding to nearest. Phases are in cycles and must be in [0, 1). A
+ * degree 9 polynomial after folding into a quarter cycle, good to well
+ * under an LSB.
+ */
+static inline void sineCycles16Scalar(int16_t *dst, const float *phase, size_t samples,
+        float amplitude)
+{
+    const float scale = amplitude * 32767.0f;
+    for (size_t i = 0; i < samples; i++) {
+        float x = phase[i];
+        if (x > 0.5f) x -= 1.0f;
+        x = fmaxf(fminf(x, 0.5f - x), -0.5f - x);
+        float y = x * 6.28318531f;
+        float y2 = y * y;
+        float p = -1.0f / 362880.0f * y2 + 1.0f / 5040.0f;
+        p = p * y2 - 1.0f / 120.0f;
+        p = p * y2 + 1.0f / 6.0f;
+        float sine = y - y * y2 * p;
+        dst[i] = clamp16((int32_t)lrintf(sine * scale));
+    }
+}
+
+static inline void sineCycles16(int16_t *dst, const float *phase, size_t samples,
+        float amplitude)
+{
+    size_t i = 0;
+#if defined(AUDIO_MIX_OPS_NEON)
+    const float32x4_t half = vdupq_n_f32(0.5f), one = vdupq_n_f32(1.0f);
+    for (; i + 4 <= samples; i += 4) {
+        float32x4_t x = vld1q_f32(phase + i);
+        x = vsubq_f32(x, vreinterpretq_f32_u32(
+                vandq_u32(vcgtq_f32(x, half), vreinterpretq_u32_f32(one))));
+        x = vmaxq_f32(vminq_f32(x, vsubq_f32(half, x)), vsubq_f32(vnegq_f32(half), x));
+        float32x4_t y = vmulq_n_f32(x, 6.28318531f);
+        float32x4_t y2 = vmulq_f32(y, y);
+        float32x4_t p = vaddq_f32(vmulq_n_f32(y2, -1.0f / 362880.0f), vdupq_n_f32(1.0f / 5040.0f));
+        p = vsubq_f32(vmulq_f32(p, y2), vdupq_n_f32(1.0f / 120.0f));
+        p = vaddq_f32(vmulq_f32(p, y2), vdupq_n_f32(1.0f / 6.0f));
+        float32x4_t sine = vmulq_n_f32(vsubq_f32(y, vmulq_f32(vmulq_f32(y, y2), p)),
+                amplitude * 32767.0f);
+#if defined(__aarch64__)
+        vst1_s16(dst + i, vqmovn_s32(vcvtnq_s32_f32(sine)));
+#else
+        // ARMv7 only truncates, so at most an LSB off the scalar result
+        vst1_s16(dst + i, vqmovn_s32(vcvtq_s32_f32(sine)));
+#endif
+    }
+#elif defined(AUDIO_MIX_OPS_SSE2)
+    const __m128 half = _mm_set1_ps(0.5f), minusHalf = _mm_set1_ps(-0.5f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(amplitude * 32767.0f);
+    for (; i + 4 <= samples; i += 4) {
+        __m128 x = _mm_loadu_ps(phase + i);
+        x = _mm_sub_ps(x, _mm_and_ps(_mm_cmpgt_ps(x, half), one));
+        x = _mm_max_ps(_mm_min_ps(x, _mm_sub_ps(half, x)), _mm_sub_ps(minusHalf, x));
+        __m128 y = _mm_mul_ps(x, _mm_set1_ps(6.28318531f));
+        __m128 y2 = _mm_mul_ps(y, y);
+        __m128 p = _mm_add_ps(_mm_mul_ps(y2, _mm_set1_ps(-1.0f / 362880.0f)),
+                _mm_set1_ps(1.0f / 5040.0f));
+        p = _mm_sub_ps(_mm_mul_ps(p, y2), _mm_set1_ps(1.0f / 120.0f));
+        p = _mm_add_ps(_mm_mul_ps(p, y2), _mm_set1_ps(1.0f / 6.0f));
+        __m128 sine = _mm_sub_ps(y, _mm_mul_ps(_mm_mul_ps(y, y2), p));
+        __m128i v = _mm_cvtps_epi32(_mm_mul_ps(sine, scale));
+        _mm_storel_epi64((__m128i *)(dst + i), _mm_packs_epi32(v, v));
+    }
+#endif
+    if (i < samples) sineCycles16Scalar(dst + i, phase + i, samples - i, amplitude);
+}
+
+/**
+ * White noise from the AudioDither generators, which step once per 4
+ * samples: the top 16 bits of each, shifted down by attenuation bits.
+ */
+static inline void noise16Scalar(int16_t *dst, size_t samples, AudioDither *state,
+        int attenuation)
+{
+    for (size_t i = 0; i < samples; i++) {
+        if ((i & 3) == 0) state->step();
+        dst[i] = (int16_t)((int32_t)state->state[i & 3] >> (16 + attenuation));
+    }
+}
+
+static inline void noise16(int16_t *dst, size_t samples, AudioDither *state, int attenuation)
+{
+    size_t i = 0;
+#if defined(AUDIO_MIX_OPS_NEON)
+    uint32x4_t x = vld1q_u32(state->state);
+    const int32x4_t shift = vdupq_n_s32(-(16 + attenuation));
+    for (; i + 4 <= samples; i += 4) {
+        x = veorq_u32(x, vshlq_n_u32(x, 13));
+        x = veorq_u32(x, vshrq_n_u32(x, 17));
+        x = veorq_u32(x, vshlq_n_u32(x, 5));
+        vst1_s16(dst + i, vmovn_s32(vshlq_s32(vreinterpretq_s32_u32(x), shift)));
+    }
+    vst1q_u32(state->state, x);
+#elif defined(AUDIO_MIX_OPS_SSE2)
+    __m128i x = _mm_loadu_si128((const __m128i *)state->state);
+    const __m128i shift = _mm_cvtsi32_si128(16 + attenuation);
+    for (; i + 4 <= samples; i += 4) {
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+        x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+        __m128i v = _mm_sra_epi32(x, shift);
+        _mm_storel_epi64((__m128i *)(dst + i), _mm_packs_epi32(v, v));
+    }
+    _mm_storeu_si128((__m128i *)state->state, x);
+#endif
+    if (i < samples) noise16Scalar(dst + i, samples - i, state, attenuation);
+}
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
+
+#endif // ANDROID_AUDIO_MIX_OPS_H
@@ -0,0 +1,133 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef ANDROID_AUDIO_PACING_CLOCK_H
+#define ANDROID_AUDIO_PACING_CLOCK_H
+
+#include <errno.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <time.h>
+
+#include <utils/Timers.h>
+
+namespace android_audio_legacy {
+
+// ----------------------------------------------------------------------------
+
+/**
+ * Paces an emulated device at exactly real-time rate.
+ *
+ * Relative sleeps of "this buffer's duration" lose the time spent between
+ * sleeps and the sleep overshoot on every call, so an emulated stream runs
+ * slow forever. Instead, deadlines here are absolute: the start time plus the
+ * duration of all frames paced so far, computed without truncation. A late
+ * wakeup just makes the next sleep shorter.
+ *
+ * If the caller falls more than the lag tolerance (kMaxLagNs by default)
+ * behind, because it stopped writing or the process was stopped, the
+ * timeline restarts instead of bursting to catch up.
+ *
+ * A device that blocks on its own, like the A2DP stack, completes writes
+ * with jitter around real time. setTolerance() lets such a caller run up to
+ * a lead ahead of the timeline before it is held back, and catch up from a
+ * stall up to a larger lag, so the device's own pacing is left alone and
+ * only a device taking audio faster than real time is slowed down.
+ */
+class AudioPacingClock {
+public:
+                        AudioPacingClock()
+                            : mSampleRate(0), mFrames(0), mStartNs(0),
+                              mMaxLeadNs(0), mMaxLagNs(kMaxLagNs) {}
+    virtual             ~AudioPacingClock() {}
+
+            /** account for frames at sampleRate and sleep until they are due */
+            void        pace(uint32_t frames, uint32_t sampleRate) {
+                            sleepUntil(advance(frames, sampleRate));
+                        }
+
+            /**
+             * account for frames at sampleRate without sleeping; returns the
+             * deadline to pass to sleepUntil(), or 0 if they are not early
+             */
+            nsecs_t     advance(uint32_t frames, uint32_t sampleRate) {
+                            nsecs_t now = nowNs();
+                            if (mStartNs == 0 || sampleRate != mSampleRate) {
+                                mSampleRate = sampleRate;
+                                mFrames = 0;
+                                mStartNs = now;
+                            }
+                            mFrames += frames;
+                            nsecs_t deadline = mStartNs + framesToNs(mFrames);
+                            if (now - deadline > mMaxLagNs) {
+                                mFrames = frames;
+                                mStartNs = now;
+                                deadline = now + framesToNs(frames);
+                            }
+                            deadline -= mMaxLeadNs;
+                            return deadline > now ? deadline : 0;
+                        }
+
+            /** sleep until a deadline from advance(), which may be 0 */
+            void        sleepUntil(nsecs_t deadline) {
+                            if (deadline != 0) sleepUntilNs(deadline);
+                        }
+
+            /** how far writes may run ahead of and behind the timeline */
+            void        setTolerance(nsecs_t maxLeadNs, nsecs_t maxLagNs) {
+                            mMaxLeadNs = maxLeadNs;
+                            mMaxLagNs = maxLagNs;
+                        }
+
+            /** forget the timeline, e.g. on standby */
+            void        reset() { mStartNs = 0; }
+
+            /** how far the current time is past the last deadline, for diagnostics */
+            nsecs_t     lagNs() {
+                            return mStartNs ? nowNs() - (mStartNs + framesToNs(mFrames)) : 0;
+                        }
+
+protected:
+    virtual nsecs_t     nowNs() { return systemTime(SYSTEM_TIME_MONOTONIC); }
+    virtual void        sleepUntilNs(nsecs_t deadline) {
+                            struct timespec ts;
+                            ts.tv_sec = deadline / 1000000000;
+                            ts.tv_nsec = deadline % 1000000000;
+                            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+                            }
+                        }
+
+private:
+    static const nsecs_t kMaxLagNs = 100000000;
+
+            nsecs_t     framesToNs(uint64_t frames) const {
+                            return (nsecs_t)((frames / mSampleRate) * 1000000000 +
+                                    (frames % mSampleRate) * 1000000000 / mSampleRate);
+                        }
+
+    uint32_t            mSampleRate;
+    uint64_t            mFrames;
+    nsecs_t             mStartNs;
+    nsecs_t             mMaxLeadNs;
+    nsecs_t             mMaxLagNs;
+};
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
+
+#endif // ANDROID_AUDIO_PACING_CLOCK_H
@@ -0,0 +1,170 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef ANDROID_AUDIO_PARAMETER_SCANNER_H
+#define ANDROID_AUDIO_PARAMETER_SCANNER_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include <utils/String8.h>
+
+#include <hardware_legacy/AudioSystemLegacy.h>
+
+namespace android_audio_legacy {
+
+using android::String8;
+
+// ----------------------------------------------------------------------------
+
+/**
+ * Walks the "key1=value1;key2=value2" of set_parameters() and
+ * get_parameters() in place, without copying or allocating.
+ *
+ * Routing and volume changes arrive at a high rate, and AudioParameter
+ * builds a String8 for every key and value, and a sorted vector of them,
+ * only for the few keys a stream knows to be looked up once. Pairs come
+ * out in order; as with AudioParameter, empty ones are skipped, a pair
+ * without '=' is a key with an empty value, and a key given twice should
+ * take its last value.
+ */
+class AudioParameterScanner {
+public:
+    AudioParameterScanner(const char *kvpairs)
+        : mNext(kvpairs != 0 ? kvpairs : ""), mKey(0), mKeyLength(0), mValue(0),
+          mValueLength(0) {}
+
+    /** move to the next pair; false at the end */
+    bool next() {
+        while (*mNext == ';') mNext++;
+        if (*mNext == '\0') return false;
+        mKey = mNext;
+        size_t length = strcspn(mNext, ";");
+        mNext += length;
+        const char *equals = (const char *)memchr(mKey, '=', length);
+        if (equals != 0) {
+            mKeyLength = equals - mKey;
+            mValue = equals + 1;
+            mValueLength = length - mKeyLength - 1;
+        } else {
+            mKeyLength = length;
+            mValue = mNext;
+            mValueLength = 0;
+        }
+        return true;
+    }
+
+    const char  *key() const { return mKey; }
+    size_t      keyLength() const { return mKeyLength; }
+    const char  *value() const { return mValue; }
+    size_t      valueLength() const { return mValueLength; }
+    /** the whole pair, to pass on one that is not handled here */
+    const char  *pair() const { return mKey; }
+    size_t      pairLength() const { return mNext - mKey; }
+
+    bool keyIs(const char *key) const { return equals(mKey, mKeyLength, key); }
+    bool valueIs(const char *value) const { return equals(mValue, mValueLength, value); }
+
+    /**
+     * The value as a decimal integer, read as AudioParameter::getInt()
+     * does: leading space and trailing text are ignored.
+     * BAD_VALUE if it does not start with a number.
+     */
+    status_t valueInt(int *value) const {
+        // the value ends at ';' or the end of the string, where strtol stops
+        char *end;
+        long v = strtol(mValue, &end, 10);
+        if (end == mValue || end > mValue + mValueLength) return BAD_VALUE;
+        *value = (int)v;
+        return NO_ERROR;
+    }
+
+private:
+    static bool equals(const char *s, size_t length, const char *literal) {
+        return strncmp(s, literal, length) == 0 && literal[length] == '\0';
+    }
+
+    const char  *mNext;
+    const char  *mKey;
+    size_t      mKeyLength;
+    const char  *mValue;
+    size_t      mValueLength;
+};
+
+/**
+ * kvpairs with every integer value of key replaced by convert(value), into
+ * out; for the HAL shim to translate routing between device enumerations.
+ * A key given twice has each of its values converted, so none of them is
+ * left in the other enumeration. The rest of kvpairs is copied as it is.
+ * Returns false, leaving out alone, if key is absent or its last value is
+ * not an integer.
+ */
+template <typename Convert>
+static inline bool audioParameterConvertInt(String8 *out, const char *kvpairs, const char *key,
+        Convert convert)
+{
+    AudioParameterScanner scanner(kvpairs);
+    // one allocation, for the String8, whenever the result fits here
+    char buffer[256];
+    size_t length = 0;
+    String8 spilled;
+    bool onStack = true;
+    auto append = [&](const char *s, size_t n) {
+        if (onStack && length + n < sizeof(buffer)) {
+            memcpy(buffer + length, s, n);
+            length += n;
+            return;
+        }
+        if (onStack) {
+            spilled = String8(buffer, length);
+            onStack = false;
+        }
+        spilled.append(s, n);
+    };
+
+    const char *copied = kvpairs;
+    bool lastIsInt = false;
+    while (scanner.next()) {
+        if (!scanner.keyIs(key)) continue;
+        int n;
+        lastIsInt = scanner.valueInt(&n) == NO_ERROR;
+        if (!lastIsInt) continue;
+        char digits[16];
+        int digitsLength = snprintf(digits, sizeof(digits), "%d", (int)convert(n));
+        append(copied, scanner.value() - copied);
+        append(digits, digitsLength);
+        copied = scanner.value() + scanner.valueLength();
+    }
+    if (!lastIsInt) return false;
+
+    append(copied, strlen(copied));
+    if (onStack) {
+        *out = String8(buffer, length);
+    } else {
+        *out = spilled;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
+
+#endif // ANDROID_AUDIO_PARAMETER_SCANNER_H
@@ -0,0 +1,171 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef ANDROID_AUDIO_POSITION_TRACKER_H
+#define ANDROID_AUDIO_POSITION_TRACKER_H
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <time.h>
+
+#include <utils/threads.h>
+#include <utils/Timers.h>
+
+#include <hardware_legacy/AudioSystemLegacy.h>
+
+namespace android_audio_legacy {
+    using android::Mutex;
+
+// ----------------------------------------------------------------------------
+
+/**
+ * Frame counters and CLOCK_MONOTONIC timestamps for an output stream.
+ *
+ * The stream calls advance() each time the device accepts frames. Up to
+ * downstreamFrames of what was accepted are assumed to still be queued in
+ * the driver or codec, so the presentation position lags the written count
+ * by that much.
+ *
+ * A blocking write returns when the device has made room, which is the time
+ * the timestamp wants, plus whatever scheduling delay the writer suffered.
+ * That delay only ever makes an observation late, so the reported time is
+ * the lower envelope of the last kWindow observations, each projected to the
+ * current position at the nominal rate. An observation later than that by
+ * more than kResyncNs is a real stall or underrun and restarts the window.
+ */
+class AudioPositionTracker {
+public:
+                        AudioPositionTracker()
+                            : mSampleRate(44100), mDownstreamFrames(0), mActive(false),
+                              mWritten(0), mBase(0), mLastNs(0), mCount(0) {}
+
+            void        setup(uint32_t sampleRate, uint32_t downstreamFrames) {
+                            android::AutoMutex lock(mLock);
+                            mSampleRate = sampleRate;
+                            mDownstreamFrames = downstreamFrames;
+                        }
+
+            /** frames were accepted by the device at nowNs (CLOCK_MONOTONIC) */
+            void        advance(uint32_t frames, nsecs_t nowNs) {
+                            android::AutoMutex lock(mLock);
+                            if (!mActive) {
+                                // leaving standby: the render position restarts here
+                                mActive = true;
+                                mBase = mWritten;
+                                mCount = 0;
+                            }
+                            mWritten += frames;
+
+                            nsecs_t earliest = nowNs;
+                            size_t n = mCount < kWindow ? mCount : kWindow;
+                            for (size_t i = 0; i < n; i++) {
+                                nsecs_t projected = mWindow[i].timeNs +
+                                        framesToNs(mWritten - mWindow[i].frames);
+                                if (projected < earliest) earliest = projected;
+                            }
+                            if (nowNs - earliest > kResyncNs) {
+                                mCount = 0;
+                                earliest = nowNs;
+                            }
+                            mWindow[mCount % kWindow].frames = mWritten;
+                            mWindow[mCount % kWindow].timeNs = nowNs;
+                            mCount++;
+                            mLastNs = earliest;
+                        }
+
+            /** the output went to standby; anything queued plays out */
+            void        standby() {
+                            android::AutoMutex lock(mLock);
+                            if (!mActive) return;
+                            mLastNs += framesToNs(queued_l());
+                            mBase = mWritten;
+                            mActive = false;
+                        }
+
+            /** total frames accepted by the device since the stream was opened */
+            uint64_t    framesWritten() const {
+                            android::AutoMutex lock(mLock);
+                            return mWritten;
+                        }
+
+            status_t    getPresentationPosition(uint64_t *frames, struct timespec *timestamp) const {
+                            android::AutoMutex lock(mLock);
+                            if (mLastNs == 0) return INVALID_OPERATION;
+                            *frames = mWritten - queued_l();
+                            timestamp->tv_sec = mLastNs / 1000000000;
+                            timestamp->tv_nsec = mLastNs % 1000000000;
+                            return NO_ERROR;
+                        }
+
+            /** frames rendered since leaving standby, extrapolated to nowNs */
+            status_t    getRenderPosition(uint32_t *dspFrames, nsecs_t nowNs) const {
+                            android::AutoMutex lock(mLock);
+                            if (!mActive) {
+                                *dspFrames = 0;
+                                return NO_ERROR;
+                            }
+                            uint64_t rendered = mWritten - queued_l() - mBase;
+                            if (nowNs > mLastNs) {
+                                rendered += (uint64_t)(nowNs - mLastNs) * mSampleRate / 1000000000;
+                            }
+                            if (rendered > mWritten - mBase) rendered = mWritten - mBase;
+                            *dspFrames = (uint32_t)rendered;
+                            return NO_ERROR;
+                        }
+
+            /** local time in us at which the next frame written will be presented */
+            status_t    getNextWriteTimestamp(int64_t *timestampUs) const {
+                            android::AutoMutex lock(mLock);
+                            if (!mActive) return INVALID_OPERATION;
+                            *timestampUs = (mLastNs + framesToNs(queued_l())) / 1000;
+                            return NO_ERROR;
+                        }
+
+private:
+    // an observation this much later than predicted restarts the timeline
+    static const nsecs_t kResyncNs = 10000000;
+    static const size_t kWindow = 8;
+
+    struct Observation {
+        uint64_t        frames;
+        nsecs_t         timeNs;
+    };
+
+            nsecs_t     framesToNs(uint64_t frames) const {
+                            return (nsecs_t)(frames * 1000000000 / mSampleRate);
+                        }
+            uint64_t    queued_l() const {
+                            uint64_t sinceStandby = mWritten - mBase;
+                            return sinceStandby < mDownstreamFrames ? sinceStandby : mDownstreamFrames;
+                        }
+
+    mutable Mutex       mLock;
+    uint32_t            mSampleRate;
+    uint32_t            mDownstreamFrames;
+    bool                mActive;
+    uint64_t            mWritten;
+    uint64_t            mBase;      // mWritten when the stream last left standby
+    nsecs_t             mLastNs;    // filtered time of the last advance()
+    Observation         mWindow[kWindow];
+    size_t              mCount;
+};
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
+
+#endif // ANDROID_AUDIO_POSITION_TRACKER_H
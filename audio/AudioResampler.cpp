@@ -0,0 +1,196 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "AudioResampler"
+#include <utils/Log.h>
+
+#include "AudioMixOps.h"
+#include "AudioResampler.h"
+
+namespace android_audio_legacy {
+
+// ----------------------------------------------------------------------------
+
+// Kaiser window beta; ~80dB stopband.
+static const double kKaiserBeta = 8.0;
+
+// Passband edge as a fraction of the lower Nyquist frequency; the
+// transition band of the filter sits above it.
+static const double kCutoff = 0.91;
+
+size_t AudioResampler::tapsFor(uint32_t inRate, uint32_t outRate)
+{
+    size_t taps = kTaps;
+    if (inRate > outRate) {
+        taps = (kTaps * inRate / outRate + 7) & ~(size_t)7;
+        if (taps > kMaxTaps) taps = kMaxTaps;
+    }
+    return taps;
+}
+
+static double besselI0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 50; k++) {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+AudioResampler::AudioResampler(uint32_t inRate, uint32_t outRate, uint32_t channels)
+    : mInRate(inRate), mOutRate(outRate), mChannels(channels),
+      mTaps(tapsFor(inRate, outRate)), mStepInt(inRate / outRate), mStepFrac(inRate % outRate),
+      mPhaseScale((((uint64_t)kPhases << 16) << 32) / outRate),
+      mCoefs(new int16_t[(kPhases + 1) * mTaps])
+{
+    mHistory[0] = new int16_t[mTaps + kChunkFrames];
+    mHistory[1] = channels > 1 ? new int16_t[mTaps + kChunkFrames] : 0;
+    designFilter();
+    reset();
+}
+
+AudioResampler::~AudioResampler()
+{
+    delete[] mCoefs;
+    delete[] mHistory[0];
+    delete[] mHistory[1];
+}
+
+bool AudioResampler::isSupported(uint32_t inRate, uint32_t outRate, uint32_t channels)
+{
+    return inRate >= kMinRate && inRate <= kMaxRate &&
+            outRate >= kMinRate && outRate <= kMaxRate &&
+            (channels == 1 || channels == 2);
+}
+
+void AudioResampler::designFilter()
+{
+    // cutoff in cycles per input sample
+    double ratio = mOutRate < mInRate ? (double)mOutRate / mInRate : 1.0;
+    double fc = 0.5 * kCutoff * ratio;
+    const double center = mTaps / 2 - 1;
+    const double i0beta = besselI0(kKaiserBeta);
+
+    double *h = new double[mTaps];
+    for (size_t p = 0; p <= kPhases; p++) {
+        double frac = (double)p / kPhases;
+        double sum = 0;
+        for (size_t k = 0; k < mTaps; k++) {
+            double x = k - center - frac;
+            double w = x / (mTaps / 2);
+            double window = fabs(w) < 1.0 ? besselI0(kKaiserBeta * sqrt(1.0 - w * w)) / i0beta : 0;
+            double sinc = x == 0 ? 1.0 : sin(2 * M_PI * fc * x) / (2 * M_PI * fc * x);
+            h[k] = 2 * fc * sinc * window;
+            sum += h[k];
+        }
+        // unity DC gain for every phase, with the rounding error on the
+        // largest tap where it matters least
+        int16_t *row = mCoefs + p * mTaps;
+        int32_t total = 0;
+        size_t peak = 0;
+        for (size_t k = 0; k < mTaps; k++) {
+            row[k] = (int16_t)lrint(h[k] / sum * 32768.0);
+            total += row[k];
+            if (abs(row[k]) > abs(row[peak])) peak = k;
+        }
+        row[peak] += 32768 - total;
+    }
+    delete[] h;
+}
+
+void AudioResampler::reset()
+{
+    // Prime the window so the first output is centered on the first input
+    // frame: the conversion is aligned, only delayed by the mTaps / 2 frames
+    // of lookahead it needs.
+    mAvail = mTaps / 2 - 1;
+    for (uint32_t c = 0; c < mChannels; c++) {
+        memset(mHistory[c], 0, mAvail * sizeof(int16_t));
+    }
+    mBase = 0;
+    mPhase = 0;
+}
+
+size_t AudioResampler::produce(int16_t *out, size_t outFrames)
+{
+    size_t n = 0;
+    while (n < outFrames && mBase + mTaps <= mAvail) {
+        uint32_t x = (uint32_t)(((uint64_t)mPhase * mPhaseScale) >> 32);
+        const int16_t *h0 = mCoefs + (x >> 16) * mTaps;
+        const int64_t a = x & 0xffff;
+        for (uint32_t c = 0; c < mChannels; c++) {
+            int32_t r0, r1;
+            dot16x2(mHistory[c] + mBase, h0, h0 + mTaps, mTaps, &r0, &r1);
+            int64_t acc = r0 * (65536 - a) + r1 * a;
+            out[n * mChannels + c] = clamp16((int32_t)((acc + (1LL << 30)) >> 31));
+        }
+        n++;
+        mBase += mStepInt;
+        mPhase += mStepFrac;
+        if (mPhase >= mOutRate) {
+            mPhase -= mOutRate;
+            mBase++;
+        }
+    }
+    return n;
+}
+
+size_t AudioResampler::resample(int16_t *out, size_t outFrames,
+        const int16_t *in, size_t *inFrames)
+{
+    size_t produced = 0, consumed = 0;
+    for (;;) {
+        produced += produce(out + produced * mChannels, outFrames - produced);
+        if (produced == outFrames) break;
+
+        // drop what no later output can reach, then refill
+        size_t drop = mBase < mAvail ? mBase : mAvail;
+        for (uint32_t c = 0; c < mChannels; c++) {
+            memmove(mHistory[c], mHistory[c] + drop, (mAvail - drop) * sizeof(int16_t));
+        }
+        mAvail -= drop;
+        mBase -= drop;
+
+        size_t n = *inFrames - consumed;
+        if (n > mTaps + kChunkFrames - mAvail) n = mTaps + kChunkFrames - mAvail;
+        if (n == 0) break;
+        const int16_t *src = in + consumed * mChannels;
+        if (mChannels == 1) {
+            memcpy(mHistory[0] + mAvail, src, n * sizeof(int16_t));
+        } else {
+            int16_t *l = mHistory[0] + mAvail, *r = mHistory[1] + mAvail;
+            for (size_t i = 0; i < n; i++) {
+                l[i] = src[2 * i];
+                r[i] = src[2 * i + 1];
+            }
+        }
+        mAvail += n;
+        consumed += n;
+    }
+    *inFrames = consumed;
+    return produced;
+}
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
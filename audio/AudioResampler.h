@@ -0,0 +1,101 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef ANDROID_AUDIO_RESAMPLER_H
+#define ANDROID_AUDIO_RESAMPLER_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+namespace android_audio_legacy {
+
+// ----------------------------------------------------------------------------
+
+/**
+ * Polyphase sample rate converter for 16-bit mono or interleaved stereo.
+ *
+ * Any pair of rates in [kMinRate, kMaxRate] is supported. The prototype is
+ * a Kaiser-windowed sinc cut off just below the lower of the two Nyquist
+ * frequencies, spanning kTaps samples at that lower rate (so downsampling
+ * uses proportionally more input taps), tabulated at kPhases fractional
+ * positions; outputs between two tabulated phases are interpolated linearly
+ * between both dot products. The input position is tracked as an exact
+ * fraction of the output rate, so there is no long-term drift.
+ *
+ * Coefficients are Q15 and each phase sums to exactly unity gain; the dot
+ * products use the SIMD kernels from AudioMixOps.h.
+ */
+class AudioResampler {
+public:
+    static const uint32_t kMinRate = 4000;
+    static const uint32_t kMaxRate = 192000;
+
+                        AudioResampler(uint32_t inRate, uint32_t outRate, uint32_t channels);
+                        ~AudioResampler();
+
+    static  bool        isSupported(uint32_t inRate, uint32_t outRate, uint32_t channels);
+
+            uint32_t    inRate() const { return mInRate; }
+            uint32_t    outRate() const { return mOutRate; }
+            uint32_t    channels() const { return mChannels; }
+            /** input frames of lookahead before an input frame reaches the output */
+            size_t      delayFrames() const { return mTaps / 2; }
+
+            /**
+             * Convert from in into out. On entry *inFrames is what in holds;
+             * on return it is how much was consumed, which is all of it
+             * unless out filled up first. Returns the frames produced.
+             */
+            size_t      resample(int16_t *out, size_t outFrames,
+                                 const int16_t *in, size_t *inFrames);
+
+            /** forget the history, e.g. on standby */
+            void        reset();
+
+private:
+    static const size_t kTaps = 96;
+    static const size_t kMaxTaps = 1024;
+    static const size_t kPhases = 128;
+    // input frames buffered beyond the filter span
+    static const size_t kChunkFrames = 256;
+
+                        AudioResampler(const AudioResampler &);
+            AudioResampler& operator=(const AudioResampler &);
+
+    static  size_t      tapsFor(uint32_t inRate, uint32_t outRate);
+            void        designFilter();
+            size_t      produce(int16_t *out, size_t outFrames);
+
+    const uint32_t      mInRate;
+    const uint32_t      mOutRate;
+    const uint32_t      mChannels;
+    const size_t        mTaps;          // per phase, a multiple of 8
+    const uint32_t      mStepInt;       // whole input frames per output frame
+    const uint32_t      mStepFrac;      // and the remainder, in 1/mOutRate
+    uint64_t            mPhaseScale;    // mPhase to Q16 phase-table index, << 32
+    int16_t             *mCoefs;        // (kPhases + 1) rows of mTaps
+    int16_t             *mHistory[2];   // planar input, mTaps + kChunkFrames
+    size_t              mAvail;         // frames in mHistory
+    size_t              mBase;          // first frame of the next output's window
+    uint32_t            mPhase;         // fractional position, in 1/mOutRate
+};
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
+
+#endif // ANDROID_AUDIO_RESAMPLER_H
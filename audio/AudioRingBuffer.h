@@ -0,0 +1,128 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef ANDROID_AUDIO_RING_BUFFER_H
+#define ANDROID_AUDIO_RING_BUFFER_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include <atomic>
+
+namespace android_audio_legacy {
+
+// ----------------------------------------------------------------------------
+
+/**
+ * Single-producer/single-consumer lock-free byte ring.
+ *
+ * One thread may write and one other thread may read concurrently without
+ * any lock. Positions are free-running byte counters; the capacity is rounded
+ * up to a power of two so wrapping is a mask. Neither side ever blocks: short
+ * transfers tell the caller the ring was full or empty.
+ */
+class AudioRingBuffer {
+public:
+    explicit            AudioRingBuffer(size_t capacity)
+                            : mCapacity(roundUpPow2(capacity)), mMask(mCapacity - 1),
+                              mData((uint8_t *)calloc(1, mCapacity)), mWritePos(0), mReadPos(0) {}
+                        ~AudioRingBuffer() { free(mData); }
+
+            size_t      capacity() const { return mCapacity; }
+
+            /** bytes that can be read now; call from the consumer */
+            size_t      availableToRead() const {
+                            return mWritePos.load(std::memory_order_acquire) -
+                                    mReadPos.load(std::memory_order_relaxed);
+                        }
+
+            /** bytes that can be written now; call from the producer */
+            size_t      availableToWrite() const {
+                            return mCapacity - (mWritePos.load(std::memory_order_relaxed) -
+                                    mReadPos.load(std::memory_order_acquire));
+                        }
+
+            /** total bytes ever written/read; safe to call from any thread */
+            uint64_t    totalWritten() const { return mWritePos.load(std::memory_order_acquire); }
+            uint64_t    totalRead() const { return mReadPos.load(std::memory_order_acquire); }
+
+            /** copy in up to bytes; returns the number of bytes written */
+            size_t      write(const void *buffer, size_t bytes) {
+                            size_t avail = availableToWrite();
+                            if (bytes > avail) bytes = avail;
+                            if (bytes == 0) return 0;
+                            size_t pos = mWritePos.load(std::memory_order_relaxed) & mMask;
+                            size_t first = bytes < mCapacity - pos ? bytes : mCapacity - pos;
+                            memcpy(mData + pos, buffer, first);
+                            memcpy(mData, (const uint8_t *)buffer + first, bytes - first);
+                            mWritePos.fetch_add(bytes, std::memory_order_release);
+                            return bytes;
+                        }
+
+            /** copy out up to bytes; returns the number of bytes read */
+            size_t      read(void *buffer, size_t bytes) {
+                            size_t avail = availableToRead();
+                            if (bytes > avail) bytes = avail;
+                            if (bytes == 0) return 0;
+                            size_t pos = mReadPos.load(std::memory_order_relaxed) & mMask;
+                            size_t first = bytes < mCapacity - pos ? bytes : mCapacity - pos;
+                            memcpy(buffer, mData + pos, first);
+                            memcpy((uint8_t *)buffer + first, mData, bytes - first);
+                            mReadPos.fetch_add(bytes, std::memory_order_release);
+                            return bytes;
+                        }
+
+            /** drop up to bytes from the read side; returns the number dropped */
+            size_t      skip(size_t bytes) {
+                            size_t avail = availableToRead();
+                            if (bytes > avail) bytes = avail;
+                            mReadPos.fetch_add(bytes, std::memory_order_release);
+                            return bytes;
+                        }
+
+            /** empty the ring; only valid while neither side is active */
+            void        reset() {
+                            mReadPos.store(mWritePos.load(std::memory_order_relaxed),
+                                    std::memory_order_release);
+                        }
+
+private:
+    static  size_t      roundUpPow2(size_t v) {
+                            size_t p = 1;
+                            while (p < v) p <<= 1;
+                            return p;
+                        }
+
+                        AudioRingBuffer(const AudioRingBuffer &);
+            AudioRingBuffer& operator=(const AudioRingBuffer &);
+
+    const size_t        mCapacity;
+    const size_t        mMask;
+    uint8_t             *mData;
+    // written by the producer only
+    std::atomic<uint64_t> mWritePos;
+    // written by the consumer only
+    std::atomic<uint64_t> mReadPos;
+};
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
+
+#endif // ANDROID_AUDIO_RING_BUFFER_H
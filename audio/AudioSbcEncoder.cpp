@@ -0,0 +1,683 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#include <string.h>
+
+#define LOG_TAG "AudioSbcEncoder"
+#include <utils/Log.h>
+
+#include "AudioMixOps.h"
+#include "AudioSbcEncoder.h"
+
+namespace android_audio_legacy {
+
+// ----------------------------------------------------------------------------
+
+static const uint8_t kSyncWord = 0x9c;
+static const uint8_t kCrcInit = 0x0f;
+
+// The prototype filter of the specification times 2^16 (4 subbands) or
+// 2^17 (8 subbands), in time order: entry n weights the sample n places
+// after the oldest in the window, where the specification's C[i] weights
+// the one i places before the newest.
+static const int16_t kWindow4[40] = {
+        35,     98,    179,    251,    255,    122,   -201,   -715,
+      1339,   1892,   2110,   1696,    402,  -1889,  -5089,  -8886,
+     12779,  16164,  18470,  19288,  18470,  16164,  12779,   8886,
+     -5089,  -1889,    402,   1696,   2110,   1892,   1339,    715,
+      -201,    122,    255,    251,    179,     98,     35,      0,
+};
+static const int16_t kWindow8[80] = {
+        21,     45,     73,    108,    149,    194,    234,    264,
+       276,    261,    212,    118,    -23,   -216,   -458,   -742,
+      1052,   1371,   1671,   1921,   2085,   2126,   2008,   1696,
+      1161,    383,   -644,  -1919,  -3422,  -5122,  -6971,  -8913,
+     10877,  12789,  14575,  16157,  17467,  18449,  19057,  19262,
+     19057,  18449,  17467,  16157,  14575,  12789,  10877,   8913,
+     -6971,  -5122,  -3422,  -1919,   -644,    383,   1161,   1696,
+      2008,   2126,   2085,   1921,   1671,   1371,   1052,    742,
+      -458,   -216,    -23,    118,    212,    261,    276,    264,
+       234,    194,    149,    108,     73,     45,     21,      0,
+};
+// Windowed sums are rounded to 16 bits by this much, leaving 1 (4
+// subbands) or 2 (8 subbands) fractional bits.
+static const int kWindowShift = 15;
+
+// The matrixing cos((i + 0.5) * (k - M / 2) * pi / M) times 2^14 (4
+// subbands) or 2^13 (8 subbands), so subband samples come out with
+// kScaleOutBits fractional bits. Pairs of windowed sums are interleaved
+// for each subband i: entry [p][i][j] is for the sum 2p + j in time order,
+// which is k = 2M - 1 - (2p + j). No subband filter gains more than 1.6,
+// so nothing here overflows 32 bits.
+static const int16_t kMatrix4[32] = {
+     -6270,      0,  15137,      0, -15137,      0,   6270,      0,
+      6270,  11585, -15137, -11585,  15137, -11585,  -6270,  11585,
+     15137,  16384,   6270,  16384,  -6270,  16384, -15137,  16384,
+     15137,  11585,   6270, -11585,  -6270, -11585, -15137,  11585,
+};
+static const int16_t kMatrix8[128] = {
+     -4551,  -3135,   8035,   7568,  -1598,  -7568,  -6811,   3135,
+      6811,   3135,   1598,  -7568,  -8035,   7568,   4551,  -3135,
+     -1598,      0,   4551,      0,  -6811,      0,   8035,      0,
+     -8035,      0,   6811,      0,  -4551,      0,   1598,      0,
+      1598,   3135,  -4551,  -7568,   6811,   7568,  -8035,  -3135,
+      8035,  -3135,  -6811,   7568,   4551,  -7568,  -1598,   3135,
+      4551,   5793,  -8035,  -5793,   1598,  -5793,   6811,   5793,
+     -6811,   5793,  -1598,  -5793,   8035,  -5793,  -4551,   5793,
+      6811,   7568,  -1598,   3135,  -8035,  -3135,  -4551,  -7568,
+      4551,  -7568,   8035,  -3135,   1598,   3135,  -6811,   7568,
+      8035,   8192,   6811,   8192,   4551,   8192,   1598,   8192,
+     -1598,   8192,  -4551,   8192,  -6811,   8192,  -8035,   8192,
+      8035,   7568,   6811,   3135,   4551,  -3135,   1598,  -7568,
+     -1598,  -7568,  -4551,  -3135,  -6811,   3135,  -8035,   7568,
+      6811,   5793,  -1598,  -5793,  -8035,  -5793,  -4551,   5793,
+      4551,   5793,   8035,  -5793,   1598,  -5793,  -6811,   5793,
+};
+// Loudness allocation offsets, by sampling frequency.
+static const int8_t kLoudnessOffset4[4][4] = {
+    { -1, 0, 0, 0 }, { -2, 0, 0, 1 }, { -2, 0, 0, 1 }, { -2, 0, 0, 1 },
+};
+static const int8_t kLoudnessOffset8[4][8] = {
+    { -2, 0, 0, 0, 0, 0, 0, 1 }, { -3, 0, 0, 0, 0, 0, 1, 2 },
+    { -4, 0, 0, 0, 0, 0, 1, 2 }, { -4, 0, 0, 0, 0, 0, 1, 2 },
+};
+
+static int frequencyIndex(uint32_t sampleRate)
+{
+    switch (sampleRate) {
+    case 16000: return 0;
+    case 32000: return 1;
+    case 44100: return 2;
+    case 48000: return 3;
+    }
+    return -1;
+}
+
+/**
+ * One block of m subband samples from the 10 * m input samples at x,
+ * oldest first. The reference the vector versions match bit for bit.
+ */
+static inline void analyzeScalar(const int16_t *x, int32_t *sb, uint32_t m)
+{
+    const int16_t *window = m == 8 ? kWindow8 : kWindow4;
+    const int16_t *matrix = m == 8 ? kMatrix8 : kMatrix4;
+    int16_t y[2 * AudioSbcEncoder::kMaxSubbands];
+    for (uint32_t k = 0; k < 2 * m; k++) {
+        int32_t acc = 0;
+        for (uint32_t j = 0; j < 10 * m; j += 2 * m) {
+            acc += x[k + j] * window[k + j];
+        }
+        y[k] = clamp16((acc + (1 << (kWindowShift - 1))) >> kWindowShift);
+    }
+    for (uint32_t i = 0; i < m; i++) {
+        int32_t acc = 0;
+        for (uint32_t p = 0; p < m; p++) {
+            const int16_t *c = matrix + (p * m + i) * 2;
+            acc += y[2 * p] * c[0] + y[2 * p + 1] * c[1];
+        }
+        sb[i] = acc;
+    }
+}
+
+static inline void analyze8(const int16_t *x, int32_t *sb)
+{
+#if defined(AUDIO_MIX_OPS_NEON)
+    int32x4_t a0 = vdupq_n_s32(0), a1 = a0, a2 = a0, a3 = a0;
+    for (uint32_t j = 0; j < 80; j += 16) {
+        int16x8_t v0 = vld1q_s16(x + j), v1 = vld1q_s16(x + j + 8);
+        int16x8_t w0 = vld1q_s16(kWindow8 + j), w1 = vld1q_s16(kWindow8 + j + 8);
+        a0 = vmlal_s16(a0, vget_low_s16(v0), vget_low_s16(w0));
+        a1 = vmlal_s16(a1, vget_high_s16(v0), vget_high_s16(w0));
+        a2 = vmlal_s16(a2, vget_low_s16(v1), vget_low_s16(w1));
+        a3 = vmlal_s16(a3, vget_high_s16(v1), vget_high_s16(w1));
+    }
+    // rounding, saturating narrow: exactly the scalar clamp16
+    int16_t y[16];
+    vst1q_s16(y, vcombine_s16(vqrshrn_n_s32(a0, kWindowShift), vqrshrn_n_s32(a1, kWindowShift)));
+    vst1q_s16(y + 8, vcombine_s16(vqrshrn_n_s32(a2, kWindowShift),
+                                  vqrshrn_n_s32(a3, kWindowShift)));
+    int32x4_t s0 = vdupq_n_s32(0), s1 = s0;
+    for (uint32_t p = 0; p < 8; p++) {
+        // each pair's coefficients for subbands 0-3 and 4-7, split by j
+        int16x4x2_t c0 = vld2_s16(kMatrix8 + p * 16);
+        int16x4x2_t c1 = vld2_s16(kMatrix8 + p * 16 + 8);
+        s0 = vmlal_n_s16(s0, c0.val[0], y[2 * p]);
+        s0 = vmlal_n_s16(s0, c0.val[1], y[2 * p + 1]);
+        s1 = vmlal_n_s16(s1, c1.val[0], y[2 * p]);
+        s1 = vmlal_n_s16(s1, c1.val[1], y[2 * p + 1]);
+    }
+    vst1q_s32(sb, s0);
+    vst1q_s32(sb + 4, s1);
+#elif defined(AUDIO_MIX_OPS_SSE2)
+    const __m128i round = _mm_set1_epi32(1 << (kWindowShift - 1));
+    __m128i a0 = _mm_setzero_si128(), a1 = a0, a2 = a0, a3 = a0;
+    for (uint32_t j = 0; j < 80; j += 16) {
+        __m128i v0 = _mm_loadu_si128((const __m128i *)(x + j));
+        __m128i v1 = _mm_loadu_si128((const __m128i *)(x + j + 8));
+        __m128i w0 = _mm_loadu_si128((const __m128i *)(kWindow8 + j));
+        __m128i w1 = _mm_loadu_si128((const __m128i *)(kWindow8 + j + 8));
+        // full 32 bit products from their low and high halves
+        __m128i lo = _mm_mullo_epi16(v0, w0), hi = _mm_mulhi_epi16(v0, w0);
+        a0 = _mm_add_epi32(a0, _mm_unpacklo_epi16(lo, hi));
+        a1 = _mm_add_epi32(a1, _mm_unpackhi_epi16(lo, hi));
+        lo = _mm_mullo_epi16(v1, w1);
+        hi = _mm_mulhi_epi16(v1, w1);
+        a2 = _mm_add_epi32(a2, _mm_unpacklo_epi16(lo, hi));
+        a3 = _mm_add_epi32(a3, _mm_unpackhi_epi16(lo, hi));
+    }
+    __m128i y[2];
+    y[0] = _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(a0, round), kWindowShift),
+                           _mm_srai_epi32(_mm_add_epi32(a1, round), kWindowShift));
+    y[1] = _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(a2, round), kWindowShift),
+                           _mm_srai_epi32(_mm_add_epi32(a3, round), kWindowShift));
+    // each 32 bit lane of y is a pair; broadcast it and let madd multiply
+    // and sum it with its coefficients for four subbands at a time
+    __m128i s0 = _mm_setzero_si128(), s1 = s0;
+    for (uint32_t p = 0; p < 8; p++) {
+        __m128i pair;
+        switch (p & 3) {
+        case 0: pair = _mm_shuffle_epi32(y[p >> 2], _MM_SHUFFLE(0, 0, 0, 0)); break;
+        case 1: pair = _mm_shuffle_epi32(y[p >> 2], _MM_SHUFFLE(1, 1, 1, 1)); break;
+        case 2: pair = _mm_shuffle_epi32(y[p >> 2], _MM_SHUFFLE(2, 2, 2, 2)); break;
+        default: pair = _mm_shuffle_epi32(y[p >> 2], _MM_SHUFFLE(3, 3, 3, 3)); break;
+        }
+        s0 = _mm_add_epi32(s0, _mm_madd_epi16(pair,
+                _mm_loadu_si128((const __m128i *)(kMatrix8 + p * 16))));
+        s1 = _mm_add_epi32(s1, _mm_madd_epi16(pair,
+                _mm_loadu_si128((const __m128i *)(kMatrix8 + p * 16 + 8))));
+    }
+    _mm_storeu_si128((__m128i *)sb, s0);
+    _mm_storeu_si128((__m128i *)(sb + 4), s1);
+#else
+    analyzeScalar(x, sb, 8);
+#endif
+}
+
+static inline void analyze4(const int16_t *x, int32_t *sb)
+{
+#if defined(AUDIO_MIX_OPS_NEON)
+    int32x4_t a0 = vdupq_n_s32(0), a1 = a0;
+    for (uint32_t j = 0; j < 40; j += 8) {
+        int16x8_t v = vld1q_s16(x + j), w = vld1q_s16(kWindow4 + j);
+        a0 = vmlal_s16(a0, vget_low_s16(v), vget_low_s16(w));
+        a1 = vmlal_s16(a1, vget_high_s16(v), vget_high_s16(w));
+    }
+    int16_t y[8];
+    vst1q_s16(y, vcombine_s16(vqrshrn_n_s32(a0, kWindowShift), vqrshrn_n_s32(a1, kWindowShift)));
+    int32x4_t s = vdupq_n_s32(0);
+    for (uint32_t p = 0; p < 4; p++) {
+        int16x4x2_t c = vld2_s16(kMatrix4 + p * 8);
+        s = vmlal_n_s16(s, c.val[0], y[2 * p]);
+        s = vmlal_n_s16(s, c.val[1], y[2 * p + 1]);
+    }
+    vst1q_s32(sb, s);
+#elif defined(AUDIO_MIX_OPS_SSE2)
+    const __m128i round = _mm_set1_epi32(1 << (kWindowShift - 1));
+    __m128i a0 = _mm_setzero_si128(), a1 = a0;
+    for (uint32_t j = 0; j < 40; j += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(x + j));
+        __m128i w = _mm_loadu_si128((const __m128i *)(kWindow4 + j));
+        __m128i lo = _mm_mullo_epi16(v, w), hi = _mm_mulhi_epi16(v, w);
+        a0 = _mm_add_epi32(a0, _mm_unpacklo_epi16(lo, hi));
+        a1 = _mm_add_epi32(a1, _mm_unpackhi_epi16(lo, hi));
+    }
+    __m128i y = _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(a0, round), kWindowShift),
+                                _mm_srai_epi32(_mm_add_epi32(a1, round), kWindowShift));
+    const __m128i *c = (const __m128i *)kMatrix4;
+    __m128i s = _mm_madd_epi16(_mm_shuffle_epi32(y, _MM_SHUFFLE(0, 0, 0, 0)),
+                               _mm_loadu_si128(c));
+    s = _mm_add_epi32(s, _mm_madd_epi16(_mm_shuffle_epi32(y, _MM_SHUFFLE(1, 1, 1, 1)),
+                                        _mm_loadu_si128(c + 1)));
+    s = _mm_add_epi32(s, _mm_madd_epi16(_mm_shuffle_epi32(y, _MM_SHUFFLE(2, 2, 2, 2)),
+                                        _mm_loadu_si128(c + 2)));
+    s = _mm_add_epi32(s, _mm_madd_epi16(_mm_shuffle_epi32(y, _MM_SHUFFLE(3, 3, 3, 3)),
+                                        _mm_loadu_si128(c + 3)));
+    _mm_storeu_si128((__m128i *)sb, s);
+#else
+    analyzeScalar(x, sb, 4);
+#endif
+}
+
+/**
+ * OR over blocks of each subband's s ^ (s >> 31): |s| when positive and
+ * |s| - 1 when negative, the magnitude two's complement needs covered.
+ * Blocks are stride samples apart.
+ */
+static inline void magnitudesScalar(uint32_t *mag, const int32_t *sb, size_t stride,
+        uint32_t blocks, uint32_t m)
+{
+    memset(mag, 0, m * sizeof(*mag));
+    for (uint32_t b = 0; b < blocks; b++, sb += stride) {
+        for (uint32_t i = 0; i < m; i++) {
+            mag[i] |= (uint32_t)(sb[i] ^ (sb[i] >> 31));
+        }
+    }
+}
+
+static inline void magnitudes(uint32_t *mag, const int32_t *sb, size_t stride,
+        uint32_t blocks, uint32_t m)
+{
+#if defined(AUDIO_MIX_OPS_NEON)
+    for (uint32_t i = 0; i < m; i += 4) {
+        int32x4_t acc = vdupq_n_s32(0);
+        for (uint32_t b = 0; b < blocks; b++) {
+            int32x4_t s = vld1q_s32(sb + b * stride + i);
+            acc = vorrq_s32(acc, veorq_s32(s, vshrq_n_s32(s, 31)));
+        }
+        vst1q_u32(mag + i, vreinterpretq_u32_s32(acc));
+    }
+#elif defined(AUDIO_MIX_OPS_SSE2)
+    for (uint32_t i = 0; i < m; i += 4) {
+        __m128i acc = _mm_setzero_si128();
+        for (uint32_t b = 0; b < blocks; b++) {
+            __m128i s = _mm_loadu_si128((const __m128i *)(sb + b * stride + i));
+            acc = _mm_or_si128(acc, _mm_xor_si128(s, _mm_srai_epi32(s, 31)));
+        }
+        _mm_storeu_si128((__m128i *)(mag + i), acc);
+    }
+#else
+    magnitudesScalar(mag, sb, stride, blocks, m);
+#endif
+}
+
+/** floor((l + r) / 2) and floor((l - r) / 2), without overflowing */
+static inline void midSideScalar(int32_t *mid, int32_t *side, const int32_t *l,
+        const int32_t *r, uint32_t m)
+{
+    for (uint32_t i = 0; i < m; i++) {
+        mid[i] = (l[i] >> 1) + (r[i] >> 1) + (l[i] & r[i] & 1);
+        side[i] = (l[i] >> 1) - (r[i] >> 1) - (~l[i] & r[i] & 1);
+    }
+}
+
+static inline void midSide(int32_t *mid, int32_t *side, const int32_t *l,
+        const int32_t *r, uint32_t m)
+{
+#if defined(AUDIO_MIX_OPS_NEON)
+    const int32x4_t one = vdupq_n_s32(1);
+    for (uint32_t i = 0; i < m; i += 4) {
+        int32x4_t a = vld1q_s32(l + i), b = vld1q_s32(r + i);
+        int32x4_t ha = vshrq_n_s32(a, 1), hb = vshrq_n_s32(b, 1);
+        vst1q_s32(mid + i, vaddq_s32(vaddq_s32(ha, hb), vandq_s32(vandq_s32(a, b), one)));
+        vst1q_s32(side + i, vsubq_s32(vsubq_s32(ha, hb), vandq_s32(vbicq_s32(b, a), one)));
+    }
+#elif defined(AUDIO_MIX_OPS_SSE2)
+    const __m128i one = _mm_set1_epi32(1);
+    for (uint32_t i = 0; i < m; i += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(l + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(r + i));
+        __m128i ha = _mm_srai_epi32(a, 1), hb = _mm_srai_epi32(b, 1);
+        _mm_storeu_si128((__m128i *)(mid + i), _mm_add_epi32(_mm_add_epi32(ha, hb),
+                _mm_and_si128(_mm_and_si128(a, b), one)));
+        _mm_storeu_si128((__m128i *)(side + i), _mm_sub_epi32(_mm_sub_epi32(ha, hb),
+                _mm_and_si128(_mm_andnot_si128(a, b), one)));
+    }
+#else
+    midSideScalar(mid, side, l, r, m);
+#endif
+}
+
+/** the smallest scale factor whose 2^(sf + 1) covers a magnitude */
+static inline uint8_t scaleFactor(uint32_t mag)
+{
+    uint8_t sf = 0;
+    for (mag >>= AudioSbcEncoder::kScaleOutBits + 1; mag; mag >>= 1) sf++;
+    return sf;
+}
+
+// Most significant bit first.
+class SbcBitWriter {
+public:
+    SbcBitWriter(uint8_t *dst) : mDst(dst), mBits(0), mCount(0) {}
+
+    // n up to 16
+    void put(uint32_t value, uint32_t n) {
+        mBits = (mBits << n) | value;
+        mCount += n;
+        while (mCount >= 8) {
+            mCount -= 8;
+            *mDst++ = (uint8_t)(mBits >> mCount);
+        }
+    }
+    void align() {
+        if (mCount) put(0, 8 - mCount);
+    }
+
+private:
+    uint8_t *mDst;
+    uint32_t mBits;
+    uint32_t mCount;
+};
+
+// ----------------------------------------------------------------------------
+
+AudioSbcEncoder::AudioSbcEncoder(bool reference)
+    : mReference(reference)
+{
+    memset(&mConfig, 0, sizeof(mConfig));
+    memset(mSamples, 0, sizeof(mSamples));
+    memset(mScaleFactors, 0, sizeof(mScaleFactors));
+    reset();
+}
+
+void AudioSbcEncoder::reset()
+{
+    memset(mHistory, 0, sizeof(mHistory));
+}
+
+uint32_t AudioSbcEncoder::maxBitpool(const Config &config)
+{
+    uint32_t max = config.subbands *
+            (config.channelMode == MODE_STEREO || config.channelMode == MODE_JOINT_STEREO ?
+             32 : 16);
+    // the most the A2DP codec capabilities can advertise
+    return max < 250 ? max : 250;
+}
+
+size_t AudioSbcEncoder::frameBytes(const Config &config)
+{
+    const uint32_t channels = channelCount(config.channelMode);
+    size_t bits = config.blocks * config.bitpool;
+    if (config.channelMode == MODE_MONO || config.channelMode == MODE_DUAL_CHANNEL) {
+        bits *= channels;
+    } else if (config.channelMode == MODE_JOINT_STEREO) {
+        bits += config.subbands;
+    }
+    return 4 + 4 * config.subbands * channels / 8 + (bits + 7) / 8;
+}
+
+status_t AudioSbcEncoder::configure(const Config &config)
+{
+    if (frequencyIndex(config.sampleRate) < 0 || config.channelMode > MODE_JOINT_STEREO ||
+            config.blocks == 0 || config.blocks > kMaxBlocks || config.blocks % 4 ||
+            (config.subbands != 4 && config.subbands != 8) ||
+            config.allocation > ALLOCATION_SNR ||
+            config.bitpool < 2 || config.bitpool > maxBitpool(config)) {
+        return BAD_VALUE;
+    }
+    mConfig = config;
+    reset();
+    return NO_ERROR;
+}
+
+status_t AudioSbcEncoder::setBitpool(uint32_t bitpool)
+{
+    if (mConfig.subbands == 0 || bitpool < 2 || bitpool > maxBitpool(mConfig)) {
+        return BAD_VALUE;
+    }
+    mConfig.bitpool = bitpool;
+    return NO_ERROR;
+}
+
+uint8_t AudioSbcEncoder::crc8(uint8_t crc, const uint8_t *data, size_t bits)
+{
+    for (size_t i = 0; i < bits; i++) {
+        uint32_t bit = (data[i / 8] >> (7 - i % 8)) & 1;
+        bool feedback = ((crc >> 7) ^ bit) != 0;
+        crc = (uint8_t)(crc << 1);
+        if (feedback) crc ^= 0x1d;
+    }
+    return crc;
+}
+
+void AudioSbcEncoder::allocateBits(const Config &config,
+        const uint8_t scaleFactors[kMaxChannels][kMaxSubbands],
+        uint8_t bits[kMaxChannels][kMaxSubbands])
+{
+    const uint32_t m = config.subbands;
+    const int frequency = frequencyIndex(config.sampleRate);
+    const int bitpool = config.bitpool;
+    // stereo modes share one bitpool between the channels, taking subbands
+    // of each in turn; the others give each channel a bitpool of its own
+    const bool shared = config.channelMode == MODE_STEREO ||
+            config.channelMode == MODE_JOINT_STEREO;
+    const uint32_t channels = shared ? 2 : 1;
+    const uint32_t passes = shared ? 1 : channelCount(config.channelMode);
+
+    for (uint32_t pass = 0; pass < passes; pass++) {
+        int need[kMaxChannels][kMaxSubbands];
+        int out[kMaxChannels][kMaxSubbands];
+        int maxNeed = 0;
+        for (uint32_t c = 0; c < channels; c++) {
+            const uint8_t *sf = scaleFactors[pass + c];
+            for (uint32_t sb = 0; sb < m; sb++) {
+                int n;
+                if (config.allocation == ALLOCATION_SNR) {
+                    n = sf[sb];
+                } else if (sf[sb] == 0) {
+                    n = -5;
+                } else {
+                    int loudness = sf[sb] - (m == 4 ? kLoudnessOffset4[frequency][sb] :
+                                                      kLoudnessOffset8[frequency][sb]);
+                    n = loudness > 0 ? loudness / 2 : loudness;
+                }
+                need[c][sb] = n;
+                if (n > maxNeed) maxNeed = n;
+            }
+        }
+
+        // lower the slice while the bits above it still fit the bitpool
+        int bitcount = 0, slicecount = 0, bitslice = maxNeed + 1;
+        do {
+            bitslice--;
+            bitcount += slicecount;
+            slicecount = 0;
+            for (uint32_t c = 0; c < channels; c++) {
+                for (uint32_t sb = 0; sb < m; sb++) {
+                    if (need[c][sb] > bitslice + 1 && need[c][sb] < bitslice + 16) {
+                        slicecount++;
+                    } else if (need[c][sb] == bitslice + 1) {
+                        slicecount += 2;
+                    }
+                }
+            }
+        } while (bitcount + slicecount < bitpool);
+        if (bitcount + slicecount == bitpool) {
+            bitcount += slicecount;
+            bitslice--;
+        }
+
+        for (uint32_t c = 0; c < channels; c++) {
+            for (uint32_t sb = 0; sb < m; sb++) {
+                int n = need[c][sb] - bitslice;
+                out[c][sb] = need[c][sb] < bitslice + 2 ? 0 : n < 16 ? n : 16;
+            }
+        }
+
+        // what is left goes out a bit at a time from the lowest subband:
+        // first to those already allocated and to those just below the
+        // slice, then to any
+        uint32_t c = 0, sb = 0;
+        while (bitcount < bitpool && sb < m) {
+            if (out[c][sb] >= 2 && out[c][sb] < 16) {
+                out[c][sb]++;
+                bitcount++;
+            } else if (need[c][sb] == bitslice + 1 && bitpool > bitcount + 1) {
+                out[c][sb] = 2;
+                bitcount += 2;
+            }
+            if (++c == channels) {
+                c = 0;
+                sb++;
+            }
+        }
+        c = 0;
+        sb = 0;
+        while (bitcount < bitpool && sb < m) {
+            if (out[c][sb] < 16) {
+                out[c][sb]++;
+                bitcount++;
+            }
+            if (++c == channels) {
+                c = 0;
+                sb++;
+            }
+        }
+
+        for (c = 0; c < channels; c++) {
+            for (sb = 0; sb < m; sb++) {
+                bits[pass + c][sb] = (uint8_t)out[c][sb];
+            }
+        }
+    }
+}
+
+void AudioSbcEncoder::analyze(uint32_t channels)
+{
+    const uint32_t m = mConfig.subbands;
+    for (uint32_t c = 0; c < channels; c++) {
+        for (uint32_t b = 0; b < mConfig.blocks; b++) {
+            const int16_t *x = mHistory[c] + b * m;
+            if (mReference) {
+                analyzeScalar(x, mSamples[b][c], m);
+            } else if (m == 8) {
+                analyze8(x, mSamples[b][c]);
+            } else {
+                analyze4(x, mSamples[b][c]);
+            }
+        }
+    }
+}
+
+void AudioSbcEncoder::computeScaleFactors(uint32_t channels)
+{
+    const size_t stride = kMaxChannels * kMaxSubbands;
+    uint32_t mag[kMaxSubbands];
+    for (uint32_t c = 0; c < channels; c++) {
+        if (mReference) {
+            magnitudesScalar(mag, mSamples[0][c], stride, mConfig.blocks, mConfig.subbands);
+        } else {
+            magnitudes(mag, mSamples[0][c], stride, mConfig.blocks, mConfig.subbands);
+        }
+        for (uint32_t sb = 0; sb < mConfig.subbands; sb++) {
+            mScaleFactors[c][sb] = scaleFactor(mag[sb]);
+        }
+    }
+}
+
+uint32_t AudioSbcEncoder::jointStereo()
+{
+    const uint32_t m = mConfig.subbands;
+    const size_t stride = kMaxChannels * kMaxSubbands;
+    int32_t joint[kMaxBlocks][kMaxChannels][kMaxSubbands];
+    uint32_t mag[kMaxChannels][kMaxSubbands];
+    for (uint32_t b = 0; b < mConfig.blocks; b++) {
+        if (mReference) {
+            midSideScalar(joint[b][0], joint[b][1], mSamples[b][0], mSamples[b][1], m);
+        } else {
+            midSide(joint[b][0], joint[b][1], mSamples[b][0], mSamples[b][1], m);
+        }
+    }
+    for (uint32_t c = 0; c < kMaxChannels; c++) {
+        if (mReference) {
+            magnitudesScalar(mag[c], joint[0][c], stride, mConfig.blocks, m);
+        } else {
+            magnitudes(mag[c], joint[0][c], stride, mConfig.blocks, m);
+        }
+    }
+
+    // mid and side wherever they scale smaller; the last subband's join
+    // bit is reserved
+    uint32_t join = 0;
+    for (uint32_t sb = 0; sb + 1 < m; sb++) {
+        uint8_t mid = scaleFactor(mag[0][sb]), side = scaleFactor(mag[1][sb]);
+        if (mid + side < mScaleFactors[0][sb] + mScaleFactors[1][sb]) {
+            join |= 1 << sb;
+            mScaleFactors[0][sb] = mid;
+            mScaleFactors[1][sb] = side;
+            for (uint32_t b = 0; b < mConfig.blocks; b++) {
+                mSamples[b][0][sb] = joint[b][0][sb];
+                mSamples[b][1][sb] = joint[b][1][sb];
+            }
+        }
+    }
+    return join;
+}
+
+size_t AudioSbcEncoder::pack(uint8_t *dst, uint32_t join)
+{
+    const uint32_t m = mConfig.subbands;
+    const uint32_t channels = channelCount(mConfig.channelMode);
+
+    dst[0] = kSyncWord;
+    dst[1] = (uint8_t)((frequencyIndex(mConfig.sampleRate) << 6) |
+            ((mConfig.blocks / 4 - 1) << 4) | (mConfig.channelMode << 2) |
+            (mConfig.allocation << 1) | (m == 8 ? 1 : 0));
+    dst[2] = (uint8_t)mConfig.bitpool;
+
+    // the CRC covers the join bits and scale factors, written first
+    SbcBitWriter writer(dst + 4);
+    size_t crcBits = 4 * m * channels;
+    if (mConfig.channelMode == MODE_JOINT_STEREO) {
+        for (uint32_t sb = 0; sb < m; sb++) {
+            writer.put((join >> sb) & 1, 1);
+        }
+        crcBits += m;
+    }
+    for (uint32_t c = 0; c < channels; c++) {
+        for (uint32_t sb = 0; sb < m; sb++) {
+            writer.put(mScaleFactors[c][sb], 4);
+        }
+    }
+
+    uint8_t bits[kMaxChannels][kMaxSubbands];
+    allocateBits(mConfig, mScaleFactors, bits);
+    for (uint32_t b = 0; b < mConfig.blocks; b++) {
+        for (uint32_t c = 0; c < channels; c++) {
+            for (uint32_t sb = 0; sb < m; sb++) {
+                uint32_t n = bits[c][sb];
+                if (n == 0) continue;
+                // (s / 2^(sf + 1) + 1) * (2^n - 1) / 2, with s in subband
+                // sample units; the scale factor keeps it in [0, 2^n - 1)
+                uint32_t shift = mScaleFactors[c][sb] + 1 + kScaleOutBits;
+                int64_t s = (int64_t)mSamples[b][c][sb] + ((int64_t)1 << shift);
+                writer.put((uint32_t)((s * ((1 << n) - 1)) >> (shift + 1)), n);
+            }
+        }
+    }
+    writer.align();
+
+    dst[3] = crc8(crc8(kCrcInit, dst + 1, 16), dst + 4, crcBits);
+    return frameBytes();
+}
+
+size_t AudioSbcEncoder::encode(const int16_t *pcm, uint8_t *dst)
+{
+    const uint32_t m = mConfig.subbands;
+    const uint32_t channels = channelCount(mConfig.channelMode);
+    const size_t samples = frameSamples();
+    if (samples == 0) return 0;
+
+    // the windows of this frame's blocks reach 9 blocks back
+    for (uint32_t c = 0; c < channels; c++) {
+        int16_t *x = mHistory[c];
+        memmove(x, x + samples, 9 * m * sizeof(*x));
+        x += 9 * m;
+        for (size_t i = 0; i < samples; i++) {
+            x[i] = pcm[i * channels + c];
+        }
+    }
+
+    analyze(channels);
+    computeScaleFactors(channels);
+    uint32_t join = mConfig.channelMode == MODE_JOINT_STEREO ? jointStereo() : 0;
+    return pack(dst, join);
+}
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
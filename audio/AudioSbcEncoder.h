@@ -0,0 +1,141 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef ANDROID_AUDIO_SBC_ENCODER_H
+#define ANDROID_AUDIO_SBC_ENCODER_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <hardware_legacy/AudioSystemLegacy.h>
+
+namespace android_audio_legacy {
+
+// ----------------------------------------------------------------------------
+
+/**
+ * SBC encoder, as specified in appendix B of the A2DP specification.
+ *
+ * The analysis filterbank runs in 16 bit fixed point: the windowing and
+ * the matrixing are each one pass of 16x16 bit multiply-accumulates, done
+ * with NEON or SSE2 where available, as are the scale factors and the
+ * joint stereo decision that feed the bit allocation. Subband samples carry
+ * kScaleOutBits fractional bits. The vector and scalar paths are integer
+ * throughout and never overflow, so their frames are bit for bit the same;
+ * constructing with reference set uses only the scalar one.
+ *
+ * The bitpool may be changed between frames, to trade bitrate for quality
+ * as the link allows.
+ */
+class AudioSbcEncoder {
+public:
+    enum {
+        MODE_MONO,
+        MODE_DUAL_CHANNEL,
+        MODE_STEREO,
+        MODE_JOINT_STEREO,
+    };
+    enum {
+        ALLOCATION_LOUDNESS,
+        ALLOCATION_SNR,
+    };
+
+    struct Config {
+        uint32_t    sampleRate;     // 16000, 32000, 44100 or 48000
+        uint32_t    channelMode;    // MODE_*
+        uint32_t    blocks;         // 4, 8, 12 or 16
+        uint32_t    subbands;       // 4 or 8
+        uint32_t    allocation;     // ALLOCATION_*
+        uint32_t    bitpool;        // 2 to maxBitpool()
+    };
+
+    static const uint32_t kMaxSubbands = 8;
+    static const uint32_t kMaxBlocks = 16;
+    static const uint32_t kMaxChannels = 2;
+    // fractional bits of subband samples, which are in units of input samples
+    static const uint32_t kScaleOutBits = 15;
+    // the largest frame any valid configuration produces
+    static const size_t kMaxFrameBytes = 528;
+
+                        AudioSbcEncoder(bool reference = false);
+
+            /** check config and start a new stream with it */
+            status_t    configure(const Config &config);
+            const Config& config() const { return mConfig; }
+
+            /** takes effect from the next frame */
+            status_t    setBitpool(uint32_t bitpool);
+
+            /** PCM frames one SBC frame takes: blocks * subbands */
+            size_t      frameSamples() const { return mConfig.blocks * mConfig.subbands; }
+            /** size of an SBC frame at the current bitpool */
+            size_t      frameBytes() const { return frameBytes(mConfig); }
+
+            /**
+             * Encode frameSamples() frames of 16 bit PCM, interleaved if
+             * stereo, into one SBC frame of frameBytes() at dst.
+             * Returns the bytes written.
+             */
+            size_t      encode(const int16_t *pcm, uint8_t *dst);
+
+            /** clear the filterbank history, e.g. on a discontinuity */
+            void        reset();
+
+    static  size_t      frameBytes(const Config &config);
+    static  uint32_t    maxBitpool(const Config &config);
+    static  uint32_t    channelCount(uint32_t channelMode) {
+                            return channelMode == MODE_MONO ? 1 : 2;
+                        }
+
+            /**
+             * The bit allocation of the specification, for each channel and
+             * subband from the scale factors. Public for decoders.
+             */
+    static  void        allocateBits(const Config &config,
+                                const uint8_t scaleFactors[kMaxChannels][kMaxSubbands],
+                                uint8_t bits[kMaxChannels][kMaxSubbands]);
+
+            /**
+             * CRC-8 of the specification (x^8 + x^4 + x^3 + x^2 + 1) over
+             * the first bits of data, continuing from crc; frames start it
+             * at 0x0f.
+             */
+    static  uint8_t     crc8(uint8_t crc, const uint8_t *data, size_t bits);
+
+private:
+                        AudioSbcEncoder(const AudioSbcEncoder &);
+            AudioSbcEncoder& operator=(const AudioSbcEncoder &);
+
+            void        analyze(uint32_t channels);
+            void        computeScaleFactors(uint32_t channels);
+            uint32_t    jointStereo();
+            size_t      pack(uint8_t *dst, uint32_t join);
+
+    const bool          mReference;
+    Config              mConfig;
+    // per channel, the last 9 blocks of the previous frame then this
+    // frame's, in time order
+    int16_t             mHistory[kMaxChannels][(9 + kMaxBlocks) * kMaxSubbands];
+    int32_t             mSamples[kMaxBlocks][kMaxChannels][kMaxSubbands];
+    uint8_t             mScaleFactors[kMaxChannels][kMaxSubbands];
+};
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
+
+#endif // ANDROID_AUDIO_SBC_ENCODER_H
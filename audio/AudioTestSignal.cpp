@@ -0,0 +1,236 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define LOG_TAG "AudioTestSignal"
+#include <utils/Log.h>
+
+#include "AudioMixOps.h"
+#include "AudioTestSignal.h"
+
+namespace android_audio_legacy {
+
+// ----------------------------------------------------------------------------
+
+static const float kSweepStartHz = 20.0f;
+static const float kSweepEndHz = 20000.0f;
+// -6dBFS for the sweep, about -12dBFS for noise, leaving headroom downstream
+static const float kSweepAmplitude = 0.5f;
+static const int kNoiseAttenuation = 2;
+
+static uint32_t readLe32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t readLe16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+AudioTestSignal::AudioTestSignal(uint32_t sampleRate, uint32_t channelCount, int format)
+    : mSampleRate(sampleRate), mChannelCount(channelCount), mFormat(format),
+      mFrameSize(channelCount * (format == AudioSystem::PCM_16_BIT ? 2 : 1)),
+      mType(SIGNAL_NONE), mData(0), mSize(0), mPosition(0), mMap(0), mMapSize(0)
+{
+}
+
+AudioTestSignal::~AudioTestSignal()
+{
+    release();
+}
+
+void AudioTestSignal::release()
+{
+    if (mMap != 0) {
+        munmap(mMap, mMapSize);
+        mMap = 0;
+        mMapSize = 0;
+    } else {
+        free((void *)mData);
+    }
+    mData = 0;
+    mSize = 0;
+    mPosition = 0;
+    mType = SIGNAL_NONE;
+}
+
+int AudioTestSignal::typeFromString(const char *name)
+{
+    if (strcmp(name, "sweep") == 0) return SIGNAL_SWEEP;
+    if (strcmp(name, "noise") == 0) return SIGNAL_NOISE;
+    if (strcmp(name, "impulse") == 0) return SIGNAL_IMPULSE;
+    if (strcmp(name, "file") == 0) return SIGNAL_FILE;
+    return SIGNAL_NONE;
+}
+
+status_t AudioTestSignal::openFile(const char *path)
+{
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return -errno;
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < 12) {
+        ::close(fd);
+        return BAD_VALUE;
+    }
+    // populated now, so the audio thread does not take the page faults
+    void *map = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        ALOGE("cannot map %s: %s", path, strerror(errno));
+        return NO_MEMORY;
+    }
+
+    const uint8_t *p = (const uint8_t *)map;
+    const uint8_t *end = p + st.st_size;
+    const uint8_t *data = 0;
+    size_t dataSize = 0;
+    bool formatOk = false;
+    if (memcmp(p, "RIFF", 4) == 0 && memcmp(p + 8, "WAVE", 4) == 0) {
+        // chunks are word aligned; "data" is normally the last one
+        for (p += 12; p + 8 <= end; ) {
+            uint32_t size = readLe32(p + 4);
+            const uint8_t *body = p + 8;
+            if (size > (size_t)(end - body)) size = end - body;
+            if (memcmp(p, "fmt ", 4) == 0 && size >= 16) {
+                uint32_t bits = readLe16(body + 14);
+                formatOk = readLe16(body) == 1 && readLe16(body + 2) == mChannelCount &&
+                        readLe32(body + 4) == mSampleRate &&
+                        bits == (mFormat == AudioSystem::PCM_16_BIT ? 16u : 8u);
+            } else if (memcmp(p, "data", 4) == 0) {
+                data = body;
+                dataSize = size;
+                break;
+            }
+            p = body + size + (size & 1);
+        }
+    }
+    dataSize -= dataSize % mFrameSize;
+    if (!formatOk || data == 0 || dataSize == 0) {
+        ALOGW("%s is not a %u channel, %u Hz PCM WAV file", path, mChannelCount, mSampleRate);
+        munmap(map, st.st_size);
+        return BAD_VALUE;
+    }
+
+    release();
+    madvise(map, st.st_size, MADV_SEQUENTIAL);
+    mMap = map;
+    mMapSize = st.st_size;
+    mData = data;
+    mSize = dataSize;
+    mType = SIGNAL_FILE;
+    ALOGV("mapped %zu bytes of %s", mSize, path);
+    return NO_ERROR;
+}
+
+status_t AudioTestSignal::generate(int type)
+{
+    if (type != SIGNAL_SWEEP && type != SIGNAL_NOISE && type != SIGNAL_IMPULSE) {
+        return BAD_VALUE;
+    }
+    if (mSampleRate == 0 || mChannelCount == 0 || mChannelCount > 2) return BAD_VALUE;
+
+    size_t frames = (size_t)mSampleRate * kLoopMs / 1000;
+    size_t samples = frames * mChannelCount;
+    bool wide = mFormat == AudioSystem::PCM_16_BIT;
+    uint8_t *loop = (uint8_t *)malloc(frames * mFrameSize);
+    // 16 bit interleaved, then the signal itself in mono
+    int16_t *pcm = wide ? (int16_t *)loop : (int16_t *)malloc(samples * sizeof(int16_t));
+    int16_t *mono = mChannelCount == 1 ? pcm : (int16_t *)malloc(frames * sizeof(int16_t));
+    float *phase = type == SIGNAL_SWEEP ? (float *)malloc(frames * sizeof(float)) : 0;
+    if (loop == 0 || pcm == 0 || mono == 0 || (type == SIGNAL_SWEEP && phase == 0)) {
+        if (mono != pcm) free(mono);
+        if (pcm != (int16_t *)loop) free(pcm);
+        free(loop);
+        free(phase);
+        return NO_MEMORY;
+    }
+
+    switch (type) {
+    case SIGNAL_SWEEP: {
+        // exponential, so each octave gets the same time; the phase is
+        // accumulated in double so it stays accurate over the whole loop
+        double endHz = kSweepEndHz < mSampleRate * 0.45 ? kSweepEndHz : mSampleRate * 0.45;
+        double step = kSweepStartHz / (double)mSampleRate;
+        double growth = pow(endHz / kSweepStartHz, 1.0 / frames);
+        double cycles = 0;
+        for (size_t i = 0; i < frames; i++) {
+            phase[i] = (float)cycles;
+            cycles += step;
+            if (cycles >= 1.0) cycles -= 1.0;
+            step *= growth;
+        }
+        sineCycles16(mono, phase, frames, kSweepAmplitude);
+        break;
+    }
+    case SIGNAL_NOISE: {
+        AudioDither state;
+        noise16(mono, frames, &state, kNoiseAttenuation);
+        break;
+    }
+    case SIGNAL_IMPULSE:
+        memset(mono, 0, frames * sizeof(int16_t));
+        mono[0] = 32767;
+        break;
+    }
+
+    if (mono != pcm) {
+        upmixMonoToStereo16(pcm, mono, frames);
+        free(mono);
+    }
+    if (!wide) {
+        for (size_t i = 0; i < samples; i++) {
+            loop[i] = (uint8_t)((pcm[i] >> 8) + 128);
+        }
+        free(pcm);
+    }
+    free(phase);
+
+    release();
+    mData = loop;
+    mSize = frames * mFrameSize;
+    mType = type;
+    return NO_ERROR;
+}
+
+size_t AudioTestSignal::read(void *buffer, size_t bytes)
+{
+    if (mSize == 0) return 0;
+    uint8_t *dst = (uint8_t *)buffer;
+    size_t left = bytes;
+    while (left) {
+        size_t n = mSize - mPosition < left ? mSize - mPosition : left;
+        memcpy(dst, mData + mPosition, n);
+        dst += n;
+        left -= n;
+        mPosition += n;
+        if (mPosition == mSize) mPosition = 0;
+    }
+    return bytes;
+}
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
@@ -0,0 +1,95 @@
+/*
+**
+** Copyright 2026, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef ANDROID_AUDIO_TEST_SIGNAL_H
+#define ANDROID_AUDIO_TEST_SIGNAL_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <hardware_legacy/AudioSystemLegacy.h>
+
+namespace android_audio_legacy {
+
+// ----------------------------------------------------------------------------
+
+/**
+ * A looping capture source for testing without a microphone.
+ *
+ * The loop is either a WAV file, mapped once and never read with stdio, or
+ * a signal generated up front: a logarithmic sine sweep, white noise or an
+ * impulse per loop. Either way read() is a memcpy and nothing on the audio
+ * thread touches storage or allocates. Generated signals are deterministic,
+ * so two runs capture the same samples.
+ *
+ * 16 bit and unsigned 8 bit PCM, mono or stereo.
+ */
+class AudioTestSignal {
+public:
+    enum {
+        SIGNAL_NONE,
+        SIGNAL_FILE,
+        SIGNAL_SWEEP,       // 20Hz to 20kHz, or Nyquist, over the loop
+        SIGNAL_NOISE,
+        SIGNAL_IMPULSE,     // one full scale sample at the start of the loop
+    };
+
+    // length of generated loops
+    static const uint32_t kLoopMs = 2000;
+
+                        AudioTestSignal(uint32_t sampleRate, uint32_t channelCount, int format);
+                        ~AudioTestSignal();
+
+            /** map a WAV file, which must match the stream's configuration */
+            status_t    openFile(const char *path);
+            /** generate a SIGNAL_SWEEP, SIGNAL_NOISE or SIGNAL_IMPULSE loop */
+            status_t    generate(int type);
+
+            /** fill buffer from the loop, wrapping as needed; 0 if there is none */
+            size_t      read(void *buffer, size_t bytes);
+            /** start again from the beginning of the loop */
+            void        rewind() { mPosition = 0; }
+
+            int         type() const { return mType; }
+            size_t      loopBytes() const { return mSize; }
+
+            /** "sweep", "noise", "impulse" or "file", SIGNAL_NONE for anything else */
+    static  int         typeFromString(const char *name);
+
+private:
+                        AudioTestSignal(const AudioTestSignal &);
+            AudioTestSignal& operator=(const AudioTestSignal &);
+
+            void        release();
+
+    const uint32_t      mSampleRate;
+    const uint32_t      mChannelCount;
+    const int           mFormat;
+    const size_t        mFrameSize;
+    int                 mType;
+    const uint8_t       *mData;         // the loop, in the stream's format
+    size_t              mSize;          // whole frames
+    size_t              mPosition;
+    void                *mMap;          // file mapping, when mType is SIGNAL_FILE
+    size_t              mMapSize;
+};
+
+// ----------------------------------------------------------------------------
+
+}; // namespace android_audio_legacy
+
+#endif // ANDROID_AUDIO_TEST_SIGNAL_H
@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "AudioDumpFormat.h"
+
+using namespace android_audio_legacy;
+
+static volatile sig_atomic_t gStop = 0;
+
+static void usage() {
+    std::cout << "Usage: audio_dump info <file.adump>\n"
+              << "       audio_dump wav <file.adump> <out.wav>\n"
+              << "       audio_dump replay <file.adump> [speed]\n"
+              << "Inspect a dump written by AudioDumpInterface, convert it to WAV, or write\n"
+              << "its PCM to stdout with the timing it was recorded with. Frames the dump\n"
+              << "dropped come back as silence. speed scales the recorded timing (2 = twice\n"
+              << "as fast, 0 = as fast as possible).\n";
+}
+
+static int64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+static bool isUnsigned8(const AudioDumpHeader& h) {
+    return h.format == AudioSystem::PCM_8_BIT;
+}
+
+static bool isFloat(const AudioDumpHeader& h) {
+    return h.format == AUDIO_FORMAT_PCM_FLOAT;
+}
+
+// Walks a dump, calling audio(data, frames, gap) for its audio, with the
+// gaps the sync records show filled with silence, and sync(record) at each
+// sync.
+// Returns false if the dump is corrupt.
+template <typename Audio, typename Sync>
+static bool walk(AudioDumpReader* reader, Audio audio, Sync sync) {
+    const AudioDumpHeader& h = reader->header();
+    std::vector<uint8_t> silence(kAudioDumpMaxRecordFrames * h.frameSize,
+                                 isUnsigned8(h) ? 0x80 : 0);
+    uint64_t position = 0;  // in the stream, counting the gaps
+    uint32_t type;
+    status_t status;
+    while (!gStop && (status = reader->next(&type)) == NO_ERROR) {
+        if (type == AUDIO_DUMP_RECORD_SYNC) {
+            const AudioDumpSync& s = reader->sync();
+            while (position < s.position) {
+                size_t n = std::min<uint64_t>(s.position - position, kAudioDumpMaxRecordFrames);
+                audio(silence.data(), n, true);
+                position += n;
+            }
+            sync(s);
+        } else if (reader->frames()) {
+            audio(reader->pcm(), reader->frames(), false);
+            position += reader->frames();
+        }
+    }
+    return gStop || status == NOT_ENOUGH_DATA;
+}
+
+static int info(const char* path) {
+    AudioDumpReader reader;
+    if (reader.open(path) != NO_ERROR) {
+        std::cerr << "cannot read dump " << path << "\n";
+        return EXIT_FAILURE;
+    }
+    const AudioDumpHeader& h = reader.header();
+    char start[64];
+    time_t seconds = h.startRealtimeNs / 1000000000;
+    strftime(start, sizeof(start), "%Y-%m-%d %H:%M:%S", localtime(&seconds));
+    printf("%s stream, device %#x, started %s.%03lld\n",
+           (h.flags & AUDIO_DUMP_FLAG_INPUT) ? "input" : "output", h.device, start,
+           (long long)(h.startRealtimeNs / 1000000 % 1000));
+    printf("format %#x, %u Hz, channel mask %#x (%u channels), %u byte frames%s\n", h.format,
+           h.sampleRate, h.channelMask, h.channelCount, h.frameSize,
+           (h.flags & AUDIO_DUMP_FLAG_COMPRESSED) ? ", compressed" : "");
+
+    uint64_t recorded = 0, missing = 0, syncs = 0;
+    int64_t firstNs = 0, lastNs = 0;
+    bool ok = walk(
+            &reader,
+            [&](const void*, size_t frames, bool gap) { (gap ? missing : recorded) += frames; },
+            [&](const AudioDumpSync& s) {
+                if (syncs++ == 0) firstNs = s.timeNs;
+                lastNs = s.timeNs;
+            });
+    long size = 0;
+    if (FILE* f = fopen(path, "rb")) {
+        fseek(f, 0, SEEK_END);
+        size = ftell(f);
+        fclose(f);
+    }
+    printf("%llu frames (%.3f s), %llu dropped, %llu sync records over %.3f s\n",
+           (unsigned long long)recorded, h.sampleRate ? double(recorded) / h.sampleRate : 0.0,
+           (unsigned long long)missing, (unsigned long long)syncs, (lastNs - firstNs) / 1e9);
+    if (recorded) {
+        printf("%ld bytes, %.1f%% of the PCM\n", size,
+               100.0 * size / double(recorded * h.frameSize));
+    }
+    if (!ok) {
+        std::cerr << "corrupt record after frame " << reader.framesRead() << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+static void put16(FILE* f, uint16_t v) {
+    fputc(v & 0xff, f);
+    fputc(v >> 8, f);
+}
+
+static void put32(FILE* f, uint32_t v) {
+    put16(f, v & 0xffff);
+    put16(f, v >> 16);
+}
+
+static void writeWavHeader(FILE* f, const AudioDumpHeader& h, uint32_t dataBytes) {
+    uint16_t bits = h.frameSize / h.channelCount * 8;
+    fwrite("RIFF", 4, 1, f);
+    put32(f, 36 + dataBytes);
+    fwrite("WAVEfmt ", 8, 1, f);
+    put32(f, 16);
+    put16(f, isFloat(h) ? 3 : 1);
+    put16(f, h.channelCount);
+    put32(f, h.sampleRate);
+    put32(f, h.sampleRate * h.frameSize);
+    put16(f, h.frameSize);
+    put16(f, bits);
+    fwrite("data", 4, 1, f);
+    put32(f, dataBytes);
+}
+
+static int wav(const char* path, const char* out) {
+    AudioDumpReader reader;
+    if (reader.open(path) != NO_ERROR) {
+        std::cerr << "cannot read dump " << path << "\n";
+        return EXIT_FAILURE;
+    }
+    const AudioDumpHeader& h = reader.header();
+    if (h.channelCount == 0 || h.frameSize % h.channelCount) {
+        std::cerr << "cannot express format " << std::hex << h.format << " as WAV\n";
+        return EXIT_FAILURE;
+    }
+    FILE* f = fopen(out, "wb");
+    if (f == nullptr) {
+        std::cerr << "cannot write " << out << ": " << strerror(errno) << "\n";
+        return EXIT_FAILURE;
+    }
+    // the sizes are patched once known
+    writeWavHeader(f, h, 0);
+    uint64_t bytes = 0;
+    bool ok = walk(
+            &reader,
+            [&](const void* data, size_t frames, bool) {
+                fwrite(data, h.frameSize, frames, f);
+                bytes += frames * h.frameSize;
+            },
+            [](const AudioDumpSync&) {});
+    fseek(f, 0, SEEK_SET);
+    writeWavHeader(f, h, uint32_t(std::min<uint64_t>(bytes, UINT32_MAX - 36)));
+    fclose(f);
+    std::cerr << "wrote " << bytes / h.frameSize << " frames\n";
+    if (!ok) {
+        std::cerr << "stopped at a corrupt record after frame " << reader.framesRead() << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+// Audio goes out at the stream's rate, anchored to each sync record, so
+// the output keeps the recorded timing including stalls. Deadlines are
+// absolute so pacing error does not accumulate.
+static int replay(const char* path, double speed) {
+    AudioDumpReader reader;
+    if (reader.open(path) != NO_ERROR) {
+        std::cerr << "cannot read dump " << path << "\n";
+        return EXIT_FAILURE;
+    }
+    const AudioDumpHeader& h = reader.header();
+    const int64_t startNs = nowNs();
+    int64_t anchorNs = 0, recordedAnchorNs = -1;
+    uint64_t anchorPosition = 0, position = 0;
+    bool ok = walk(
+            &reader,
+            [&](const void* data, size_t frames, bool) {
+                if (speed > 0 && recordedAnchorNs >= 0 && h.sampleRate) {
+                    int64_t due = anchorNs + int64_t((position - anchorPosition) * 1e9 /
+                                                     h.sampleRate / speed);
+                    int64_t now = nowNs() - startNs;
+                    if (due > now) usleep((due - now) / 1000);
+                }
+                if (fwrite(data, h.frameSize, frames, stdout) != frames) gStop = 1;
+                position += frames;
+            },
+            [&](const AudioDumpSync& s) {
+                if (speed <= 0) return;
+                if (recordedAnchorNs < 0) recordedAnchorNs = s.timeNs;
+                anchorNs = int64_t((s.timeNs - recordedAnchorNs) / speed);
+                anchorPosition = s.position;
+            });
+    fflush(stdout);
+    std::cerr << "replayed " << position << " frames\n";
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, [](int) { gStop = 1; });
+    signal(SIGTERM, [](int) { gStop = 1; });
+
+    if (!strcmp(argv[1], "info")) {
+        return info(argv[2]);
+    }
+    if (!strcmp(argv[1], "wav") && argc > 3) {
+        return wav(argv[2], argv[3]);
+    }
+    if (!strcmp(argv[1], "replay")) {
+        return replay(argv[2], argc > 3 ? strtod(argv[3], nullptr) : 1.0);
+    }
+
+    usage();
+    return EXIT_FAILURE;
+}
@@ -26,6 +26,9 @@
 #include <hardware_legacy/AudioHardwareInterface.h>
 #include <hardware_legacy/AudioSystemLegacy.h>
 
+#include "AudioDeviceMap.h"
+#include "AudioParameterScanner.h"
+
 namespace android_audio_legacy {
 
 class AudioHardwareInterface;
@@ -55,65 +58,14 @@ struct legacy_stream_in {
 };
 
 
-enum {
-    HAL_API_REV_1_0,
-    HAL_API_REV_2_0,
-    HAL_API_REV_NUM
-} hal_api_rev;
-
-static uint32_t audio_device_conv_table[][HAL_API_REV_NUM] =
-{
-    /* output devices */
-    { AudioSystem::DEVICE_OUT_EARPIECE, AUDIO_DEVICE_OUT_EARPIECE },
-    { AudioSystem::DEVICE_OUT_SPEAKER, AUDIO_DEVICE_OUT_SPEAKER },
-    { AudioSystem::DEVICE_OUT_WIRED_HEADSET, AUDIO_DEVICE_OUT_WIRED_HEADSET },
-    { AudioSystem::DEVICE_OUT_WIRED_HEADPHONE, AUDIO_DEVICE_OUT_WIRED_HEADPHONE },
-    { AudioSystem::DEVICE_OUT_BLUETOOTH_SCO, AUDIO_DEVICE_OUT_BLUETOOTH_SCO },
-    { AudioSystem::DEVICE_OUT_BLUETOOTH_SCO_HEADSET, AUDIO_DEVICE_OUT_BLUETOOTH_SCO_HEADSET },
-    { AudioSystem::DEVICE_OUT_BLUETOOTH_SCO_CARKIT, AUDIO_DEVICE_OUT_BLUETOOTH_SCO_CARKIT },
-    { AudioSystem::DEVICE_OUT_BLUETOOTH_A2DP, AUDIO_DEVICE_OUT_BLUETOOTH_A2DP },
-    { AudioSystem::DEVICE_OUT_BLUETOOTH_A2DP_HEADPHONES, AUDIO_DEVICE_OUT_BLUETOOTH_A2DP_HEADPHONES },
-    { AudioSystem::DEVICE_OUT_BLUETOOTH_A2DP_SPEAKER, AUDIO_DEVICE_OUT_BLUETOOTH_A2DP_SPEAKER },
-    { AudioSystem::DEVICE_OUT_AUX_DIGITAL, AUDIO_DEVICE_OUT_AUX_DIGITAL },
-    { AudioSystem::DEVICE_OUT_ANLG_DOCK_HEADSET, AUDIO_DEVICE_OUT_ANLG_DOCK_HEADSET },
-    { AudioSystem::DEVICE_OUT_DGTL_DOCK_HEADSET, AUDIO_DEVICE_OUT_DGTL_DOCK_HEADSET },
-    { AudioSystem::DEVICE_OUT_DEFAULT, AUDIO_DEVICE_OUT_DEFAULT },
-    /* input devices */
-    { AudioSystem::DEVICE_IN_COMMUNICATION, AUDIO_DEVICE_IN_COMMUNICATION },
-    { AudioSystem::DEVICE_IN_AMBIENT, AUDIO_DEVICE_IN_AMBIENT },
-    { AudioSystem::DEVICE_IN_BUILTIN_MIC, AUDIO_DEVICE_IN_BUILTIN_MIC },
-    { AudioSystem::DEVICE_IN_BLUETOOTH_SCO_HEADSET, AUDIO_DEVICE_IN_BLUETOOTH_SCO_HEADSET },
-    { AudioSystem::DEVICE_IN_WIRED_HEADSET, AUDIO_DEVICE_IN_WIRED_HEADSET },
-    { AudioSystem::DEVICE_IN_AUX_DIGITAL, AUDIO_DEVICE_IN_AUX_DIGITAL },
-    { AudioSystem::DEVICE_IN_VOICE_CALL, AUDIO_DEVICE_IN_VOICE_CALL },
-    { AudioSystem::DEVICE_IN_BACK_MIC, AUDIO_DEVICE_IN_BACK_MIC },
-    { AudioSystem::DEVICE_IN_DEFAULT, AUDIO_DEVICE_IN_DEFAULT },
-};
-
-static audio_devices_t convert_audio_device(uint32_t from_device, int from_rev, int to_rev)
+static int to_legacy_device(int device)
 {
-    const uint32_t k_num_devices = sizeof(audio_device_conv_table)/sizeof(uint32_t)/HAL_API_REV_NUM;
-    audio_devices_t to_device = AUDIO_DEVICE_NONE;
-    uint32_t in_bit = 0;
-
-    if (from_rev != HAL_API_REV_1_0) {
-        in_bit = from_device & AUDIO_DEVICE_BIT_IN;
-        from_device &= ~AUDIO_DEVICE_BIT_IN;
-    }
+    return convert_audio_device(device, HAL_API_REV_2_0, HAL_API_REV_1_0);
+}
 
-    while (from_device) {
-        uint32_t i = 31 - __builtin_clz(from_device);
-        uint32_t cur_device = (1 << i) | in_bit;
-
-        for (i = 0; i < k_num_devices; i++) {
-            if (audio_device_conv_table[i][from_rev] == cur_device) {
-                to_device = (audio_devices_t)(to_device | audio_device_conv_table[i][to_rev]);
-                break;
-            }
-        }
-        from_device &= ~cur_device;
-    }
-    return to_device;
+static int from_legacy_device(int device)
+{
+    return convert_audio_device(device, HAL_API_REV_1_0, HAL_API_REV_2_0);
 }
 
 
@@ -130,9 +82,7 @@ static int out_set_sample_rate(struct audio_stream *stream, uint32_t rate)
     struct legacy_stream_out *out =
         reinterpret_cast<struct legacy_stream_out *>(stream);
 
-    ALOGE("(%s:%d) %s: Implement me!", __FILE__, __LINE__, __func__);
-    /* TODO: implement this */
-    return 0;
+    return out->legacy_out->reconfigure(0, rate);
 }
 
 static size_t out_get_buffer_size(const struct audio_stream *stream)
@@ -161,9 +111,7 @@ static int out_set_format(struct audio_stream *stream, audio_format_t format)
 {
     struct legacy_stream_out *out =
         reinterpret_cast<struct legacy_stream_out *>(stream);
-    ALOGE("(%s:%d) %s: Implement me!", __FILE__, __LINE__, __func__);
-    /* TODO: implement me */
-    return 0;
+    return out->legacy_out->reconfigure((int) format, 0);
 }
 
 static int out_standby(struct audio_stream *stream)
@@ -185,15 +133,11 @@ static int out_set_parameters(struct audio_stream *stream, const char *kvpairs)
 {
     struct legacy_stream_out *out =
         reinterpret_cast<struct legacy_stream_out *>(stream);
-    int val;
-    String8 s8 = String8(kvpairs);
-    AudioParameter parms = AudioParameter(String8(kvpairs));
-
-    if (parms.getInt(String8(AUDIO_PARAMETER_STREAM_ROUTING), val) == NO_ERROR) {
-        val = convert_audio_device(val, HAL_API_REV_2_0, HAL_API_REV_1_0);
-        parms.remove(String8(AUDIO_PARAMETER_STREAM_ROUTING));
-        parms.addInt(String8(AUDIO_PARAMETER_STREAM_ROUTING), val);
-        s8 = parms.toString();
+    String8 s8;
+
+    if (!audioParameterConvertInt(&s8, kvpairs, AUDIO_PARAMETER_STREAM_ROUTING,
+                                  to_legacy_device)) {
+        s8 = String8(kvpairs);
     }
 
     return out->legacy_out->setParameters(s8);
@@ -203,19 +147,13 @@ static char * out_get_parameters(const struct audio_stream *stream, const char *
 {
     const struct legacy_stream_out *out =
         reinterpret_cast<const struct legacy_stream_out *>(stream);
-    String8 s8;
-    int val;
-
-    s8 = out->legacy_out->getParameters(String8(keys));
+    String8 s8 = out->legacy_out->getParameters(String8(keys));
+    String8 converted;
 
-    AudioParameter parms = AudioParameter(s8);
-    if (parms.getInt(String8(AUDIO_PARAMETER_STREAM_ROUTING), val) == NO_ERROR) {
-        val = convert_audio_device(val, HAL_API_REV_1_0, HAL_API_REV_2_0);
-        parms.remove(String8(AUDIO_PARAMETER_STREAM_ROUTING));
-        parms.addInt(String8(AUDIO_PARAMETER_STREAM_ROUTING), val);
-        s8 = parms.toString();
+    if (audioParameterConvertInt(&converted, s8.string(), AUDIO_PARAMETER_STREAM_ROUTING,
+                                 from_legacy_device)) {
+        return strdup(converted.string());
     }
-
     return strdup(s8.string());
 }
 
@@ -258,6 +196,54 @@ static int out_get_next_write_timestamp(const struct audio_stream_out *stream,
     return out->legacy_out->getNextWriteTimestamp(timestamp);
 }
 
+static int out_get_presentation_position(const struct audio_stream_out *stream,
+                                        uint64_t *frames, struct timespec *timestamp)
+{
+    const struct legacy_stream_out *out =
+        reinterpret_cast<const struct legacy_stream_out *>(stream);
+    return out->legacy_out->getPresentationPosition(frames, timestamp);
+}
+
+static int out_start(const struct audio_stream_out *stream)
+{
+    const struct legacy_stream_out *out =
+        reinterpret_cast<const struct legacy_stream_out *>(stream);
+    return out->legacy_out->start();
+}
+
+static int out_stop(const struct audio_stream_out *stream)
+{
+    const struct legacy_stream_out *out =
+        reinterpret_cast<const struct legacy_stream_out *>(stream);
+    return out->legacy_out->stop();
+}
+
+static int out_create_mmap_buffer(const struct audio_stream_out *stream,
+                                  int32_t min_size_frames,
+                                  struct audio_mmap_buffer_info *info)
+{
+    const struct legacy_stream_out *out =
+        reinterpret_cast<const struct legacy_stream_out *>(stream);
+    if (info == NULL || min_size_frames <= 0)
+        return -EINVAL;
+    return out->legacy_out->createMmapBuffer(min_size_frames,
+                                             &info->shared_memory_address,
+                                             &info->shared_memory_fd,
+                                             &info->buffer_size_frames,
+                                             &info->burst_size_frames);
+}
+
+static int out_get_mmap_position(const struct audio_stream_out *stream,
+                                 struct audio_mmap_position *position)
+{
+    const struct legacy_stream_out *out =
+        reinterpret_cast<const struct legacy_stream_out *>(stream);
+    if (position == NULL)
+        return -EINVAL;
+    return out->legacy_out->getMmapPosition(&position->time_nanoseconds,
+                                            &position->position_frames);
+}
+
 static int out_add_audio_effect(const struct audio_stream *stream, effect_handle_t effect)
 {
     return 0;
@@ -281,9 +267,7 @@ static int in_set_sample_rate(struct audio_stream *stream, uint32_t rate)
     struct legacy_stream_in *in =
         reinterpret_cast<struct legacy_stream_in *>(stream);
 
-    ALOGE("(%s:%d) %s: Implement me!", __FILE__, __LINE__, __func__);
-    /* TODO: implement this */
-    return 0;
+    return in->legacy_in->reconfigure(0, rate);
 }
 
 static size_t in_get_buffer_size(const struct audio_stream *stream)
@@ -312,9 +296,7 @@ static int in_set_format(struct audio_stream *stream, audio_format_t format)
 {
     struct legacy_stream_in *in =
         reinterpret_cast<struct legacy_stream_in *>(stream);
-    ALOGE("(%s:%d) %s: Implement me!", __FILE__, __LINE__, __func__);
-    /* TODO: implement me */
-    return 0;
+    return in->legacy_in->reconfigure((int) format, 0);
 }
 
 static int in_standby(struct audio_stream *stream)
@@ -335,15 +317,11 @@ static int in_set_parameters(struct audio_stream *stream, const char *kvpairs)
 {
     struct legacy_stream_in *in =
         reinterpret_cast<struct legacy_stream_in *>(stream);
-    int val;
-    AudioParameter parms = AudioParameter(String8(kvpairs));
-    String8 s8 = String8(kvpairs);
-
-    if (parms.getInt(String8(AUDIO_PARAMETER_STREAM_ROUTING), val) == NO_ERROR) {
-        val = convert_audio_device(val, HAL_API_REV_2_0, HAL_API_REV_1_0);
-        parms.remove(String8(AUDIO_PARAMETER_STREAM_ROUTING));
-        parms.addInt(String8(AUDIO_PARAMETER_STREAM_ROUTING), val);
-        s8 = parms.toString();
+    String8 s8;
+
+    if (!audioParameterConvertInt(&s8, kvpairs, AUDIO_PARAMETER_STREAM_ROUTING,
+                                  to_legacy_device)) {
+        s8 = String8(kvpairs);
     }
 
     return in->legacy_in->setParameters(s8);
@@ -354,19 +332,13 @@ static char * in_get_parameters(const struct audio_stream *stream,
 {
     const struct legacy_stream_in *in =
         reinterpret_cast<const struct legacy_stream_in *>(stream);
-    String8 s8;
-    int val;
-
-    s8 = in->legacy_in->getParameters(String8(keys));
+    String8 s8 = in->legacy_in->getParameters(String8(keys));
+    String8 converted;
 
-    AudioParameter parms = AudioParameter(s8);
-    if (parms.getInt(String8(AUDIO_PARAMETER_STREAM_ROUTING), val) == NO_ERROR) {
-        val = convert_audio_device(val, HAL_API_REV_1_0, HAL_API_REV_2_0);
-        parms.remove(String8(AUDIO_PARAMETER_STREAM_ROUTING));
-        parms.addInt(String8(AUDIO_PARAMETER_STREAM_ROUTING), val);
-        s8 = parms.toString();
+    if (audioParameterConvertInt(&converted, s8.string(), AUDIO_PARAMETER_STREAM_ROUTING,
+                                 from_legacy_device)) {
+        return strdup(converted.string());
     }
-
     return strdup(s8.string());
 }
 
@@ -392,6 +364,14 @@ static uint32_t in_get_input_frames_lost(struct audio_stream_in *stream)
     return in->legacy_in->getInputFramesLost();
 }
 
+static int in_get_capture_position(const struct audio_stream_in *stream,
+                                   int64_t *frames, int64_t *time)
+{
+    const struct legacy_stream_in *in =
+        reinterpret_cast<const struct legacy_stream_in *>(stream);
+    return in->legacy_in->getCapturePosition(frames, time);
+}
+
 static int in_add_audio_effect(const struct audio_stream *stream, effect_handle_t effect)
 {
     const struct legacy_stream_in *in =
@@ -532,6 +512,13 @@ static int adev_open_output_stream(struct audio_hw_device *dev,
     out->stream.write = out_write;
     out->stream.get_render_position = out_get_render_position;
     out->stream.get_next_write_timestamp = out_get_next_write_timestamp;
+    out->stream.get_presentation_position = out_get_presentation_position;
+    if (flags & AUDIO_OUTPUT_FLAG_MMAP_NOIRQ) {
+        out->stream.start = out_start;
+        out->stream.stop = out_stop;
+        out->stream.create_mmap_buffer = out_create_mmap_buffer;
+        out->stream.get_mmap_position = out_get_mmap_position;
+    }
 
     *stream_out = &out->stream;
     return 0;
@@ -598,6 +585,7 @@ static int adev_open_input_stream(struct audio_hw_device *dev,
     in->stream.set_gain = in_set_gain;
     in->stream.read = in_read;
     in->stream.get_input_frames_lost = in_get_input_frames_lost;
+    in->stream.get_capture_position = in_get_capture_position;
 
     *stream_in = &in->stream;
     return 0;
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_FAKE_AUDIO_DEVICE_H
+#define ANDROID_AUDIO_FAKE_AUDIO_DEVICE_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+static inline int64_t fakeDeviceNowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+static inline void fakeDeviceSleepUntil(int64_t deadlineNs) {
+    struct timespec ts = {time_t(deadlineNs / 1000000000), long(deadlineNs % 1000000000)};
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+}
+
+// Stand-in for a blocking PCM driver such as /dev/eac: the HAL writes to
+// fd(), and a thread drains the other end of a pipe one period at a time at
+// a fixed rate, optionally stalling every stallEvery periods like a driver
+// waiting on a late DMA interrupt. onPeriod, if set, sees each period as the
+// device consumes it.
+class FakeAudioDevice {
+  public:
+    FakeAudioDevice(size_t periodBytes, int64_t periodNs, int64_t stallNs = 0, int stallEvery = 0,
+                    std::function<void(const char*)> onPeriod = nullptr)
+        : mPeriodBytes(periodBytes),
+          mPeriodNs(periodNs),
+          mStallNs(stallNs),
+          mStallEvery(stallEvery),
+          mOnPeriod(onPeriod) {
+        if (pipe(mFds) != 0) abort();
+        // Keep the kernel buffer small so it cannot hide the device timing.
+        fcntl(mFds[1], F_SETPIPE_SZ, 4096);
+        mThread = std::thread([this] { drain(); });
+    }
+    ~FakeAudioDevice() {
+        close(mFds[1]);
+        mThread.join();
+        close(mFds[0]);
+    }
+    int fd() const { return mFds[1]; }
+    // CPU time spent by the device thread itself, valid after destruction
+    // has started or once the writer side is idle.
+    int64_t cpuNs() const { return mCpuNs; }
+
+  private:
+    void drain() {
+        std::vector<char> buf(mPeriodBytes);
+        int64_t deadline = fakeDeviceNowNs();
+        for (int n = 1;; n++) {
+            int64_t start = fakeDeviceNowNs();
+            size_t got = 0;
+            while (got < buf.size()) {
+                ssize_t ret = read(mFds[0], buf.data() + got, buf.size() - got);
+                if (ret <= 0) {
+                    updateCpu();
+                    return;
+                }
+                got += ret;
+            }
+            if (mOnPeriod) mOnPeriod(buf.data());
+            // The device clock keeps absolute time, so a late wakeup of this
+            // thread is caught up, but time spent starved of data is not banked.
+            int64_t now = fakeDeviceNowNs();
+            if (now - start > mPeriodNs / 4) deadline = now;
+            deadline += mPeriodNs;
+            if (mStallEvery && n % mStallEvery == 0) deadline += mStallNs;
+            fakeDeviceSleepUntil(deadline);
+            updateCpu();
+        }
+    }
+    void updateCpu() {
+        struct timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        mCpuNs = int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+    const size_t mPeriodBytes;
+    const int64_t mPeriodNs;
+    const int64_t mStallNs;
+    const int mStallEvery;
+    std::function<void(const char*)> mOnPeriod;
+    int mFds[2];
+    std::thread mThread;
+    volatile int64_t mCpuNs = 0;
+};
+
+// Stand-in for a capture driver: a thread writes one period of mono 16-bit
+// frames to a pipe every periodNs for the HAL to read from fd(). Each sample
+// is its frame number, truncated to 16 bits, so a reader can tell exactly
+// how many frames went missing between two it received. Like a driver whose
+// buffer overflows, a period that does not fit in the pipe is dropped.
+class FakeCaptureDevice {
+  public:
+    FakeCaptureDevice(size_t periodFrames, int64_t periodNs)
+        : mPeriodFrames(periodFrames), mPeriodNs(periodNs) {
+        if (pipe(mFds) != 0) abort();
+        fcntl(mFds[1], F_SETFL, O_NONBLOCK);
+        mThread = std::thread([this] { fill(); });
+    }
+    ~FakeCaptureDevice() {
+        mStop = true;
+        mThread.join();
+        close(mFds[1]);
+        close(mFds[0]);
+    }
+    int fd() const { return mFds[0]; }
+    // periods the pipe had no room for
+    int dropped() const { return mDropped; }
+
+  private:
+    void fill() {
+        std::vector<int16_t> buf(mPeriodFrames);
+        uint16_t frame = 0;
+        int64_t deadline = fakeDeviceNowNs();
+        while (!mStop) {
+            for (auto& s : buf) s = int16_t(frame++);
+            if (write(mFds[1], buf.data(), buf.size() * sizeof(int16_t)) < 0) mDropped++;
+            deadline += mPeriodNs;
+            fakeDeviceSleepUntil(deadline);
+        }
+    }
+
+    const size_t mPeriodFrames;
+    const int64_t mPeriodNs;
+    int mFds[2];
+    std::thread mThread;
+    std::atomic<bool> mStop{false};
+    std::atomic<int> mDropped{0};
+};
+
+#endif  // ANDROID_AUDIO_FAKE_AUDIO_DEVICE_H
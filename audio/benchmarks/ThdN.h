@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_THD_N_H
+#define ANDROID_AUDIO_THD_N_H
+
+#include <math.h>
+#include <stdint.h>
+
+#include <utility>
+#include <vector>
+
+#include "AudioResampler.h"
+
+// THD+N of a 16-bit signal that should be a pure tone of freq at rate: the
+// best-fit sine (least squares over sin, cos and DC) is removed and the
+// residual power is reported relative to the tone, in dB.
+static inline double thdNDb(const int16_t* x, size_t n, double freq, uint32_t rate) {
+    double a[3][4] = {};
+    for (size_t i = 0; i < n; i++) {
+        double w = 2 * M_PI * freq * i / rate;
+        double b[3] = {sin(w), cos(w), 1.0};
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 3; c++) a[r][c] += b[r] * b[c];
+            a[r][3] += b[r] * x[i];
+        }
+    }
+    for (int p = 0; p < 3; p++) {
+        for (int r = 0; r < 3; r++) {
+            if (r == p) continue;
+            double f = a[r][p] / a[p][p];
+            for (int c = p; c < 4; c++) a[r][c] -= f * a[p][c];
+        }
+    }
+    double s = a[0][3] / a[0][0], c = a[1][3] / a[1][1], dc = a[2][3] / a[2][2];
+    double signal = 0, noise = 0;
+    for (size_t i = 0; i < n; i++) {
+        double w = 2 * M_PI * freq * i / rate;
+        double fit = s * sin(w) + c * cos(w) + dc;
+        signal += fit * fit;
+        noise += (x[i] - fit) * (x[i] - fit);
+    }
+    return 10 * log10(noise / signal);
+}
+
+// Converts half a second of a -6dBFS tone from inRate to outRate and returns
+// the THD+N of the output, ignoring the filter's startup.
+static inline double resamplerThdNDb(uint32_t inRate, uint32_t outRate, double freq) {
+    android_audio_legacy::AudioResampler src(inRate, outRate, 1);
+    std::vector<int16_t> in(inRate / 2);
+    for (size_t i = 0; i < in.size(); i++) {
+        in[i] = int16_t(lrint(16384 * sin(2 * M_PI * freq * i / inRate)));
+    }
+    std::vector<int16_t> out(outRate);
+    size_t consumed = in.size();
+    size_t produced = src.resample(out.data(), out.size(), in.data(), &consumed);
+    size_t skip = src.delayFrames() * outRate / inRate + 16;
+    return thdNDb(out.data() + skip, produced - skip, freq, outRate);
+}
+
+#endif  // ANDROID_AUDIO_THD_N_H
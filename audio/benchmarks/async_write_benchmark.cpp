@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "AudioHardwareGeneric.h"
+#include "FakeAudioDevice.h"
+
+using namespace android_audio_legacy;
+
+// write() latency of AudioStreamOutGeneric against a fake device that drains
+// a pipe at a fixed rate and periodically stalls, like a driver waiting on a
+// DMA interrupt that comes late. The client writes one period on a fixed
+// cadence, slightly slower than the device's average rate, as AudioFlinger's
+// mixer would.
+
+static constexpr size_t kPeriodBytes = 512;
+static constexpr int64_t kDevicePeriodNs = 50000;
+static constexpr int64_t kDeviceStallNs = 5000000;
+static constexpr int kDeviceStallEvery = 256;
+static constexpr int64_t kClientPeriodNs = 125000;
+
+// state.range(0): 0 = blocking write path, otherwise async ring size in bytes.
+static void BM_GenericWriteLatency(benchmark::State& state) {
+    FakeAudioDevice device(kPeriodBytes, kDevicePeriodNs, kDeviceStallNs, kDeviceStallEvery);
+    AudioStreamOutGeneric out;
+    out.set(nullptr, device.fd(), AudioSystem::DEVICE_OUT_SPEAKER, nullptr, nullptr, nullptr);
+    if (state.range(0)) {
+        out.enableAsyncWrite(state.range(0));
+    }
+
+    std::vector<char> period(kPeriodBytes);
+    std::vector<int64_t> latencies;
+    latencies.reserve(state.max_iterations);
+    int64_t deadline = fakeDeviceNowNs();
+    for (auto _ : state) {
+        int64_t start = fakeDeviceNowNs();
+        out.write(period.data(), period.size());
+        latencies.push_back(fakeDeviceNowNs() - start);
+        deadline += kClientPeriodNs;
+        fakeDeviceSleepUntil(deadline);
+    }
+    out.standby();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        return double(latencies[size_t(p * (latencies.size() - 1))]);
+    };
+    state.counters["p50_ns"] = percentile(0.50);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["max_ns"] = double(latencies.back());
+    state.counters["underruns"] = out.underruns();
+    state.counters["overruns"] = out.overruns();
+}
+BENCHMARK(BM_GenericWriteLatency)->Arg(0)->Arg(16384)->Arg(65536)->Iterations(8192)->UseRealTime();
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "AudioHardwareGeneric.h"
+
+using namespace android_audio_legacy;
+
+static const int kFormats[] = {
+    AUDIO_FORMAT_PCM_16_BIT,
+    AUDIO_FORMAT_PCM_8_24_BIT,
+    AUDIO_FORMAT_PCM_FLOAT,
+    AUDIO_FORMAT_PCM_24_BIT_PACKED,
+};
+
+// bufferSize() of a generic output opened at state.range(0) Hz in
+// kFormats[state.range(1)], stereo, with the normal (state.range(2) == 0) or
+// fast profile. Reports the negotiated buffer and the period it amounts to
+// at the client rate.
+static void BM_OutputBufferSize(benchmark::State& state) {
+    uint32_t rate = state.range(0);
+    int format = kFormats[state.range(1)];
+    audio_output_flags_t flags = state.range(2) ? AUDIO_OUTPUT_FLAG_FAST : AUDIO_OUTPUT_FLAG_NONE;
+    AudioStreamOutGeneric out;
+    if (out.set(nullptr, -1, 0, &format, nullptr, &rate, flags) != NO_ERROR) {
+        state.SkipWithError("format not supported");
+        return;
+    }
+
+    size_t bytes = 0;
+    for (auto _ : state) {
+        bytes = out.bufferSize();
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.counters["buffer_bytes"] = bytes;
+    state.counters["period_us"] = double(bytes / out.frameSize()) * 1e6 / rate;
+}
+BENCHMARK(BM_OutputBufferSize)
+        ->ArgsProduct({{8000, 16000, 22050, 32000, 44100, 48000, 96000, 192000},
+                       {0, 1, 2, 3},
+                       {0, 1}});
+
+// The sizing arithmetic alone, as getInputBufferSize() runs it.
+static void BM_InputBufferSize(benchmark::State& state) {
+    uint32_t rate = state.range(0);
+    size_t bytes = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(rate);
+        bytes = AudioStreamInGeneric::bufferSizeFor(rate);
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.counters["buffer_bytes"] = bytes;
+    state.counters["period_us"] = double(bytes / sizeof(int16_t)) * 1e6 / rate;
+}
+BENCHMARK(BM_InputBufferSize)->DenseRange(8000, 48000, 8000)->Arg(11025)->Arg(22050)->Arg(44100);
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <time.h>
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "AudioDeviceMap.h"
+
+using namespace android_audio_legacy;
+
+static int64_t threadCpuNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// convert_audio_device() as it was: a scan of audio_device_conv_table for
+// each device in the mask.
+static audio_devices_t convertByScan(uint32_t from_device, int from_rev, int to_rev) {
+    audio_devices_t to_device = AUDIO_DEVICE_NONE;
+    uint32_t in_bit = 0;
+
+    if (from_rev != HAL_API_REV_1_0) {
+        in_bit = from_device & AUDIO_DEVICE_BIT_IN;
+        from_device &= ~AUDIO_DEVICE_BIT_IN;
+    }
+
+    while (from_device) {
+        uint32_t i = 31 - __builtin_clz(from_device);
+        uint32_t cur_device = (1 << i) | in_bit;
+
+        for (i = 0; i < k_num_devices; i++) {
+            if (audio_device_conv_table[i][from_rev] == cur_device) {
+                to_device = (audio_devices_t)(to_device | audio_device_conv_table[i][to_rev]);
+                break;
+            }
+        }
+        from_device &= ~cur_device;
+    }
+    return to_device;
+}
+
+// Every combination of output devices and of input devices, in both
+// directions, converted with the bit maps (state.range(0) == 1) or the scan
+// (== 0). ns_per_mask is the average over all of them.
+static void BM_ConvertDevice(benchmark::State& state) {
+    const bool mapped = state.range(0);
+    struct Mask {
+        uint32_t mask;
+        int from, to;
+    };
+    std::vector<Mask> masks;
+    for (int from = HAL_API_REV_1_0; from <= HAL_API_REV_2_0; from++) {
+        const int to = from == HAL_API_REV_1_0 ? HAL_API_REV_2_0 : HAL_API_REV_1_0;
+        for (bool input : {false, true}) {
+            std::vector<uint32_t> d;
+            for (const auto& row : audio_device_conv_table) {
+                bool in = convert_audio_device(row[HAL_API_REV_1_0], HAL_API_REV_1_0,
+                                               HAL_API_REV_2_0) & AUDIO_DEVICE_BIT_IN;
+                if (in == input) d.push_back(row[from]);
+            }
+            for (uint32_t c = 1; c < (1u << d.size()); c++) {
+                uint32_t mask = 0;
+                for (size_t i = 0; i < d.size(); i++) {
+                    if (c & (1u << i)) mask |= d[i];
+                }
+                masks.push_back({mask, from, to});
+            }
+        }
+    }
+
+    int64_t start = threadCpuNs();
+    for (auto _ : state) {
+        uint32_t sum = 0;
+        for (const Mask& m : masks) {
+            sum += mapped ? convert_audio_device(m.mask, m.from, m.to)
+                          : convertByScan(m.mask, m.from, m.to);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.counters["masks"] = masks.size();
+    state.counters["ns_per_mask"] =
+            (threadCpuNs() - start) / (double(state.iterations()) * masks.size());
+}
+BENCHMARK(BM_ConvertDevice)->Arg(0)->Arg(1);
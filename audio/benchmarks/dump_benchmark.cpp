@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "AudioDumpFormat.h"
+#include "AudioDumpWriter.h"
+#include "FakeAudioDevice.h"
+
+using namespace android_audio_legacy;
+
+// The dump step of AudioStreamOutDump::write() as the audio thread sees it:
+// a 10ms period of 48kHz stereo every 10ms, made faster than real time so a
+// run covers several seconds of audio.
+
+static constexpr size_t kPeriodBytes = 480 * 4;
+static constexpr int64_t kClientPeriodNs = 1000000;
+static constexpr size_t kRingBytes = 512 * 1024;
+
+enum {
+    DUMP_OFF,
+    DUMP_FWRITE,        // what write() used to do
+    DUMP_ASYNC,
+    DUMP_ASYNC_DIRECT,
+    DUMP_CONTAINER,     // AudioDumpFormat records and sync markers
+    DUMP_COMPRESSED,    // and Rice coded
+};
+
+// Two tones, closer to real content than a constant for the compressed modes.
+static void fillPeriod(int16_t* frames, size_t count, size_t* n) {
+    for (size_t i = 0; i < count; i++, (*n)++) {
+        frames[2 * i] = int16_t(8000 * sin(*n * 0.0575) + 3000 * sin(*n * 0.31));
+        frames[2 * i + 1] = int16_t(6000 * sin(*n * 0.0411) + 2000 * sin(*n * 0.53));
+    }
+}
+
+static std::string dumpPath() {
+    const char* dir = getenv("TMPDIR");
+    return std::string(dir ? dir : "/data/local/tmp") + "/audio_dump_benchmark.pcm";
+}
+
+// state.range(0) is one of the modes above.
+static void BM_DumpWriteLatency(benchmark::State& state) {
+    const int mode = state.range(0);
+    const std::string path = dumpPath();
+    FILE* file = nullptr;
+    AudioDumpWriter writer(kRingBytes, mode == DUMP_ASYNC_DIRECT);
+    if (mode == DUMP_FWRITE) {
+        file = fopen(path.c_str(), "wb");
+    } else if (mode != DUMP_OFF) {
+        writer.init();
+        AudioDumpHeader header;
+        audioDumpInitHeader(&header);
+        header.format = AudioSystem::PCM_16_BIT;
+        header.sampleRate = 48000;
+        header.channelMask = AudioSystem::CHANNEL_OUT_STEREO;
+        header.channelCount = 2;
+        header.frameSize = 4;
+        header.flags = mode == DUMP_COMPRESSED ? AUDIO_DUMP_FLAG_COMPRESSED : 0;
+        writer.open(path.c_str(), mode >= DUMP_CONTAINER ? &header : nullptr);
+    }
+
+    std::vector<int16_t> period(kPeriodBytes / sizeof(int16_t));
+    size_t n = 0;
+    fillPeriod(period.data(), period.size() / 2, &n);
+    std::vector<int64_t> latencies;
+    latencies.reserve(state.max_iterations);
+    int64_t deadline = fakeDeviceNowNs();
+    for (auto _ : state) {
+        int64_t start = fakeDeviceNowNs();
+        if (file) {
+            fwrite(period.data(), kPeriodBytes, 1, file);
+        } else if (mode != DUMP_OFF) {
+            writer.write(period.data(), kPeriodBytes);
+        }
+        latencies.push_back(fakeDeviceNowNs() - start);
+        deadline += kClientPeriodNs;
+        fakeDeviceSleepUntil(deadline);
+    }
+    if (file) fclose(file);
+    writer.close();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        return double(latencies[size_t(p * (latencies.size() - 1))]);
+    };
+    state.counters["p50_ns"] = percentile(0.50);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["max_ns"] = double(latencies.back());
+    state.counters["drops"] = writer.drops();
+    unlink(path.c_str());
+}
+BENCHMARK(BM_DumpWriteLatency)
+        ->Arg(DUMP_OFF)
+        ->Arg(DUMP_FWRITE)
+        ->Arg(DUMP_ASYNC)
+        ->Arg(DUMP_ASYNC_DIRECT)
+        ->Arg(DUMP_CONTAINER)
+        ->Arg(DUMP_COMPRESSED)
+        ->Iterations(4096)
+        ->UseRealTime();
+
+// Rice coding of one full record on the dump thread, and what it saves.
+static void BM_DumpEncodeRice(benchmark::State& state) {
+    std::vector<int16_t> pcm(kAudioDumpMaxRecordFrames * 2);
+    size_t n = 0;
+    fillPeriod(pcm.data(), kAudioDumpMaxRecordFrames, &n);
+    std::vector<uint8_t> encoded(pcm.size() * sizeof(int16_t));
+    size_t size = 0;
+    for (auto _ : state) {
+        size = audioDumpEncodeRice(encoded.data(), encoded.size(), pcm.data(),
+                                   kAudioDumpMaxRecordFrames, 2);
+        benchmark::DoNotOptimize(size);
+    }
+    state.SetItemsProcessed(state.iterations() * kAudioDumpMaxRecordFrames);
+    state.counters["ratio"] = double(size) / encoded.size();
+}
+BENCHMARK(BM_DumpEncodeRice);
+
+static void BM_DumpDecodeRice(benchmark::State& state) {
+    std::vector<int16_t> pcm(kAudioDumpMaxRecordFrames * 2);
+    size_t n = 0;
+    fillPeriod(pcm.data(), kAudioDumpMaxRecordFrames, &n);
+    std::vector<uint8_t> encoded(pcm.size() * sizeof(int16_t));
+    size_t size = audioDumpEncodeRice(encoded.data(), encoded.size(), pcm.data(),
+                                      kAudioDumpMaxRecordFrames, 2);
+    size_t frames;
+    for (auto _ : state) {
+        audioDumpDecodeRice(pcm.data(), kAudioDumpMaxRecordFrames, &frames, 2, encoded.data(),
+                            size);
+        benchmark::DoNotOptimize(pcm.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kAudioDumpMaxRecordFrames);
+}
+BENCHMARK(BM_DumpDecodeRice);
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "AudioFormatConverter.h"
+#include "AudioMixOps.h"
+
+using namespace android_audio_legacy;
+
+// Throughput of the client format conversion in AudioStreamOutGeneric::write(),
+// one 1024-frame period at a time, to 16-bit stereo.
+
+static constexpr size_t kPeriodFrames = 1024;
+
+static const struct {
+    const char* name;
+    int format;
+    uint32_t channelMask;
+} kFormats[] = {
+    {"pcm16_stereo", AUDIO_FORMAT_PCM_16_BIT, AudioSystem::CHANNEL_OUT_STEREO},
+    {"pcm16_mono", AUDIO_FORMAT_PCM_16_BIT, AudioSystem::CHANNEL_OUT_MONO},
+    {"pcm16_5.1", AUDIO_FORMAT_PCM_16_BIT, AudioSystem::CHANNEL_OUT_5POINT1},
+    {"float_stereo", AUDIO_FORMAT_PCM_FLOAT, AudioSystem::CHANNEL_OUT_STEREO},
+    {"8_24_stereo", AUDIO_FORMAT_PCM_8_24_BIT, AudioSystem::CHANNEL_OUT_STEREO},
+    {"pcm32_stereo", AUDIO_FORMAT_PCM_32_BIT, AudioSystem::CHANNEL_OUT_STEREO},
+    {"packed24_stereo", AUDIO_FORMAT_PCM_24_BIT_PACKED, AudioSystem::CHANNEL_OUT_STEREO},
+    {"float_mono", AUDIO_FORMAT_PCM_FLOAT, AudioSystem::CHANNEL_OUT_MONO},
+    {"float_5.1", AUDIO_FORMAT_PCM_FLOAT, AudioSystem::CHANNEL_OUT_5POINT1},
+};
+
+// state.range(0) indexes kFormats; state.range(1) turns dither on.
+static void BM_FormatConverter(benchmark::State& state) {
+    const auto& f = kFormats[state.range(0)];
+    AudioFormatConverter conv(f.format, f.channelMask, 2, state.range(1));
+    std::vector<uint8_t> in(kPeriodFrames * conv.frameSize());
+    std::mt19937 rng(1);
+    if (f.format == AUDIO_FORMAT_PCM_FLOAT) {
+        std::uniform_real_distribution<float> sample(-1.0f, 1.0f);
+        for (size_t i = 0; i < in.size() / sizeof(float); i++) ((float*)in.data())[i] = sample(rng);
+    } else {
+        for (auto& b : in) b = uint8_t(rng());
+    }
+    std::vector<int16_t> out(kPeriodFrames * 2);
+
+    for (auto _ : state) {
+        conv.convert(out.data(), in.data(), kPeriodFrames);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetLabel(std::string(f.name) + (state.range(1) ? " dither" : ""));
+    state.SetBytesProcessed(state.iterations() * in.size());
+    state.counters["ns_per_frame"] = benchmark::Counter(
+            double(state.iterations() * kPeriodFrames),
+            benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+BENCHMARK(BM_FormatConverter)->ArgsProduct({{0, 1, 2, 3, 4, 5, 6, 7, 8}, {0}});
+BENCHMARK(BM_FormatConverter)->ArgsProduct({{3, 4, 5, 6}, {1}});
+
+// The kernels alone over a stereo period, SIMD (state.range(1) == 1) against
+// the scalar reference: 0 float, 1 32-bit, 2 packed 24-bit, 3 Q8.23 to 16-bit.
+static void BM_FormatKernel(benchmark::State& state) {
+    const size_t n = kPeriodFrames * 2;
+    const bool simd = state.range(1);
+    std::vector<float> f(n, 0.25f);
+    std::vector<int32_t> wide(n, 0x123456);
+    std::vector<uint8_t> packed(n * 3, 0x5a);
+    std::vector<int16_t> narrow(n);
+    std::vector<int32_t> out(n);
+
+    for (auto _ : state) {
+        switch (state.range(0)) {
+        case 0:
+            simd ? convertFloatTo8_24(out.data(), f.data(), n)
+                 : convertFloatTo8_24Scalar(out.data(), f.data(), n);
+            break;
+        case 1:
+            simd ? convert32To8_24(out.data(), wide.data(), n)
+                 : convert32To8_24Scalar(out.data(), wide.data(), n);
+            break;
+        case 2:
+            simd ? convertPacked24To8_24(out.data(), packed.data(), n)
+                 : convertPacked24To8_24Scalar(out.data(), packed.data(), n);
+            break;
+        case 3:
+            simd ? convert8_24To16(narrow.data(), wide.data(), n, nullptr)
+                 : convert8_24To16Scalar(narrow.data(), wide.data(), n, nullptr);
+            break;
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::DoNotOptimize(narrow.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_FormatKernel)->ArgsProduct({{0, 1, 2, 3}, {0, 1}});
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <time.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "AudioHardwareGeneric.h"
+#include "AudioMixOps.h"
+#include "FakeAudioDevice.h"
+
+using namespace android_audio_legacy;
+
+// Cost of mixing state.range(0) streams of one 1024-frame period with a
+// non-unity gain, using the SIMD kernel (state.range(1) == 1) or the scalar
+// reference (== 0).
+
+static constexpr size_t kPeriodFrames = 1024;
+
+static void BM_MixKernel(benchmark::State& state) {
+    const size_t streams = state.range(0);
+    const bool simd = state.range(1);
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> sample(-16384, 16383);
+    std::vector<std::vector<int16_t>> sources(streams, std::vector<int16_t>(kPeriodFrames * 2));
+    for (auto& source : sources) {
+        for (auto& s : source) s = sample(rng);
+    }
+    std::vector<int16_t> mix(kPeriodFrames * 2);
+
+    for (auto _ : state) {
+        std::fill(mix.begin(), mix.end(), 0);
+        for (const auto& source : sources) {
+            if (simd) {
+                mixStereo16(mix.data(), source.data(), kPeriodFrames, 24000, 20000);
+            } else {
+                mixStereo16Scalar(mix.data(), source.data(), kPeriodFrames, 24000, 20000);
+            }
+        }
+        benchmark::DoNotOptimize(mix.data());
+    }
+    state.SetItemsProcessed(state.iterations() * streams * kPeriodFrames);
+    state.counters["ns_per_stream_period"] = benchmark::Counter(
+            double(state.iterations() * streams),
+            benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+BENCHMARK(BM_MixKernel)->ArgsProduct({{1, 2, 4, 8}, {0, 1}});
+
+// The whole path: state.range(0) AudioStreamOutGeneric attached to an
+// AudioMixerGeneric writing to a fake device 8x faster than real time. CPU is
+// the whole process minus the fake device thread, per second of audio played.
+
+static constexpr int64_t kPeriodNs = int64_t(kPeriodFrames) * 1000000000 / 44100 / 8;
+
+static int64_t processCpuNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+static void BM_MixerGeneric(benchmark::State& state) {
+    const size_t streams = state.range(0);
+    FakeAudioDevice device(kPeriodFrames * 4, kPeriodNs);
+    AudioMixerGeneric mixer(device.fd(), kPeriodFrames);
+    if (mixer.start() != NO_ERROR) {
+        state.SkipWithError("cannot start mixer");
+        return;
+    }
+    std::vector<std::unique_ptr<AudioStreamOutGeneric>> outs;
+    for (size_t i = 0; i < streams; i++) {
+        outs.emplace_back(new AudioStreamOutGeneric());
+        outs.back()->set(nullptr, device.fd(), AudioSystem::DEVICE_OUT_SPEAKER, nullptr, nullptr,
+                         nullptr);
+        outs.back()->attachMixer(&mixer, 0);
+        outs.back()->setVolume(0.5f, 0.5f);
+    }
+
+    std::vector<int16_t> period(kPeriodFrames * 2, 1000);
+    int64_t cpuStart = processCpuNs() - device.cpuNs();
+    for (auto _ : state) {
+        for (auto& out : outs) {
+            out->write(period.data(), period.size() * sizeof(int16_t));
+        }
+    }
+    for (auto& out : outs) out->standby();
+    int64_t cpu = processCpuNs() - device.cpuNs() - cpuStart;
+
+    double audioSeconds = double(state.iterations()) * kPeriodFrames / 44100;
+    state.counters["cpu_us_per_audio_sec"] = cpu / 1000.0 / audioSeconds;
+    uint32_t underruns = 0;
+    for (auto& out : outs) underruns += out->underruns();
+    state.counters["underruns"] = underruns;
+}
+BENCHMARK(BM_MixerGeneric)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Iterations(512)->UseRealTime();
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "AudioHardwareGeneric.h"
+#include "FakeAudioDevice.h"
+
+using namespace android_audio_legacy;
+
+// Compares AudioStreamOutGeneric's write() path with its mmap path on a fake
+// device running 8x faster than real time. Each period carries the time the
+// client produced it; the device reports how long it took to reach it. CPU
+// is the whole process minus the fake device thread, per second of audio.
+
+static constexpr size_t kFrameSize = 4;
+static constexpr size_t kBurstFrames = 128;
+static constexpr size_t kPeriodBytes = kBurstFrames * kFrameSize;
+static constexpr int64_t kPeriodNs = int64_t(kBurstFrames) * 1000000000 / 44100 / 8;
+
+static int64_t processCpuNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+class LatencyProbe {
+  public:
+    explicit LatencyProbe(size_t capacity) : mLatencies(capacity) {}
+    void stamp(char* period) {
+        int64_t now = fakeDeviceNowNs();
+        memcpy(period, &now, sizeof(now));
+    }
+    // Runs on the device thread; a period the client has not refreshed
+    // carries the previous stamp and is not counted twice.
+    void onPeriod(const char* period) {
+        int64_t stamp;
+        memcpy(&stamp, period, sizeof(stamp));
+        if (stamp == 0 || stamp == mLastStamp) return;
+        mLastStamp = stamp;
+        size_t i = mCount.load(std::memory_order_relaxed);
+        if (i < mLatencies.size()) {
+            mLatencies[i] = fakeDeviceNowNs() - stamp;
+            mCount.store(i + 1, std::memory_order_release);
+        }
+    }
+    void report(benchmark::State& state) {
+        size_t n = mCount.load(std::memory_order_acquire);
+        if (n == 0) return;
+        std::sort(mLatencies.begin(), mLatencies.begin() + n);
+        state.counters["latency_p50_us"] = mLatencies[n / 2] / 1000.0;
+        state.counters["latency_p99_us"] = mLatencies[(n - 1) * 99 / 100] / 1000.0;
+    }
+
+  private:
+    std::vector<int64_t> mLatencies;
+    std::atomic<size_t> mCount{0};
+    int64_t mLastStamp = 0;
+};
+
+static void reportCpu(benchmark::State& state, int64_t cpuNs) {
+    double audioSeconds = double(state.iterations()) * kBurstFrames / 44100;
+    state.counters["cpu_us_per_audio_sec"] = cpuNs / 1000.0 / audioSeconds;
+}
+
+static void BM_GenericOutputWrite(benchmark::State& state) {
+    LatencyProbe probe(state.max_iterations);
+    FakeAudioDevice device(kPeriodBytes, kPeriodNs, 0, 0,
+                           [&probe](const char* p) { probe.onPeriod(p); });
+    AudioStreamOutGeneric out;
+    out.set(nullptr, device.fd(), AudioSystem::DEVICE_OUT_SPEAKER, nullptr, nullptr, nullptr);
+
+    std::vector<char> period(kPeriodBytes);
+    int64_t cpuStart = processCpuNs() - device.cpuNs();
+    for (auto _ : state) {
+        probe.stamp(period.data());
+        out.write(period.data(), period.size());
+    }
+    int64_t cpu = processCpuNs() - device.cpuNs() - cpuStart;
+
+    reportCpu(state, cpu);
+    probe.report(state);
+}
+BENCHMARK(BM_GenericOutputWrite)->Iterations(4096)->UseRealTime();
+
+// state.range(0): how many bursts the client keeps queued ahead of the device.
+static void BM_GenericOutputMmap(benchmark::State& state) {
+    const int64_t lead = state.range(0) * kBurstFrames;
+    LatencyProbe probe(state.max_iterations);
+    FakeAudioDevice device(kPeriodBytes, kPeriodNs, 0, 0,
+                           [&probe](const char* p) { probe.onPeriod(p); });
+    AudioStreamOutGeneric out;
+    out.set(nullptr, device.fd(), AudioSystem::DEVICE_OUT_SPEAKER, nullptr, nullptr, nullptr);
+
+    void* shared;
+    int fd;
+    int32_t frames, burst;
+    if (out.createMmapBuffer(4 * kBurstFrames, &shared, &fd, &frames, &burst) != NO_ERROR ||
+        burst != int32_t(kBurstFrames)) {
+        state.SkipWithError("createMmapBuffer failed");
+        return;
+    }
+    char* buffer = static_cast<char*>(shared);
+
+    int64_t written = 0;
+    int64_t cpuStart = processCpuNs() - device.cpuNs();
+    out.start();
+    for (auto _ : state) {
+        // Wait for room, sleeping until the next burst is due rather than polling.
+        for (;;) {
+            int64_t timeNs;
+            int32_t position;
+            out.getMmapPosition(&timeNs, &position);
+            if (written - position < lead) break;
+            int64_t now = fakeDeviceNowNs();
+            fakeDeviceSleepUntil(std::max(timeNs + kPeriodNs, now + kPeriodNs / 4));
+        }
+        probe.stamp(buffer + (written % frames) * kFrameSize);
+        written += kBurstFrames;
+    }
+    out.stop();
+    int64_t cpu = processCpuNs() - device.cpuNs() - cpuStart;
+
+    reportCpu(state, cpu);
+    probe.report(state);
+}
+BENCHMARK(BM_GenericOutputMmap)->Arg(1)->Arg(2)->Iterations(4096)->UseRealTime();
@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include "AudioPacingClock.h"
+
+using namespace android_audio_legacy;
+
+// Drift of an emulated device (stub or dump stream with no final stream)
+// against the audio it claims to have played.
+//
+// The simulated benchmarks play one hour of 16-bit stereo in state.range(1)
+// frame writes at state.range(0) Hz on a virtual clock: every sleep
+// overshoots by 20-120us and the caller spends 5-50us between writes, which
+// is what a loaded device sees. The real-time ones run a few seconds on the
+// real clock to confirm the model.
+
+static constexpr size_t kFrameSize = 4;
+static constexpr nsecs_t kHourNs = 3600LL * 1000000000;
+
+class VirtualClock {
+  public:
+    VirtualClock() : mNow(1000000000), mRng(42), mOvershoot(20000, 120000), mWork(5000, 50000) {}
+    nsecs_t now() const { return mNow; }
+    void sleepUntil(nsecs_t deadline) {
+        if (deadline > mNow) mNow = deadline;
+        mNow += mOvershoot(mRng);
+    }
+    void work() { mNow += mWork(mRng); }
+
+  private:
+    nsecs_t mNow;
+    std::mt19937 mRng;
+    std::uniform_int_distribution<nsecs_t> mOvershoot;
+    std::uniform_int_distribution<nsecs_t> mWork;
+};
+
+class VirtualPacingClock : public AudioPacingClock {
+  public:
+    explicit VirtualPacingClock(VirtualClock* clock) : mClock(clock) {}
+
+  protected:
+    virtual nsecs_t nowNs() { return mClock->now(); }
+    virtual void sleepUntilNs(nsecs_t deadline) { mClock->sleepUntil(deadline); }
+
+  private:
+    VirtualClock* mClock;
+};
+
+static void reportDrift(benchmark::State& state, nsecs_t elapsedNs, uint64_t frames,
+                        uint32_t rate) {
+    nsecs_t audioNs = nsecs_t(frames / rate) * 1000000000 + nsecs_t(frames % rate) * 1000000000 / rate;
+    state.counters["drift_ms"] = (elapsedNs - audioNs) / 1e6;
+}
+
+// The pacing AudioStreamOutStub and the dump streams used before: sleep for
+// the buffer duration relative to now, truncated to whole ms on the dump path.
+static void BM_PacingDriftRelativeSleep(benchmark::State& state) {
+    const uint32_t rate = state.range(0);
+    const size_t bytes = state.range(1) * kFrameSize;
+    for (auto _ : state) {
+        VirtualClock clock;
+        nsecs_t start = clock.now();
+        uint64_t frames = 0;
+        while (clock.now() - start < kHourNs) {
+            clock.work();
+            clock.sleepUntil(clock.now() + nsecs_t((((bytes * 1000) / kFrameSize) / rate) * 1000) * 1000);
+            frames += bytes / kFrameSize;
+        }
+        reportDrift(state, clock.now() - start, frames, rate);
+    }
+}
+BENCHMARK(BM_PacingDriftRelativeSleep)->Args({44100, 1024})->Args({48000, 960})->Args({44100, 256});
+
+static void BM_PacingDriftAbsoluteDeadline(benchmark::State& state) {
+    const uint32_t rate = state.range(0);
+    const uint32_t framesPerWrite = state.range(1);
+    for (auto _ : state) {
+        VirtualClock clock;
+        VirtualPacingClock pacing(&clock);
+        nsecs_t start = clock.now();
+        uint64_t frames = 0;
+        while (clock.now() - start < kHourNs) {
+            clock.work();
+            pacing.pace(framesPerWrite, rate);
+            frames += framesPerWrite;
+        }
+        reportDrift(state, clock.now() - start, frames, rate);
+    }
+}
+BENCHMARK(BM_PacingDriftAbsoluteDeadline)->Args({44100, 1024})->Args({48000, 960})->Args({44100, 256});
+
+// A few seconds on the real clock: state.range(0) == 0 sleeps relatively with
+// usleep() as before, 1 uses AudioPacingClock.
+static void BM_PacingDriftRealTime(benchmark::State& state) {
+    const uint32_t rate = 44100;
+    const uint32_t framesPerWrite = 256;
+    const int writes = 3 * rate / framesPerWrite;
+    for (auto _ : state) {
+        AudioPacingClock pacing;
+        nsecs_t start = systemTime(SYSTEM_TIME_MONOTONIC);
+        for (int i = 0; i < writes; i++) {
+            if (state.range(0)) {
+                pacing.pace(framesPerWrite, rate);
+            } else {
+                usleep(framesPerWrite * 1000000 / rate);
+            }
+        }
+        reportDrift(state, systemTime(SYSTEM_TIME_MONOTONIC) - start,
+                    uint64_t(writes) * framesPerWrite, rate);
+    }
+}
+BENCHMARK(BM_PacingDriftRealTime)->Arg(0)->Arg(1)->Iterations(1)->UseRealTime();
+
+// A2DP output against a fake a2dp_write() on the virtual clock. The fake
+// stack sends at real time on its own timeline and returns once the frames
+// before the ones written have gone out, give or take -3..+10ms of jitter.
+// On 2% of writes the link stalls for 40-120ms; the stack bursts to catch up
+// afterwards, and the headset's 150ms of buffering hides it unless the
+// writer is late too. A writer that comes back after the stack ran dry
+// pushes the stack's timeline back. state.range(1) == 1 is a headset being
+// disconnected instead: every write returns at once.
+//
+// starved_ms is how long the headset ran dry, which is what over-sleeping
+// costs; writes_per_s is over the nominal 17.2 of a 2560 frame buffer when
+// the writer spins. state.range(0) == 0 throttles as A2dpAudioStreamOut
+// did, with a relative sleep when a write completed in under a quarter of
+// the buffer; 1 uses AudioPacingClock with the tolerances A2dpAudioStreamOut
+// sets.
+class FakeA2dpStack {
+  public:
+    FakeA2dpStack(VirtualClock* clock, uint32_t rate, bool disconnected)
+        : mClock(clock), mRate(rate), mDisconnected(disconnected), mRng(7),
+          mJitter(-3000000, 10000000), mStall(40000000, 120000000), mStallChance(0, 49),
+          mStartNs(0), mPlayNs(0), mDoneNs(0), mFrames(0), mStarvedNs(0) {}
+
+    void write(uint32_t frames) {
+        nsecs_t now = mClock->now();
+        if (mStartNs == 0) {
+            mStartNs = now;
+            mPlayNs = now + 150000000;
+        }
+        // when the stack could have taken these frames; later than that is
+        // the writer's doing and the stack has nothing to send meanwhile
+        nsecs_t sendNs = mStartNs + framesToNs(mFrames);
+        nsecs_t ready = sendNs > mDoneNs ? sendNs : mDoneNs;
+        if (now > ready) {
+            mStartNs += now - ready;
+            sendNs += now - ready;
+        }
+        nsecs_t done = now + 300000;  // encoding
+        nsecs_t arrival = sendNs;
+        if (!mDisconnected) {
+            nsecs_t due = sendNs + mJitter(mRng);
+            if (mStallChance(mRng) == 0) {
+                nsecs_t stall = mStall(mRng);
+                due += stall;
+                arrival += stall;
+            }
+            if (due > done) done = due;
+            // a gap is heard
+            nsecs_t playNs = mPlayNs + framesToNs(mFrames);
+            if (arrival > playNs) {
+                mStarvedNs += arrival - playNs;
+                mPlayNs += arrival - playNs;
+            }
+        }
+        mFrames += frames;
+        mDoneNs = done;
+        mClock->sleepUntil(done);
+    }
+    nsecs_t starvedNs() const { return mStarvedNs; }
+
+  private:
+    nsecs_t framesToNs(uint64_t frames) const { return nsecs_t(frames) * 1000000000 / mRate; }
+
+    VirtualClock* mClock;
+    const uint32_t mRate;
+    const bool mDisconnected;
+    std::mt19937 mRng;
+    std::uniform_int_distribution<nsecs_t> mJitter;
+    std::uniform_int_distribution<nsecs_t> mStall;
+    std::uniform_int_distribution<int> mStallChance;
+    nsecs_t mStartNs;   // the stack's timeline
+    nsecs_t mPlayNs;    // the headset's
+    nsecs_t mDoneNs;
+    uint64_t mFrames;
+    nsecs_t mStarvedNs;
+};
+static void BM_PacingA2dp(benchmark::State& state) {
+    const uint32_t rate = 44100;
+    const uint32_t framesPerWrite = 2560;  // A2dpAudioStreamOut::bufferSize()
+    const nsecs_t bufferNs = nsecs_t(framesPerWrite) * 1000000000 / rate;
+    const nsecs_t latencyNs = bufferNs + 200000000;
+    for (auto _ : state) {
+        VirtualClock clock;
+        FakeA2dpStack stack(&clock, rate, state.range(1));
+        VirtualPacingClock pacing(&clock);
+        pacing.setTolerance(bufferNs, latencyNs);
+        nsecs_t start = clock.now();
+        nsecs_t last = start;
+        uint64_t frames = 0, writes = 0;
+        while (clock.now() - start < kHourNs) {
+            clock.work();
+            stack.write(framesPerWrite);
+            if (state.range(0)) {
+                pacing.pace(framesPerWrite, rate);
+            } else {
+                nsecs_t now = clock.now();
+                if (now - last < bufferNs / 4) clock.sleepUntil(now + bufferNs - (now - last));
+                last = now;
+            }
+            frames += framesPerWrite;
+            writes++;
+        }
+        nsecs_t elapsed = clock.now() - start;
+        reportDrift(state, elapsed, frames, rate);
+        state.counters["starved_ms"] = stack.starvedNs() / 1e6;
+        state.counters["writes_per_s"] = writes * 1e9 / elapsed;
+    }
+}
+BENCHMARK(BM_PacingA2dp)->Args({0, 0})->Args({1, 0})->Args({0, 1})->Args({1, 1});
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "AudioHardwareGeneric.h"
+#include "AudioParameterScanner.h"
+
+using namespace android_audio_legacy;
+
+// Stands in for the shim's convert_audio_device(), which is not what is
+// measured here.
+static int convertDevice(int device) {
+    return device ^ 0x4;
+}
+
+// What out_set_parameters() and AudioStreamOutGeneric::setParameters() did
+// before: the shim parses into an AudioParameter to rewrite routing and
+// serializes it again, and the stream parses that.
+static status_t legacySetParameters(const char* kvpairs, int* device) {
+    int val;
+    String8 s8 = String8(kvpairs);
+    AudioParameter parms = AudioParameter(String8(kvpairs));
+    if (parms.getInt(String8(AUDIO_PARAMETER_STREAM_ROUTING), val) == NO_ERROR) {
+        val = convertDevice(val);
+        parms.remove(String8(AUDIO_PARAMETER_STREAM_ROUTING));
+        parms.addInt(String8(AUDIO_PARAMETER_STREAM_ROUTING), val);
+        s8 = parms.toString();
+    }
+
+    AudioParameter param = AudioParameter(s8);
+    String8 key = String8(AudioParameter::keyRouting);
+    if (param.getInt(key, *device) == NO_ERROR) {
+        param.remove(key);
+    }
+    return param.size() ? BAD_VALUE : NO_ERROR;
+}
+
+// A routing change through the shim into AudioStreamOutGeneric, the way it
+// was (state.range(0) == 0) and with AudioParameterScanner (== 1).
+static void BM_SetRouting(benchmark::State& state) {
+    const bool scanner = state.range(0);
+    AudioStreamOutGeneric out;
+    const char* kvpairs = "routing=2";
+    int device = 0;
+    for (auto _ : state) {
+        if (scanner) {
+            String8 s8;
+            if (!audioParameterConvertInt(&s8, kvpairs, AUDIO_PARAMETER_STREAM_ROUTING,
+                                          convertDevice)) {
+                s8 = String8(kvpairs);
+            }
+            benchmark::DoNotOptimize(out.setParameters(s8));
+        } else {
+            benchmark::DoNotOptimize(legacySetParameters(kvpairs, &device));
+        }
+    }
+    state.counters["calls_per_second"] =
+            benchmark::Counter(double(state.iterations()), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_SetRouting)->Arg(0)->Arg(1);
+
+// The keys an A2DP output is sent when its headset connects, looked up with
+// AudioParameter (state.range(0) == 0) or scanned (== 1).
+static void BM_ParseA2dpKeys(benchmark::State& state) {
+    const bool scanner = state.range(0);
+    const String8 kvpairs("a2dp_sink_address=00:11:22:33:44:55;closing=false;routing=128");
+    for (auto _ : state) {
+        int device = 0;
+        bool closing = false;
+        size_t addressLength = 0;
+        if (scanner) {
+            AudioParameterScanner param(kvpairs.string());
+            while (param.next()) {
+                if (param.keyIs("a2dp_sink_address")) {
+                    addressLength = param.valueLength();
+                } else if (param.keyIs("closing")) {
+                    closing = param.valueIs("true");
+                } else if (param.keyIs(AudioParameter::keyRouting)) {
+                    param.valueInt(&device);
+                }
+            }
+        } else {
+            AudioParameter param = AudioParameter(kvpairs);
+            String8 value;
+            if (param.get(String8("a2dp_sink_address"), value) == NO_ERROR) {
+                addressLength = value.length();
+            }
+            if (param.get(String8("closing"), value) == NO_ERROR) {
+                closing = value == "true";
+            }
+            param.getInt(String8(AudioParameter::keyRouting), device);
+        }
+        benchmark::DoNotOptimize(device);
+        benchmark::DoNotOptimize(closing);
+        benchmark::DoNotOptimize(addressLength);
+    }
+    state.counters["calls_per_second"] =
+            benchmark::Counter(double(state.iterations()), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_ParseA2dpKeys)->Arg(0)->Arg(1);
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "AudioHardwareGeneric.h"
+#include "FakeAudioDevice.h"
+
+using namespace android_audio_legacy;
+
+// How long AudioStreamOutGeneric takes to switch the client rate between
+// 48kHz and 32kHz: reconfigure() against what the framework does without
+// it, standby(), close and reopen at the new rate, on a fake device running
+// 8x faster than real time. The time is how long the switch holds up the
+// client, cpu_us what it costs the client thread; lost_frames is what was
+// written at the old rate but never reached the device, per switch.
+
+static constexpr size_t kPeriodBytes = AudioStreamOutGeneric::kDeviceBufferSize;
+static constexpr int64_t kPeriodNs = int64_t(kPeriodBytes / 4) * 1000000000 / 44100 / 8;
+static constexpr uint32_t kRates[2] = {48000, 32000};
+
+static int64_t threadCpuNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+static AudioStreamOutGeneric* open(int fd, uint32_t rate, size_t ringBytes) {
+    AudioStreamOutGeneric* out = new AudioStreamOutGeneric();
+    out->set(nullptr, fd, AudioSystem::DEVICE_OUT_SPEAKER, nullptr, nullptr, &rate);
+    if (ringBytes) out->enableAsyncWrite(ringBytes);
+    return out;
+}
+
+// state.range(0): 0 = reconfigure(), 1 = close and reopen.
+// state.range(1): 0 = blocking write path, otherwise async ring size in bytes.
+static void BM_GenericOutputSwitchRate(benchmark::State& state) {
+    const bool reopen = state.range(0);
+    const size_t ringBytes = state.range(1);
+    std::atomic<int64_t> played{0};
+    FakeAudioDevice device(kPeriodBytes, kPeriodNs, 0, 0,
+                           [&played](const char*) { played += kPeriodBytes / 4; });
+    std::unique_ptr<AudioStreamOutGeneric> out(open(device.fd(), kRates[0], ringBytes));
+
+    std::vector<char> buffer(out->bufferSize() * 2);
+    double written = 0;  // in device frames
+    auto write = [&] {
+        out->write(buffer.data(), out->bufferSize());
+        written += double(out->bufferSize() / out->frameSize()) * 44100 / out->sampleRate();
+    };
+    int64_t cpuNs = 0;
+    int n = 0;
+    for (auto _ : state) {
+        uint32_t rate = kRates[++n % 2];
+        // a few periods at the old rate, so there is something to play out
+        for (int i = 0; i < 4; i++) {
+            write();
+        }
+
+        int64_t start = fakeDeviceNowNs();
+        int64_t cpuStart = threadCpuNs();
+        if (reopen) {
+            out->standby();
+            out.reset(open(device.fd(), rate, ringBytes));
+        } else if (out->reconfigure(0, rate) != NO_ERROR) {
+            state.SkipWithError("reconfigure failed");
+            return;
+        }
+        state.SetIterationTime((fakeDeviceNowNs() - start) / 1e9);
+        cpuNs += threadCpuNs() - cpuStart;
+        write();
+    }
+    // two device periods of padding push the last partial one out
+    std::vector<char> padding(2 * kPeriodBytes);
+    out->reconfigure(0, 44100);
+    out->write(padding.data(), padding.size());
+    out->standby();
+    fakeDeviceSleepUntil(fakeDeviceNowNs() + 4 * kPeriodNs);
+    state.counters["cpu_us"] = cpuNs / 1000.0 / state.iterations();
+    state.counters["lost_frames"] = std::max(0.0, written - played.load()) / state.iterations();
+}
+BENCHMARK(BM_GenericOutputSwitchRate)
+        ->ArgNames({"reopen", "ring"})
+        ->ArgsProduct({{0, 1}, {0, 16384}})
+        ->Iterations(200)
+        ->UseManualTime()
+        ->Unit(benchmark::kMicrosecond);
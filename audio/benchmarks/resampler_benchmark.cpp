@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include <time.h>
+
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "AudioMixOps.h"
+#include "AudioResampler.h"
+#include "ThdN.h"
+
+using namespace android_audio_legacy;
+
+static int64_t threadCpuNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// Cycles per output sample are estimated from CPU time and the nominal
+// clock the benchmark library reports.
+static void reportPerSample(benchmark::State& state, int64_t cpuNs, double samples) {
+    double ns = cpuNs / samples;
+    state.counters["ns_per_sample"] = ns;
+    state.counters["cycles_per_sample"] = ns * benchmark::CPUInfo::Get().cycles_per_second / 1e9;
+}
+
+// The polyphase inner loop on its own: state.range(0) taps, with the SIMD
+// kernel (state.range(1) == 1) or the scalar reference (== 0).
+static void BM_Dot16x2(benchmark::State& state) {
+    const size_t taps = state.range(0);
+    const bool simd = state.range(1);
+    std::mt19937 rng(1);
+    std::vector<int16_t> x(taps + 64), h(2 * taps);
+    for (auto& v : x) v = int16_t(rng());
+    for (auto& v : h) v = int16_t(rng()) / 16;
+
+    size_t offset = 0;
+    int64_t start = threadCpuNs();
+    for (auto _ : state) {
+        int32_t r0, r1;
+        if (simd) {
+            dot16x2(x.data() + offset, h.data(), h.data() + taps, taps, &r0, &r1);
+        } else {
+            dot16x2Scalar(x.data() + offset, h.data(), h.data() + taps, taps, &r0, &r1);
+        }
+        benchmark::DoNotOptimize(r0);
+        benchmark::DoNotOptimize(r1);
+        offset = (offset + 1) & 63;
+    }
+    reportPerSample(state, threadCpuNs() - start, double(state.iterations()));
+}
+BENCHMARK(BM_Dot16x2)->ArgsProduct({{96, 208}, {0, 1}});
+
+// Stereo conversion in 1024-frame writes from state.range(0) to
+// state.range(1) Hz, with the THD+N of a 997Hz tone through the same pair.
+static void BM_Resample(benchmark::State& state) {
+    const uint32_t inRate = state.range(0), outRate = state.range(1);
+    const size_t kFrames = 1024;
+    AudioResampler src(inRate, outRate, 2);
+    std::vector<int16_t> in(kFrames * 2), out((kFrames * outRate / inRate + 64) * 2);
+    for (size_t i = 0; i < kFrames; i++) {
+        in[2 * i] = in[2 * i + 1] = int16_t(16384 * sin(2 * M_PI * 997.0 * i / inRate));
+    }
+
+    size_t produced = 0;
+    int64_t start = threadCpuNs();
+    for (auto _ : state) {
+        size_t consumed = kFrames;
+        produced += src.resample(out.data(), out.size() / 2, in.data(), &consumed);
+    }
+    reportPerSample(state, threadCpuNs() - start, double(produced) * 2);
+    state.counters["thd_n_db"] = resamplerThdNDb(inRate, outRate, 997.0);
+}
+BENCHMARK(BM_Resample)
+        ->Args({44100, 48000})
+        ->Args({48000, 44100})
+        ->Args({22050, 44100})
+        ->Args({16000, 44100})
+        ->Args({8000, 44100})
+        ->Args({96000, 44100})
+        ->Args({8000, 16000})
+        ->Args({8000, 48000});
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "AudioSbcEncoder.h"
+
+using namespace android_audio_legacy;
+
+// Joint stereo 44.1kHz, 16 blocks, at the A2DP high quality bitpool of 53,
+// with state.range(0) subbands; the vector filterbank (state.range(1) == 1)
+// or the scalar reference (== 0). frames_per_second is SBC frames, and
+// realtime how many streams one core could encode.
+static void BM_SbcEncode(benchmark::State& state) {
+    AudioSbcEncoder::Config config = {44100, AudioSbcEncoder::MODE_JOINT_STEREO, 16,
+                                      uint32_t(state.range(0)),
+                                      AudioSbcEncoder::ALLOCATION_LOUDNESS, 53};
+    AudioSbcEncoder encoder(state.range(1) == 0);
+    encoder.configure(config);
+
+    // a second of music-like input: a few tones and some noise
+    std::mt19937 rng(1);
+    std::vector<int16_t> pcm(44100 * 2);
+    for (size_t i = 0; i < pcm.size() / 2; i++) {
+        double s = 0.3 * sin(2 * M_PI * 220 * i / 44100.0) +
+                0.2 * sin(2 * M_PI * 1760 * i / 44100.0) +
+                std::uniform_real_distribution<double>(-0.05, 0.05)(rng);
+        pcm[2 * i] = int16_t(s * 32767);
+        pcm[2 * i + 1] = int16_t(s * 0.7 * 32767);
+    }
+    const size_t samples = encoder.frameSamples() * 2;
+    uint8_t frame[AudioSbcEncoder::kMaxFrameBytes];
+
+    size_t offset = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(encoder.encode(&pcm[offset], frame));
+        offset += samples;
+        if (offset + samples > pcm.size()) offset = 0;
+    }
+    state.counters["frames_per_second"] =
+            benchmark::Counter(double(state.iterations()), benchmark::Counter::kIsRate);
+    state.counters["realtime"] = benchmark::Counter(
+            double(state.iterations()) * encoder.frameSamples() / 44100,
+            benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_SbcEncode)->ArgsProduct({{4, 8}, {0, 1}});
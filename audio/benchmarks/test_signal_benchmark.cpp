@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "AudioMixOps.h"
+#include "AudioTestSignal.h"
+#include "FakeAudioDevice.h"
+
+using namespace android_audio_legacy;
+
+// The injection step of AudioStreamInDump::read() with no final stream: a
+// 10ms read of 48kHz stereo from a 2s sine440 file.
+
+static constexpr uint32_t kRate = 48000;
+static constexpr size_t kReadBytes = kRate / 100 * 4;
+static constexpr size_t kFileFrames = kRate * 2;
+static constexpr size_t kHeaderBytes = 44;
+
+static std::string writeWav() {
+    const char* dir = getenv("TMPDIR");
+    std::string path = std::string(dir ? dir : "/data/local/tmp") + "/test_signal_benchmark.wav";
+    uint32_t data = kFileFrames * 4;
+    uint8_t header[kHeaderBytes] = {'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E',
+                                    'f', 'm', 't', ' ', 16, 0, 0, 0, 1, 0, 2, 0,
+                                    0x80, 0xbb, 0, 0, 0, 0xee, 2, 0, 4, 0, 16, 0,
+                                    'd', 'a', 't', 'a'};
+    memcpy(header + 40, &data, 4);
+    std::vector<int16_t> samples(kFileFrames * 2);
+    for (size_t i = 0; i < samples.size(); i++) samples[i] = int16_t(i * 37);
+    FILE* f = fopen(path.c_str(), "wb");
+    fwrite(header, 1, sizeof(header), f);
+    fwrite(samples.data(), 2, samples.size(), f);
+    fclose(f);
+    return path;
+}
+
+// state.range(0): 0 for fread()/fseek() per read, as read() used to, 1 for
+// AudioTestSignal. state.range(1): evict the file from the page cache at
+// every loop, as happens under memory pressure.
+static void BM_InjectReadLatency(benchmark::State& state) {
+    const bool mapped = state.range(0);
+    const bool cold = state.range(1);
+    const std::string path = writeWav();
+    FILE* file = nullptr;
+    AudioTestSignal signal(kRate, 2, AudioSystem::PCM_16_BIT);
+    if (mapped) {
+        if (signal.openFile(path.c_str()) != NO_ERROR) {
+            state.SkipWithError("cannot map");
+            return;
+        }
+    } else {
+        file = fopen(path.c_str(), "rb");
+        fseek(file, kHeaderBytes, SEEK_SET);
+    }
+    int fd = open(path.c_str(), O_RDONLY);
+
+    std::vector<uint8_t> buffer(kReadBytes);
+    std::vector<int64_t> latencies;
+    size_t position = 0;
+    for (auto _ : state) {
+        int64_t start = fakeDeviceNowNs();
+        if (mapped) {
+            signal.read(buffer.data(), buffer.size());
+        } else {
+            size_t n = fread(buffer.data(), 1, buffer.size(), file);
+            if (n < buffer.size()) {
+                fseek(file, kHeaderBytes, SEEK_SET);
+                fread(buffer.data() + n, 1, buffer.size() - n, file);
+            }
+        }
+        latencies.push_back(fakeDeviceNowNs() - start);
+        benchmark::DoNotOptimize(buffer.data());
+
+        position += buffer.size();
+        if (position >= kFileFrames * 4) {
+            position -= kFileFrames * 4;
+            if (cold) posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        }
+    }
+    close(fd);
+    if (file != nullptr) fclose(file);
+    unlink(path.c_str());
+
+    std::sort(latencies.begin(), latencies.end());
+    state.counters["p50_ns"] = latencies[latencies.size() / 2];
+    state.counters["p99_ns"] = latencies[latencies.size() * 99 / 100];
+    state.counters["max_ns"] = latencies.back();
+}
+BENCHMARK(BM_InjectReadLatency)->ArgsProduct({{0, 1}, {0, 1}})->Iterations(4000);
+
+// Sine generation for state.range(0) samples, scalar or vector.
+template <bool kVector>
+static void BM_SineCycles16(benchmark::State& state) {
+    const size_t samples = state.range(0);
+    std::vector<float> phase(samples);
+    for (size_t i = 0; i < samples; i++) phase[i] = float(i % 97) / 97;
+    std::vector<int16_t> out(samples);
+    for (auto _ : state) {
+        if (kVector) {
+            sineCycles16(out.data(), phase.data(), samples, 0.5f);
+        } else {
+            sineCycles16Scalar(out.data(), phase.data(), samples, 0.5f);
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * samples);
+}
+BENCHMARK_TEMPLATE(BM_SineCycles16, false)->Arg(960);
+BENCHMARK_TEMPLATE(BM_SineCycles16, true)->Arg(960);
+
+template <bool kVector>
+static void BM_Noise16(benchmark::State& state) {
+    const size_t samples = state.range(0);
+    std::vector<int16_t> out(samples);
+    AudioDither dither;
+    for (auto _ : state) {
+        if (kVector) {
+            noise16(out.data(), samples, &dither, 2);
+        } else {
+            noise16Scalar(out.data(), samples, &dither, 2);
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * samples);
+}
+BENCHMARK_TEMPLATE(BM_Noise16, false)->Arg(960);
+BENCHMARK_TEMPLATE(BM_Noise16, true)->Arg(960);
+
+// A whole generated loop, as opening an input without a final stream does.
+static void BM_GenerateLoop(benchmark::State& state) {
+    AudioTestSignal signal(kRate, 2, AudioSystem::PCM_16_BIT);
+    for (auto _ : state) {
+        signal.generate(state.range(0));
+    }
+}
+BENCHMARK(BM_GenerateLoop)
+        ->Arg(AudioTestSignal::SIGNAL_SWEEP)
+        ->Arg(AudioTestSignal::SIGNAL_NOISE)
+        ->Arg(AudioTestSignal::SIGNAL_IMPULSE)
+        ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_TEST_UTILS_H
+#define ANDROID_AUDIO_TEST_UTILS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// A scratch file path: under $TMPDIR if set, otherwise gtest's temp directory.
+static inline std::string tempPath(const char* name) {
+    const char* dir = getenv("TMPDIR");
+    return (dir != nullptr ? std::string(dir) + "/" : ::testing::TempDir()) + name;
+}
+
+// The 16-bit samples in a file, which is then removed; empty if it is missing.
+static inline std::vector<int16_t> readAndRemove(const std::string& path) {
+    std::vector<int16_t> data;
+    FILE* f = fopen(path.c_str(), "rb");
+    if (f == nullptr) return data;
+    int16_t s;
+    while (fread(&s, sizeof(s), 1, f) == 1) data.push_back(s);
+    fclose(f);
+    unlink(path.c_str());
+    return data;
+}
+
+// Voluntary context switches of the whole process so far: a thread blocked
+// on a condition adds none while it waits, one polling adds one per wakeup.
+static inline long voluntarySwitches() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_nvcsw;
+}
+
+#endif  // ANDROID_AUDIO_TEST_UTILS_H
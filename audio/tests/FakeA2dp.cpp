@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// liba2dp and the wake locks for A2dpAudioInterface in the tests: a sink
+// that accepts everything, at once, unless told to fail.
+
+#include <errno.h>
+
+#include <mutex>
+
+#include <audio/liba2dp.h>
+#include <hardware_legacy/power.h>
+
+#include "FakeA2dp.h"
+
+static std::mutex sLock;
+static FakeA2dpState sState;
+static int sHandle;
+
+void fakeA2dpReset() {
+    std::lock_guard<std::mutex> lock(sLock);
+    sState = FakeA2dpState();
+}
+
+FakeA2dpState fakeA2dpState() {
+    std::lock_guard<std::mutex> lock(sLock);
+    return sState;
+}
+
+void fakeA2dpSetWriteError(int error) {
+    std::lock_guard<std::mutex> lock(sLock);
+    sState.writeError = error;
+}
+
+extern "C" int a2dp_init(int rate, int channels, a2dpData* dataPtr) {
+    std::lock_guard<std::mutex> lock(sLock);
+    if (rate != 44100 || channels != 2) return -EINVAL;
+    sState.inits++;
+    *dataPtr = &sHandle;
+    return 0;
+}
+
+extern "C" void a2dp_set_sink(a2dpData data, const char* address) {
+    std::lock_guard<std::mutex> lock(sLock);
+    sState.sink = address;
+}
+
+extern "C" int a2dp_write(a2dpData data, const void* buffer, int count) {
+    std::lock_guard<std::mutex> lock(sLock);
+    if (data != &sHandle) return -EBADF;
+    if (sState.writeError < 0) return sState.writeError;
+    sState.bytesWritten += count;
+    return count;
+}
+
+extern "C" int a2dp_stop(a2dpData data) {
+    std::lock_guard<std::mutex> lock(sLock);
+    sState.stops++;
+    return 0;
+}
+
+extern "C" void a2dp_cleanup(a2dpData data) {
+    std::lock_guard<std::mutex> lock(sLock);
+    sState.cleanups++;
+}
+
+extern "C" int acquire_wake_lock(int lock, const char* id) {
+    std::lock_guard<std::mutex> guard(sLock);
+    sState.wakeLocks++;
+    return 0;
+}
+
+extern "C" int release_wake_lock(const char* id) {
+    std::lock_guard<std::mutex> lock(sLock);
+    sState.wakeLocks--;
+    return 0;
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_FAKE_A2DP_H
+#define ANDROID_AUDIO_FAKE_A2DP_H
+
+#include <stdint.h>
+
+#include <string>
+
+// What the fake a2dp_*() and wake lock calls in FakeA2dp.cpp have seen, and
+// how a2dp_write() behaves. Everything is reset by fakeA2dpReset().
+struct FakeA2dpState {
+    int inits;
+    int stops;
+    int cleanups;
+    int wakeLocks;          // acquired minus released
+    uint64_t bytesWritten;
+    std::string sink;       // last a2dp_set_sink() address
+    int writeError;         // a2dp_write() returns this when negative
+};
+
+void fakeA2dpReset();
+FakeA2dpState fakeA2dpState();
+void fakeA2dpSetWriteError(int error);
+
+#endif  // ANDROID_AUDIO_FAKE_A2DP_H
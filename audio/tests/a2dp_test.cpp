@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <errno.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "A2dpAudioInterface.h"
+#include "AudioDumpInterface.h"
+#include "AudioHardwareStub.h"
+#include "FakeA2dp.h"
+
+namespace android_audio_legacy {
+
+class A2dpAudioInterfaceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        fakeA2dpReset();
+        mHw = new A2dpAudioInterface(new AudioHardwareStub());
+        status_t status = UNKNOWN_ERROR;
+        mOut = mHw->openOutputStream(AUDIO_DEVICE_OUT_BLUETOOTH_A2DP, nullptr, nullptr, nullptr,
+                                     &status);
+        ASSERT_EQ(NO_ERROR, status);
+        ASSERT_NE(nullptr, mOut);
+        mBuffer.resize(mOut->bufferSize());
+    }
+    void TearDown() override {
+        if (mOut != nullptr) mHw->closeOutputStream(mOut);
+        delete mHw;
+    }
+
+    A2dpAudioInterface* mHw = nullptr;
+    AudioStreamOut* mOut = nullptr;
+    std::vector<char> mBuffer;
+};
+
+// What write() accepts goes through the transport thread to a2dp_write(),
+// under a wake lock that standby() releases.
+TEST_F(A2dpAudioInterfaceTest, WritesReachTheLink) {
+    for (int i = 0; i < 10; i++) {
+        ASSERT_EQ(ssize_t(mBuffer.size()), mOut->write(mBuffer.data(), mBuffer.size()));
+    }
+    for (int i = 0; i < 100 && fakeA2dpState().bytesWritten == 0; i++) {
+        usleep(10000);
+    }
+    FakeA2dpState state = fakeA2dpState();
+    EXPECT_EQ(1, state.inits);
+    EXPECT_GT(state.bytesWritten, 0u);
+    EXPECT_LE(state.bytesWritten, 10 * mBuffer.size());
+    EXPECT_EQ(1, state.wakeLocks);
+
+    EXPECT_EQ(NO_ERROR, mOut->standby());
+    state = fakeA2dpState();
+    EXPECT_EQ(1, state.stops);
+    EXPECT_EQ(0, state.wakeLocks);
+}
+
+// AudioFlinger reads latency() once, so it covers the deepest jitter target
+// however the target moves: a buffer, the stack and 300ms.
+TEST_F(A2dpAudioInterfaceTest, LatencyStaysAtDeepestJitterTarget) {
+    uint32_t bufferMs = mOut->bufferSize() / mOut->frameSize() * 1000 / mOut->sampleRate();
+    uint32_t latency = mOut->latency();
+    EXPECT_EQ(bufferMs + 200 + 300, latency);
+
+    // starve the transport so the target is raised
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(ssize_t(mBuffer.size()), mOut->write(mBuffer.data(), mBuffer.size()));
+        usleep(200000);
+        EXPECT_EQ(latency, mOut->latency());
+    }
+}
+
+// An a2dp_write() failure comes back from a later write(), which then
+// starts over.
+TEST_F(A2dpAudioInterfaceTest, LinkErrorReachesWrite) {
+    fakeA2dpSetWriteError(-EIO);
+    ssize_t result = 0;
+    for (int i = 0; i < 20 && result >= 0; i++) {
+        result = mOut->write(mBuffer.data(), mBuffer.size());
+    }
+    EXPECT_EQ(-EIO, result);
+    EXPECT_EQ(0, fakeA2dpState().wakeLocks);
+
+    fakeA2dpSetWriteError(0);
+    EXPECT_EQ(ssize_t(mBuffer.size()), mOut->write(mBuffer.data(), mBuffer.size()));
+}
+
+// Other devices go to the wrapped interface, here through the dump interface.
+TEST(A2dpAudioInterfaceWrapTest, OtherDevicesOpenOnHardwareInterface) {
+    A2dpAudioInterface hw(new AudioDumpInterface(new AudioHardwareStub()));
+    ASSERT_EQ(NO_ERROR, hw.initCheck());
+    status_t status = UNKNOWN_ERROR;
+    AudioStreamOut* out = hw.openOutputStreamWithFlags(AUDIO_DEVICE_OUT_SPEAKER,
+            AUDIO_OUTPUT_FLAG_NONE, nullptr, nullptr, nullptr, &status);
+    ASSERT_EQ(NO_ERROR, status);
+    ASSERT_NE(nullptr, out);
+    EXPECT_EQ(0u, out->latency());
+    hw.closeOutputStream(out);
+    EXPECT_EQ(NO_ERROR, hw.setMasterMute(true));
+}
+
+}  // namespace android_audio_legacy
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "AudioHardwareGeneric.h"
+#include "../benchmarks/FakeAudioDevice.h"
+#include "AudioTestUtils.h"
+
+namespace android_audio_legacy {
+
+// Every byte written reaches the device, however the writes race the writer
+// thread going to sleep: a lost wakeup would stall this for good.
+TEST(AudioAsyncWriteTest, DeliversEveryWrite) {
+    std::atomic<size_t> played{0};
+    const size_t kPeriodBytes = 1024;
+    FakeAudioDevice device(kPeriodBytes, 20000, 0, 0,
+                           [&](const char*) { played += kPeriodBytes; });
+    AudioStreamOutGeneric out;
+    ASSERT_EQ(NO_ERROR, out.set(nullptr, device.fd(), 0, nullptr, nullptr, nullptr));
+    ASSERT_EQ(NO_ERROR, out.enableAsyncWrite(8192));
+
+    // odd sizes, so the ring keeps running dry part way through a period
+    std::vector<int16_t> buffer(2 * 75);
+    size_t written = 0;
+    for (int i = 0; i < 4096; i++) {
+        ASSERT_EQ(ssize_t(buffer.size() * 2), out.write(buffer.data(), buffer.size() * 2));
+        written += buffer.size() * 2;
+        if (i % 64 == 0) usleep(100);
+    }
+    // pad to whole device periods
+    std::vector<char> padding(kPeriodBytes - written % kPeriodBytes);
+    ASSERT_EQ(ssize_t(padding.size()), out.write(padding.data(), padding.size()));
+    written += padding.size();
+    for (int i = 0; i < 200 && played < written; i++) {
+        usleep(10000);
+    }
+    EXPECT_EQ(written, played.load());
+}
+
+// With nothing queued the writer thread sleeps until write() wakes it.
+TEST(AudioAsyncWriteTest, IdleWriterThreadSleeps) {
+    FakeAudioDevice device(4096, 1000000);
+    AudioStreamOutGeneric out;
+    ASSERT_EQ(NO_ERROR, out.set(nullptr, device.fd(), 0, nullptr, nullptr, nullptr));
+    ASSERT_EQ(NO_ERROR, out.enableAsyncWrite(16384));
+    std::vector<int16_t> buffer(2048);
+    ASSERT_EQ(4096, out.write(buffer.data(), 4096));
+    usleep(50000);
+
+    long before = voluntarySwitches();
+    usleep(200000);
+    // this thread's own sleep, and nothing else
+    EXPECT_LT(voluntarySwitches() - before, 5);
+
+    ASSERT_EQ(NO_ERROR, out.standby());
+    before = voluntarySwitches();
+    usleep(200000);
+    EXPECT_LT(voluntarySwitches() - before, 5);
+}
+
+// A device that fails every write does not block; write() returns its error
+// and the writer thread still only takes audio at the device rate, so the
+// client is held back by the ring filling up rather than spinning.
+TEST(AudioAsyncWriteTest, DeviceErrorReachesWrite) {
+    int fd = open("/dev/null", O_RDONLY);
+    ASSERT_GE(fd, 0);
+    {
+        AudioStreamOutGeneric out;
+        ASSERT_EQ(NO_ERROR, out.set(nullptr, fd, 0, nullptr, nullptr, nullptr));
+        ASSERT_EQ(NO_ERROR, out.enableAsyncWrite(16384));
+        std::vector<int16_t> buffer(2048);
+        size_t accepted = 0;
+        int errors = 0;
+        int64_t end = fakeDeviceNowNs() + 200000000;
+        while (fakeDeviceNowNs() < end) {
+            ssize_t ret = out.write(buffer.data(), 4096);
+            if (ret == -EBADF) {
+                errors++;
+                usleep(1000);
+            } else {
+                ASSERT_EQ(4096, ret);
+                accepted += ret;
+            }
+        }
+        EXPECT_GT(errors, 0);
+        // 200ms of audio at most, plus the ring and the period in flight
+        EXPECT_LT(accepted, 44100u / 5 * 4 + 16384 + 2 * 4096);
+    }
+    close(fd);
+}
+
+// standby() does not wait behind a write() that is itself waiting for the
+// device to make room in the ring.
+TEST(AudioAsyncWriteTest, StandbyDoesNotWaitForBlockedWrite) {
+    // the device stops for a second after its second period
+    FakeAudioDevice device(4096, 1000000, 1000000000, 2);
+    AudioStreamOutGeneric out;
+    ASSERT_EQ(NO_ERROR, out.set(nullptr, device.fd(), 0, nullptr, nullptr, nullptr));
+    ASSERT_EQ(NO_ERROR, out.enableAsyncWrite(16384));
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        std::vector<int16_t> buffer(2048);
+        while (!stop) {
+            out.write(buffer.data(), 4096);
+        }
+    });
+    // long enough for the ring to fill and write() to block
+    usleep(100000);
+    EXPECT_GT(out.overruns(), 0u);
+    int64_t start = fakeDeviceNowNs();
+    EXPECT_EQ(NO_ERROR, out.standby());
+    // twice the latency at most, which is 20ms plus the ring's ~93ms
+    EXPECT_LT(fakeDeviceNowNs() - start, 400000000);
+    stop = true;
+    writer.join();
+}
+
+}  // namespace android_audio_legacy
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "AudioHardwareGeneric.h"
+
+namespace android_audio_legacy {
+
+TEST(AudioBufferSizeTest, RoundsUpToAlignmentWithinLimits) {
+    const AudioPeriodConstraints c = {48000, 96, 960, 32};
+    // 5ms is 240 frames, rounded up to 256
+    EXPECT_EQ(256u, AudioHardwareBase::bufferFrames(48000, 5000, c));
+    // below the shortest period
+    EXPECT_EQ(96u, AudioHardwareBase::bufferFrames(48000, 1000, c));
+    // above the longest, which is itself aligned
+    EXPECT_EQ(960u, AudioHardwareBase::bufferFrames(48000, 40000, c));
+    // limits scale with the rate the stream is resampled from: 480 frames max
+    // at 24kHz, and rounding up to 32 must not pass it
+    EXPECT_EQ(480u - 480u % 32, AudioHardwareBase::bufferFrames(24000, 40000, c));
+    EXPECT_EQ(0u, AudioHardwareBase::bufferFrames(0, 5000, c));
+}
+
+TEST(AudioBufferSizeTest, InputSizeFollowsRate) {
+    // 20ms, as it always was at the device rate
+    EXPECT_EQ(AudioStreamInGeneric::kDeviceBufferSize, AudioStreamInGeneric::bufferSizeFor(8000));
+    EXPECT_EQ(960u * 2, AudioStreamInGeneric::bufferSizeFor(48000));
+    EXPECT_EQ(224u * 2, AudioStreamInGeneric::bufferSizeFor(11025));
+}
+
+TEST(AudioBufferSizeTest, FastOutputUsesShortPeriods) {
+    AudioStreamOutGeneric normal, fast;
+    uint32_t rate = 48000;
+    ASSERT_EQ(NO_ERROR, normal.set(nullptr, -1, 0, nullptr, nullptr, &rate));
+    ASSERT_EQ(NO_ERROR, fast.set(nullptr, -1, 0, nullptr, nullptr, &rate, AUDIO_OUTPUT_FLAG_FAST));
+    // a device buffer's worth, 1024 frames at 44.1kHz, without going over
+    EXPECT_EQ(1104u * 4, normal.bufferSize());
+    // 5ms
+    EXPECT_EQ(240u * 4, fast.bufferSize());
+    EXPECT_EQ(0u, fast.bufferSize() % (16 * fast.frameSize()));
+}
+
+}  // namespace android_audio_legacy
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "AudioHardwareGeneric.h"
+#include "../benchmarks/FakeAudioDevice.h"
+#include "AudioTestUtils.h"
+
+namespace android_audio_legacy {
+
+static const size_t kPeriodFrames = AudioStreamInGeneric::kDeviceBufferSize / sizeof(int16_t);
+
+static void openInput(AudioStreamInGeneric *in, int fd, size_t ringBytes) {
+    int format = AudioSystem::PCM_16_BIT;
+    uint32_t channels = AudioSystem::CHANNEL_IN_MONO;
+    uint32_t rate = AudioStreamInGeneric::kDeviceRate;
+    ASSERT_EQ(NO_ERROR, in->set(nullptr, fd, AudioSystem::DEVICE_IN_BUILTIN_MIC, &format,
+                                &channels, &rate, (AudioSystem::audio_in_acoustics)0));
+    ASSERT_EQ(NO_ERROR, in->enableCaptureThread(ringBytes));
+}
+
+// Reads count periods and returns how many frames were skipped between
+// them, going by the frame numbers FakeCaptureDevice writes.
+static size_t readPeriods(AudioStreamInGeneric *in, int count, uint16_t *next) {
+    std::vector<int16_t> buffer(kPeriodFrames);
+    size_t missing = 0;
+    for (int i = 0; i < count; i++) {
+        EXPECT_EQ(ssize_t(kPeriodFrames * sizeof(int16_t)),
+                  in->read(buffer.data(), buffer.size() * sizeof(int16_t)));
+        for (int16_t s : buffer) {
+            missing += uint16_t(s - *next);
+            *next = uint16_t(s) + 1;
+        }
+    }
+    return missing;
+}
+
+TEST(AudioStreamInGenericTest, StalledReaderCountsLostFrames) {
+    // eight times real time, so the stall overflows the ring quickly
+    FakeCaptureDevice device(kPeriodFrames, 1000000);
+    AudioStreamInGeneric in;
+    openInput(&in, device.fd(), 8 * AudioStreamInGeneric::kDeviceBufferSize);
+
+    uint16_t next = 0;
+    EXPECT_EQ(0u, readPeriods(&in, 20, &next));
+    EXPECT_EQ(0u, in.getInputFramesLost());
+
+    // ~40 periods arrive while read() is not called; the ring holds ~12
+    usleep(40000);
+    size_t missing = readPeriods(&in, 60, &next);
+    EXPECT_GT(missing, 20 * kPeriodFrames);
+    EXPECT_EQ(0u, missing % kPeriodFrames);
+    EXPECT_EQ(missing, in.getInputFramesLost());
+    EXPECT_EQ(missing / kPeriodFrames, in.overruns());
+    // reading the count resets it
+    EXPECT_EQ(0u, in.getInputFramesLost());
+    // the capture thread itself kept up with the device
+    EXPECT_EQ(0, device.dropped());
+
+    // lost frames still count towards the capture position
+    int64_t frames, time;
+    ASSERT_EQ(NO_ERROR, in.getCapturePosition(&frames, &time));
+    EXPECT_EQ(int64_t(80 * kPeriodFrames + missing), frames);
+}
+
+TEST(AudioStreamInGenericTest, CapturePositionFollowsReads) {
+    FakeCaptureDevice device(kPeriodFrames,
+                             int64_t(kPeriodFrames) * 1000000000 / AudioStreamInGeneric::kDeviceRate);
+    AudioStreamInGeneric in;
+    openInput(&in, device.fd(), 8 * AudioStreamInGeneric::kDeviceBufferSize);
+
+    int64_t frames, time;
+    EXPECT_EQ(INVALID_OPERATION, in.getCapturePosition(&frames, &time));
+
+    uint16_t next = 0;
+    int64_t lastTime = 0;
+    for (int i = 1; i <= 10; i++) {
+        EXPECT_EQ(0u, readPeriods(&in, 1, &next));
+        ASSERT_EQ(NO_ERROR, in.getCapturePosition(&frames, &time));
+        EXPECT_EQ(int64_t(i * kPeriodFrames), frames);
+        // stamped when the period arrived, not when it was read
+        EXPECT_LE(time, fakeDeviceNowNs());
+        EXPECT_GT(time, lastTime);
+        lastTime = time;
+    }
+    EXPECT_EQ(0u, in.getInputFramesLost());
+
+    // nothing stale is handed out after standby
+    ASSERT_EQ(NO_ERROR, in.standby());
+    EXPECT_EQ(INVALID_OPERATION, in.getCapturePosition(&frames, &time));
+    std::vector<int16_t> buffer(kPeriodFrames);
+    ASSERT_EQ(ssize_t(kPeriodFrames * sizeof(int16_t)),
+              in.read(buffer.data(), buffer.size() * sizeof(int16_t)));
+    ASSERT_EQ(NO_ERROR, in.getCapturePosition(&frames, &time));
+    EXPECT_GT(time, lastTime);
+}
+
+// In standby the capture thread sleeps until read() starts it again, and it
+// is idle again once standby() returns.
+TEST(AudioStreamInGenericTest, StandbyCaptureThreadSleeps) {
+    // The fake device wakes about four times in each 200ms window; polling
+    // would add forty.
+    FakeCaptureDevice device(kPeriodFrames, 50000000);
+    AudioStreamInGeneric in;
+    openInput(&in, device.fd(), 8 * AudioStreamInGeneric::kDeviceBufferSize);
+    usleep(50000);
+    long before = voluntarySwitches();
+    usleep(200000);
+    EXPECT_LT(voluntarySwitches() - before, 10);
+
+    uint16_t next = 0;
+    readPeriods(&in, 2, &next);
+    EXPECT_EQ(NO_ERROR, in.standby());
+    EXPECT_EQ(0u, in.getInputFramesLost());
+    before = voluntarySwitches();
+    usleep(200000);
+    EXPECT_LT(voluntarySwitches() - before, 10);
+}
+
+// A failed or removed device makes read() return the error rather than
+// wait on the capture thread for good, and standby() still goes through.
+TEST(AudioStreamInGenericTest, DeviceErrorReachesRead) {
+    int fd = open("/dev/null", O_WRONLY);
+    ASSERT_GE(fd, 0);
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    close(fds[1]);
+    std::vector<int16_t> buffer(kPeriodFrames);
+    {
+        AudioStreamInGeneric in;
+        openInput(&in, fd, 8 * AudioStreamInGeneric::kDeviceBufferSize);
+        EXPECT_EQ(-EBADF, in.read(buffer.data(), buffer.size() * sizeof(int16_t)));
+        EXPECT_EQ(-EBADF, in.read(buffer.data(), buffer.size() * sizeof(int16_t)));
+        EXPECT_EQ(NO_ERROR, in.standby());
+    }
+    {
+        AudioStreamInGeneric in;
+        openInput(&in, fds[0], 8 * AudioStreamInGeneric::kDeviceBufferSize);
+        EXPECT_EQ(-EIO, in.read(buffer.data(), buffer.size() * sizeof(int16_t)));
+        EXPECT_EQ(NO_ERROR, in.standby());
+    }
+    close(fds[0]);
+    close(fd);
+}
+
+// A driver that returns an odd number of bytes before failing does not
+// shift the samples after it by a byte.
+TEST(AudioStreamInGenericTest, SplitSampleStaysAligned) {
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    std::atomic<bool> stop{false};
+    std::thread device([&] {
+        std::vector<int16_t> frames(4000);
+        for (size_t i = 0; i < frames.size(); i++) frames[i] = int16_t(i);
+        const char* p = (const char*)frames.data();
+        const char* end = p + frames.size() * sizeof(int16_t);
+        // 99 bytes at a time, so most periods end on half a sample
+        while (p < end && !stop) {
+            ssize_t n = write(fds[1], p, std::min<size_t>(99, end - p));
+            if (n > 0) p += n;
+            usleep(1000);
+        }
+    });
+    std::vector<int16_t> captured;
+    {
+        AudioStreamInGeneric in;
+        openInput(&in, fds[0], 64 * AudioStreamInGeneric::kDeviceBufferSize);
+        std::vector<int16_t> buffer(kPeriodFrames);
+        for (int i = 0; i < 1000 && captured.size() < 3000; i++) {
+            // the pipe running dry is an error for a blocking driver
+            ssize_t n = in.read(buffer.data(), buffer.size() * sizeof(int16_t));
+            if (n > 0) {
+                captured.insert(captured.end(), buffer.begin(), buffer.begin() + n / 2);
+            }
+        }
+    }
+    stop = true;
+    device.join();
+    close(fds[1]);
+    close(fds[0]);
+    ASSERT_GE(captured.size(), 3000u);
+    for (size_t i = 0; i < captured.size(); i++) {
+        ASSERT_EQ(int16_t(i), captured[i]) << "at " << i;
+    }
+}
+
+}  // namespace android_audio_legacy
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "AudioDeviceMap.h"
+
+namespace android_audio_legacy {
+
+// The devices of one side of the table: legacy or 2.0, outputs or inputs.
+static std::vector<uint32_t> devices(int rev, bool input) {
+    std::vector<uint32_t> d;
+    for (const auto& row : audio_device_conv_table) {
+        bool in = rev == HAL_API_REV_2_0 ? (row[rev] & AUDIO_DEVICE_BIT_IN) != 0
+                                         : (row[rev] & AudioSystem::DEVICE_IN_ALL) != 0;
+        if (in == input) d.push_back(row[rev]);
+    }
+    return d;
+}
+
+// Every combination of every side's devices converts to the combination of
+// their rows' other sides, and bits in no row are dropped.
+TEST(AudioDeviceMapTest, ConvertsEveryMask) {
+    for (int from = HAL_API_REV_1_0; from <= HAL_API_REV_2_0; from++) {
+        const int to = from == HAL_API_REV_1_0 ? HAL_API_REV_2_0 : HAL_API_REV_1_0;
+        for (bool input : {false, true}) {
+            const std::vector<uint32_t> d = devices(from, input);
+            ASSERT_LT(d.size(), 20u);
+            uint32_t all = 0;
+            for (uint32_t combination = 0; combination < (1u << d.size()); combination++) {
+                uint32_t mask = 0, expected = 0;
+                for (size_t i = 0; i < d.size(); i++) {
+                    if (combination & (1u << i)) {
+                        mask |= d[i];
+                        expected |= convert_audio_device(d[i], from, to);
+                    }
+                }
+                ASSERT_EQ(expected, (uint32_t)convert_audio_device(mask, from, to))
+                        << "from " << from << " mask " << std::hex << mask;
+                all = mask;
+            }
+            for (const auto& row : audio_device_conv_table) {
+                if (std::find(d.begin(), d.end(), row[from]) != d.end()) {
+                    EXPECT_EQ(row[to], (uint32_t)convert_audio_device(row[from], from, to));
+                }
+            }
+            // a bit no device of this side uses
+            uint32_t unused = 0;
+            for (uint32_t bit = 1; bit && !unused; bit <<= 1) {
+                if (!((all | AUDIO_DEVICE_BIT_IN) & bit)) unused = bit;
+            }
+            EXPECT_EQ(convert_audio_device(all, from, to),
+                      convert_audio_device(all | unused, from, to));
+        }
+    }
+}
+
+}  // namespace android_audio_legacy
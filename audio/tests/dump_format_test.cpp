@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "AudioDumpFormat.h"
+#include "AudioDumpWriter.h"
+#include "AudioTestUtils.h"
+
+namespace android_audio_legacy {
+
+static std::vector<int16_t> roundTrip(const std::vector<int16_t>& pcm, uint32_t channels,
+                                      size_t* encoded) {
+    std::vector<uint8_t> buffer(pcm.size() * sizeof(int16_t));
+    size_t frames = pcm.size() / channels;
+    *encoded = audioDumpEncodeRice(buffer.data(), buffer.size(), pcm.data(), frames, channels);
+    std::vector<int16_t> decoded(pcm.size());
+    size_t decodedFrames = 0;
+    if (*encoded != 0) {
+        EXPECT_TRUE(audioDumpDecodeRice(decoded.data(), frames, &decodedFrames, channels,
+                                        buffer.data(), *encoded));
+        EXPECT_EQ(frames, decodedFrames);
+    }
+    return decoded;
+}
+
+TEST(AudioDumpFormatTest, RiceIsLossless) {
+    const size_t kFrames = 4096;
+    std::vector<int16_t> tone(kFrames * 2);
+    for (size_t i = 0; i < kFrames; i++) {
+        tone[2 * i] = int16_t(12000 * sin(i * 0.031));
+        tone[2 * i + 1] = int16_t(-9000 * sin(i * 0.0071));
+    }
+    size_t encoded;
+    EXPECT_EQ(tone, roundTrip(tone, 2, &encoded));
+    // a smooth signal codes to well under half
+    EXPECT_GT(encoded, 0u);
+    EXPECT_LT(encoded, tone.size());
+
+    // full scale clicks in silence need the escape code
+    std::vector<int16_t> clicks(kFrames);
+    for (size_t i = 0; i < kFrames; i += 500) clicks[i] = i % 1000 ? 32767 : -32768;
+    EXPECT_EQ(clicks, roundTrip(clicks, 1, &encoded));
+    EXPECT_GT(encoded, 0u);
+
+    // white noise does not compress, and is left to be stored as it is
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> sample(-32768, 32767);
+    std::vector<int16_t> noise(kFrames);
+    for (auto& s : noise) s = sample(rng);
+    roundTrip(noise, 1, &encoded);
+    EXPECT_EQ(0u, encoded);
+}
+
+TEST(AudioDumpFormatTest, RejectsCorruptRecords) {
+    std::vector<int16_t> pcm(256);
+    for (size_t i = 0; i < pcm.size(); i++) pcm[i] = int16_t(i * 11);
+    std::vector<uint8_t> buffer(pcm.size() * 2);
+    size_t size = audioDumpEncodeRice(buffer.data(), buffer.size(), pcm.data(), pcm.size(), 1);
+    ASSERT_GT(size, 0u);
+    std::vector<int16_t> out(pcm.size());
+    size_t frames;
+    EXPECT_FALSE(audioDumpDecodeRice(out.data(), pcm.size(), &frames, 1, buffer.data(), size - 1));
+    EXPECT_FALSE(audioDumpDecodeRice(out.data(), pcm.size() - 1, &frames, 1, buffer.data(), size));
+    buffer[4] = 0xff;  // order 7
+    EXPECT_FALSE(audioDumpDecodeRice(out.data(), pcm.size(), &frames, 1, buffer.data(), size));
+}
+
+// What AudioStreamOutDump does, read back the way the audio_dump tool does.
+TEST(AudioDumpFormatTest, WriterContainerReadsBack) {
+    const std::string path = tempPath("dump_format.adump");
+    const uint32_t kRate = 48000;
+    std::vector<int16_t> written;
+    {
+        AudioDumpWriter writer(512 * 1024, false);
+        ASSERT_EQ(NO_ERROR, writer.init());
+        AudioDumpHeader header;
+        audioDumpInitHeader(&header);
+        header.format = AudioSystem::PCM_16_BIT;
+        header.sampleRate = kRate;
+        header.channelMask = AudioSystem::CHANNEL_OUT_STEREO;
+        header.channelCount = 2;
+        header.frameSize = 4;
+        header.device = AudioSystem::DEVICE_OUT_SPEAKER;
+        header.flags = AUDIO_DUMP_FLAG_COMPRESSED;
+        ASSERT_EQ(NO_ERROR, writer.open(path.c_str(), &header));
+        std::vector<int16_t> buffer(480 * 2);
+        size_t n = 0;
+        for (int i = 0; i < 200; i++) {
+            for (size_t f = 0; f < 480; f++, n++) {
+                buffer[2 * f] = buffer[2 * f + 1] = int16_t(10000 * sin(n * 0.05));
+            }
+            ASSERT_EQ(buffer.size() * 2, writer.write(buffer.data(), buffer.size() * 2));
+            written.insert(written.end(), buffer.begin(), buffer.end());
+            usleep(100);
+        }
+        writer.close();
+    }
+
+    AudioDumpReader reader;
+    ASSERT_EQ(NO_ERROR, reader.open(path.c_str()));
+    EXPECT_EQ(kRate, reader.header().sampleRate);
+    EXPECT_EQ(uint32_t(AudioSystem::DEVICE_OUT_SPEAKER), reader.header().device);
+    EXPECT_GT(reader.header().startRealtimeNs, 0);
+    EXPECT_EQ(kAudioDumpByteOrder, reader.header().byteOrder);
+
+    std::vector<int16_t> read;
+    int syncs = 0, riceRecords = 0;
+    uint32_t type;
+    status_t status;
+    while ((status = reader.next(&type)) == NO_ERROR) {
+        if (type == AUDIO_DUMP_RECORD_SYNC) {
+            // the first marks the start of the stream
+            if (syncs++ == 0) {
+                EXPECT_EQ(0u, reader.sync().position);
+            }
+            EXPECT_EQ(read.size() / 2, reader.sync().position);
+            continue;
+        }
+        if (type == AUDIO_DUMP_RECORD_RICE) riceRecords++;
+        const int16_t* p = static_cast<const int16_t*>(reader.pcm());
+        read.insert(read.end(), p, p + reader.frames() * 2);
+    }
+    EXPECT_EQ(NOT_ENOUGH_DATA, status);
+    EXPECT_EQ(written, read);
+    EXPECT_GE(syncs, 1);
+    EXPECT_GT(riceRecords, 0);
+    unlink(path.c_str());
+}
+
+// Integers are in the writer's byte order, so a file from a device of the
+// other one is refused rather than misread.
+TEST(AudioDumpFormatTest, RejectsOtherByteOrder) {
+    const std::string path = tempPath("dump_format_swapped.adump");
+    AudioDumpHeader header;
+    audioDumpInitHeader(&header);
+    header.frameSize = 4;
+    header.byteOrder = __builtin_bswap32(kAudioDumpByteOrder);
+    FILE* f = fopen(path.c_str(), "wb");
+    ASSERT_NE(nullptr, f);
+    ASSERT_EQ(1u, fwrite(&header, sizeof(header), 1, f));
+    fclose(f);
+
+    AudioDumpReader reader;
+    EXPECT_EQ(BAD_VALUE, reader.open(path.c_str()));
+    unlink(path.c_str());
+}
+
+}  // namespace android_audio_legacy
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "AudioDumpWriter.h"
+#include "AudioTestUtils.h"
+
+namespace android_audio_legacy {
+
+TEST(AudioDumpWriterTest, FilesHoldExactlyTheirWrites) {
+    const std::string first = tempPath("dump_test_1.pcm"), second = tempPath("dump_test_2.pcm");
+    std::vector<int16_t> buffer(1000);
+    int16_t next = 0;
+    {
+        AudioDumpWriter writer(64 * 1024, true);
+        ASSERT_EQ(NO_ERROR, writer.init());
+        // written before any file is open: not dumped
+        writer.write(buffer.data(), buffer.size() * sizeof(int16_t));
+        ASSERT_EQ(NO_ERROR, writer.open(first.c_str()));
+        for (int i = 0; i < 100; i++) {
+            for (auto& s : buffer) s = next++;
+            ASSERT_EQ(buffer.size() * sizeof(int16_t),
+                      writer.write(buffer.data(), buffer.size() * sizeof(int16_t)));
+            usleep(500);
+        }
+        writer.close();
+        ASSERT_EQ(NO_ERROR, writer.open(second.c_str()));
+        for (auto& s : buffer) s = next++;
+        writer.write(buffer.data(), buffer.size() * sizeof(int16_t));
+        EXPECT_EQ(0u, writer.drops());
+    }
+
+    std::vector<int16_t> a = readAndRemove(first), b = readAndRemove(second);
+    ASSERT_EQ(100000u, a.size());
+    ASSERT_EQ(1000u, b.size());
+    for (size_t i = 0; i < a.size(); i++) ASSERT_EQ(int16_t(i), a[i]);
+    EXPECT_EQ(int16_t(100000), b[0]);
+}
+
+TEST(AudioDumpWriterTest, DropsWholeBuffersWhenBehind) {
+    // no I/O thread, so nothing drains the ring
+    AudioDumpWriter writer(4096, false);
+    std::vector<char> buffer(1500);
+    EXPECT_EQ(1500u, writer.write(buffer.data(), buffer.size()));
+    EXPECT_EQ(1500u, writer.write(buffer.data(), buffer.size()));
+    EXPECT_EQ(0u, writer.write(buffer.data(), buffer.size()));
+    EXPECT_EQ(1u, writer.drops());
+    EXPECT_EQ(1500u, writer.droppedBytes());
+}
+
+}  // namespace android_audio_legacy
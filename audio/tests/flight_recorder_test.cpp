@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AudioDumpFormat.h"
+#include "AudioDumpInterface.h"
+#include "AudioFlightRecorder.h"
+#include "AudioHardwareStub.h"
+#include "AudioTestUtils.h"
+
+namespace android_audio_legacy {
+
+TEST(AudioFlightRecorderTest, KeepsTheNewestHistory) {
+    const std::string prefix = tempPath("flight_test_a");
+    // an odd size, so writes wrap at every offset
+    AudioFlightRecorder recorder(10007 * sizeof(int16_t), sizeof(int16_t));
+    ASSERT_EQ(NO_ERROR, recorder.init(prefix.c_str()));
+    ASSERT_EQ(10007 * sizeof(int16_t), recorder.capacity());
+
+    // nothing written yet: an empty file
+    ASSERT_EQ(NO_ERROR, recorder.persist());
+    EXPECT_EQ(prefix + "_1.pcm", recorder.lastPath());
+    EXPECT_TRUE(readAndRemove(recorder.lastPath()).empty());
+
+    std::vector<int16_t> buffer(480);
+    int16_t next = 0;
+    for (int i = 0; i < 100; i++) {
+        for (auto& s : buffer) s = next++;
+        recorder.write(buffer.data(), buffer.size() * sizeof(int16_t));
+    }
+    ASSERT_EQ(NO_ERROR, recorder.persist());
+    std::vector<int16_t> data = readAndRemove(recorder.lastPath());
+    ASSERT_EQ(10007u, data.size());
+    int16_t expected = next - 10007;
+    for (size_t i = 0; i < data.size(); i++) {
+        ASSERT_EQ(expected++, data[i]) << "at " << i;
+    }
+    EXPECT_EQ(0u, recorder.lostBytes());
+    EXPECT_EQ(2u, recorder.files());
+}
+
+TEST(AudioFlightRecorderTest, TriggerSavesInTheBackground) {
+    const std::string prefix = tempPath("flight_test_b");
+    AudioFlightRecorder recorder(4800 * sizeof(int16_t), sizeof(int16_t));
+    ASSERT_EQ(NO_ERROR, recorder.init(prefix.c_str()));
+
+    std::vector<int16_t> buffer(1000, 7);
+    recorder.write(buffer.data(), buffer.size() * sizeof(int16_t));
+    recorder.trigger("test");
+    // a second trigger before the save is the same event
+    recorder.trigger("test");
+    for (int i = 0; i < 40 && recorder.files() == 0; i++) {
+        usleep(10000);
+    }
+    ASSERT_EQ(1u, recorder.files());
+    EXPECT_EQ(1u, recorder.triggers());
+    EXPECT_EQ(buffer, readAndRemove(recorder.lastPath()));
+}
+
+// With a header the history is saved as a container the audio_dump tool
+// replays: the stream's configuration, then the frames, then where they end.
+TEST(AudioFlightRecorderTest, SavesContainerWithHeader) {
+    const std::string prefix = tempPath("flight_test_c");
+    AudioFlightRecorder recorder(4800 * 2 * sizeof(int16_t), 2 * sizeof(int16_t));
+    AudioDumpHeader header;
+    audioDumpInitHeader(&header);
+    header.format = AudioSystem::PCM_16_BIT;
+    header.sampleRate = 48000;
+    header.channelMask = AudioSystem::CHANNEL_OUT_STEREO;
+    header.channelCount = 2;
+    header.frameSize = 2 * sizeof(int16_t);
+    header.device = 2;
+    ASSERT_EQ(NO_ERROR, recorder.init(prefix.c_str(), &header));
+
+    // 12000 frames, of which the last 4800 are kept
+    std::vector<int16_t> buffer(2 * 1000);
+    int16_t next = 0;
+    for (int i = 0; i < 12; i++) {
+        for (auto& s : buffer) s = next++;
+        recorder.write(buffer.data(), buffer.size() * sizeof(int16_t));
+    }
+    ASSERT_EQ(NO_ERROR, recorder.persist());
+    EXPECT_EQ(prefix + "_1.adump", recorder.lastPath());
+
+    AudioDumpReader reader;
+    ASSERT_EQ(NO_ERROR, reader.open(recorder.lastPath()));
+    EXPECT_EQ(48000u, reader.header().sampleRate);
+    EXPECT_EQ(2u, reader.header().channelCount);
+    EXPECT_EQ(2u, reader.header().device);
+    std::vector<int16_t> data;
+    std::vector<uint64_t> syncs;
+    uint32_t type;
+    while (reader.next(&type) == NO_ERROR) {
+        if (type == AUDIO_DUMP_RECORD_SYNC) {
+            syncs.push_back(reader.sync().position);
+        }
+        const int16_t* pcm = (const int16_t*)reader.pcm();
+        data.insert(data.end(), pcm, pcm + reader.frames() * 2);
+    }
+    unlink(recorder.lastPath());
+
+    ASSERT_EQ(2u, syncs.size());
+    EXPECT_EQ(12000u - 4800u, syncs[0]);
+    EXPECT_EQ(12000u, syncs[1]);
+    ASSERT_EQ(4800u * 2, data.size());
+    int16_t expected = next - 4800 * 2;
+    for (size_t i = 0; i < data.size(); i++) {
+        ASSERT_EQ(expected++, data[i]) << "at " << i;
+    }
+}
+
+// A dump asks every stream to save while streams are opened and closed.
+TEST(AudioFlightRecorderTest, TriggersWhileStreamsOpenAndClose) {
+    const std::string prefix = tempPath("flight_test_d");
+    AudioDumpInterface hw(new AudioHardwareStub());
+    hw.setParameters(String8(("test_cmd_file_name=" + prefix).c_str()));
+    hw.setParameters(String8("test_cmd_flight_recorder=1"));
+
+    std::atomic<bool> done(false);
+    std::thread trigger([&] {
+        while (!done.load()) hw.triggerFlightRecorders("test");
+    });
+    for (int i = 0; i < 50; i++) {
+        AudioStreamOut* out = hw.openOutputStream(AUDIO_DEVICE_OUT_SPEAKER);
+        AudioStreamIn* in = hw.openInputStream(AUDIO_DEVICE_IN_BUILTIN_MIC, nullptr, nullptr,
+                nullptr, nullptr, (AudioSystem::audio_in_acoustics)0);
+        ASSERT_NE(nullptr, out);
+        ASSERT_NE(nullptr, in);
+        hw.closeInputStream(in);
+        hw.closeOutputStream(out);
+    }
+    done.store(true);
+    trigger.join();
+    for (const char* kind : {"out", "in"}) {
+        for (int n = 1; ; n++) {
+            std::string path = prefix + "_" + kind + "_0_flight_" + std::to_string(n) + ".adump";
+            if (unlink(path.c_str()) != 0) break;
+        }
+    }
+}
+
+// A prefix with no room left for the file number is refused up front, not
+// cut short when the recording is saved.
+TEST(AudioFlightRecorderTest, RejectsOverlongPrefix) {
+    AudioFlightRecorder recorder(4800 * sizeof(int16_t), sizeof(int16_t));
+    const std::string prefix(AudioFlightRecorder::kMaxPath - 8, 'x');
+    EXPECT_EQ(BAD_VALUE, recorder.init(prefix.c_str()));
+    EXPECT_EQ(NO_INIT, recorder.persist());
+}
+
+}  // namespace android_audio_legacy
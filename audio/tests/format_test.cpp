@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "AudioFormatConverter.h"
+#include "AudioHardwareGeneric.h"
+#include "AudioMixOps.h"
+#include "../benchmarks/FakeAudioDevice.h"
+
+namespace android_audio_legacy {
+
+// Odd lengths so the scalar tails run too.
+TEST(AudioMixOpsTest, ConvertMatchesScalar) {
+    const size_t n = 1021;
+    std::mt19937 rng(4);
+    std::vector<float> f(n);
+    std::vector<int32_t> i32(n);
+    std::vector<uint8_t> packed(n * 3);
+    for (size_t i = 0; i < n; i++) {
+        f[i] = std::uniform_real_distribution<float>(-1.5f, 1.5f)(rng);
+        i32[i] = int32_t(rng());
+    }
+    for (auto& b : packed) b = uint8_t(rng());
+
+    std::vector<int32_t> e(n), a(n);
+    convertFloatTo8_24Scalar(e.data(), f.data(), n);
+    convertFloatTo8_24(a.data(), f.data(), n);
+    EXPECT_EQ(e, a);
+    convert32To8_24Scalar(e.data(), i32.data(), n);
+    convert32To8_24(a.data(), i32.data(), n);
+    EXPECT_EQ(e, a);
+    convertPacked24To8_24Scalar(e.data(), packed.data(), n);
+    convertPacked24To8_24(a.data(), packed.data(), n);
+    EXPECT_EQ(e, a);
+
+    std::vector<int16_t> e16(2 * n), a16(2 * n);
+    for (int dithered = 0; dithered < 2; dithered++) {
+        AudioDither de, da;
+        convert8_24To16Scalar(e16.data(), i32.data(), n, dithered ? &de : nullptr);
+        convert8_24To16(a16.data(), i32.data(), n, dithered ? &da : nullptr);
+        EXPECT_EQ(e16, a16) << "dither " << dithered;
+    }
+    std::vector<int16_t> mono(n);
+    for (auto& s : mono) s = int16_t(rng());
+    upmixMonoToStereo16Scalar(e16.data(), mono.data(), n);
+    upmixMonoToStereo16(a16.data(), mono.data(), n);
+    EXPECT_EQ(e16, a16);
+    std::vector<int16_t> em(n), am(n);
+    downmixStereoToMono16Scalar(em.data(), e16.data(), n);
+    downmixStereoToMono16(am.data(), e16.data(), n);
+    EXPECT_EQ(em, am);
+    EXPECT_EQ(mono, am);
+
+    const int16_t matrix[2][8] = {{8192, 0, 5793, 5793, 5793, 0}, {0, 8192, 5793, 5793, 0, 5793}};
+    const size_t frames = e16.size() / 6;
+    std::vector<int16_t> er(2 * frames), ar(2 * frames);
+    remix16Scalar(er.data(), 2, e16.data(), 6, matrix, frames);
+    remix16(ar.data(), 2, e16.data(), 6, matrix, frames);
+    EXPECT_EQ(er, ar);
+}
+
+TEST(AudioFormatConverterTest, WideFormatsRoundToNearest) {
+    int16_t out[4];
+    const float f[] = {0.5f, -1.0f, 2.0f, 1.0f / 65536};
+    AudioFormatConverter fromFloat(AUDIO_FORMAT_PCM_FLOAT, AudioSystem::CHANNEL_OUT_STEREO, 2, false);
+    fromFloat.convert(out, f, 2);
+    EXPECT_EQ(16384, out[0]);
+    EXPECT_EQ(-32768, out[1]);
+    EXPECT_EQ(32767, out[2]);
+    EXPECT_EQ(1, out[3]);   // half an LSB rounds up
+
+    // 0x123480 is 0x1234 and a half
+    const uint8_t packed[] = {0x80, 0x34, 0x12, 0x7f, 0x34, 0x12, 0x00, 0x00, 0x80, 0xff, 0xff, 0x7f};
+    AudioFormatConverter fromPacked(AUDIO_FORMAT_PCM_24_BIT_PACKED,
+            AudioSystem::CHANNEL_OUT_STEREO, 2, false);
+    fromPacked.convert(out, packed, 2);
+    EXPECT_EQ(0x1235, out[0]);
+    EXPECT_EQ(0x1234, out[1]);
+    EXPECT_EQ(-32768, out[2]);
+    EXPECT_EQ(32767, out[3]);
+    EXPECT_EQ(6u, fromPacked.frameSize());
+
+    const int32_t q31[] = {0x40000000, -0x40000000};
+    AudioFormatConverter from32(AUDIO_FORMAT_PCM_32_BIT, AudioSystem::CHANNEL_OUT_MONO, 2, false);
+    from32.convert(out, q31, 2);
+    EXPECT_EQ(16384, out[0]);
+    EXPECT_EQ(16384, out[1]);
+    EXPECT_EQ(-16384, out[2]);
+    EXPECT_EQ(-16384, out[3]);
+}
+
+// TPDF dither is +/-1 LSB and zero mean, so a constant between two codes
+// averages out to the true level instead of always rounding the same way.
+TEST(AudioFormatConverterTest, DitherIsUnbiased) {
+    const size_t n = 1 << 16;
+    std::vector<float> f(n, 100.3f / 32768);
+    std::vector<int16_t> out(n);
+    AudioFormatConverter conv(AUDIO_FORMAT_PCM_FLOAT, AudioSystem::CHANNEL_OUT_MONO, 1, true);
+    conv.convert(out.data(), f.data(), n);
+    double sum = 0;
+    for (int16_t s : out) {
+        EXPECT_GE(s, 99);
+        EXPECT_LE(s, 101);
+        sum += s;
+    }
+    EXPECT_NEAR(100.3, sum / n, 0.02);
+}
+
+TEST(AudioFormatConverterTest, DownmixesSurround) {
+    // FL FR FC LFE BL BR
+    const int16_t in[] = {1000, 2000, 4000, 0, 8000, -8000};
+    int16_t out[2];
+    AudioFormatConverter conv(AUDIO_FORMAT_PCM_16_BIT, AudioSystem::CHANNEL_OUT_5POINT1, 2, false);
+    conv.convert(out, in, 1);
+    // front + 0.7071 * (centre + back)
+    EXPECT_NEAR(1000 + 0.7071 * (4000 + 8000), out[0], 1);
+    EXPECT_NEAR(2000 + 0.7071 * (4000 - 8000), out[1], 1);
+
+    EXPECT_FALSE(AudioFormatConverter::isSupported(AUDIO_FORMAT_PCM_8_BIT,
+            AudioSystem::CHANNEL_OUT_STEREO));
+    EXPECT_FALSE(AudioFormatConverter::isSupported(AUDIO_FORMAT_PCM_FLOAT, 0));
+}
+
+// A float 5.1 client is accepted as such and reaches the device as 16-bit stereo.
+TEST(AudioFormatConverterTest, GenericOutputAcceptsFloatSurround) {
+    std::atomic<int> peak{0};
+    FakeAudioDevice device(4096, 1000000, 0, 0, [&](const char* p) {
+        const int16_t* s = (const int16_t*)p;
+        for (int i = 0; i < 2048; i++) {
+            if (s[i] > peak) peak = s[i];
+        }
+    });
+    AudioStreamOutGeneric out;
+    int format = AUDIO_FORMAT_PCM_FLOAT;
+    uint32_t channels = AudioSystem::CHANNEL_OUT_5POINT1;
+    ASSERT_EQ(NO_ERROR, out.set(nullptr, device.fd(), 0, &format, &channels, nullptr));
+    EXPECT_EQ(AUDIO_FORMAT_PCM_FLOAT, out.format());
+    EXPECT_EQ(24u, out.frameSize());
+    EXPECT_EQ(1024 * 24u, out.bufferSize());
+
+    std::vector<float> buffer(out.bufferSize() / sizeof(float));
+    for (size_t i = 0; i < buffer.size(); i += 6) buffer[i] = 0.25f;  // front left only
+    for (int i = 0; i < 8; i++) {
+        ASSERT_EQ(ssize_t(out.bufferSize()), out.write(buffer.data(), out.bufferSize()));
+    }
+    uint64_t position;
+    struct timespec ts;
+    ASSERT_EQ(NO_ERROR, out.getPresentationPosition(&position, &ts));
+    EXPECT_EQ(8 * 1024u - 20 * 441 / 10, position);
+    usleep(20000);
+    EXPECT_EQ(8192, peak.load());
+
+    format = AUDIO_FORMAT_PCM_8_BIT;
+    AudioStreamOutGeneric bad;
+    EXPECT_EQ(BAD_VALUE, bad.set(nullptr, device.fd(), 0, &format, &channels, nullptr));
+}
+
+// Just enough of an input to ask frameSize() of any format.
+class FormatOnlyStreamIn : public AudioStreamIn {
+  public:
+    FormatOnlyStreamIn(int format, uint32_t channels) : mFormat(format), mChannels(channels) {}
+    uint32_t sampleRate() const override { return 8000; }
+    size_t bufferSize() const override { return 320; }
+    uint32_t channels() const override { return mChannels; }
+    int format() const override { return mFormat; }
+    status_t setGain(float) override { return NO_ERROR; }
+    ssize_t read(void*, ssize_t) override { return 0; }
+    status_t dump(int, const Vector<String16>&) override { return NO_ERROR; }
+    status_t standby() override { return NO_ERROR; }
+    status_t setParameters(const String8&) override { return NO_ERROR; }
+    String8 getParameters(const String8&) override { return String8(); }
+    unsigned int getInputFramesLost() const override { return 0; }
+    status_t addAudioEffect(effect_handle_t) override { return NO_ERROR; }
+    status_t removeAudioEffect(effect_handle_t) override { return NO_ERROR; }
+
+  private:
+    int mFormat;
+    uint32_t mChannels;
+};
+
+// Compressed legacy input formats have no sample size, and still count a
+// byte per sample so callers can divide by frameSize().
+TEST(AudioFormatConverterTest, FrameSizeOfNonPcmFormats) {
+    EXPECT_EQ(2u, FormatOnlyStreamIn(AudioSystem::PCM_16_BIT,
+                                     AudioSystem::CHANNEL_IN_MONO).frameSize());
+    EXPECT_EQ(1u, FormatOnlyStreamIn(AudioSystem::AMR_NB,
+                                     AudioSystem::CHANNEL_IN_MONO).frameSize());
+    EXPECT_EQ(2u, FormatOnlyStreamIn(AudioSystem::AAC,
+                                     AudioSystem::CHANNEL_IN_STEREO).frameSize());
+}
+
+}  // namespace android_audio_legacy
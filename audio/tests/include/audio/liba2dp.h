@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The liba2dp entry points A2dpAudioInterface calls, for the tests to build
+// it against FakeA2dp.cpp instead of the Bluetooth stack.
+
+#ifndef ANDROID_AUDIO_TEST_LIBA2DP_H
+#define ANDROID_AUDIO_TEST_LIBA2DP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void* a2dpData;
+
+int a2dp_init(int rate, int channels, a2dpData* dataPtr);
+void a2dp_set_sink(a2dpData data, const char* address);
+int a2dp_write(a2dpData data, const void* buffer, int count);
+int a2dp_stop(a2dpData data);
+void a2dp_cleanup(a2dpData data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // ANDROID_AUDIO_TEST_LIBA2DP_H
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "AudioJitterBuffer.h"
+
+namespace android_audio_legacy {
+
+// One int32_t frame counter per frame, so what comes out shows what was lost.
+static constexpr size_t kFrameSize = sizeof(int32_t);
+static constexpr uint32_t kMin = 100;
+static constexpr uint32_t kMax = 200;
+static constexpr uint32_t kStep = 20;
+static constexpr nsecs_t kAdaptNs = 1000000000;
+
+class AudioJitterBufferTest : public ::testing::Test {
+  protected:
+    AudioJitterBufferTest() : mJitter(1024 * kFrameSize, kFrameSize), mNext(0) {}
+    void SetUp() override { mJitter.setDepth(kMin, kMax, kStep, kAdaptNs); }
+
+    size_t write(size_t frames) {
+        std::vector<int32_t> buffer(frames);
+        for (size_t i = 0; i < frames; i++) buffer[i] = mNext++;
+        return mJitter.write(buffer.data(), frames);
+    }
+
+    size_t read(size_t frames, nsecs_t now, std::vector<int32_t>* out = nullptr) {
+        std::vector<int32_t> buffer(frames);
+        size_t n = mJitter.read(buffer.data(), frames, now);
+        if (out) out->assign(buffer.begin(), buffer.begin() + n);
+        return n;
+    }
+
+    AudioJitterBuffer mJitter;
+    int32_t mNext;
+};
+
+TEST_F(AudioJitterBufferTest, HoldsBackUntilTargetQueued) {
+    EXPECT_EQ(kMin + 2 * kStep, mJitter.targetFrames());
+    EXPECT_EQ(1024u, mJitter.capacityFrames());
+    EXPECT_EQ(139u, write(139));
+    EXPECT_EQ(0u, read(64, 0));
+    EXPECT_EQ(1u, write(1));
+    std::vector<int32_t> out;
+    EXPECT_EQ(64u, read(64, 0, &out));
+    EXPECT_EQ(0, out[0]);
+    EXPECT_EQ(63, out[63]);
+    // once started it sends whatever is queued, down to the last frame
+    EXPECT_EQ(76u, read(100, 0));
+    EXPECT_EQ(0u, mJitter.queuedFrames());
+}
+
+// Running dry while the writer carries on raises the target a step; the
+// writer having stopped is not counted.
+TEST_F(AudioJitterBufferTest, RaisesTargetOnUnderrun) {
+    write(140);
+    EXPECT_EQ(140u, read(200, 0));
+    EXPECT_EQ(0u, read(200, 0));
+    EXPECT_EQ(0u, mJitter.underruns());
+    write(10);
+    EXPECT_EQ(1u, mJitter.underruns());
+    EXPECT_EQ(160u, mJitter.targetFrames());
+    // rebuffering to the new target, so running dry again is not another one
+    EXPECT_EQ(0u, read(200, 0));
+    write(150);
+    EXPECT_EQ(1u, mJitter.underruns());
+    EXPECT_EQ(160u, read(200, 0));
+}
+
+TEST_F(AudioJitterBufferTest, TargetStaysWithinLimits) {
+    for (int i = 0; i < 10; i++) {
+        write(kMax);
+        read(1024, 0);
+        read(1024, 0);
+    }
+    write(1);
+    EXPECT_EQ(10u, mJitter.underruns());
+    EXPECT_EQ(kMax, mJitter.targetFrames());
+}
+
+// Standby empties the buffer and forgets that the sender ran dry.
+TEST_F(AudioJitterBufferTest, ResetStartsOver) {
+    write(140);
+    read(200, 0);
+    read(200, 0);
+    mJitter.reset();
+    write(100);
+    EXPECT_EQ(0u, mJitter.underruns());
+    EXPECT_EQ(100u, mJitter.queuedFrames());
+    EXPECT_EQ(0u, read(200, 0));
+    mJitter.reset();
+    EXPECT_EQ(0u, mJitter.queuedFrames());
+}
+
+// A window without coming within a step of running dry lowers the target a
+// step and drops what never drained below the old target.
+TEST_F(AudioJitterBufferTest, LowersTargetAndTrimsAfterQuietWindow) {
+    write(300);
+    EXPECT_EQ(10u, read(10, 0));
+    for (nsecs_t t = 100000000; t <= kAdaptNs; t += 100000000) {
+        write(10);
+        EXPECT_EQ(10u, read(10, t));
+    }
+    EXPECT_EQ(140u, mJitter.targetFrames());
+    EXPECT_EQ(0u, mJitter.droppedFrames());
+
+    write(10);
+    std::vector<int32_t> out;
+    EXPECT_EQ(10u, read(10, kAdaptNs + 100000000, &out));
+    EXPECT_EQ(120u, mJitter.targetFrames());
+    // the least queued over the window was 300; it is trimmed to the old
+    // target of 140, oldest first
+    EXPECT_EQ(160u, mJitter.droppedFrames());
+    EXPECT_EQ(110 + 160, out[0]);
+    EXPECT_EQ(130u, mJitter.queuedFrames());
+    EXPECT_EQ(0u, mJitter.underruns());
+}
+
+TEST_F(AudioJitterBufferTest, KeepsTargetWhenNearlyDry) {
+    write(140);
+    EXPECT_EQ(130u, read(130, 0));
+    write(5);
+    EXPECT_EQ(5u, read(5, 500000000));
+    write(200);
+    EXPECT_EQ(10u, read(10, kAdaptNs + 1));
+    EXPECT_EQ(140u, mJitter.targetFrames());
+    EXPECT_EQ(0u, mJitter.droppedFrames());
+}
+
+TEST_F(AudioJitterBufferTest, DropsNewestWhenFull) {
+    EXPECT_EQ(1000u, write(1000));
+    EXPECT_EQ(24u, write(100));
+    EXPECT_EQ(76u, mJitter.droppedFrames());
+    std::vector<int32_t> out;
+    EXPECT_EQ(1024u, read(2048, 0, &out));
+    EXPECT_EQ(1023, out.back());
+}
+
+// A writer and a sender on their own threads: frames come out in order, and
+// every frame is sent, dropped or still queued.
+TEST_F(AudioJitterBufferTest, ConcurrentWriterAndSender) {
+    const int32_t total = 200000;
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        std::vector<int32_t> buffer(64);
+        for (int32_t next = 0; next < total;) {
+            for (auto& f : buffer) f = next++;
+            mJitter.write(buffer.data(), buffer.size());
+            if (next % 4096 == 0) std::this_thread::yield();
+        }
+        done = true;
+    });
+    std::vector<int32_t> buffer(48);
+    int32_t last = -1;
+    uint64_t sent = 0;
+    bool ordered = true;
+    nsecs_t now = 0;
+    while (!done || mJitter.queuedFrames() >= mJitter.targetFrames()) {
+        size_t n = mJitter.read(buffer.data(), buffer.size(), now += 1000000);
+        for (size_t i = 0; i < n; i++) {
+            if (buffer[i] <= last) ordered = false;
+            last = buffer[i];
+        }
+        sent += n;
+        if (n == 0) std::this_thread::yield();
+    }
+    writer.join();
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(uint64_t(total), sent + mJitter.droppedFrames() + mJitter.queuedFrames());
+}
+
+}  // namespace android_audio_legacy
@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include "AudioGainRamp.h"
+#include "AudioHardwareGeneric.h"
+#include "AudioMixOps.h"
+#include "../benchmarks/FakeAudioDevice.h"
+#include "AudioTestUtils.h"
+
+namespace android_audio_legacy {
+
+TEST(AudioMixOpsTest, VectorMatchesScalar) {
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> sample(-32768, 32767);
+    const int16_t gains[][2] = {{kUnityGainQ15, kUnityGainQ15}, {16384, 8192}, {0, 32000},
+                                {gainToQ15(0.7f), gainToQ15(0.3f)}};
+    // odd frame count to cover the scalar tail
+    const size_t kFrames = 1027;
+    for (const auto& g : gains) {
+        std::vector<int16_t> src(kFrames * 2), expected(kFrames * 2), actual(kFrames * 2);
+        for (size_t i = 0; i < src.size(); i++) {
+            src[i] = sample(rng);
+            expected[i] = actual[i] = sample(rng);
+        }
+        mixStereo16Scalar(expected.data(), src.data(), kFrames, g[0], g[1]);
+        mixStereo16(actual.data(), src.data(), kFrames, g[0], g[1]);
+        EXPECT_EQ(expected, actual) << "gain " << g[0] << "/" << g[1];
+    }
+}
+
+TEST(AudioMixOpsTest, SaturatesAndAppliesGain) {
+    int16_t dst[16] = {30000, -30000, 1000, 1000, 30000, -30000, 1000, 1000,
+                       30000, -30000, 1000, 1000, 30000, -30000, 1000, 1000};
+    const int16_t src[16] = {30000, -30000, 20000, 20000, 30000, -30000, 20000, 20000,
+                             30000, -30000, 20000, 20000, 30000, -30000, 20000, 20000};
+    mixStereo16(dst, src, 8, kUnityGainQ15, gainToQ15(0.5f));
+    for (int i = 0; i < 16; i += 4) {
+        EXPECT_EQ(32767, dst[i]);
+        EXPECT_EQ(-32768, dst[i + 1]);
+        EXPECT_EQ(21000, dst[i + 2]);
+        EXPECT_EQ(11000, dst[i + 3]);
+    }
+}
+
+TEST(AudioMixOpsTest, GainRampMatchesScalar) {
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> sample(-32768, 32767);
+    const int32_t ramps[][4] = {{kUnityGainQ15 << 16, kUnityGainQ15 << 16, 0, 0},
+                                {16384 << 16, 8192 << 16, 0, 0},
+                                {kUnityGainQ15 << 16, 0, -(kUnityGainQ15 << 16) / 1027,
+                                 (20000 << 16) / 1027},
+                                {0, 1000 << 16, 37, -1}};
+    const size_t kFrames = 1027;
+    for (const auto& r : ramps) {
+        std::vector<int16_t> expected(kFrames * 2), actual(kFrames * 2);
+        for (size_t i = 0; i < expected.size(); i++) expected[i] = actual[i] = sample(rng);
+        applyGainStereo16Scalar(expected.data(), kFrames, r[0], r[1], r[2], r[3]);
+        applyGainStereo16(actual.data(), kFrames, r[0], r[1], r[2], r[3]);
+        EXPECT_EQ(expected, actual) << "ramp " << r[0] << "/" << r[1] << " step " << r[2];
+    }
+}
+
+// However the ramp is split across buffers, the gain moves by at most one
+// step per frame and lands exactly on the target.
+TEST(AudioGainRampTest, RampsWithoutSteps) {
+    AudioGainRamp ramp;
+    EXPECT_TRUE(ramp.isUnity());
+    ramp.setTarget(gainToQ15(0.25f), gainToQ15(0.5f), 441);
+    EXPECT_FALSE(ramp.isUnity());
+    std::vector<int16_t> out;
+    std::mt19937 rng(6);
+    while (out.size() < 2 * 1000) {
+        std::vector<int16_t> buf(2 * (1 + rng() % 100), 16384);
+        ramp.apply(buf.data(), buf.size() / 2);
+        out.insert(out.end(), buf.begin(), buf.end());
+    }
+    EXPECT_FALSE(ramp.isRamping());
+    const int maxStep = 16384 * 3 / 4 / 441 + 1;
+    for (size_t i = 2; i < out.size(); i += 2) {
+        EXPECT_LE(out[i], out[i - 2]);
+        EXPECT_LE(out[i - 2] - out[i], maxStep) << "frame " << i / 2;
+    }
+    EXPECT_EQ(4096, out[2 * 441]);
+    EXPECT_EQ(8192, out[2 * 441 + 1]);
+    EXPECT_EQ(4096, out.end()[-2]);
+
+    // back to unity, and then there is nothing left to do
+    ramp.setTarget(kUnityGainQ15, kUnityGainQ15, 100);
+    std::vector<int16_t> buf(2 * 200, 16384);
+    ramp.apply(buf.data(), 200);
+    EXPECT_EQ(16384, buf[2 * 100]);
+    EXPECT_TRUE(ramp.isUnity());
+}
+
+// Stream and master volume multiply; a change after the first write ramps.
+TEST(AudioMixerGenericTest, GenericOutputAppliesVolume) {
+    std::mutex lock;
+    std::vector<int16_t> played;
+    FakeAudioDevice device(4096, 1000000, 0, 0, [&](const char* period) {
+        std::lock_guard<std::mutex> guard(lock);
+        played.insert(played.end(), (const int16_t*)period, (const int16_t*)(period + 4096));
+    });
+    AudioStreamOutGeneric out;
+    ASSERT_EQ(NO_ERROR, out.set(nullptr, device.fd(), 0, nullptr, nullptr, nullptr));
+    out.setMasterVolume(0.5f);
+    ASSERT_EQ(NO_ERROR, out.setVolume(0.5f, 1.0f));
+
+    std::vector<int16_t> buffer(2048, 20000);
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(4096, out.write(buffer.data(), 4096));
+    }
+    ASSERT_EQ(NO_ERROR, out.setVolume(1.0f, 1.0f));
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(4096, out.write(buffer.data(), 4096));
+    }
+    usleep(20000);
+
+    std::lock_guard<std::mutex> guard(lock);
+    ASSERT_EQ(4 * 2048u, played.size());
+    EXPECT_EQ(5000, played[0]);
+    EXPECT_EQ(10000, played[1]);
+    EXPECT_EQ(5000, played[2 * 1024 - 2]);
+    // ramps up over 10ms rather than jumping
+    EXPECT_LT(played[2 * 2048 + 2], 5100);
+    EXPECT_GT(played[2 * 2048 + 2 * 220], 7000);
+    EXPECT_EQ(10000, played[2 * 2048 + 2 * 441]);
+    EXPECT_EQ(10000, played[2 * 2048 + 2 * 441 + 1]);
+}
+
+TEST(AudioMixerGenericTest, MixesStreamsWithGain) {
+    const size_t kPeriodFrames = 1024;
+    std::mutex lock;
+    int64_t sums[2] = {0, 0};
+    FakeAudioDevice device(kPeriodFrames * 4, int64_t(kPeriodFrames) * 1000000000 / 44100 / 4, 0,
+                           0, [&](const char* period) {
+                               std::lock_guard<std::mutex> guard(lock);
+                               const int16_t* s = (const int16_t*)period;
+                               for (size_t i = 0; i < kPeriodFrames * 2; i++) sums[i & 1] += s[i];
+                           });
+
+    AudioMixerGeneric mixer(device.fd(), kPeriodFrames);
+    ASSERT_EQ(NO_ERROR, mixer.start());
+    AudioStreamOutGeneric a, b;
+    ASSERT_EQ(NO_ERROR, a.set(nullptr, device.fd(), 0, nullptr, nullptr, nullptr));
+    ASSERT_EQ(NO_ERROR, b.set(nullptr, device.fd(), 0, nullptr, nullptr, nullptr));
+    ASSERT_EQ(NO_ERROR, a.attachMixer(&mixer, 0));
+    ASSERT_EQ(NO_ERROR, b.attachMixer(&mixer, 0));
+    EXPECT_EQ(2u, mixer.streamCount());
+    EXPECT_EQ(NO_ERROR, b.setVolume(0.5f, 0.25f));
+    EXPECT_EQ(INVALID_OPERATION, a.enableAsyncWrite(4096));
+
+    // whatever the interleaving of the two writers, every sample is mixed once
+    const int kPeriods = 8;
+    std::vector<int16_t> pa(kPeriodFrames * 2), pb(kPeriodFrames * 2);
+    for (size_t i = 0; i < pa.size(); i += 2) {
+        pa[i] = 1000, pa[i + 1] = -1000;
+        pb[i] = 8000, pb[i + 1] = 8000;
+    }
+    for (int i = 0; i < kPeriods; i++) {
+        ASSERT_EQ(ssize_t(pa.size() * 2), a.write(pa.data(), pa.size() * 2));
+        ASSERT_EQ(ssize_t(pb.size() * 2), b.write(pb.data(), pb.size() * 2));
+    }
+    a.standby();
+    b.standby();
+    // let the last mix reach the device
+    usleep(50000);
+
+    std::lock_guard<std::mutex> guard(lock);
+    EXPECT_EQ(int64_t(kPeriods) * kPeriodFrames * (1000 + 4000), sums[0]);
+    EXPECT_EQ(int64_t(kPeriods) * kPeriodFrames * (-1000 + 2000), sums[1]);
+}
+
+// With nothing queued the mixer thread sleeps until a stream writes.
+TEST(AudioMixerGenericTest, IdleMixerSleeps) {
+    FakeAudioDevice device(4096, 1000000);
+    AudioMixerGeneric mixer(device.fd(), 1024);
+    ASSERT_EQ(NO_ERROR, mixer.start());
+    long before = voluntarySwitches();
+    usleep(200000);
+    EXPECT_LT(voluntarySwitches() - before, 5);
+
+    AudioStreamOutGeneric out;
+    ASSERT_EQ(NO_ERROR, out.set(nullptr, device.fd(), 0, nullptr, nullptr, nullptr));
+    ASSERT_EQ(NO_ERROR, out.attachMixer(&mixer, 0));
+    std::vector<int16_t> buffer(2048);
+    ASSERT_EQ(4096, out.write(buffer.data(), 4096));
+    usleep(50000);
+    before = voluntarySwitches();
+    usleep(200000);
+    EXPECT_LT(voluntarySwitches() - before, 5);
+}
+
+// A stream attaching while the mixer is blocked on a slow device write gets
+// in at once rather than waiting out the write.
+TEST(AudioMixerGenericTest, DeviceWriteDoesNotHoldStreams) {
+    const int64_t kPeriodNs = 300000000;
+    FakeAudioDevice device(4096, kPeriodNs);
+    AudioMixerGeneric mixer(device.fd(), 1024);
+    ASSERT_EQ(NO_ERROR, mixer.start());
+    AudioStreamOutGeneric a;
+    ASSERT_EQ(NO_ERROR, a.set(nullptr, device.fd(), 0, nullptr, nullptr, nullptr));
+    ASSERT_EQ(NO_ERROR, a.attachMixer(&mixer, 0));
+    // one period to the device, one in the pipe, and the third blocks
+    std::vector<int16_t> buffer(2048);
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(4096, a.write(buffer.data(), 4096));
+    }
+    usleep(50000);
+
+    int64_t start = fakeDeviceNowNs();
+    AudioStreamOutGeneric b;
+    ASSERT_EQ(NO_ERROR, b.set(nullptr, device.fd(), 0, nullptr, nullptr, nullptr));
+    ASSERT_EQ(NO_ERROR, b.attachMixer(&mixer, 0));
+    EXPECT_EQ(2u, mixer.streamCount());
+    EXPECT_LT(fakeDeviceNowNs() - start, kPeriodNs / 4);
+}
+
+}  // namespace android_audio_legacy
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "AudioHardwareGeneric.h"
+#include "../benchmarks/FakeAudioDevice.h"
+
+namespace android_audio_legacy {
+
+static const uint32_t kRate = AudioStreamOutGeneric::kDeviceRate;
+
+struct MmapBuffer {
+    void* buffer = nullptr;
+    int fd = -1;
+    int32_t frames = 0;
+    int32_t burst = 0;
+};
+
+static void createMmap(AudioStreamOutGeneric* out, int fd, MmapBuffer* mmap) {
+    ASSERT_EQ(NO_ERROR, out->set(nullptr, fd, 0, nullptr, nullptr, nullptr));
+    ASSERT_EQ(NO_ERROR,
+              out->createMmapBuffer(1000, &mmap->buffer, &mmap->fd, &mmap->frames, &mmap->burst));
+    ASSERT_NE(nullptr, mmap->buffer);
+    ASSERT_GE(mmap->fd, 0);
+    EXPECT_GE(mmap->frames, 1000);
+    EXPECT_EQ(0, mmap->frames % mmap->burst);
+}
+
+// The position follows the device while started and stands still once
+// stopped; writing to the stream is for the mmap client only.
+TEST(AudioStreamMmapTest, PositionAdvancesWhileStarted) {
+    MmapBuffer mmap;
+    // a burst at a time, at real time
+    FakeAudioDevice device(128 * AudioStreamOutGeneric::kDeviceFrameSize,
+                           int64_t(128) * 1000000000 / kRate);
+    AudioStreamOutGeneric out;
+    ASSERT_NO_FATAL_FAILURE(createMmap(&out, device.fd(), &mmap));
+    char data[16] = {};
+    EXPECT_EQ(INVALID_OPERATION, out.write(data, sizeof(data)));
+
+    int64_t timeNs;
+    int32_t position;
+    ASSERT_EQ(NO_ERROR, out.getMmapPosition(&timeNs, &position));
+    EXPECT_EQ(0, position);
+
+    ASSERT_EQ(NO_ERROR, out.start());
+    usleep(200000);
+    ASSERT_EQ(NO_ERROR, out.getMmapPosition(&timeNs, &position));
+    // 200ms is 8820 frames; the pipe lets the first few bursts in at once
+    EXPECT_GT(position, 6000);
+    EXPECT_LT(position, 13000);
+    EXPECT_EQ(0, position % mmap.burst);
+    EXPECT_LE(timeNs, fakeDeviceNowNs());
+
+    ASSERT_EQ(NO_ERROR, out.stop());
+    // the burst in flight may still complete
+    usleep(50000);
+    int64_t stoppedNs;
+    int32_t stopped;
+    ASSERT_EQ(NO_ERROR, out.getMmapPosition(&stoppedNs, &stopped));
+    usleep(100000);
+    ASSERT_EQ(NO_ERROR, out.getMmapPosition(&timeNs, &position));
+    EXPECT_EQ(stopped, position);
+    EXPECT_EQ(stoppedNs, timeNs);
+
+    ASSERT_EQ(NO_ERROR, out.start());
+    usleep(50000);
+    ASSERT_EQ(NO_ERROR, out.getMmapPosition(&timeNs, &position));
+    EXPECT_GT(position, stopped);
+}
+
+// A device that fails every write does not block; the position still runs
+// at real time rather than as fast as the writer thread can go, and the
+// error is reported.
+TEST(AudioStreamMmapTest, FailedDeviceIsPaced) {
+    int fd = open("/dev/null", O_RDONLY);
+    ASSERT_GE(fd, 0);
+    {
+        MmapBuffer mmap;
+        AudioStreamOutGeneric out;
+        ASSERT_NO_FATAL_FAILURE(createMmap(&out, fd, &mmap));
+        ASSERT_EQ(NO_ERROR, out.start());
+        usleep(200000);
+        int64_t timeNs;
+        int32_t position;
+        EXPECT_EQ(-EBADF, out.getMmapPosition(&timeNs, &position));
+        EXPECT_GT(position, 6000);
+        EXPECT_LT(position, 13000);
+        ASSERT_EQ(NO_ERROR, out.stop());
+    }
+    close(fd);
+}
+
+}  // namespace android_audio_legacy
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "AudioPacingClock.h"
+
+namespace android_audio_legacy {
+
+// AudioPacingClock on a virtual clock that sleeps exactly to the deadline.
+class FakePacingClock : public AudioPacingClock {
+  public:
+    nsecs_t now = 1000000000;
+    int sleeps = 0;
+
+  protected:
+    virtual nsecs_t nowNs() { return now; }
+    virtual void sleepUntilNs(nsecs_t deadline) {
+        sleeps++;
+        if (deadline > now) now = deadline;
+    }
+};
+
+// What A2dpAudioStreamOut::set() configures: 2560-frame writes at 44.1kHz,
+// one buffer of lead and latency() of lag, at the deepest jitter target.
+// kBufferNs rounds up, so a sink at exactly real time is never early.
+static constexpr uint32_t kRate = 44100;
+static constexpr uint32_t kFrames = 2560;
+static constexpr nsecs_t kBufferNs = (nsecs_t(kFrames) * 1000000000 + kRate - 1) / kRate;
+static constexpr nsecs_t kLatencyNs = kBufferNs + 200000000 + 300000000;
+
+class A2dpPacingTest : public ::testing::Test {
+  protected:
+    void SetUp() override { mPacing.setTolerance(kBufferNs, kLatencyNs); }
+
+    // one write() that took writeNs in a2dp_write() before returning
+    void write(nsecs_t writeNs) {
+        mPacing.now += writeNs;
+        mPacing.sleepUntil(mPacing.advance(kFrames, kRate));
+    }
+
+    FakePacingClock mPacing;
+};
+
+// A headset being disconnected takes writes at once; the mixer is held to
+// real time, one buffer ahead.
+TEST_F(A2dpPacingTest, HoldsBackSinkFasterThanRealTime) {
+    nsecs_t start = mPacing.now;
+    for (int i = 0; i < 1000; i++) {
+        write(0);
+    }
+    nsecs_t audioNs = 1000 * kBufferNs;
+    EXPECT_NEAR(double(audioNs - kBufferNs), double(mPacing.now - start), 1e6);
+    EXPECT_GT(mPacing.sleeps, 990);
+}
+
+// A connected headset blocks for about a buffer with a few ms of jitter
+// either way; that is its own pacing and is never slept on.
+TEST_F(A2dpPacingTest, LeavesJitteredSinkAlone) {
+    const nsecs_t jitter[] = {-3000000, 10000000, 0, 4000000, -2000000, -9000000};
+    for (int i = 0; i < 600; i++) {
+        write(kBufferNs + jitter[i % 6]);
+    }
+    EXPECT_EQ(0, mPacing.sleeps);
+}
+
+// After a stall shorter than the lag the writer catches up on the same
+// timeline without sleeping, then is paced again.
+TEST_F(A2dpPacingTest, CatchesUpAfterStall) {
+    nsecs_t start = mPacing.now;
+    write(0);
+    write(150000000);
+    int catchUp = 0;
+    while (mPacing.sleeps == 0 && catchUp < 100) {
+        write(0);
+        catchUp++;
+    }
+    // 150ms behind, the next write goes straight through; the one after it
+    // would be more than the buffer of lead ahead and is the first to sleep
+    EXPECT_EQ(2, catchUp);
+    EXPECT_NEAR(double(-kBufferNs), double(mPacing.lagNs()), 1);
+    EXPECT_NEAR(double(3 * kBufferNs), double(mPacing.now - start), 1e6);
+}
+
+// Further behind than the lag the timeline restarts, instead of the mixer
+// bursting to make up audio the headset has long since missed.
+TEST_F(A2dpPacingTest, RestartsAfterLongStall) {
+    for (int i = 0; i < 10; i++) {
+        write(kBufferNs);
+    }
+    // the first write's buffer is already counted, hence two more
+    write(kLatencyNs + 2 * kBufferNs + 1000000);
+    EXPECT_NEAR(double(-kBufferNs), double(mPacing.lagNs()), 1);
+    write(0);
+    EXPECT_EQ(1, mPacing.sleeps);
+}
+
+// Standby forgets the timeline, so the first write after it is never late.
+TEST_F(A2dpPacingTest, StandbyRestartsTimeline) {
+    write(0);
+    mPacing.reset();
+    mPacing.now += 10LL * 1000000000;
+    EXPECT_EQ(0, mPacing.lagNs());
+    write(0);
+    EXPECT_NEAR(double(-kBufferNs), double(mPacing.lagNs()), 1);
+    EXPECT_EQ(0, mPacing.sleeps);
+}
+
+}  // namespace android_audio_legacy
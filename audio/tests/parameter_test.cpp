@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "AudioHardwareGeneric.h"
+#include "AudioParameterScanner.h"
+
+namespace android_audio_legacy {
+
+static std::vector<std::string> scan(const char* kvpairs) {
+    std::vector<std::string> pairs;
+    AudioParameterScanner param(kvpairs);
+    while (param.next()) {
+        pairs.push_back(std::string(param.key(), param.keyLength()) + "|" +
+                        std::string(param.value(), param.valueLength()));
+    }
+    return pairs;
+}
+
+// The pairs AudioParameter would find, in order.
+TEST(AudioParameterScannerTest, SplitsPairsAsAudioParameterDoes) {
+    EXPECT_EQ((std::vector<std::string>{"routing|2", "closing|true"}),
+              scan("routing=2;closing=true"));
+    // empty pairs are skipped; keys alone, as get_parameters() passes
+    // them, have empty values
+    EXPECT_EQ((std::vector<std::string>{"routing|", "a2dp_sink_address|", "x|"}),
+              scan(";;routing;a2dp_sink_address;;x=;"));
+    EXPECT_EQ((std::vector<std::string>{"a|b=c"}), scan("a=b=c"));
+    EXPECT_TRUE(scan("").empty());
+    EXPECT_TRUE(scan(nullptr).empty());
+}
+
+TEST(AudioParameterScannerTest, MatchesWholeKeysAndValues) {
+    AudioParameterScanner param("routingx=1;closing=truex;routing= -12dB");
+    ASSERT_TRUE(param.next());
+    EXPECT_FALSE(param.keyIs("routing"));
+    EXPECT_EQ("routingx=1", std::string(param.pair(), param.pairLength()));
+    ASSERT_TRUE(param.next());
+    EXPECT_TRUE(param.keyIs("closing"));
+    EXPECT_FALSE(param.valueIs("true"));
+    ASSERT_TRUE(param.next());
+    EXPECT_TRUE(param.keyIs("routing"));
+    int value = 0;
+    EXPECT_EQ(NO_ERROR, param.valueInt(&value));
+    EXPECT_EQ(-12, value);
+    EXPECT_FALSE(param.next());
+
+    // the number may not come from the next pair
+    AudioParameterScanner empty("routing=;3");
+    ASSERT_TRUE(empty.next());
+    EXPECT_EQ(BAD_VALUE, empty.valueInt(&value));
+}
+
+TEST(AudioParameterScannerTest, ConvertsOnlyTheIntegerValue) {
+    auto twice = [](int v) { return 2 * v; };
+    String8 out("unchanged");
+    EXPECT_TRUE(audioParameterConvertInt(&out, "closing=true;routing=4;x=y", "routing", twice));
+    EXPECT_STREQ("closing=true;routing=8;x=y", out.string());
+    // a key given twice has every value converted
+    EXPECT_TRUE(audioParameterConvertInt(&out, "routing=1;x=y;routing=300", "routing", twice));
+    EXPECT_STREQ("routing=2;x=y;routing=600", out.string());
+    // only the last value has to be an integer
+    EXPECT_TRUE(audioParameterConvertInt(&out, "routing=speaker;routing=3", "routing", twice));
+    EXPECT_STREQ("routing=speaker;routing=6", out.string());
+
+    out = String8("unchanged");
+    EXPECT_FALSE(audioParameterConvertInt(&out, "closing=true", "routing", twice));
+    EXPECT_FALSE(audioParameterConvertInt(&out, "routing=1;routing=speaker", "routing", twice));
+    EXPECT_STREQ("unchanged", out.string());
+
+    // longer than fits on the stack
+    std::string lng = "routing=5;pad=" + std::string(400, 'p');
+    EXPECT_TRUE(audioParameterConvertInt(&out, lng.c_str(), "routing", twice));
+    EXPECT_EQ("routing=10;pad=" + std::string(400, 'p'), std::string(out.string()));
+    lng = "routing=5;pad=" + std::string(400, 'p') + ";routing=7";
+    EXPECT_TRUE(audioParameterConvertInt(&out, lng.c_str(), "routing", twice));
+    EXPECT_EQ("routing=10;pad=" + std::string(400, 'p') + ";routing=14", std::string(out.string()));
+}
+
+TEST(AudioParameterScannerTest, GenericStreamsTakeRoutingOnly) {
+    AudioStreamOutGeneric out;
+    EXPECT_EQ(NO_ERROR, out.setParameters(String8("routing=2")));
+    EXPECT_STREQ("routing=2", out.getParameters(String8("routing")).string());
+    EXPECT_EQ(NO_ERROR, out.setParameters(String8("")));
+    EXPECT_EQ(BAD_VALUE, out.setParameters(String8("routing=4;closing=true")));
+    EXPECT_STREQ("routing=4", out.getParameters(String8("routing")).string());
+    EXPECT_EQ(BAD_VALUE, out.setParameters(String8("routing=speaker")));
+    EXPECT_STREQ("routing=4", out.getParameters(String8("routing")).string());
+}
+
+}  // namespace android_audio_legacy
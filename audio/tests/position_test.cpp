@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "AudioPositionTracker.h"
+
+namespace android_audio_legacy {
+
+static const nsecs_t kMs = 1000000;
+
+static nsecs_t toNs(const struct timespec& ts) {
+    return nsecs_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+TEST(AudioPositionTrackerTest, PresentationLagsByDownstreamFrames) {
+    AudioPositionTracker tracker;
+    tracker.setup(48000, 960);
+
+    uint64_t frames;
+    struct timespec ts = {};
+    EXPECT_EQ(INVALID_OPERATION, tracker.getPresentationPosition(&frames, &ts));
+
+    // 10ms writes landing exactly on time
+    for (int i = 0; i < 10; i++) {
+        tracker.advance(480, 1000 * kMs + i * 10 * kMs);
+    }
+    ASSERT_EQ(NO_ERROR, tracker.getPresentationPosition(&frames, &ts));
+    EXPECT_EQ(4800u - 960u, frames);
+    EXPECT_EQ(1090 * kMs, toNs(ts));
+
+    int64_t nextUs;
+    ASSERT_EQ(NO_ERROR, tracker.getNextWriteTimestamp(&nextUs));
+    EXPECT_EQ((1090 + 20) * 1000, nextUs);
+}
+
+TEST(AudioPositionTrackerTest, LateObservationsAreIgnored) {
+    AudioPositionTracker tracker;
+    tracker.setup(48000, 0);
+    tracker.advance(480, 1000 * kMs);
+    // the writer was scheduled 4ms late
+    tracker.advance(480, 1014 * kMs);
+
+    uint64_t frames;
+    struct timespec ts = {};
+    tracker.getPresentationPosition(&frames, &ts);
+    EXPECT_EQ(1010 * kMs, toNs(ts));
+
+    tracker.advance(480, 1020 * kMs);
+    tracker.getPresentationPosition(&frames, &ts);
+    EXPECT_EQ(1020 * kMs, toNs(ts));
+}
+
+TEST(AudioPositionTrackerTest, TracksSlowDeviceClock) {
+    AudioPositionTracker tracker;
+    tracker.setup(48000, 0);
+    // the device runs 1% slow: each 10ms write completes 100us later than nominal
+    nsecs_t t = 1000 * kMs;
+    for (int i = 0; i < 100; i++, t += 10 * kMs + 100000) {
+        tracker.advance(480, t);
+    }
+    uint64_t frames;
+    struct timespec ts = {};
+    tracker.getPresentationPosition(&frames, &ts);
+    t -= 10 * kMs + 100000;
+    // the window bounds the error to a few updates' worth of drift
+    EXPECT_LE(t - toNs(ts), nsecs_t(8) * 100000);
+}
+
+TEST(AudioPositionTrackerTest, StallRestartsTimeline) {
+    AudioPositionTracker tracker;
+    tracker.setup(48000, 0);
+    tracker.advance(480, 1000 * kMs);
+    tracker.advance(480, 1100 * kMs);
+
+    uint64_t frames;
+    struct timespec ts = {};
+    tracker.getPresentationPosition(&frames, &ts);
+    EXPECT_EQ(960u, frames);
+    EXPECT_EQ(1100 * kMs, toNs(ts));
+}
+
+TEST(AudioPositionTrackerTest, StandbyPlaysOutAndRestartsRenderPosition) {
+    AudioPositionTracker tracker;
+    tracker.setup(48000, 960);
+    for (int i = 0; i < 4; i++) {
+        tracker.advance(480, 1000 * kMs + i * 10 * kMs);
+    }
+
+    uint32_t dspFrames;
+    ASSERT_EQ(NO_ERROR, tracker.getRenderPosition(&dspFrames, 1030 * kMs));
+    EXPECT_EQ(1920u - 960u, dspFrames);
+    // extrapolated, but never past what was written
+    tracker.getRenderPosition(&dspFrames, 1040 * kMs);
+    EXPECT_EQ(1920u - 960u + 480u, dspFrames);
+    tracker.getRenderPosition(&dspFrames, 2000 * kMs);
+    EXPECT_EQ(1920u, dspFrames);
+
+    tracker.standby();
+    uint64_t frames;
+    struct timespec ts = {};
+    tracker.getPresentationPosition(&frames, &ts);
+    EXPECT_EQ(1920u, frames);
+    EXPECT_EQ(1050 * kMs, toNs(ts));
+    int64_t nextUs;
+    EXPECT_EQ(INVALID_OPERATION, tracker.getNextWriteTimestamp(&nextUs));
+
+    tracker.advance(480, 3000 * kMs);
+    tracker.getRenderPosition(&dspFrames, 3000 * kMs);
+    EXPECT_EQ(0u, dspFrames);
+    tracker.getPresentationPosition(&frames, &ts);
+    EXPECT_EQ(1920u + 480u - 480u, frames);
+}
+
+// Each write completes on the device's schedule, but the writer only sees
+// it after a scheduling delay of up to 6ms; every fourth time it is on time.
+// The reported timestamps follow the device, not the writer.
+TEST(AudioPositionTrackerTest, TimestampJitterFromSchedulingDelay) {
+    const uint32_t kRate = 44100;
+    const uint32_t kFrames = 1024;
+    AudioPositionTracker tracker;
+    tracker.setup(kRate, 0);
+
+    uint32_t seed = 1;
+    std::vector<nsecs_t> device, raw, reported;
+    std::vector<uint64_t> positions;
+    for (uint64_t i = 1; i <= 200; i++) {
+        nsecs_t completion = 1000 * kMs + nsecs_t(i * kFrames * 1000000000 / kRate);
+        seed = seed * 1103515245u + 12345u;
+        nsecs_t delay = i % 4 ? nsecs_t((seed >> 16) % 6000) * 1000 : 0;
+        tracker.advance(kFrames, completion + delay);
+        device.push_back(completion);
+        raw.push_back(completion + delay);
+
+        uint64_t frames;
+        struct timespec ts = {};
+        ASSERT_EQ(NO_ERROR, tracker.getPresentationPosition(&frames, &ts));
+        positions.push_back(frames);
+        reported.push_back(toNs(ts));
+    }
+
+    // jitter: how far each interval strays from the duration of audio written
+    const nsecs_t periodNs = nsecs_t(kFrames) * 1000000000 / kRate;
+    auto p99Jitter = [periodNs](const std::vector<nsecs_t>& times) {
+        // skip the first writes, before the window has an on-time one
+        std::vector<nsecs_t> jitter;
+        for (size_t i = 4; i < times.size(); i++) {
+            jitter.push_back(std::abs(times[i] - times[i - 1] - periodNs));
+        }
+        std::sort(jitter.begin(), jitter.end());
+        return jitter[(jitter.size() - 1) * 99 / 100];
+    };
+    EXPECT_GT(p99Jitter(raw), 4 * kMs);
+    EXPECT_LE(p99Jitter(reported), 1000);
+
+    for (size_t i = 1; i < positions.size(); i++) {
+        EXPECT_EQ(positions[i - 1] + kFrames, positions[i]);
+        EXPECT_GT(reported[i], reported[i - 1]);
+    }
+    for (size_t i = 4; i < reported.size(); i++) {
+        EXPECT_LE(std::abs(reported[i] - device[i]), 1000) << "write " << i;
+    }
+}
+
+}  // namespace android_audio_legacy
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "AudioHardwareGeneric.h"
+#include "../benchmarks/FakeAudioDevice.h"
+
+namespace android_audio_legacy {
+
+// A 48kHz client switches to the device rate mid-stream: everything written
+// at 48kHz reaches the device, resampler tail included, and what follows
+// goes through untouched right behind it.
+TEST(AudioStreamReconfigureTest, OutputSwitchesRateWithoutLosingAudio) {
+    std::mutex lock;
+    std::vector<int16_t> played;
+    FakeAudioDevice device(4096, 1000000, 0, 0, [&](const char* p) {
+        std::lock_guard<std::mutex> l(lock);
+        played.insert(played.end(), (const int16_t*)p, (const int16_t*)(p + 4096));
+    });
+    AudioStreamOutGeneric out;
+    uint32_t rate = 48000;
+    ASSERT_EQ(NO_ERROR, out.set(nullptr, device.fd(), 0, nullptr, nullptr, &rate));
+
+    std::vector<int16_t> dc(960 * 2, 1000);
+    for (int i = 0; i < 50; i++) {
+        ASSERT_EQ(ssize_t(dc.size() * 2), out.write(dc.data(), dc.size() * 2));
+    }
+    ASSERT_EQ(NO_ERROR, out.reconfigure(0, AudioStreamOutGeneric::kDeviceRate));
+    EXPECT_EQ(AudioStreamOutGeneric::kDeviceRate, out.sampleRate());
+
+    std::vector<int16_t> ramp(4410 * 2);
+    for (size_t i = 0; i < 4410; i++) {
+        ramp[2 * i] = int16_t(i + 1);
+        ramp[2 * i + 1] = -int16_t(i + 1);
+    }
+    ASSERT_EQ(ssize_t(ramp.size() * 2), out.write(ramp.data(), ramp.size() * 2));
+    // pad out the device's last period
+    std::vector<int16_t> silence(1024 * 2, 0);
+    ASSERT_EQ(ssize_t(silence.size() * 2), out.write(silence.data(), silence.size() * 2));
+
+    uint64_t position;
+    struct timespec ts;
+    ASSERT_EQ(NO_ERROR, out.getPresentationPosition(&position, &ts));
+    EXPECT_NEAR(48000.0 + 4410 + 1024 - 882, double(position), 2);
+    usleep(20000);
+
+    std::lock_guard<std::mutex> l(lock);
+    auto start = std::search(played.begin(), played.end(), ramp.begin(), ramp.end());
+    ASSERT_NE(played.end(), start);
+    size_t frame = (start - played.begin()) / 2;
+    EXPECT_NEAR(44100.0, double(frame), 2);
+    // the last frames before the switch are the 48kHz audio, not silence
+    EXPECT_NEAR(1000, played[2 * (frame - 200)], 2);
+    EXPECT_GT(played[2 * (frame - 8)], 500);
+}
+
+TEST(AudioStreamReconfigureTest, OutputSwitchesFormat) {
+    std::atomic<int> peak{0};
+    FakeAudioDevice device(4096, 1000000, 0, 0, [&](const char* p) {
+        const int16_t* s = (const int16_t*)p;
+        for (int i = 0; i < 2048; i++) {
+            if (s[i] > peak) peak = s[i];
+        }
+    });
+    AudioStreamOutGeneric out;
+    ASSERT_EQ(NO_ERROR, out.set(nullptr, device.fd(), 0, nullptr, nullptr, nullptr));
+
+    // what the output cannot take leaves it as it was
+    EXPECT_EQ(BAD_VALUE, out.reconfigure(0, 1000));
+    EXPECT_EQ(BAD_VALUE, out.reconfigure(0x7f000000, 0));
+    EXPECT_EQ(AudioStreamOutGeneric::kDeviceRate, out.sampleRate());
+    EXPECT_EQ(AudioSystem::PCM_16_BIT, out.format());
+
+    ASSERT_EQ(NO_ERROR, out.reconfigure(AUDIO_FORMAT_PCM_FLOAT, 0));
+    EXPECT_EQ(AUDIO_FORMAT_PCM_FLOAT, out.format());
+    EXPECT_EQ(8u, out.frameSize());
+    std::vector<float> buffer(out.bufferSize() / sizeof(float), 0.25f);
+    for (int i = 0; i < 8; i++) {
+        ASSERT_EQ(ssize_t(out.bufferSize()), out.write(buffer.data(), out.bufferSize()));
+    }
+    usleep(20000);
+    EXPECT_EQ(8192, peak.load());
+}
+
+// The framework may change the rate from another thread while its mixer
+// thread is writing; the switch waits for the write() in progress.
+TEST(AudioStreamReconfigureTest, OutputReconfiguresWhileWriting) {
+    FakeAudioDevice device(4096, 100000);
+    AudioStreamOutGeneric out;
+    uint32_t rate = 48000;
+    ASSERT_EQ(NO_ERROR, out.set(nullptr, device.fd(), 0, nullptr, nullptr, &rate));
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> failures{0};
+    std::thread writer([&] {
+        // a multiple of both the 16-bit and the float stereo frame size
+        std::vector<int16_t> buffer(1024 * 4, 1000);
+        while (!stop) {
+            if (out.write(buffer.data(), buffer.size() * 2) != ssize_t(buffer.size() * 2)) {
+                failures++;
+            }
+        }
+    });
+    const uint32_t rates[] = {32000, 44100, 48000, 22050};
+    const int formats[] = {AudioSystem::PCM_16_BIT, AUDIO_FORMAT_PCM_FLOAT};
+    for (int i = 0; i < 200; i++) {
+        EXPECT_EQ(NO_ERROR, out.reconfigure(formats[i % 2], rates[i % 4]));
+        if (i % 16 == 0) {
+            EXPECT_EQ(NO_ERROR, out.standby());
+        }
+    }
+    stop = true;
+    writer.join();
+    EXPECT_EQ(0, failures.load());
+    EXPECT_EQ(22050u, out.sampleRate());
+    EXPECT_EQ(AUDIO_FORMAT_PCM_FLOAT, out.format());
+}
+
+// Checks the frame numbers FakeCaptureDevice writes follow on from *next.
+static size_t countGaps(const std::vector<int16_t>& buffer, uint16_t* next) {
+    size_t gaps = 0;
+    for (int16_t s : buffer) {
+        if (uint16_t(s) != *next) gaps++;
+        *next = uint16_t(s) + 1;
+    }
+    return gaps;
+}
+
+// Capture carries on across a switch to 16kHz and back, and the capture
+// position keeps counting at whichever rate read() is at.
+TEST(AudioStreamReconfigureTest, InputSwitchesRateAndBack) {
+    const size_t periodFrames = AudioStreamInGeneric::kDeviceBufferSize / sizeof(int16_t);
+    FakeCaptureDevice device(periodFrames, 1000000);
+    AudioStreamInGeneric in;
+    int format = AudioSystem::PCM_16_BIT;
+    uint32_t channels = AudioSystem::CHANNEL_IN_MONO;
+    uint32_t rate = AudioStreamInGeneric::kDeviceRate;
+    ASSERT_EQ(NO_ERROR, in.set(nullptr, device.fd(), AudioSystem::DEVICE_IN_BUILTIN_MIC, &format,
+                               &channels, &rate, (AudioSystem::audio_in_acoustics)0));
+    ASSERT_EQ(NO_ERROR, in.enableCaptureThread(64 * AudioStreamInGeneric::kDeviceBufferSize));
+
+    std::vector<int16_t> buffer(periodFrames);
+    uint16_t next = 0;
+    for (int i = 0; i < 10; i++) {
+        ASSERT_EQ(ssize_t(periodFrames * 2), in.read(buffer.data(), periodFrames * 2));
+        EXPECT_EQ(0u, countGaps(buffer, &next));
+    }
+    int64_t before, after, time;
+    ASSERT_EQ(NO_ERROR, in.getCapturePosition(&before, &time));
+    EXPECT_EQ(int64_t(10 * periodFrames), before);
+
+    EXPECT_EQ(BAD_VALUE, in.reconfigure(AUDIO_FORMAT_PCM_FLOAT, 0));
+    ASSERT_EQ(NO_ERROR, in.reconfigure(0, 16000));
+    EXPECT_EQ(16000u, in.sampleRate());
+    EXPECT_EQ(AudioStreamInGeneric::bufferSizeFor(16000), in.bufferSize());
+    for (int i = 0; i < 10; i++) {
+        ASSERT_EQ(ssize_t(periodFrames * 2), in.read(buffer.data(), periodFrames * 2));
+    }
+    ASSERT_EQ(NO_ERROR, in.getCapturePosition(&after, &time));
+    // what the resampler has taken in but not yet put out counts as read
+    EXPECT_GE(after, before + int64_t(10 * periodFrames));
+    EXPECT_LE(after, before + int64_t(14 * periodFrames));
+
+    // Back at the device rate the frames the resampler had not reached are
+    // handed out first, then the device again, with nothing skipped.
+    ASSERT_EQ(NO_ERROR, in.reconfigure(0, AudioStreamInGeneric::kDeviceRate));
+    ASSERT_EQ(NO_ERROR, in.getCapturePosition(&before, &time));
+    EXPECT_EQ(after, before);
+    ASSERT_EQ(ssize_t(periodFrames * 2), in.read(buffer.data(), periodFrames * 2));
+    next = uint16_t(buffer[0]);
+    EXPECT_EQ(0u, countGaps(buffer, &next));
+    for (int i = 0; i < 10; i++) {
+        ASSERT_EQ(ssize_t(periodFrames * 2), in.read(buffer.data(), periodFrames * 2));
+        EXPECT_EQ(0u, countGaps(buffer, &next));
+    }
+    ASSERT_EQ(NO_ERROR, in.getCapturePosition(&after, &time));
+    EXPECT_EQ(before + int64_t(11 * periodFrames), after);
+    EXPECT_EQ(0u, in.getInputFramesLost());
+}
+
+}  // namespace android_audio_legacy
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <math.h>
+
+#include <random>
+#include <vector>
+
+#include "AudioHardwareGeneric.h"
+#include "AudioMixOps.h"
+#include "AudioResampler.h"
+#include "../benchmarks/FakeAudioDevice.h"
+#include "../benchmarks/ThdN.h"
+
+namespace android_audio_legacy {
+
+TEST(AudioMixOpsTest, DotMatchesScalar) {
+    std::mt19937 rng(2);
+    std::uniform_int_distribution<int> sample(-32768, 32767);
+    std::vector<int16_t> x(64), h0(64), h1(64);
+    for (int i = 0; i < 64; i++) {
+        x[i] = sample(rng);
+        h0[i] = sample(rng) / 8;
+        h1[i] = sample(rng) / 8;
+    }
+    int32_t e0, e1, a0, a1;
+    dot16x2Scalar(x.data(), h0.data(), h1.data(), 64, &e0, &e1);
+    dot16x2(x.data(), h0.data(), h1.data(), 64, &a0, &a1);
+    EXPECT_EQ(e0, a0);
+    EXPECT_EQ(e1, a1);
+}
+
+// Output frame count follows the rate ratio exactly, in arbitrary chunks.
+TEST(AudioResamplerTest, NoDrift) {
+    const uint32_t rates[][2] = {{44100, 48000}, {48000, 44100}, {8000, 44100}, {44101, 44100}};
+    for (const auto& r : rates) {
+        AudioResampler src(r[0], r[1], 2);
+        std::vector<int16_t> in(2 * 1000), out(2 * 4096);
+        uint64_t inTotal = 0, outTotal = 0;
+        std::mt19937 rng(3);
+        for (int i = 0; i < 2000; i++) {
+            size_t n = 1 + rng() % 1000;
+            size_t left = n;
+            const int16_t* p = in.data();
+            while (left) {
+                size_t consumed = left;
+                outTotal += src.resample(out.data(), 4096, p, &consumed);
+                p += consumed * 2;
+                left -= consumed;
+            }
+            inTotal += n;
+        }
+        // all input up to the filter's lookahead has been converted
+        double expected = double(inTotal - src.delayFrames()) * r[1] / r[0];
+        EXPECT_NEAR(expected, double(outTotal), 2.0) << r[0] << " -> " << r[1];
+    }
+}
+
+TEST(AudioResamplerTest, SineQuality) {
+    const uint32_t rates[][2] = {{44100, 48000}, {48000, 44100}, {8000, 44100},
+                                 {16000, 44100}, {44100, 8000}, {22050, 44100}};
+    for (const auto& r : rates) {
+        double thdn = resamplerThdNDb(r[0], r[1], 997.0);
+        EXPECT_LT(thdn, -72.0) << r[0] << " -> " << r[1];
+    }
+}
+
+// Content above the output Nyquist frequency is removed, not aliased.
+TEST(AudioResamplerTest, RejectsAliases) {
+    AudioResampler src(96000, 44100, 1);
+    const size_t kIn = 96000;
+    std::vector<int16_t> in(kIn), out(kIn);
+    for (size_t i = 0; i < kIn; i++) in[i] = int16_t(16384 * sin(2 * M_PI * 30000.0 * i / 96000));
+    size_t consumed = kIn;
+    size_t produced = src.resample(out.data(), out.size(), in.data(), &consumed);
+    double power = 0;
+    for (size_t i = 256; i < produced; i++) power += double(out[i]) * out[i];
+    double rms = sqrt(power / (produced - 256));
+    EXPECT_LT(20 * log10(rms / (16384 / M_SQRT2)), -70.0);
+}
+
+// A 48kHz client is converted to the 44.1kHz device and positions are
+// reported back at the client rate.
+TEST(AudioResamplerTest, GenericOutputAcceptsClientRate) {
+    std::atomic<size_t> deviceBytes{0};
+    FakeAudioDevice device(4096, 1000000, 0, 0,
+                           [&](const char*) { deviceBytes += 4096; });
+    AudioStreamOutGeneric out;
+    uint32_t rate = 48000;
+    ASSERT_EQ(NO_ERROR, out.set(nullptr, device.fd(), 0, nullptr, nullptr, &rate));
+    EXPECT_EQ(48000u, out.sampleRate());
+    EXPECT_EQ(0u, out.bufferSize() % (16 * out.frameSize()));
+
+    rate = 1000;
+    AudioStreamOutGeneric bad;
+    EXPECT_EQ(BAD_VALUE, bad.set(nullptr, device.fd(), 0, nullptr, nullptr, &rate));
+    EXPECT_EQ(AudioStreamOutGeneric::kDeviceRate, rate);
+
+    std::vector<int16_t> buffer(out.bufferSize() / sizeof(int16_t));
+    size_t frames = 0;
+    while (frames < 48000) {
+        ASSERT_EQ(ssize_t(out.bufferSize()), out.write(buffer.data(), out.bufferSize()));
+        frames += out.bufferSize() / out.frameSize();
+    }
+    uint64_t position;
+    struct timespec ts;
+    ASSERT_EQ(NO_ERROR, out.getPresentationPosition(&position, &ts));
+    // everything but the filter lookahead and what the driver holds
+    const double lagFrames = 48000 * 0.020 + 96;
+    EXPECT_NEAR(double(frames) - lagFrames / 2, double(position), lagFrames);
+    usleep(20000);
+    EXPECT_NEAR(44100.0, double(deviceBytes.load()) / 4, 44100 * 0.04);
+}
+
+}  // namespace android_audio_legacy
@@ -0,0 +1,400 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <math.h>
+
+#include <random>
+#include <vector>
+
+#include "AudioSbcEncoder.h"
+#include "sbc_test_vectors.h"
+
+namespace android_audio_legacy {
+
+typedef AudioSbcEncoder::Config SbcConfig;
+
+static const uint32_t kModes[] = {
+        AudioSbcEncoder::MODE_MONO, AudioSbcEncoder::MODE_DUAL_CHANNEL,
+        AudioSbcEncoder::MODE_STEREO, AudioSbcEncoder::MODE_JOINT_STEREO};
+
+// A tone on the left, the same tone quieter and shifted on the right, and
+// some noise; full scale square waves at the end drive the filterbank into
+// saturation.
+static std::vector<int16_t> testSignal(size_t frames, uint32_t channels, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<int16_t> pcm(frames * channels);
+    for (size_t i = 0; i < frames; i++) {
+        for (uint32_t c = 0; c < channels; c++) {
+            double s = (c ? 0.3 : 0.6) * sin(2 * M_PI * 997 * i / 44100.0 + c) +
+                    std::uniform_real_distribution<double>(-0.05, 0.05)(rng);
+            if (i > frames * 3 / 4) s = (i / (7 + c)) & 1 ? 1.0 : -1.0;
+            pcm[i * channels + c] = int16_t(std::min(32767.0, std::max(-32768.0, s * 32768)));
+        }
+    }
+    return pcm;
+}
+
+// The decoder of the specification, in floating point.
+class SbcDecoder {
+public:
+    // Decodes one frame at src of up to size bytes into pcm, interleaved.
+    // Returns the frame length, or 0 if it is malformed.
+    size_t decode(const uint8_t* src, size_t size, std::vector<float>* pcm) {
+        if (size < 4 || src[0] != 0x9c) return 0;
+        static const uint32_t kRates[4] = {16000, 32000, 44100, 48000};
+        SbcConfig config;
+        config.sampleRate = kRates[src[1] >> 6];
+        config.blocks = ((src[1] >> 4) & 3) * 4 + 4;
+        config.channelMode = (src[1] >> 2) & 3;
+        config.allocation = (src[1] >> 1) & 1;
+        config.subbands = src[1] & 1 ? 8 : 4;
+        config.bitpool = src[2];
+        const size_t bytes = AudioSbcEncoder::frameBytes(config);
+        if (bytes > size) return 0;
+        mConfig = config;
+        mSrc = src + 4;
+        mBit = 0;
+
+        const uint32_t m = config.subbands;
+        const uint32_t channels = AudioSbcEncoder::channelCount(config.channelMode);
+        uint32_t join = 0;
+        if (config.channelMode == AudioSbcEncoder::MODE_JOINT_STEREO) {
+            for (uint32_t sb = 0; sb < m; sb++) join |= get(1) << sb;
+        }
+        uint8_t sf[2][8] = {}, bits[2][8];
+        for (uint32_t c = 0; c < channels; c++) {
+            for (uint32_t sb = 0; sb < m; sb++) sf[c][sb] = get(4);
+        }
+        uint8_t crc = AudioSbcEncoder::crc8(0x0f, src + 1, 16);
+        if (AudioSbcEncoder::crc8(crc, src + 4, mBit) != src[3]) return 0;
+        AudioSbcEncoder::allocateBits(config, sf, bits);
+
+        for (uint32_t b = 0; b < config.blocks; b++) {
+            double s[2][8];
+            for (uint32_t c = 0; c < channels; c++) {
+                for (uint32_t sb = 0; sb < m; sb++) {
+                    double levels = (1 << bits[c][sb]) - 1;
+                    s[c][sb] = bits[c][sb] ? (1 << (sf[c][sb] + 1)) *
+                            ((get(bits[c][sb]) * 2 + 1) / levels - 1) : 0;
+                }
+            }
+            for (uint32_t sb = 0; sb < m; sb++) {
+                if (join & (1 << sb)) {
+                    double mid = s[0][sb], side = s[1][sb];
+                    s[0][sb] = mid + side;
+                    s[1][sb] = mid - side;
+                }
+            }
+            for (uint32_t c = 0; c < channels; c++) synthesize(c, s[c], channels, pcm);
+        }
+        return mBit <= (bytes - 4) * 8 ? bytes : 0;
+    }
+
+    SbcConfig mConfig;
+
+private:
+    uint32_t get(uint32_t n) {
+        uint32_t v = 0;
+        for (uint32_t i = 0; i < n; i++, mBit++) {
+            v = (v << 1) | ((mSrc[mBit / 8] >> (7 - mBit % 8)) & 1);
+        }
+        return v;
+    }
+
+    void synthesize(uint32_t c, const double* s, uint32_t channels, std::vector<float>* pcm) {
+        const uint32_t m = mConfig.subbands;
+        std::vector<double>& v = mV[c];
+        v.resize(20 * m);
+        for (uint32_t i = 20 * m - 1; i >= 2 * m; i--) v[i] = v[i - 2 * m];
+        for (uint32_t k = 0; k < 2 * m; k++) {
+            v[k] = 0;
+            for (uint32_t i = 0; i < m; i++) {
+                v[k] += cos((i + 0.5) * (k + m / 2.0) * M_PI / m) * s[i];
+            }
+        }
+        double u[80];
+        for (uint32_t i = 0; i < 5; i++) {
+            for (uint32_t j = 0; j < m; j++) {
+                u[i * 2 * m + j] = v[i * 4 * m + j];
+                u[i * 2 * m + m + j] = v[i * 4 * m + 3 * m + j];
+            }
+        }
+        size_t base = pcm->size() / channels;
+        if (c == 0) pcm->resize(pcm->size() + m * channels);
+        else base -= m;
+        for (uint32_t j = 0; j < m; j++) {
+            double out = 0;
+            for (uint32_t i = 0; i < 10; i++) out += u[j + m * i] * prototype(j + m * i) * -double(m);
+            (*pcm)[(base + j) * channels + c] = float(out / 32768);
+        }
+    }
+
+    // The specification's C[i], from its table; 4 or 8 subbands.
+    double prototype(uint32_t i) {
+        static const double kP4[40] = {
+                0.00000000E+00,  5.36548976E-04,  1.49188357E-03,  2.73370904E-03,
+                3.83720193E-03,  3.89205149E-03,  1.86581691E-03, -3.06012286E-03,
+                1.09137620E-02,  2.04385087E-02,  2.88757392E-02,  3.21939290E-02,
+                2.58767811E-02,  6.13245186E-03, -2.88217274E-02, -7.76463494E-02,
+                1.35593274E-01,  1.94987841E-01,  2.46636662E-01,  2.81828203E-01,
+                2.94315332E-01,  2.81828203E-01,  2.46636662E-01,  1.94987841E-01,
+               -1.35593274E-01, -7.76463494E-02, -2.88217274E-02,  6.13245186E-03,
+                2.58767811E-02,  3.21939290E-02,  2.88757392E-02,  2.04385087E-02,
+               -1.09137620E-02, -3.06012286E-03,  1.86581691E-03,  3.89205149E-03,
+                3.83720193E-03,  2.73370904E-03,  1.49188357E-03,  5.36548976E-04};
+        static const double kP8[80] = {
+                0.00000000E+00,  1.56575398E-04,  3.43256425E-04,  5.54620202E-04,
+                8.23919506E-04,  1.13992507E-03,  1.47640169E-03,  1.78371725E-03,
+                2.01182542E-03,  2.10371989E-03,  1.99454554E-03,  1.61656283E-03,
+                9.02154502E-04, -1.78805361E-04, -1.64973098E-03, -3.49717454E-03,
+                5.65949473E-03,  8.02941163E-03,  1.04584443E-02,  1.27472335E-02,
+                1.46525263E-02,  1.59045603E-02,  1.62208471E-02,  1.53184106E-02,
+                1.29371806E-02,  8.85757540E-03,  2.92408442E-03, -4.91578024E-03,
+               -1.46404076E-02, -2.61098752E-02, -3.90751381E-02, -5.31873032E-02,
+                6.79989431E-02,  8.29847578E-02,  9.75753918E-02,  1.11196689E-01,
+                1.23264548E-01,  1.33264415E-01,  1.40753505E-01,  1.45389847E-01,
+                1.46955068E-01,  1.45389847E-01,  1.40753505E-01,  1.33264415E-01,
+                1.23264548E-01,  1.11196689E-01,  9.75753918E-02,  8.29847578E-02,
+               -6.79989431E-02, -5.31873032E-02, -3.90751381E-02, -2.61098752E-02,
+               -1.46404076E-02, -4.91578024E-03,  2.92408442E-03,  8.85757540E-03,
+                1.29371806E-02,  1.53184106E-02,  1.62208471E-02,  1.59045603E-02,
+                1.46525263E-02,  1.27472335E-02,  1.04584443E-02,  8.02941163E-03,
+               -5.65949473E-03, -3.49717454E-03, -1.64973098E-03, -1.78805361E-04,
+                9.02154502E-04,  1.61656283E-03,  1.99454554E-03,  2.10371989E-03,
+                2.01182542E-03,  1.78371725E-03,  1.47640169E-03,  1.13992507E-03,
+                8.23919506E-04,  5.54620202E-04,  3.43256425E-04,  1.56575398E-04};
+        return mConfig.subbands == 8 ? kP8[i] : kP4[i];
+    }
+
+    const uint8_t* mSrc;
+    size_t mBit;
+    std::vector<double> mV[2];
+};
+
+static std::vector<uint8_t> encodeAll(AudioSbcEncoder* encoder, const std::vector<int16_t>& pcm) {
+    const uint32_t channels = AudioSbcEncoder::channelCount(encoder->config().channelMode);
+    const size_t samples = encoder->frameSamples() * channels;
+    std::vector<uint8_t> out;
+    uint8_t frame[AudioSbcEncoder::kMaxFrameBytes];
+    for (size_t i = 0; i + samples <= pcm.size(); i += samples) {
+        size_t n = encoder->encode(&pcm[i], frame);
+        out.insert(out.end(), frame, frame + n);
+    }
+    return out;
+}
+
+TEST(AudioSbcEncoderTest, CrcIsTheSpecifications) {
+    // CRC-8/SAE-J1850, which shares the polynomial, checks to 0x4b
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    EXPECT_EQ(0x4b, AudioSbcEncoder::crc8(0xff, check, 72) ^ 0xff);
+    // and carries on from a partial result, as the frame header's does
+    uint8_t crc = AudioSbcEncoder::crc8(0xff, check, 16);
+    EXPECT_EQ(0x4b, AudioSbcEncoder::crc8(crc, check + 2, 56) ^ 0xff);
+}
+
+TEST(AudioSbcEncoderTest, RejectsInvalidConfigurations) {
+    AudioSbcEncoder encoder;
+    SbcConfig good = {44100, AudioSbcEncoder::MODE_JOINT_STEREO, 16, 8,
+                      AudioSbcEncoder::ALLOCATION_LOUDNESS, 53};
+    EXPECT_EQ(NO_ERROR, encoder.configure(good));
+    EXPECT_EQ(119u, encoder.frameBytes());
+    EXPECT_EQ(128u, encoder.frameSamples());
+
+    SbcConfig bad = good;
+    bad.sampleRate = 22050;
+    EXPECT_EQ(BAD_VALUE, encoder.configure(bad));
+    bad = good;
+    bad.blocks = 10;
+    EXPECT_EQ(BAD_VALUE, encoder.configure(bad));
+    bad = good;
+    bad.subbands = 6;
+    EXPECT_EQ(BAD_VALUE, encoder.configure(bad));
+    bad = good;
+    bad.bitpool = 251;
+    EXPECT_EQ(BAD_VALUE, encoder.configure(bad));
+
+    EXPECT_EQ(BAD_VALUE, encoder.setBitpool(1));
+    EXPECT_EQ(NO_ERROR, encoder.setBitpool(35));
+    EXPECT_EQ(83u, encoder.frameBytes());
+    EXPECT_EQ(250u, AudioSbcEncoder::maxBitpool(good));
+    good.channelMode = AudioSbcEncoder::MODE_MONO;
+    EXPECT_EQ(128u, AudioSbcEncoder::maxBitpool(good));
+}
+
+// Every configuration, so both filterbanks, all four channel modes and the
+// saturating input in testSignal() go through both paths.
+TEST(AudioSbcEncoderTest, VectorMatchesScalar) {
+    for (uint32_t mode : kModes) {
+        for (uint32_t subbands = 4; subbands <= 8; subbands += 4) {
+            for (uint32_t blocks = 4; blocks <= 16; blocks += 4) {
+                for (uint32_t allocation = 0; allocation < 2; allocation++) {
+                    SbcConfig config = {48000, mode, blocks, subbands, allocation, 0};
+                    config.bitpool = AudioSbcEncoder::maxBitpool(config) / 3;
+                    AudioSbcEncoder vector, reference(true);
+                    ASSERT_EQ(NO_ERROR, vector.configure(config));
+                    ASSERT_EQ(NO_ERROR, reference.configure(config));
+                    auto pcm = testSignal(4096, AudioSbcEncoder::channelCount(mode), blocks);
+                    EXPECT_EQ(encodeAll(&reference, pcm), encodeAll(&vector, pcm))
+                            << "mode " << mode << " subbands " << subbands << " blocks " << blocks
+                            << " allocation " << allocation;
+                }
+            }
+        }
+    }
+}
+
+// An SBC frame split at the audio samples: the header, CRC, join flags and
+// scale factors, which decide the bit allocation, and then the quantized
+// samples it lays out.
+struct SbcFrameFields {
+    std::vector<uint32_t> side;
+    std::vector<uint32_t> samples;
+};
+
+static size_t parseFrame(const uint8_t* src, size_t size, SbcFrameFields* fields) {
+    if (size < 4 || src[0] != 0x9c) return 0;
+    static const uint32_t kRates[4] = {16000, 32000, 44100, 48000};
+    SbcConfig config;
+    config.sampleRate = kRates[src[1] >> 6];
+    config.blocks = ((src[1] >> 4) & 3) * 4 + 4;
+    config.channelMode = (src[1] >> 2) & 3;
+    config.allocation = (src[1] >> 1) & 1;
+    config.subbands = src[1] & 1 ? 8 : 4;
+    config.bitpool = src[2];
+    const size_t bytes = AudioSbcEncoder::frameBytes(config);
+    if (bytes > size) return 0;
+
+    size_t bit = 32;
+    auto get = [&](uint32_t n) {
+        uint32_t v = 0;
+        for (uint32_t i = 0; i < n; i++, bit++) v = (v << 1) | ((src[bit / 8] >> (7 - bit % 8)) & 1);
+        return v;
+    };
+    fields->side.assign(src, src + 4);
+    fields->samples.clear();
+    const uint32_t m = config.subbands;
+    const uint32_t channels = AudioSbcEncoder::channelCount(config.channelMode);
+    if (config.channelMode == AudioSbcEncoder::MODE_JOINT_STEREO) fields->side.push_back(get(m));
+    uint8_t sf[2][8] = {}, bits[2][8];
+    for (uint32_t c = 0; c < channels; c++) {
+        for (uint32_t sb = 0; sb < m; sb++) fields->side.push_back(sf[c][sb] = get(4));
+    }
+    AudioSbcEncoder::allocateBits(config, sf, bits);
+    for (uint32_t b = 0; b < config.blocks; b++) {
+        for (uint32_t c = 0; c < channels; c++) {
+            for (uint32_t sb = 0; sb < m; sb++) fields->samples.push_back(get(bits[c][sb]));
+        }
+    }
+    return bit <= bytes * 8 ? bytes : 0;
+}
+
+// Frames from an independent encoder, in sbc_test_vectors.h, for the same
+// input. Everything up to the samples must be the same bytes; the samples
+// themselves may round the other way now and then, as the two filterbanks
+// round differently, but never by more than a step.
+TEST(AudioSbcEncoderTest, MatchesIndependentEncoder) {
+    struct {
+        SbcConfig config;
+        const uint8_t* frames;
+        size_t size;
+    } cases[] = {
+            {{44100, AudioSbcEncoder::MODE_STEREO, 16, 8, 0, 53},
+             kSbcVectorStereo44, sizeof(kSbcVectorStereo44)},
+            {{44100, AudioSbcEncoder::MODE_JOINT_STEREO, 16, 8, 0, 53},
+             kSbcVectorJointStereo44, sizeof(kSbcVectorJointStereo44)},
+            {{48000, AudioSbcEncoder::MODE_MONO, 16, 4, 0, 31},
+             kSbcVectorMono48, sizeof(kSbcVectorMono48)},
+            {{32000, AudioSbcEncoder::MODE_JOINT_STEREO, 8, 4, 0, 35},
+             kSbcVectorJointStereo32, sizeof(kSbcVectorJointStereo32)},
+    };
+    for (const auto& c : cases) {
+        for (bool reference : {false, true}) {
+            AudioSbcEncoder encoder(reference);
+            ASSERT_EQ(NO_ERROR, encoder.configure(c.config));
+            auto out = encodeAll(&encoder,
+                    sbcVectorSignal(AudioSbcEncoder::channelCount(c.config.channelMode)));
+            ASSERT_EQ(c.size, out.size()) << "bitpool " << c.config.bitpool;
+
+            size_t samples = 0, rounded = 0;
+            SbcFrameFields ours, theirs;
+            for (size_t i = 0; i < out.size();) {
+                size_t n = parseFrame(&out[i], out.size() - i, &ours);
+                ASSERT_EQ(encoder.frameBytes(), n) << "frame at " << i;
+                ASSERT_EQ(n, parseFrame(c.frames + i, c.size - i, &theirs));
+                ASSERT_EQ(theirs.side, ours.side) << "bitpool " << c.config.bitpool
+                        << " frame at " << i;
+                ASSERT_EQ(theirs.samples.size(), ours.samples.size());
+                for (size_t s = 0; s < ours.samples.size(); s++) {
+                    int32_t d = int32_t(ours.samples[s]) - int32_t(theirs.samples[s]);
+                    ASSERT_LE(abs(d), 1) << "bitpool " << c.config.bitpool << " frame at " << i;
+                    if (d) rounded++;
+                }
+                samples += ours.samples.size();
+                i += n;
+            }
+            // about one in a hundred with 4 subbands, fewer with 8
+            EXPECT_LE(rounded * 50, samples) << "bitpool " << c.config.bitpool;
+        }
+    }
+}
+
+// Frames parse back per the specification, and decode to the input within
+// what the bitpool allows.
+TEST(AudioSbcEncoderTest, DecodesToTheInput) {
+    for (uint32_t mode : kModes) {
+        for (uint32_t subbands = 4; subbands <= 8; subbands += 4) {
+            SbcConfig config = {44100, mode, 16, subbands, AudioSbcEncoder::ALLOCATION_LOUDNESS,
+                                mode >= AudioSbcEncoder::MODE_STEREO ? 53u : 31u};
+            AudioSbcEncoder encoder;
+            ASSERT_EQ(NO_ERROR, encoder.configure(config));
+            const uint32_t channels = AudioSbcEncoder::channelCount(mode);
+            // the tone and noise, without the square waves
+            auto pcm = testSignal(16384, channels, 2);
+            pcm.resize(pcm.size() * 3 / 4 / (encoder.frameSamples() * channels) *
+                       encoder.frameSamples() * channels);
+            auto frames = encodeAll(&encoder, pcm);
+
+            SbcDecoder decoder;
+            std::vector<float> out;
+            for (size_t i = 0; i < frames.size();) {
+                size_t n = decoder.decode(&frames[i], frames.size() - i, &out);
+                ASSERT_EQ(encoder.frameBytes(), n) << "frame at " << i;
+                EXPECT_EQ(config.bitpool, decoder.mConfig.bitpool);
+                EXPECT_EQ(config.channelMode, decoder.mConfig.channelMode);
+                i += n;
+            }
+            ASSERT_EQ(pcm.size(), out.size());
+
+            // analysis and synthesis together delay by 9 * M + 1
+            const size_t delay = 9 * subbands + 1;
+            double signal = 0, noise = 0;
+            for (size_t i = 1024; i + delay < pcm.size() / channels; i++) {
+                for (uint32_t c = 0; c < channels; c++) {
+                    double x = pcm[i * channels + c] / 32768.0;
+                    double e = out[(i + delay) * channels + c] - x;
+                    signal += x * x;
+                    noise += e * e;
+                }
+            }
+            EXPECT_GT(10 * log10(signal / noise), 30.0)
+                    << "mode " << mode << " subbands " << subbands;
+        }
+    }
+}
+
+}  // namespace android_audio_legacy
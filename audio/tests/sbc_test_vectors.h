@@ -0,0 +1,445 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SBC frames from an independent encoder, for sbc_encoder_test to hold
+// AudioSbcEncoder to: FFmpeg 7.0.2's libavcodec sbc encoder, which derives
+// from BlueZ's libsbc, fed sbcVectorSignal() as 16 bit little-endian PCM.
+//
+//   ffmpeg -f s16le -ar <rate> -ac <channels> -i signal.raw -c:a sbc
+//       -b:a <bit rate> [-sbc_delay <s>] -global_quality:a <bitpool * 118> -f sbc out.sbc
+//
+// The bit rate and delay only pick the channel mode, subbands and blocks;
+// global_quality sets the bitpool. FFmpeg always allocates by loudness.
+
+#ifndef ANDROID_AUDIO_SBC_TEST_VECTORS_H
+#define ANDROID_AUDIO_SBC_TEST_VECTORS_H
+
+#include <stdint.h>
+
+#include <vector>
+
+// Samples of the vectors: 1024 frames of a triangle wave on each channel
+// with LCG noise, then full scale square waves for the last quarter to
+// drive the filterbank into saturation. Integer only, so it is the same
+// on every platform.
+static inline std::vector<int16_t> sbcVectorSignal(uint32_t channels) {
+    const int32_t frames = 1024;
+    std::vector<int16_t> pcm;
+    uint32_t seed = 1;
+    for (int32_t i = 0; i < frames; i++) {
+        for (int32_t c = 0; c < (int32_t)channels; c++) {
+            seed = seed * 1103515245u + 12345u;
+            int32_t noise = ((int32_t)((seed >> 16) & 0x7fff) - 16384) >> 3;
+            int32_t s;
+            if (i >= frames * 3 / 4) {
+                s = (i / (7 + c)) & 1 ? 32767 : -32768;
+            } else {
+                int32_t period = 44 + 16 * c, amp = 16000 - 7000 * c;
+                int32_t p = i % period, v = p * 4 * amp / period;
+                s = (p < period / 2 ? v - amp : 3 * amp - v) + noise;
+            }
+            pcm.push_back((int16_t)s);
+        }
+    }
+    return pcm;
+}
+
+// 44100 Hz stereo, 16 blocks, 8 subbands, bitpool 53: -b:a 345k
+static const uint8_t kSbcVectorStereo44[944] = {
+        0x9c, 0xb9, 0x35, 0x7b, 0xdb, 0xab, 0x9a, 0x99, 0xcb, 0x9a, 0x99, 0x9a,
+        0x7e, 0xee, 0xed, 0xaf, 0xdd, 0xba, 0xab, 0xf7, 0x77, 0x6d, 0x7e, 0xed,
+        0xd5, 0x5d, 0xb3, 0xbb, 0x6b, 0x96, 0x6e, 0xaa, 0xf2, 0x91, 0xf3, 0x1d,
+        0x49, 0x69, 0x13, 0xc3, 0x97, 0x08, 0x34, 0xa5, 0xa3, 0x45, 0x69, 0x82,
+        0xd6, 0x8d, 0x1c, 0x57, 0x83, 0x9b, 0x96, 0xe2, 0x67, 0x13, 0x37, 0xd1,
+        0x99, 0x47, 0xbc, 0x38, 0x54, 0x4f, 0x2d, 0x12, 0x59, 0x9a, 0x42, 0xc8,
+        0xd5, 0x57, 0x92, 0x6a, 0xca, 0x01, 0x57, 0x42, 0x3b, 0x69, 0xd6, 0x90,
+        0xad, 0x79, 0xea, 0x2a, 0x83, 0xc1, 0x8a, 0x5e, 0x34, 0xce, 0x92, 0x86,
+        0x1d, 0x2a, 0xc1, 0x77, 0x84, 0x9a, 0x4f, 0x96, 0x44, 0xb3, 0xbb, 0x86,
+        0x68, 0x6a, 0xea, 0xa4, 0x62, 0xdd, 0x37, 0xe3, 0xa8, 0x91, 0x9c, 0xb9,
+        0x35, 0xb9, 0xda, 0x99, 0xa9, 0xa9, 0xc9, 0xaa, 0x99, 0x99, 0x98, 0x82,
+        0x3b, 0x73, 0x8b, 0xba, 0x6e, 0xd9, 0x45, 0x5b, 0x4b, 0x21, 0xd4, 0x2f,
+        0x84, 0x6f, 0x69, 0x16, 0xcf, 0x1a, 0x9b, 0x2c, 0x65, 0x41, 0x45, 0x74,
+        0xd1, 0x64, 0xaa, 0xc8, 0xfd, 0x3d, 0x45, 0x2a, 0xd7, 0x19, 0xab, 0x55,
+        0xc9, 0x47, 0x02, 0x58, 0xa9, 0xf5, 0x8e, 0xc4, 0x9b, 0xf0, 0x5b, 0xb3,
+        0x41, 0x2a, 0xac, 0x83, 0x55, 0xab, 0x6e, 0x6b, 0xc9, 0x41, 0x77, 0x69,
+        0xec, 0x3f, 0x29, 0x93, 0x49, 0x5c, 0xac, 0x98, 0x08, 0xed, 0x53, 0x35,
+        0x5d, 0x55, 0x0e, 0x68, 0x95, 0x8d, 0xd0, 0x5a, 0xd7, 0x2d, 0x33, 0xb4,
+        0xe1, 0x21, 0x95, 0x3d, 0x29, 0x99, 0x45, 0x36, 0x46, 0xd5, 0x76, 0xac,
+        0xe9, 0x02, 0x86, 0x36, 0x6a, 0x93, 0x64, 0x70, 0x9c, 0xb9, 0x35, 0x54,
+        0xda, 0x98, 0x99, 0x99, 0xc9, 0x9a, 0xa9, 0xa9, 0x5b, 0xad, 0x96, 0x54,
+        0xa7, 0x2c, 0xd6, 0x26, 0x4d, 0xc8, 0x32, 0xba, 0x72, 0xf9, 0x74, 0xd2,
+        0xa1, 0x2f, 0x44, 0x37, 0x0d, 0x9e, 0x71, 0xc0, 0x0a, 0x52, 0x32, 0xac,
+        0x65, 0x8e, 0xf2, 0x5a, 0xf2, 0x15, 0xad, 0x48, 0xbe, 0x65, 0x5a, 0x6e,
+        0x51, 0x20, 0xdb, 0xdc, 0x12, 0xd3, 0x7c, 0x1e, 0x36, 0xdb, 0x64, 0xd9,
+        0x5b, 0xc0, 0x4a, 0x4b, 0x0f, 0x35, 0x12, 0x5a, 0x95, 0xaa, 0x36, 0x10,
+        0xb8, 0xc6, 0xc6, 0x89, 0x89, 0xb4, 0x8c, 0x33, 0x26, 0xb3, 0x05, 0x59,
+        0xcd, 0xb2, 0x59, 0xbc, 0x29, 0x1a, 0x8f, 0x5c, 0x12, 0xd6, 0xf3, 0xe3,
+        0x23, 0x7d, 0xe3, 0x77, 0x6e, 0x15, 0x2c, 0x68, 0x9f, 0xa4, 0x3e, 0x46,
+        0x16, 0x67, 0x1a, 0x46, 0x9d, 0xdc, 0x9c, 0xb9, 0x35, 0x01, 0xdb, 0xa9,
+        0x89, 0x99, 0xca, 0xa9, 0x99, 0x99, 0x2b, 0x14, 0xc9, 0x83, 0x11, 0x95,
+        0xac, 0xa5, 0x9a, 0xdd, 0x0e, 0xcb, 0x6b, 0xb7, 0x43, 0x9b, 0x13, 0xe6,
+        0x78, 0x9d, 0x88, 0xd6, 0x17, 0x31, 0x3b, 0x9a, 0xe5, 0x11, 0x48, 0x41,
+        0xe6, 0x1b, 0x38, 0x8f, 0x69, 0x69, 0x2d, 0xa6, 0xb0, 0x39, 0x64, 0x2c,
+        0x28, 0xba, 0x69, 0x49, 0xb7, 0x96, 0xa2, 0x90, 0xd3, 0x43, 0x60, 0xe7,
+        0x57, 0x04, 0x41, 0x11, 0xcb, 0x6c, 0x26, 0x66, 0xed, 0x3d, 0x0d, 0x5d,
+        0x8c, 0xbb, 0x17, 0x0d, 0x68, 0x7d, 0x52, 0x41, 0xde, 0xbb, 0x36, 0xc4,
+        0xb0, 0x99, 0x6d, 0x08, 0xb7, 0xe5, 0x56, 0xa4, 0x6e, 0x87, 0x5a, 0xc9,
+        0x8c, 0xd1, 0x1b, 0x11, 0xc3, 0x91, 0xaa, 0x9b, 0x52, 0xa9, 0xa5, 0xd9,
+        0x34, 0x6d, 0x2c, 0x32, 0x9c, 0xb9, 0x35, 0xe9, 0xda, 0x9a, 0x99, 0x99,
+        0xc9, 0x99, 0x99, 0x99, 0x1f, 0x10, 0xea, 0x41, 0x45, 0xe4, 0xda, 0xd5,
+        0xa9, 0x6a, 0x3c, 0x6c, 0x54, 0xed, 0xde, 0x34, 0xb3, 0x03, 0x31, 0xa7,
+        0xc9, 0x91, 0x91, 0x3d, 0x4b, 0x4d, 0x98, 0xc9, 0x70, 0xa5, 0xd0, 0x1c,
+        0x35, 0x13, 0xd4, 0x8a, 0xe3, 0x2a, 0x69, 0x2c, 0x8a, 0x6b, 0xc7, 0x4a,
+        0xc5, 0x61, 0x53, 0x08, 0x1d, 0xa6, 0x04, 0x46, 0x5e, 0xdf, 0xd2, 0xae,
+        0xa4, 0x39, 0x38, 0xde, 0x19, 0xcc, 0x4e, 0x4c, 0x22, 0x32, 0xd4, 0x35,
+        0x33, 0x93, 0x41, 0x71, 0x38, 0x38, 0x65, 0xa1, 0x5f, 0x36, 0xb4, 0x25,
+        0xea, 0x14, 0xe3, 0xa1, 0x24, 0x52, 0x62, 0x32, 0x82, 0xd2, 0x75, 0x12,
+        0x6b, 0x9f, 0x53, 0x99, 0x84, 0xd8, 0xe2, 0x50, 0x92, 0xa1, 0xe4, 0x1e,
+        0x46, 0xab, 0x9c, 0xb9, 0x35, 0x41, 0xda, 0xa9, 0x9a, 0x99, 0xca, 0xa9,
+        0xa9, 0x99, 0x2f, 0x06, 0xcc, 0x0f, 0x12, 0x22, 0x29, 0x18, 0x8b, 0x11,
+        0xb9, 0xac, 0xd9, 0x65, 0x2c, 0x37, 0x27, 0x98, 0x76, 0xa9, 0xb6, 0x9b,
+        0x46, 0xb6, 0x31, 0xb7, 0x8b, 0xe3, 0x31, 0x32, 0xda, 0x26, 0x51, 0x26,
+        0xc9, 0x51, 0x93, 0x2d, 0x06, 0x14, 0x49, 0xb5, 0x92, 0x81, 0x35, 0x6a,
+        0x8b, 0xad, 0x32, 0x61, 0x1e, 0x44, 0x52, 0xbe, 0xb1, 0x14, 0xb4, 0x11,
+        0x6c, 0xc7, 0x09, 0xa7, 0x20, 0xd0, 0xec, 0xd5, 0x60, 0xba, 0xb2, 0xc7,
+        0x97, 0x79, 0x0a, 0x59, 0xe0, 0xb9, 0xa7, 0xb4, 0x23, 0x52, 0x33, 0x72,
+        0x9a, 0xa6, 0x1f, 0x34, 0xcc, 0x39, 0x71, 0xd0, 0xed, 0x26, 0x53, 0x76,
+        0x33, 0x8a, 0x8d, 0x87, 0x50, 0xd8, 0x41, 0xd1, 0x99, 0xcb, 0xbb, 0x49,
+        0x9c, 0xb9, 0x35, 0xd9, 0xdf, 0xcd, 0xbd, 0xac, 0xee, 0xcd, 0xbc, 0xbc,
+        0x49, 0xee, 0xd6, 0xc7, 0x7b, 0x35, 0xa8, 0xaf, 0x76, 0xb6, 0x6b, 0xd9,
+        0xad, 0x51, 0x7b, 0x35, 0xb1, 0x1d, 0x0d, 0x6b, 0xa3, 0xdd, 0x8d, 0x85,
+        0x25, 0x6b, 0x52, 0x98, 0x04, 0x90, 0x73, 0xe4, 0x12, 0xdd, 0x86, 0x51,
+        0xb5, 0xe8, 0xcb, 0x60, 0xc4, 0x36, 0x4c, 0x78, 0x93, 0x50, 0x5c, 0xd1,
+        0xda, 0xab, 0xfb, 0x52, 0xe8, 0x05, 0xce, 0x19, 0x1f, 0x1c, 0xd4, 0x17,
+        0x6c, 0x7a, 0xda, 0xfe, 0xd4, 0xba, 0x0a, 0xb3, 0xd6, 0xc7, 0xc7, 0x35,
+        0x05, 0x49, 0x9c, 0x2e, 0xbf, 0xb5, 0x2e, 0x88, 0xb0, 0xe9, 0x31, 0xf1,
+        0xcd, 0x41, 0x1e, 0x77, 0xc9, 0xaf, 0xed, 0x4b, 0xa3, 0x8a, 0x3b, 0x54,
+        0x7c, 0x73, 0x50, 0x40, 0xb9, 0xc3, 0x2b, 0xfb, 0x52, 0xe8, 0x9c, 0xb9,
+        0x35, 0xfe, 0xdf, 0x7d, 0x2d, 0xac, 0xee, 0xad, 0xac, 0xbc, 0xed, 0x97,
+        0x8c, 0x7c, 0x7b, 0x28, 0x91, 0x56, 0xca, 0xab, 0xfb, 0x04, 0x76, 0x29,
+        0x30, 0xb5, 0x1f, 0x1e, 0xca, 0x25, 0x16, 0x14, 0xda, 0xfe, 0xc1, 0x1d,
+        0x83, 0xcf, 0xc6, 0xc7, 0xc7, 0xb2, 0x89, 0x71, 0x46, 0x52, 0xbf, 0xb0,
+        0x47, 0x60, 0x17, 0x0d, 0x11, 0xf1, 0xec, 0xa2, 0x5d, 0xb2, 0xf1, 0xaf,
+        0xec, 0x11, 0xd8, 0x2a, 0xd9, 0x54, 0x7c, 0x7b, 0x28, 0x95, 0x26, 0x16,
+        0xab, 0xfb, 0x04, 0x76, 0x22, 0xc2, 0x9b, 0x1f, 0x1e, 0xca, 0x24, 0x79,
+        0xf8, 0xda, 0xfe, 0xc1, 0x1d, 0x8e, 0x28, 0xca, 0x47, 0xc7, 0xb2, 0x89,
+        0x02, 0xe1, 0xa2, 0xbf, 0xb0, 0x47, 0x63, 0xb6, 0x5e, 0x31, 0xf1, 0xec,
+        0xa2, 0x45, 0x5b, 0x2a, 0xaf, 0xec, 0x11, 0xd8,
+};
+
+// 44100 Hz joint stereo, 16 blocks, 8 subbands, bitpool 53: -b:a 170k
+static const uint8_t kSbcVectorJointStereo44[952] = {
+        0x9c, 0xbd, 0x35, 0xf9, 0x72, 0xdb, 0x9a, 0x9a, 0x99, 0xca, 0x99, 0x99,
+        0x8a, 0x7e, 0xed, 0xdb, 0xb7, 0xee, 0xdb, 0x6b, 0xf7, 0x6e, 0xdd, 0xbf,
+        0x76, 0xdb, 0x5d, 0xb3, 0x86, 0xcd, 0xcb, 0xb6, 0xda, 0xf2, 0x43, 0x66,
+        0x4e, 0xa1, 0x38, 0xd3, 0xc3, 0xb6, 0x11, 0x1a, 0xb6, 0xa1, 0x45, 0x69,
+        0x06, 0x23, 0x46, 0x90, 0xb7, 0x83, 0x97, 0x2f, 0x31, 0x41, 0x59, 0x37,
+        0xd9, 0xba, 0x87, 0xdc, 0xd2, 0x8c, 0x4f, 0x0e, 0x24, 0x4c, 0xd6, 0xa3,
+        0x48, 0xd6, 0x51, 0x26, 0x35, 0x64, 0xd1, 0x57, 0x3a, 0x76, 0xcc, 0xec,
+        0x95, 0x1d, 0x79, 0xdc, 0x55, 0x81, 0xda, 0xbd, 0x5e, 0x32, 0xe1, 0x2b,
+        0x43, 0x0d, 0x38, 0xc1, 0x78, 0xe9, 0x9d, 0x27, 0x32, 0xb4, 0xb3, 0xc7,
+        0x0e, 0xb4, 0x4a, 0x6d, 0xa4, 0x62, 0x42, 0x67, 0xf2, 0x2b, 0xa9, 0x9c,
+        0xbd, 0x35, 0x19, 0x3e, 0xda, 0xa9, 0x98, 0x99, 0xc9, 0x89, 0x89, 0x99,
+        0x99, 0x45, 0x8d, 0xb9, 0xc4, 0x48, 0xde, 0xe4, 0xba, 0x55, 0xa5, 0x89,
+        0x27, 0x30, 0x01, 0xdb, 0xb4, 0x8b, 0x8d, 0x48, 0x9d, 0x8f, 0x12, 0xa0,
+        0xa6, 0x6d, 0xc1, 0x62, 0x7a, 0xdd, 0x7e, 0x93, 0x31, 0xaa, 0x6b, 0x95,
+        0x15, 0xaa, 0xf3, 0x6f, 0x05, 0x21, 0x90, 0xba, 0xcb, 0x1c, 0x9c, 0x18,
+        0x77, 0x57, 0xa0, 0xd7, 0x24, 0x84, 0xa8, 0x85, 0xa7, 0x36, 0xa7, 0x21,
+        0x7b, 0xca, 0x71, 0x9f, 0x81, 0xb9, 0x09, 0x6d, 0xdc, 0x2c, 0x04, 0x94,
+        0xb5, 0x36, 0xaf, 0x55, 0x47, 0x33, 0x68, 0xed, 0xd8, 0x66, 0xab, 0x96,
+        0x8b, 0x35, 0xe2, 0x12, 0xc4, 0x9e, 0x94, 0xaa, 0x49, 0x33, 0x1d, 0xa8,
+        0xbb, 0x5a, 0xdc, 0x62, 0xa2, 0xe9, 0xc3, 0x49, 0xd8, 0x9b, 0x9c, 0xbd,
+        0x35, 0x5f, 0x0a, 0xda, 0x98, 0x99, 0x99, 0xc9, 0x9a, 0x99, 0x99, 0x5a,
+        0xd6, 0xcb, 0x2a, 0x53, 0x94, 0xde, 0x2b, 0x26, 0xe4, 0x19, 0x5d, 0x32,
+        0xf9, 0xba, 0x69, 0x58, 0x97, 0xa1, 0xb7, 0x10, 0xcf, 0x28, 0xe0, 0x05,
+        0x36, 0x32, 0xa6, 0x32, 0x47, 0x79, 0x2d, 0x91, 0x16, 0x56, 0xac, 0x4f,
+        0x32, 0xa9, 0x72, 0x54, 0x90, 0x8d, 0xee, 0x09, 0x53, 0x7c, 0x4f, 0x1a,
+        0x6d, 0xb2, 0x6d, 0x1b, 0xc1, 0x25, 0x25, 0x87, 0x9a, 0x86, 0x5a, 0x92,
+        0xd5, 0x9b, 0x08, 0x5c, 0x26, 0x86, 0x84, 0xc4, 0xda, 0x46, 0x19, 0xa6,
+        0xb3, 0x82, 0xac, 0xe6, 0xd9, 0x2d, 0xbc, 0x44, 0x8d, 0x4b, 0xae, 0x09,
+        0x74, 0xf4, 0x71, 0x8d, 0xbe, 0xf1, 0xbb, 0x6e, 0x16, 0x96, 0x54, 0xcf,
+        0xd2, 0x16, 0x46, 0x0b, 0x33, 0x8d, 0x23, 0x4e, 0xda, 0x9c, 0xbd, 0x35,
+        0xfc, 0x6a, 0xd9, 0x99, 0x89, 0x99, 0xca, 0x99, 0x89, 0x89, 0x2c, 0x71,
+        0xc3, 0x21, 0x95, 0x50, 0xac, 0xb0, 0x76, 0xba, 0x87, 0x5b, 0x4b, 0x77,
+        0x5b, 0x2e, 0x31, 0xf4, 0x39, 0x59, 0x8a, 0x14, 0x8e, 0x18, 0x8d, 0x10,
+        0xd5, 0x19, 0x11, 0x88, 0xf2, 0xf7, 0x28, 0x0f, 0x06, 0xc2, 0x76, 0xd7,
+        0xb2, 0xb1, 0x62, 0x38, 0x92, 0x9d, 0x49, 0x4d, 0x97, 0xc6, 0xc5, 0x1a,
+        0x69, 0xa3, 0x62, 0xe8, 0x96, 0x28, 0xd0, 0x99, 0x49, 0x64, 0x2a, 0x4d,
+        0xdb, 0x1e, 0x57, 0x5d, 0x4c, 0xe3, 0x32, 0x26, 0xb3, 0xbc, 0x52, 0x45,
+        0x25, 0x15, 0x9b, 0x5d, 0x3c, 0x99, 0x72, 0xd1, 0x68, 0xf2, 0xf2, 0xb4,
+        0xee, 0xb6, 0x9d, 0x8c, 0xc8, 0x93, 0x13, 0x14, 0x67, 0x23, 0x55, 0x1a,
+        0x4a, 0xa9, 0x99, 0x30, 0x6c, 0x36, 0x24, 0x71, 0x9c, 0xbd, 0x35, 0x0e,
+        0x3c, 0xda, 0x89, 0x89, 0x99, 0xc9, 0x99, 0x98, 0x99, 0x1e, 0x22, 0x29,
+        0x21, 0x45, 0x17, 0x1a, 0xdb, 0x4e, 0xa8, 0xbc, 0x6a, 0xa6, 0xed, 0xb9,
+        0x6d, 0xc7, 0x03, 0xa9, 0xe7, 0xcb, 0x1a, 0x48, 0xbd, 0x4b, 0x68, 0x98,
+        0xd2, 0xe0, 0x94, 0xd0, 0x1b, 0x89, 0x13, 0xa5, 0x1a, 0x8b, 0x2b, 0x15,
+        0xac, 0x84, 0xc9, 0x55, 0x8a, 0xca, 0x9d, 0x52, 0xd0, 0xb2, 0x9a, 0x04,
+        0x17, 0x16, 0xdf, 0xa1, 0x48, 0x84, 0x39, 0x25, 0x1e, 0x13, 0x19, 0x28,
+        0xcc, 0x36, 0xaa, 0xd4, 0x69, 0x69, 0xcb, 0x41, 0x6a, 0x48, 0x38, 0xe3,
+        0xa1, 0x3f, 0x30, 0x49, 0xa5, 0xf4, 0x61, 0x8c, 0xa1, 0x0c, 0x92, 0x61,
+        0x64, 0xc3, 0x52, 0x74, 0xa3, 0x6b, 0x9e, 0xa6, 0x9e, 0x84, 0xd4, 0xcd,
+        0x50, 0xa5, 0xc5, 0x52, 0x1e, 0x27, 0x23, 0x9c, 0xbd, 0x35, 0x18, 0x7c,
+        0xda, 0x99, 0x99, 0x99, 0xc9, 0x98, 0x99, 0x99, 0x2e, 0xc6, 0x18, 0x97,
+        0x94, 0xa6, 0xd1, 0x1a, 0x71, 0xa7, 0x5c, 0x32, 0xc2, 0xe5, 0x3b, 0x6a,
+        0x27, 0xca, 0x8e, 0x43, 0xb6, 0x05, 0x6e, 0x1b, 0x2c, 0xcd, 0x1b, 0xeb,
+        0x63, 0x4c, 0x6c, 0x1b, 0x2e, 0xa6, 0x9a, 0xa2, 0x89, 0x9c, 0xe3, 0x68,
+        0x49, 0xa8, 0xa2, 0x40, 0xb7, 0x6c, 0x2b, 0xad, 0x54, 0x8a, 0x8d, 0x1d,
+        0x25, 0xbe, 0xae, 0xba, 0xaa, 0x0e, 0xa2, 0xcf, 0x08, 0x8d, 0xb2, 0xe8,
+        0x95, 0xc8, 0xe0, 0xba, 0x69, 0x27, 0xcb, 0x49, 0x38, 0x59, 0xa1, 0x32,
+        0x93, 0xdb, 0x56, 0x42, 0x31, 0x6b, 0x49, 0x53, 0x29, 0x86, 0x4c, 0x4a,
+        0xa3, 0x70, 0x74, 0xea, 0x67, 0x75, 0x27, 0x13, 0x46, 0xd7, 0x1a, 0x98,
+        0x51, 0xb3, 0x6c, 0xe4, 0x34, 0xdb, 0x9c, 0xbd, 0x35, 0x34, 0x68, 0xde,
+        0xbd, 0xbd, 0xac, 0xee, 0xcd, 0xac, 0xbc, 0x49, 0xed, 0xd6, 0xc7, 0x7b,
+        0xb5, 0xa8, 0xaf, 0x6e, 0xb6, 0x6b, 0xdd, 0xad, 0x51, 0x73, 0x75, 0xb1,
+        0x20, 0xcd, 0x6b, 0xa4, 0x14, 0x2d, 0x84, 0xe8, 0x63, 0x52, 0x90, 0x8c,
+        0x90, 0x77, 0x8c, 0x52, 0xdd, 0xd2, 0xa9, 0xb5, 0xca, 0x4b, 0x60, 0xc1,
+        0x3e, 0x4c, 0x79, 0xab, 0x40, 0x5c, 0xe9, 0x32, 0xab, 0xee, 0x82, 0xe8,
+        0x05, 0x10, 0x59, 0x1f, 0xa3, 0x50, 0x17, 0x72, 0x56, 0xda, 0xf9, 0xa0,
+        0xba, 0x0a, 0x84, 0xc6, 0xc7, 0xf6, 0xd5, 0x05, 0x4b, 0x10, 0xae, 0xbe,
+        0x08, 0x2e, 0x88, 0xa5, 0x15, 0x31, 0xff, 0x35, 0x41, 0x1e, 0xd5, 0xc9,
+        0xaf, 0x86, 0x0b, 0xa3, 0x87, 0x46, 0x54, 0x7f, 0x4d, 0x50, 0x40, 0xd1,
+        0x0b, 0x2b, 0xe8, 0x82, 0xe8, 0x9c, 0xbd, 0x35, 0x03, 0xc0, 0xde, 0x7d,
+        0x2d, 0xac, 0xde, 0xad, 0xac, 0xbc, 0x74, 0xd7, 0x8d, 0xec, 0xb6, 0x51,
+        0x14, 0x9b, 0xca, 0xa1, 0x60, 0x08, 0xee, 0x14, 0x00, 0xb5, 0x68, 0xcd,
+        0x94, 0x45, 0x8f, 0x94, 0xd9, 0x19, 0x02, 0x3b, 0x81, 0xc3, 0xc6, 0xd3,
+        0xb7, 0x65, 0x11, 0x77, 0xa6, 0x52, 0x71, 0xc0, 0x8e, 0xe0, 0x04, 0x0d,
+        0x14, 0x14, 0xd9, 0x44, 0x5e, 0xca, 0xf1, 0x9d, 0x30, 0x23, 0xb8, 0x16,
+        0x19, 0x55, 0x26, 0xf6, 0x51, 0x16, 0x8c, 0x16, 0xa5, 0x00, 0x08, 0xee,
+        0x11, 0x92, 0x9b, 0x63, 0xed, 0x94, 0x45, 0x3b, 0x78, 0xd8, 0x70, 0x82,
+        0x3b, 0x87, 0x1c, 0xca, 0x5d, 0xeb, 0x65, 0x11, 0x41, 0x41, 0xa2, 0x01,
+        0x00, 0x8e, 0xe1, 0xd3, 0x5e, 0x37, 0xb2, 0xd9, 0x44, 0x52, 0x6f, 0x2a,
+        0x85, 0x80, 0x23, 0xb8,
+};
+
+// 48000 Hz mono, 16 blocks, 4 subbands, bitpool 31: -b:a 100k -sbc_delay 0.003
+static const uint8_t kSbcVectorMono48[1088] = {
+        0x9c, 0xf0, 0x1f, 0xab, 0xdc, 0xaa, 0x7f, 0x5f, 0x9f, 0xbe, 0xfe, 0x40,
+        0xbd, 0x7d, 0xd5, 0x75, 0x79, 0x13, 0xa5, 0x20, 0x72, 0x41, 0xfc, 0xc5,
+        0x67, 0x67, 0x3c, 0x25, 0xb0, 0xde, 0x67, 0xa7, 0x8e, 0x54, 0x70, 0xac,
+        0x5d, 0xda, 0xdd, 0x69, 0x2f, 0xe2, 0x40, 0xab, 0x57, 0x55, 0x7c, 0xbf,
+        0x14, 0xf7, 0x05, 0x26, 0x07, 0x59, 0xe1, 0xdb, 0x67, 0x8b, 0xcc, 0x29,
+        0x47, 0xf8, 0x65, 0xaf, 0x09, 0xb0, 0x3e, 0x5f, 0x9c, 0xf0, 0x1f, 0x1e,
+        0xda, 0xaa, 0x52, 0x5d, 0xac, 0xb0, 0xf3, 0xc8, 0xe1, 0x8a, 0x9f, 0x8a,
+        0xa3, 0x96, 0x7d, 0x57, 0x91, 0x9e, 0xc2, 0x49, 0xf2, 0x7a, 0x8a, 0xec,
+        0x45, 0xe4, 0xd6, 0x4a, 0xb0, 0xb3, 0x54, 0x53, 0x24, 0x3f, 0xa6, 0x54,
+        0x30, 0x34, 0x57, 0xb2, 0x50, 0x56, 0x59, 0xa8, 0xa2, 0x98, 0x74, 0xa1,
+        0xa8, 0x39, 0xad, 0x5b, 0xd4, 0xaa, 0x83, 0xba, 0x73, 0xb5, 0xd6, 0x90,
+        0x77, 0x3a, 0x48, 0x92, 0x9c, 0xf0, 0x1f, 0x80, 0xd9, 0x9a, 0xd8, 0x0b,
+        0xe4, 0xcb, 0x3d, 0xfc, 0x91, 0x05, 0xb0, 0x06, 0xba, 0x89, 0xf7, 0xde,
+        0xad, 0x42, 0x01, 0xad, 0x27, 0x61, 0x98, 0x2c, 0x0c, 0x95, 0x24, 0xce,
+        0xf2, 0xc0, 0x13, 0xd3, 0xb7, 0xa4, 0xe6, 0x57, 0xa1, 0xa5, 0xda, 0xaa,
+        0xdb, 0xc9, 0xca, 0xe7, 0x1e, 0xca, 0x33, 0x2b, 0x19, 0x22, 0x1d, 0xc5,
+        0x6d, 0x39, 0x4b, 0x8e, 0xd0, 0x1a, 0xca, 0xa1, 0x8b, 0xe8, 0xda, 0xd0,
+        0x9c, 0xf0, 0x1f, 0x73, 0xda, 0x99, 0x10, 0x56, 0x12, 0xfa, 0x98, 0x34,
+        0xeb, 0x15, 0xec, 0x76, 0x9f, 0xd5, 0x77, 0x21, 0x5a, 0xed, 0x7d, 0x7a,
+        0x79, 0x9d, 0x56, 0x76, 0x04, 0x74, 0x85, 0xf6, 0xe2, 0xc9, 0xf2, 0xc6,
+        0x4f, 0x67, 0xea, 0x13, 0xb8, 0x80, 0x39, 0x47, 0xc4, 0x82, 0xb5, 0x75,
+        0x20, 0xa5, 0x07, 0x2e, 0x05, 0x0a, 0x3c, 0xbe, 0x10, 0x5b, 0x7d, 0x4c,
+        0x29, 0x03, 0x5f, 0xb0, 0x66, 0x12, 0xb2, 0x18, 0x9c, 0xf0, 0x1f, 0x1e,
+        0xda, 0xaa, 0xe7, 0xef, 0x58, 0xc5, 0xad, 0x1c, 0x46, 0x3e, 0x3e, 0x8f,
+        0xc2, 0xe3, 0x7c, 0xff, 0x92, 0x24, 0x4a, 0x86, 0x1d, 0xe3, 0x95, 0x4d,
+        0x37, 0x44, 0x93, 0xdb, 0x19, 0x20, 0x69, 0x75, 0x9d, 0x79, 0x24, 0x28,
+        0x59, 0x56, 0x3a, 0xaf, 0x8f, 0x35, 0x97, 0x5c, 0xaf, 0x78, 0xe8, 0xa2,
+        0x2c, 0xc1, 0x3e, 0x22, 0x54, 0x4b, 0x65, 0x29, 0x57, 0xe8, 0xba, 0x6c,
+        0x9d, 0xeb, 0xaa, 0xdd, 0x9c, 0xf0, 0x1f, 0x1e, 0xda, 0xaa, 0x26, 0x9b,
+        0xa9, 0xc2, 0x12, 0x69, 0xcb, 0xa1, 0x0d, 0x26, 0xc2, 0xb3, 0xed, 0x85,
+        0x3a, 0x6a, 0x66, 0x4d, 0x9d, 0x5a, 0x3d, 0x5d, 0x53, 0xfd, 0x6c, 0x87,
+        0x30, 0x6b, 0x24, 0x2b, 0x62, 0x9a, 0x2d, 0x51, 0x40, 0xe3, 0x35, 0x22,
+        0x90, 0xfa, 0x7b, 0xa3, 0xa8, 0xcb, 0x02, 0xb5, 0x71, 0x05, 0xd5, 0xfc,
+        0x2a, 0x7b, 0x95, 0xe6, 0xde, 0x83, 0xe5, 0x71, 0xd4, 0x8f, 0x4a, 0x1b,
+        0x9c, 0xf0, 0x1f, 0x73, 0xda, 0x99, 0xcb, 0x61, 0xba, 0x8b, 0xed, 0xdb,
+        0xda, 0x13, 0x5e, 0x43, 0xb1, 0x24, 0xa2, 0xbf, 0xe8, 0xd6, 0xaa, 0x1c,
+        0x12, 0xe8, 0x04, 0xe2, 0x64, 0x85, 0x3a, 0xe5, 0xf7, 0x8c, 0x50, 0x4e,
+        0x0e, 0x52, 0x1f, 0x6a, 0x19, 0x00, 0xc6, 0xa4, 0x56, 0x90, 0x87, 0x20,
+        0x5e, 0x66, 0x63, 0x49, 0x7e, 0xad, 0xde, 0x75, 0x39, 0xf2, 0x8b, 0xc5,
+        0x65, 0xb7, 0x4c, 0x2d, 0xb4, 0xa5, 0x4d, 0x21, 0x9c, 0xf0, 0x1f, 0x1e,
+        0xda, 0xaa, 0x3a, 0xe0, 0x31, 0x4c, 0x3e, 0x54, 0x57, 0x9c, 0x36, 0x88,
+        0x73, 0x02, 0x6c, 0xb1, 0x23, 0x77, 0xa1, 0x91, 0xfb, 0xf5, 0xf4, 0x15,
+        0x57, 0xb2, 0xfb, 0xa6, 0x8c, 0x78, 0x94, 0x92, 0x9d, 0xda, 0x09, 0x16,
+        0x2f, 0x34, 0x4c, 0x33, 0x61, 0xc2, 0x6c, 0x91, 0x41, 0xec, 0xbd, 0x15,
+        0xe1, 0x79, 0xf1, 0x8a, 0xe2, 0xfe, 0x34, 0x77, 0x15, 0x33, 0xf7, 0x8a,
+        0xc2, 0x15, 0xb0, 0x23, 0x9c, 0xf0, 0x1f, 0x54, 0xda, 0x9a, 0xab, 0x62,
+        0x0b, 0x3f, 0xab, 0xd5, 0x23, 0xa3, 0xa8, 0x90, 0x7e, 0xce, 0xda, 0xf4,
+        0xf2, 0x59, 0xd2, 0x45, 0xfc, 0xcb, 0xfb, 0x9a, 0x96, 0x91, 0xb4, 0x9b,
+        0xb8, 0x8d, 0x95, 0x84, 0xcf, 0x17, 0x20, 0x2e, 0x4e, 0x9a, 0x13, 0xe0,
+        0x46, 0x22, 0x7e, 0x9d, 0x2d, 0x34, 0x8f, 0x92, 0x1d, 0x55, 0x72, 0x0c,
+        0xfd, 0x14, 0xe3, 0xaa, 0x35, 0xf3, 0xf6, 0x0b, 0x50, 0xd3, 0x18, 0x9a,
+        0x9c, 0xf0, 0x1f, 0x39, 0xda, 0xa9, 0x6b, 0x9d, 0x21, 0x24, 0x84, 0x2d,
+        0xb9, 0x38, 0x65, 0x9d, 0xa8, 0x70, 0x86, 0x91, 0x13, 0x75, 0x2d, 0x39,
+        0x9d, 0x0f, 0x83, 0xa1, 0xd9, 0xed, 0x77, 0xba, 0x27, 0xe9, 0x6f, 0xcf,
+        0x46, 0xee, 0xa4, 0x5f, 0x69, 0xa1, 0xc3, 0xd5, 0x7a, 0x5c, 0x74, 0x85,
+        0xcb, 0x83, 0x51, 0x85, 0x14, 0xe9, 0x8a, 0x0d, 0xa4, 0x24, 0xfc, 0x59,
+        0x82, 0x37, 0xf7, 0x91, 0x27, 0xc6, 0x10, 0xea, 0x9c, 0xf0, 0x1f, 0x1e,
+        0xda, 0xaa, 0x7b, 0x16, 0x95, 0xb9, 0x59, 0xd0, 0x31, 0xbf, 0x37, 0x49,
+        0x74, 0xd7, 0x75, 0x45, 0x74, 0xfd, 0xc1, 0xd2, 0x2c, 0x53, 0x12, 0x6b,
+        0x36, 0x99, 0x84, 0x67, 0xd0, 0x22, 0x6e, 0xb5, 0x5f, 0x25, 0xa0, 0x2d,
+        0x22, 0x25, 0x58, 0x4b, 0x4d, 0x1b, 0x4e, 0x8c, 0xf3, 0xe4, 0x99, 0x5d,
+        0xaa, 0x4a, 0xa6, 0xfc, 0x9a, 0xb4, 0xb3, 0xd7, 0xfd, 0x6c, 0x26, 0x6d,
+        0xea, 0x90, 0x14, 0xc9, 0x9c, 0xf0, 0x1f, 0x1e, 0xda, 0xaa, 0x91, 0x23,
+        0xa2, 0x3e, 0xca, 0xa2, 0xbe, 0x69, 0x15, 0x3a, 0x8e, 0xd1, 0x02, 0xe8,
+        0xa2, 0x01, 0x59, 0xd2, 0x6c, 0x49, 0xe0, 0xf4, 0x34, 0x1f, 0xa5, 0xd7,
+        0x27, 0xd6, 0x14, 0x16, 0xdc, 0xd2, 0x16, 0x5e, 0x5d, 0xd3, 0x57, 0x3d,
+        0x57, 0x52, 0x21, 0x90, 0x84, 0xa3, 0x39, 0xb2, 0x97, 0x0d, 0x7e, 0x35,
+        0x07, 0xf3, 0x2a, 0xc6, 0x48, 0x49, 0x77, 0xf3, 0x8c, 0x51, 0x4f, 0x5a,
+        0x9c, 0xf0, 0x1f, 0x98, 0xfd, 0xdd, 0x73, 0xdf, 0x40, 0x80, 0xfe, 0xc1,
+        0x7b, 0x0e, 0x28, 0x86, 0xfd, 0xf4, 0x6e, 0xe2, 0x4b, 0xb9, 0x0b, 0x85,
+        0xeb, 0x06, 0xaf, 0x53, 0xf2, 0x62, 0x3a, 0xb6, 0x6f, 0x66, 0xa7, 0xe0,
+        0x42, 0x54, 0x02, 0x33, 0xbe, 0x8b, 0x97, 0xab, 0x1f, 0x15, 0x8c, 0x56,
+        0xb4, 0xd7, 0xbb, 0x0d, 0x32, 0xe7, 0xaa, 0x19, 0x31, 0x25, 0x4b, 0x37,
+        0xb3, 0x54, 0x10, 0x21, 0x2a, 0x01, 0x19, 0xdf, 0x9c, 0xf0, 0x1f, 0x98,
+        0xfd, 0xdd, 0x45, 0xcb, 0xd5, 0x8f, 0x8a, 0xc6, 0x2b, 0x5a, 0x6b, 0xdd,
+        0x86, 0x99, 0x73, 0xd5, 0x0c, 0x98, 0x92, 0xa5, 0x9b, 0xd9, 0xaa, 0x08,
+        0x10, 0x95, 0x00, 0x8c, 0xef, 0xa2, 0xe5, 0xea, 0xc7, 0xc5, 0x63, 0x15,
+        0xad, 0x35, 0xee, 0xc3, 0x4c, 0xb9, 0xea, 0x86, 0x4c, 0x49, 0x52, 0xcd,
+        0xec, 0xd5, 0x04, 0x08, 0x4a, 0x80, 0x46, 0x77, 0xd1, 0x72, 0xf5, 0x63,
+        0xe2, 0xb1, 0x8a, 0xd6, 0x9c, 0xf0, 0x1f, 0x98, 0xfd, 0xdd, 0x9a, 0xf7,
+        0x61, 0xa6, 0x5c, 0xf5, 0x43, 0x26, 0x24, 0xa9, 0x66, 0xf6, 0x6a, 0x82,
+        0x04, 0x25, 0x40, 0x23, 0x3b, 0xe8, 0xb9, 0x7a, 0xb1, 0xf1, 0x58, 0xc5,
+        0x6b, 0x4d, 0x7b, 0xb0, 0xd3, 0x2e, 0x7a, 0xa1, 0x93, 0x12, 0x54, 0xb3,
+        0x7b, 0x35, 0x41, 0x02, 0x12, 0xa0, 0x11, 0x9d, 0xf4, 0x5c, 0xbd, 0x58,
+        0xf8, 0xac, 0x62, 0xb5, 0xa6, 0xbd, 0xd8, 0x69, 0x97, 0x3d, 0x50, 0xc9,
+        0x9c, 0xf0, 0x1f, 0x98, 0xfd, 0xdd, 0x89, 0x2a, 0x59, 0xbd, 0x9a, 0xa0,
+        0x81, 0x09, 0x50, 0x08, 0xce, 0xfa, 0x2e, 0x5e, 0xac, 0x7c, 0x56, 0x31,
+        0x5a, 0xd3, 0x5e, 0xec, 0x34, 0xcb, 0x9e, 0xa8, 0x64, 0xc4, 0x95, 0x2c,
+        0xde, 0xcd, 0x50, 0x40, 0x84, 0xa8, 0x04, 0x67, 0x7d, 0x17, 0x2f, 0x56,
+        0x3e, 0x2b, 0x18, 0xad, 0x69, 0xaf, 0x76, 0x1a, 0x65, 0xcf, 0x54, 0x32,
+        0x62, 0x4a, 0x96, 0x6f, 0x66, 0xa8, 0x20, 0x42,
+};
+
+// 32000 Hz joint stereo, 8 blocks, 4 subbands, bitpool 35:
+// -b:a 450k -sbc_delay 0.0025
+static const uint8_t kSbcVectorJointStereo32[1408] = {
+        0x9c, 0x5c, 0x23, 0x13, 0xed, 0xba, 0xab, 0xa9, 0xa7, 0xef, 0x76, 0xfb,
+        0xb6, 0xfd, 0xee, 0xdf, 0x76, 0xdd, 0xb5, 0xdb, 0xae, 0xdb, 0xa9, 0x24,
+        0x76, 0x14, 0x34, 0x25, 0xc8, 0x99, 0xc7, 0xdb, 0x85, 0x84, 0x89, 0xf3,
+        0x9e, 0x55, 0x06, 0x4b, 0x83, 0xbd, 0x16, 0xa0, 0x9c, 0x5c, 0x23, 0x77,
+        0xed, 0x98, 0x9c, 0x99, 0xab, 0x68, 0x72, 0xf4, 0x47, 0x8f, 0x16, 0xe4,
+        0xcc, 0xb1, 0x9c, 0x5a, 0x54, 0xcd, 0x39, 0x16, 0x96, 0x21, 0x8c, 0x74,
+        0xd0, 0x32, 0x4d, 0x50, 0x51, 0x26, 0x4d, 0x3b, 0x61, 0x17, 0x4d, 0xa3,
+        0x84, 0xa4, 0xd8, 0xc0, 0x9c, 0x5c, 0x23, 0x18, 0x4d, 0x99, 0x9c, 0xa9,
+        0xa4, 0xe9, 0x92, 0xb7, 0x1a, 0xee, 0x00, 0x1f, 0x45, 0x2a, 0xaa, 0x62,
+        0xd8, 0x16, 0x61, 0x70, 0x32, 0xcb, 0xec, 0x92, 0x94, 0xc4, 0x5a, 0x9e,
+        0x96, 0x6c, 0x32, 0x4b, 0xb8, 0xf5, 0xc5, 0x34, 0x5d, 0x2c, 0x2d, 0xa0,
+        0x9c, 0x5c, 0x23, 0x9d, 0xec, 0x98, 0xad, 0x98, 0x85, 0xed, 0x91, 0x4a,
+        0x5a, 0x99, 0xad, 0x99, 0xbe, 0x93, 0x41, 0xc2, 0x55, 0xd4, 0x11, 0x96,
+        0x90, 0x60, 0xa0, 0xa6, 0x9c, 0x4c, 0x15, 0x2b, 0x4c, 0xaa, 0x17, 0x0b,
+        0xe3, 0xaa, 0xd4, 0xea, 0x95, 0x58, 0x32, 0x80, 0x9c, 0x5c, 0x23, 0xc6,
+        0xec, 0x99, 0xac, 0x99, 0xab, 0x0d, 0x53, 0xe9, 0x56, 0xa5, 0xce, 0x68,
+        0x82, 0xc8, 0x37, 0x3a, 0xcd, 0x18, 0xa3, 0x7a, 0xd9, 0x62, 0x10, 0x70,
+        0xc9, 0x55, 0x21, 0x15, 0xe8, 0x75, 0x6d, 0x45, 0xd9, 0x30, 0x0d, 0xcf,
+        0xba, 0x6b, 0xcd, 0xc0, 0x9c, 0x5c, 0x23, 0x1b, 0xed, 0xaa, 0x9b, 0x98,
+        0xaa, 0xd6, 0x8c, 0xda, 0xa7, 0x84, 0x90, 0xe8, 0x60, 0xb4, 0x34, 0x9f,
+        0x54, 0xd5, 0x87, 0xb2, 0xed, 0x81, 0x8e, 0x99, 0x11, 0xe6, 0x4e, 0x9d,
+        0x45, 0xb3, 0x2d, 0x55, 0x1c, 0x97, 0x16, 0x9b, 0x62, 0xc0, 0x18, 0xb0,
+        0x9c, 0x5c, 0x23, 0xf9, 0x6d, 0x99, 0xac, 0x9a, 0x91, 0x34, 0xa0, 0x12,
+        0xb4, 0x98, 0x6b, 0x00, 0x8b, 0xa0, 0x33, 0x64, 0x21, 0xcd, 0x72, 0xad,
+        0x6c, 0x52, 0xcf, 0x54, 0xb9, 0x78, 0x9d, 0x5a, 0x39, 0xac, 0xcb, 0x79,
+        0xc5, 0x90, 0x61, 0xca, 0x8b, 0x75, 0x4c, 0xe0, 0x9c, 0x5c, 0x23, 0xf2,
+        0x6d, 0x99, 0x9c, 0x98, 0x96, 0x2a, 0xb3, 0xe2, 0x98, 0x7e, 0x6b, 0x72,
+        0x61, 0x05, 0xda, 0xbb, 0x89, 0x48, 0x67, 0xc7, 0x31, 0x22, 0x48, 0xf4,
+        0xdc, 0xda, 0x90, 0x0e, 0xca, 0x18, 0xc2, 0xba, 0x2b, 0x27, 0xa3, 0x68,
+        0x68, 0x82, 0x19, 0x30, 0x9c, 0x5c, 0x23, 0xb8, 0xec, 0xa9, 0xad, 0x9a,
+        0x8a, 0x70, 0x27, 0x64, 0x43, 0x7c, 0xed, 0x5f, 0x65, 0x22, 0x42, 0x29,
+        0x30, 0xcb, 0x54, 0xb6, 0xe5, 0xd5, 0x54, 0x57, 0x15, 0x6b, 0xa7, 0xa4,
+        0x19, 0xd8, 0x79, 0x2b, 0x9d, 0x30, 0x74, 0xcb, 0x82, 0x88, 0x8e, 0xe0,
+        0x9c, 0x5c, 0x23, 0x17, 0x2d, 0xa9, 0x9c, 0x99, 0xa7, 0x92, 0x2b, 0xbd,
+        0x47, 0x57, 0x29, 0xdc, 0xd6, 0xf6, 0x2e, 0xc9, 0x2c, 0x5f, 0x68, 0x38,
+        0xc6, 0x1b, 0xd0, 0x84, 0x56, 0x1b, 0xb3, 0xf0, 0x21, 0x57, 0x6d, 0xab,
+        0x02, 0x0a, 0xd5, 0x1d, 0x62, 0xa0, 0x4a, 0x20, 0x9c, 0x5c, 0x23, 0x2e,
+        0xed, 0x99, 0xac, 0x98, 0xa4, 0x51, 0x2d, 0x13, 0x14, 0x76, 0x36, 0x12,
+        0x49, 0x19, 0x9b, 0x24, 0x6c, 0xec, 0x23, 0x98, 0xdb, 0x93, 0xab, 0x18,
+        0xe3, 0x43, 0x77, 0xd5, 0x6c, 0xd3, 0xb7, 0x6c, 0x22, 0xb9, 0x64, 0xe0,
+        0x4d, 0x94, 0x96, 0x30, 0x9c, 0x5c, 0x23, 0x56, 0xad, 0x99, 0xac, 0x99,
+        0xa9, 0x69, 0x09, 0xd4, 0x44, 0xfd, 0x99, 0x34, 0x3a, 0x95, 0x04, 0xd5,
+        0x32, 0xda, 0x1a, 0x46, 0x72, 0x55, 0x34, 0xd1, 0x10, 0x4c, 0x89, 0x10,
+        0xdc, 0xa6, 0xcd, 0x7a, 0x33, 0xb4, 0x09, 0xbe, 0x75, 0x9b, 0x1a, 0x30,
+        0x9c, 0x5c, 0x23, 0x81, 0xec, 0x99, 0xad, 0xa9, 0x9c, 0x0d, 0x15, 0x6a,
+        0x97, 0xe6, 0x92, 0xb8, 0xf9, 0x3b, 0x9b, 0x53, 0xcf, 0x15, 0xfa, 0x8d,
+        0xed, 0x6c, 0x9e, 0x10, 0xad, 0x8b, 0x50, 0x9a, 0x23, 0xf3, 0x89, 0x5a,
+        0xda, 0x6a, 0xa4, 0x9e, 0xab, 0x0f, 0x9a, 0x20, 0x9c, 0x5c, 0x23, 0x7a,
+        0xcb, 0x99, 0xad, 0x99, 0x91, 0xd1, 0x6a, 0xc7, 0xa0, 0xcd, 0xe3, 0x81,
+        0x26, 0xe5, 0x35, 0x94, 0x0e, 0x6e, 0x73, 0x72, 0xea, 0xdb, 0xe7, 0x29,
+        0x69, 0x82, 0xd7, 0x0c, 0xbd, 0x03, 0x65, 0x47, 0x67, 0x3b, 0x2c, 0x18,
+        0xad, 0x9f, 0xd8, 0xa0, 0x9c, 0x5c, 0x23, 0x8a, 0x0d, 0x99, 0x9c, 0xa9,
+        0x94, 0xb8, 0xd4, 0x72, 0xb2, 0x3e, 0x1a, 0xb0, 0xe6, 0x83, 0x8c, 0x18,
+        0x1f, 0xa2, 0x28, 0x4b, 0xd2, 0x2c, 0x80, 0xf0, 0x7e, 0x6c, 0xd5, 0xb2,
+        0x2d, 0xac, 0x67, 0x23, 0x95, 0x70, 0xee, 0x78, 0xc0, 0xe2, 0xde, 0xd0,
+        0x9c, 0x5c, 0x23, 0x8a, 0x0d, 0x99, 0x9c, 0xa9, 0x9d, 0xa9, 0x9b, 0xb9,
+        0x99, 0x25, 0x4b, 0x4a, 0x64, 0x59, 0x4d, 0xc4, 0x27, 0x9a, 0x05, 0xb8,
+        0x52, 0x64, 0x25, 0x12, 0x00, 0x2d, 0x02, 0xe0, 0xc2, 0x50, 0x05, 0x38,
+        0x48, 0xc7, 0x05, 0x39, 0x69, 0x20, 0x39, 0x40, 0x9c, 0x5c, 0x23, 0x06,
+        0x2d, 0x99, 0xac, 0x99, 0x9a, 0x34, 0xea, 0xa0, 0xb9, 0x91, 0x9a, 0x65,
+        0x93, 0xbb, 0x73, 0x3e, 0x09, 0x66, 0xd1, 0xe3, 0xea, 0x9a, 0x9f, 0x52,
+        0xfc, 0xaa, 0x6d, 0x81, 0x95, 0x14, 0x24, 0xe4, 0x53, 0x90, 0x82, 0x0c,
+        0x44, 0x6b, 0xd1, 0x20, 0x9c, 0x5c, 0x23, 0x61, 0x6d, 0x99, 0x9d, 0x98,
+        0xa0, 0xac, 0xb1, 0x76, 0xea, 0x8c, 0xdb, 0x28, 0x00, 0xa1, 0x4c, 0x24,
+        0x36, 0x6d, 0x18, 0x96, 0x76, 0x64, 0xd5, 0x4e, 0x96, 0xbb, 0x5d, 0xd0,
+        0x8b, 0x67, 0xcf, 0x58, 0xd3, 0x7a, 0x96, 0x4a, 0x4b, 0x91, 0x41, 0x30,
+        0x9c, 0x5c, 0x23, 0x8e, 0xab, 0x99, 0x9d, 0xa8, 0x9a, 0x3a, 0xa3, 0x12,
+        0xa4, 0xb4, 0x16, 0x49, 0x24, 0x91, 0xc3, 0x85, 0x95, 0x21, 0x03, 0x84,
+        0xb2, 0x21, 0x4c, 0x90, 0xae, 0x8b, 0x72, 0x15, 0x37, 0x4e, 0x2f, 0x45,
+        0xad, 0x3e, 0x6c, 0x70, 0x36, 0xed, 0x3f, 0x40, 0x9c, 0x5c, 0x23, 0xb0,
+        0xec, 0x9a, 0xad, 0x98, 0x9c, 0x52, 0xcf, 0x44, 0x6d, 0x31, 0x27, 0x63,
+        0x65, 0x14, 0xcb, 0x9a, 0xf2, 0x8a, 0x22, 0x97, 0x11, 0x84, 0x39, 0x16,
+        0x99, 0xbd, 0x41, 0xd9, 0xda, 0xad, 0x0c, 0x92, 0xb4, 0x3e, 0x04, 0xb5,
+        0x59, 0x89, 0x9e, 0x50, 0x9c, 0x5c, 0x23, 0xeb, 0x4d, 0x99, 0x9c, 0x99,
+        0x98, 0x16, 0xd7, 0x7a, 0xc5, 0x54, 0x88, 0x7e, 0x7c, 0xf2, 0x94, 0xaf,
+        0x24, 0xef, 0x7a, 0x73, 0x70, 0xc0, 0xd2, 0x14, 0x62, 0xca, 0x92, 0xa1,
+        0xcb, 0x77, 0x35, 0x9e, 0x8a, 0x40, 0xc5, 0x1f, 0x39, 0xa4, 0xd6, 0xc0,
+        0x9c, 0x5c, 0x23, 0xb4, 0xcd, 0x9a, 0x9c, 0x99, 0x92, 0xcc, 0xc9, 0x2c,
+        0xda, 0x48, 0x9a, 0x2d, 0x1a, 0x54, 0x9b, 0x97, 0x05, 0x23, 0xd3, 0xc9,
+        0x0e, 0xf6, 0x90, 0x4d, 0x6a, 0x20, 0x35, 0xdd, 0xee, 0x38, 0x47, 0x13,
+        0xb1, 0xc5, 0x7a, 0xe0, 0x46, 0x73, 0xce, 0x10, 0x9c, 0x5c, 0x23, 0xab,
+        0xec, 0x99, 0xac, 0x9a, 0x9d, 0x2a, 0xea, 0xbc, 0x87, 0x43, 0x6a, 0x39,
+        0x32, 0x96, 0xce, 0x44, 0x99, 0x91, 0x08, 0x4c, 0x46, 0x14, 0x02, 0x2d,
+        0x8a, 0x86, 0x26, 0x99, 0xa6, 0x89, 0x31, 0x46, 0x29, 0x6d, 0x9d, 0x34,
+        0x52, 0xf9, 0x9b, 0x80, 0x9c, 0x5c, 0x23, 0x2e, 0x6d, 0x89, 0xac, 0x99,
+        0x9c, 0xd4, 0x70, 0x43, 0x39, 0xe9, 0xf1, 0x16, 0x99, 0xb5, 0x26, 0xb5,
+        0x0a, 0xac, 0xad, 0x5d, 0x06, 0xa2, 0x63, 0x72, 0xe9, 0x9a, 0x47, 0x69,
+        0xae, 0x21, 0x98, 0x80, 0x3b, 0xeb, 0x02, 0x85, 0x7c, 0x9f, 0x4c, 0xa0,
+        0x9c, 0x5c, 0x23, 0xe7, 0xaf, 0xdc, 0xce, 0xdc, 0xc7, 0xee, 0xed, 0x87,
+        0x77, 0x01, 0xdd, 0xbc, 0xee, 0xe0, 0xbc, 0x48, 0x99, 0xdc, 0x06, 0x87,
+        0x24, 0x43, 0x71, 0x97, 0xaf, 0x4b, 0x87, 0xb5, 0xe3, 0x6c, 0x0a, 0x65,
+        0x5e, 0x5b, 0xa4, 0x63, 0x33, 0x70, 0xc6, 0x50, 0x9c, 0x5c, 0x23, 0x80,
+        0xae, 0xdc, 0xde, 0xdd, 0xc2, 0x41, 0x6d, 0xf0, 0x7c, 0x01, 0x74, 0x42,
+        0xcc, 0x7b, 0x83, 0xa9, 0x79, 0x06, 0xda, 0xf2, 0xac, 0x5d, 0x03, 0x4e,
+        0x16, 0x06, 0xc8, 0x4f, 0x5e, 0x4c, 0xc7, 0xd3, 0x87, 0x9f, 0x9c, 0x4a,
+        0x03, 0x61, 0xc4, 0xd0, 0x9c, 0x5c, 0x23, 0xf8, 0x8e, 0xdd, 0xdf, 0xdd,
+        0xc1, 0x8a, 0xa1, 0xd0, 0x6c, 0xfc, 0x15, 0x60, 0xd6, 0x71, 0xdb, 0x97,
+        0x7a, 0x03, 0x9a, 0x90, 0x6c, 0x1d, 0x5a, 0x6a, 0xe6, 0x06, 0xd0, 0x9b,
+        0xbe, 0x2d, 0x65, 0xf0, 0x6b, 0x53, 0xa0, 0x42, 0x55, 0x07, 0xc1, 0xd0,
+        0x9c, 0x5c, 0x23, 0x70, 0xaf, 0xdd, 0xde, 0xdc, 0xc8, 0xa1, 0x2b, 0xb0,
+        0x3c, 0xd6, 0xdc, 0xec, 0xce, 0x5b, 0xd6, 0x80, 0x38, 0xc5, 0x32, 0xd6,
+        0x84, 0x75, 0x8c, 0xdd, 0xfd, 0x08, 0xc8, 0x84, 0xdc, 0xac, 0x25, 0xd2,
+        0x98, 0x1b, 0xa4, 0x61, 0x05, 0x4f, 0xc3, 0xd0, 0x9c, 0x5c, 0x23, 0xa5,
+        0xaf, 0xdc, 0xde, 0xdd, 0xc7, 0x76, 0xa7, 0x10, 0x9c, 0x6e, 0xc4, 0x38,
+        0xc6, 0x66, 0x9b, 0xb5, 0xba, 0x06, 0x26, 0x6f, 0x0c, 0x4d, 0x50, 0x16,
+        0xdf, 0x07, 0xc7, 0x97, 0x44, 0x2c, 0xc6, 0xd8, 0x3a, 0x97, 0x90, 0x57,
+        0xaf, 0x2a, 0xc5, 0xd0, 0x9c, 0x5c, 0x23, 0xf8, 0x8e, 0xdd, 0xdf, 0xdd,
+        0xc0, 0x35, 0x21, 0xb0, 0x6c, 0x84, 0xd5, 0xd2, 0xd6, 0x7d, 0x37, 0x78,
+        0xfa, 0x04, 0xa0, 0xd6, 0x8c, 0x1d, 0x18, 0xaa, 0x1d, 0x06, 0xcf, 0xc1,
+        0x56, 0x0d, 0x67, 0x1d, 0xb9, 0x77, 0xa0, 0x39, 0xa9, 0x06, 0xc1, 0xd0,
+        0x9c, 0x5c, 0x23, 0xe1, 0xae, 0xdd, 0xdf, 0xdc, 0xc5, 0xa6, 0x2e, 0x60,
+        0xbd, 0x09, 0xcb, 0xe2, 0xc6, 0x5f, 0x07, 0xb5, 0x39, 0x44, 0x24, 0xd0,
+        0x7c, 0x75, 0x96, 0x12, 0xad, 0x03, 0xca, 0xed, 0xcd, 0x6c, 0xe5, 0x6d,
+        0x68, 0x3f, 0x8c, 0x65, 0x2d, 0x6c, 0x47, 0x50, 0x9c, 0x5c, 0x23, 0x69,
+        0x8f, 0xdd, 0xde, 0xdd, 0xc8, 0xcd, 0xdf, 0xd0, 0x6c, 0x88, 0x35, 0xca,
+        0xd6, 0x5d, 0x2a, 0x81, 0xba, 0x06, 0x10, 0x54, 0xfc, 0x1d, 0x77, 0x6e,
+        0x71, 0x06, 0xc6, 0xea, 0x43, 0x8d, 0x66, 0x69, 0xab, 0x5b, 0xa0, 0x62,
+        0x6e, 0xf0, 0xc1, 0xd0,
+};
+
+#endif  // ANDROID_AUDIO_SBC_TEST_VECTORS_H
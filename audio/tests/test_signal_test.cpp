@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "AudioMixOps.h"
+#include "AudioTestSignal.h"
+#include "AudioTestUtils.h"
+
+namespace android_audio_legacy {
+
+static void put32(std::vector<uint8_t>* v, uint32_t x) {
+    for (int i = 0; i < 4; i++) v->push_back(uint8_t(x >> (8 * i)));
+}
+
+static void put16(std::vector<uint8_t>* v, uint16_t x) {
+    v->push_back(uint8_t(x));
+    v->push_back(uint8_t(x >> 8));
+}
+
+// A mono 16 bit WAV file holding 0, 1, 2, ... with a chunk before "data".
+static void writeWav(const std::string& path, uint32_t rate, size_t frames) {
+    std::vector<uint8_t> fmt, file;
+    put16(&fmt, 1);
+    put16(&fmt, 1);
+    put32(&fmt, rate);
+    put32(&fmt, rate * 2);
+    put16(&fmt, 2);
+    put16(&fmt, 16);
+    file.insert(file.end(), {'R', 'I', 'F', 'F'});
+    put32(&file, 0);
+    file.insert(file.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+    put32(&file, fmt.size());
+    file.insert(file.end(), fmt.begin(), fmt.end());
+    // odd sized, so the next chunk is padded
+    file.insert(file.end(), {'L', 'I', 'S', 'T'});
+    put32(&file, 3);
+    file.insert(file.end(), {'a', 'b', 'c', 0});
+    file.insert(file.end(), {'d', 'a', 't', 'a'});
+    put32(&file, frames * 2);
+    for (size_t i = 0; i < frames; i++) put16(&file, uint16_t(i));
+    FILE* f = fopen(path.c_str(), "wb");
+    ASSERT_TRUE(f != nullptr) << path << ": " << strerror(errno);
+    EXPECT_EQ(file.size(), fwrite(file.data(), 1, file.size(), f));
+    fclose(f);
+}
+
+TEST(AudioTestSignalTest, LoopsMappedFile) {
+    const size_t kFrames = 1000;
+    const std::string path = tempPath("test_signal.wav");
+    ASSERT_NO_FATAL_FAILURE(writeWav(path, 8000, kFrames));
+    AudioTestSignal signal(8000, 1, AudioSystem::PCM_16_BIT);
+    ASSERT_EQ(NO_ERROR, signal.openFile(path.c_str()));
+    EXPECT_EQ(AudioTestSignal::SIGNAL_FILE, signal.type());
+    EXPECT_EQ(kFrames * 2, signal.loopBytes());
+
+    // reads that straddle the end of the file, several times over
+    std::vector<int16_t> buffer(333);
+    size_t next = 0;
+    for (int i = 0; i < 10; i++) {
+        ASSERT_EQ(buffer.size() * 2, signal.read(buffer.data(), buffer.size() * 2));
+        for (int16_t s : buffer) {
+            ASSERT_EQ(int16_t(next % kFrames), s);
+            next++;
+        }
+    }
+    signal.rewind();
+    ASSERT_EQ(2u, signal.read(buffer.data(), 2));
+    EXPECT_EQ(0, buffer[0]);
+
+    // a file for another configuration is not used
+    AudioTestSignal stereo(8000, 2, AudioSystem::PCM_16_BIT);
+    EXPECT_EQ(BAD_VALUE, stereo.openFile(path.c_str()));
+    EXPECT_EQ(0u, stereo.read(buffer.data(), 2));
+    unlink(path.c_str());
+}
+
+TEST(AudioTestSignalTest, GeneratesDeterministicSignals) {
+    const uint32_t kRate = 48000;
+    const size_t kLoopFrames = kRate * AudioTestSignal::kLoopMs / 1000;
+    AudioTestSignal a(kRate, 2, AudioSystem::PCM_16_BIT), b(kRate, 2, AudioSystem::PCM_16_BIT);
+    std::vector<int16_t> x(kLoopFrames * 2), y(kLoopFrames * 2);
+    for (int type : {AudioTestSignal::SIGNAL_SWEEP, AudioTestSignal::SIGNAL_NOISE}) {
+        ASSERT_EQ(NO_ERROR, a.generate(type));
+        ASSERT_EQ(NO_ERROR, b.generate(type));
+        ASSERT_EQ(kLoopFrames * 4, a.loopBytes());
+        a.read(x.data(), x.size() * 2);
+        b.read(y.data(), y.size() * 2);
+        EXPECT_EQ(x, y) << "type " << type;
+        int peak = 0;
+        for (size_t i = 0; i < x.size(); i += 2) {
+            ASSERT_EQ(x[i], x[i + 1]);
+            peak = std::max(peak, abs(x[i]));
+        }
+        EXPECT_GT(peak, 4096);
+        EXPECT_LE(peak, 16384);
+    }
+
+    AudioTestSignal impulse(8000, 1, AudioSystem::PCM_8_BIT);
+    ASSERT_EQ(NO_ERROR, impulse.generate(AudioTestSignal::SIGNAL_IMPULSE));
+    std::vector<uint8_t> bytes(8000 * AudioTestSignal::kLoopMs / 1000 + 1);
+    impulse.read(bytes.data(), bytes.size());
+    EXPECT_EQ(255, bytes[0]);
+    EXPECT_EQ(128, bytes[1]);
+    EXPECT_EQ(128, bytes[bytes.size() - 2]);
+    // and again at the top of the next loop
+    EXPECT_EQ(255, bytes.back());
+}
+
+TEST(AudioMixOpsTest, GeneratorsMatchScalar) {
+    // odd count to cover the scalar tail
+    const size_t kSamples = 1027;
+    std::vector<float> phase(kSamples);
+    for (size_t i = 0; i < kSamples; i++) phase[i] = float(i) / kSamples;
+    std::vector<int16_t> expected(kSamples), actual(kSamples);
+    sineCycles16Scalar(expected.data(), phase.data(), kSamples, 1.0f);
+    sineCycles16(actual.data(), phase.data(), kSamples, 1.0f);
+    for (size_t i = 0; i < kSamples; i++) {
+        EXPECT_NEAR(expected[i], actual[i], 1) << "at " << i;
+        EXPECT_NEAR(32767.0 * sin(2 * M_PI * phase[i]), expected[i], 1) << "at " << i;
+    }
+
+    AudioDither s0, s1;
+    noise16Scalar(expected.data(), kSamples, &s0, 2);
+    noise16(actual.data(), kSamples, &s1, 2);
+    EXPECT_EQ(expected, actual);
+    for (int16_t s : actual) ASSERT_LT(abs(s), 8192);
+}
+
+}  // namespace android_audio_legacy
@@ -25,6 +25,16 @@ namespace android_audio_legacy {
 
 // ----------------------------------------------------------------------------
 
+/**
+ * The periods a PCM device accepts, for sizing stream buffers.
+ */
+struct AudioPeriodConstraints {
+    uint32_t    rate;           // the frame limits are at this rate; 0 if at any rate
+    uint32_t    minFrames;      // shortest period
+    uint32_t    maxFrames;      // longest period; 0 for no limit
+    uint32_t    alignFrames;    // periods are whole multiples of this
+};
+
 /**
  * AudioHardwareBase is a convenient base class used for implementing the
  * AudioHardwareInterface interface.
@@ -51,6 +61,24 @@ public:
     /**This method dumps the state of the audio hardware */
     virtual status_t dumpState(int fd, const Vector<String16>& args);
 
+    /** target period of the normal and of the AUDIO_OUTPUT_FLAG_FAST profile */
+    static const uint32_t kNormalPeriodUs = 20000;
+    static const uint32_t kFastPeriodUs = 5000;
+    /** 16-frame aligned periods of at least 16 frames, the default for any device */
+    static const AudioPeriodConstraints kDefaultPeriodConstraints;
+
+    /**
+     * Frames per buffer for a stream at sampleRate: periodUs worth, rounded
+     * up to whole alignFrames and kept within the device limits, which are
+     * scaled from constraints.rate when the stream is resampled.
+     */
+    static  size_t      bufferFrames(uint32_t sampleRate, uint32_t periodUs,
+                                     const AudioPeriodConstraints& constraints);
+
+    /** the period of the profile flags ask for */
+    static  uint32_t    periodUsFor(audio_output_flags_t flags, uint32_t normalPeriodUs)
+                            { return (flags & AUDIO_OUTPUT_FLAG_FAST) ? kFastPeriodUs : normalPeriodUs; }
+
 protected:
     /** returns true if the given mode maps to a telephony or VoIP call is in progress */
     virtual bool     isModeInCall(int mode)
@@ -61,15 +61,19 @@ public:
 
     /**
      * return audio format in 8bit or 16bit PCM format -
-     * eg. AudioSystem:PCM_16_BIT
+     * eg. AudioSystem:PCM_16_BIT, or one of the wider AUDIO_FORMAT_PCM_* formats
      */
     virtual int         format() const = 0;
 
     /**
      * return the frame size (number of bytes per sample).
      */
-    uint32_t    frameSize() const { return audio_channel_count_from_out_mask(channels())*
-                            ((format()==AUDIO_FORMAT_PCM_16_BIT)?sizeof(int16_t):sizeof(int8_t)); }
+    uint32_t    frameSize() const {
+                    // non-PCM formats such as AMR_NB count a byte per sample, as
+                    // they always did, rather than 0
+                    size_t bytes = audio_bytes_per_sample((audio_format_t)format());
+                    return audio_channel_count_from_out_mask(channels())*(bytes ? bytes : 1);
+                }
 
     /**
      * return the audio hardware driver latency in milli seconds.
@@ -121,6 +125,34 @@ public:
      */
     virtual status_t    getPresentationPosition(uint64_t *frames, struct timespec *timestamp);
 
+    /**
+     * Allocate a buffer shared with the client for zero-copy playback: the
+     * client writes frames straight into the buffer and the hardware only
+     * advances its read position. minSizeFrames is a hint; the actual buffer
+     * and burst sizes are returned. After this call write() is not used.
+     */
+    virtual status_t    createMmapBuffer(int32_t minSizeFrames, void **buffer, int *fd,
+                                         int32_t *bufferSizeFrames, int32_t *burstSizeFrames);
+
+    /**
+     * Return the number of frames consumed from the mmap buffer and the
+     * CLOCK_MONOTONIC time in ns at which that position was reached.
+     */
+    virtual status_t    getMmapPosition(int64_t *timeNs, int32_t *positionFrames);
+
+    /** start/stop consuming an mmap buffer */
+    virtual status_t    start();
+    virtual status_t    stop();
+
+    /**
+     * Switch an open output to another format or sample rate, 0 keeping the
+     * current one. What was already written plays out in the old
+     * configuration first, so the stream does not have to be closed and
+     * reopened. Returns BAD_VALUE for a configuration the output cannot
+     * take and INVALID_OPERATION if it cannot be switched while open.
+     */
+    virtual status_t    reconfigure(int format, uint32_t sampleRate);
+
 };
 
 /**
@@ -150,8 +182,12 @@ public:
     /**
      * return the frame size (number of bytes per sample).
      */
-    uint32_t    frameSize() const { return audio_channel_count_from_in_mask(channels())*
-                            ((format()==AudioSystem::PCM_16_BIT)?sizeof(int16_t):sizeof(int8_t)); }
+    uint32_t    frameSize() const {
+                    // non-PCM formats such as AMR_NB count a byte per sample, as
+                    // they always did, rather than 0
+                    size_t bytes = audio_bytes_per_sample((audio_format_t)format());
+                    return audio_channel_count_from_in_mask(channels())*(bytes ? bytes : 1);
+                }
 
     /** set the input gain for the audio driver. This method is for
      *  for future use */
@@ -185,6 +221,21 @@ public:
     // Unit: the number of input audio frames
     virtual unsigned int  getInputFramesLost() const = 0;
 
+    /**
+     * Return the number of frames read() has returned so far, counting any
+     * lost to overruns, and the CLOCK_MONOTONIC time in ns at which the next
+     * frame was captured. Lets echo cancellation align capture with playback.
+     */
+    virtual status_t    getCapturePosition(int64_t *frames, int64_t *time);
+
+    /**
+     * Switch an open input to another format or sample rate, 0 keeping the
+     * current one. Capture carries on across the switch. Returns BAD_VALUE
+     * for a configuration the input cannot take and INVALID_OPERATION if it
+     * cannot be switched while open.
+     */
+    virtual status_t    reconfigure(int format, uint32_t sampleRate);
+
     virtual status_t addAudioEffect(effect_handle_t effect) = 0;
     virtual status_t removeAudioEffect(effect_handle_t effect) = 0;
 };
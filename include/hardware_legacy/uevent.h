@@ -17,17 +17,113 @@
 #ifndef _HARDWARE_UEVENT_H
 #define _HARDWARE_UEVENT_H
 
+#include <stdint.h>
+
 #if __cplusplus
 extern "C" {
 #endif
 
+#define UEVENT_SUBSYSTEM_NAME_LEN 32
+#define UEVENT_LATENCY_BUCKETS    20
+
+struct uevent_stats {
+    uint64_t events;        /* datagrams received */
+    uint64_t bytes;
+    uint64_t coalesced;     /* events folded into a later delivery */
+    uint64_t truncated;     /* datagrams larger than the caller's buffer */
+    uint64_t overruns;      /* socket overflows (ENOBUFS), events were lost */
+    uint64_t recv_errors;
+};
+
+struct uevent_subsystem_stats {
+    char subsystem[UEVENT_SUBSYSTEM_NAME_LEN];
+    uint64_t events;
+    uint64_t bytes;
+};
+
+struct uevent_handler_stats {
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    /* latency_hist[i] counts calls taking less than 2^i us (and at least 2^(i-1) us) */
+    uint64_t latency_hist[UEVENT_LATENCY_BUCKETS];
+};
+
 int uevent_init();
+
+/*
+ * Use an already-open datagram or seqpacket socket as the event source
+ * instead of the kernel netlink socket, e.g. one end of a socketpair that
+ * replays a recorded event stream. Takes ownership of the socket and closes
+ * any previously set one. Returns 1 on success, 0 on failure.
+ */
+int uevent_init_fd(int fd);
 int uevent_get_fd();
+
+/*
+ * Block until an event arrives, dispatch it and return its length. The
+ * event is NUL-terminated in buffer, so at most buffer_length - 1 bytes are
+ * received; larger events are truncated. Returns -1 with errno set to
+ * EINVAL if buffer_length is less than 2.
+ *
+ * Native handlers are called with msg_len set to the received length
+ * (not the buffer capacity) and msg[msg_len] == '\0'.
+ */
 int uevent_next_event(char* buffer, int buffer_length);
+
+/*
+ * Non-blocking counterpart of uevent_next_event() for callers that multiplex
+ * the uevent socket into their own event loop. Receives and dispatches every
+ * event already queued on the socket, then returns the number of events
+ * received (0 if none were pending) or -1 on error.
+ */
+int uevent_process_pending(char* buffer, int buffer_length);
+
+/*
+ * Enable coalescing of "change" event storms. Change events for the same
+ * ACTION@DEVPATH arriving within window_ms of the last delivery are collapsed
+ * into one trailing delivery of the latest payload, with UEVENT_COALESCED=<n>
+ * appended giving the number of events folded into it. The final state of a
+ * device is always delivered, and other actions on a DEVPATH flush its
+ * pending change first. A window of 0 (the default) disables coalescing.
+ */
+void uevent_set_coalesce_window_ms(int window_ms);
+
+/*
+ * Milliseconds until the next pending coalesced delivery is due, or -1 if
+ * none. Event loops should use this as their wait timeout and call
+ * uevent_process_pending() when it expires.
+ */
+int uevent_get_timeout_ms();
+
+/*
+ * Register/unregister the uevent socket with an existing epoll instance.
+ * The socket is added for EPOLLIN with cookie stored in epoll_data.ptr; when
+ * it is reported readable, call uevent_process_pending().
+ */
+int uevent_epoll_add(int epoll_fd, void *cookie);
+int uevent_epoll_del(int epoll_fd);
 int uevent_add_native_handler(void (*handler)(void *data, const char *msg, int msg_len),
                               void *handler_data);
 int uevent_remove_native_handler(void (*handler)(void *data, const char *msg, int msg_len));
 
+/*
+ * Instrumentation. Counters are maintained lock-free on the event path and
+ * may be queried from any thread. Subsystems are taken from the SUBSYSTEM=
+ * variable of each event; events without one are counted as "unknown".
+ */
+void uevent_get_stats(struct uevent_stats *stats);
+
+/* Fills up to max_stats entries and returns the number filled */
+int uevent_get_subsystem_stats(struct uevent_subsystem_stats *stats, int max_stats);
+
+/* Returns 0 on success, -1 if the handler is not registered */
+int uevent_get_handler_stats(void (*handler)(void *data, const char *msg, int msg_len),
+                             struct uevent_handler_stats *stats);
+
+/* Write a human-readable summary of all counters to fd */
+int uevent_dump_stats(int fd);
+
 #if __cplusplus
 } // extern "C"
 #endif
@@ -16,12 +16,17 @@
 
 #include <hardware_legacy/uevent.h>
 
+#include <errno.h>
 #include <malloc.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 #include <poll.h>
 #include <pthread.h>
 
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <sys/queue.h>
@@ -34,11 +39,70 @@ pthread_mutex_t uevent_handler_list_lock = PTHREAD_MUTEX_INITIALIZER;
 struct uevent_handler {
     void (*handler)(void *data, const char *msg, int msg_len);
     void *handler_data;
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t latency_hist[UEVENT_LATENCY_BUCKETS];
     LIST_ENTRY(uevent_handler) list;
 };
 
 static int fd = -1;
 
+/*
+ * Instrumentation. Counters are only written by the thread processing
+ * events and use relaxed atomics so they can be read from any thread.
+ * Subsystem slots are claimed by the processing thread and published by
+ * bumping subsystem_count; their names never change afterwards.
+ */
+#define UEVENT_SUBSYSTEM_SLOTS 32
+
+struct uevent_subsystem_counters {
+    char name[UEVENT_SUBSYSTEM_NAME_LEN];
+    uint64_t events;
+    uint64_t bytes;
+};
+
+static struct uevent_stats global_stats;
+static struct uevent_subsystem_counters subsystem_stats[UEVENT_SUBSYSTEM_SLOTS];
+static int subsystem_count = 0;
+static int64_t stats_start_ns = 0;
+
+#define STAT_ADD(field, n) __atomic_fetch_add(&(field), (n), __ATOMIC_RELAXED)
+#define STAT_GET(field) __atomic_load_n(&(field), __ATOMIC_RELAXED)
+
+/*
+ * Optional coalescing of "change" storms. The first change event for a
+ * DEVPATH is delivered immediately and opens a window; further changes for
+ * the same DEVPATH inside the window are folded into one trailing delivery
+ * of the latest payload, tagged with UEVENT_COALESCED=<n>. Any other action
+ * on the DEVPATH flushes the pending change first so ordering is preserved.
+ * Coalescing state is only touched by the thread processing events.
+ */
+#define UEVENT_COALESCE_SLOTS   32
+#define UEVENT_COALESCE_KEY_LEN 256
+
+struct uevent_coalesce_slot {
+    int in_use;
+    char key[UEVENT_COALESCE_KEY_LEN];  /* "ACTION@DEVPATH" header */
+    int64_t deadline_ns;
+    int count;                          /* events folded into msg */
+    char *msg;
+    int msg_len;
+    int msg_size;
+};
+
+static int coalesce_window_ms = 0;
+static int coalesce_slots_in_use = 0;
+static struct uevent_coalesce_slot coalesce_slots[UEVENT_COALESCE_SLOTS];
+
+static int64_t uevent_now_ns()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
 /* Returns 0 on failure, 1 on success */
 int uevent_init()
 {
@@ -63,16 +127,319 @@ int uevent_init()
     }
 
     fd = s;
+    stats_start_ns = uevent_now_ns();
     return (fd > 0);
 }
 
+/* Returns 0 on failure, 1 on success */
+int uevent_init_fd(int s)
+{
+    if (s < 0)
+        return 0;
+
+    if (fd >= 0 && fd != s)
+        close(fd);
+    fd = s;
+    stats_start_ns = uevent_now_ns();
+    return 1;
+}
+
 int uevent_get_fd()
 {
     return fd;
 }
 
+static void uevent_account_handler(struct uevent_handler *h, uint64_t ns)
+{
+    uint64_t us = ns / 1000;
+    int bucket = 0;
+
+    /* bucket i counts calls taking [2^(i-1), 2^i) us; bucket 0 is < 1us */
+    while (us && bucket < UEVENT_LATENCY_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+
+    STAT_ADD(h->calls, 1);
+    STAT_ADD(h->total_ns, ns);
+    STAT_ADD(h->latency_hist[bucket], 1);
+    if (ns > STAT_GET(h->max_ns))
+        __atomic_store_n(&h->max_ns, ns, __ATOMIC_RELAXED);
+}
+
+/* Handlers get the exact payload length; buffer[length] is always NUL. */
+static void uevent_dispatch(const char *buffer, int length)
+{
+    struct uevent_handler *h;
+
+    pthread_mutex_lock(&uevent_handler_list_lock);
+    LIST_FOREACH(h, &uevent_handler_list, list) {
+        int64_t start = uevent_now_ns();
+        h->handler(h->handler_data, buffer, length);
+        uevent_account_handler(h, uevent_now_ns() - start);
+    }
+    pthread_mutex_unlock(&uevent_handler_list_lock);
+}
+
+static struct uevent_subsystem_counters *uevent_subsystem_slot(const char *name, size_t len)
+{
+    int n = __atomic_load_n(&subsystem_count, __ATOMIC_ACQUIRE);
+    int i;
+
+    if (len >= UEVENT_SUBSYSTEM_NAME_LEN)
+        len = UEVENT_SUBSYSTEM_NAME_LEN - 1;
+
+    for (i = 0; i < n; i++) {
+        if (!strncmp(subsystem_stats[i].name, name, len) &&
+                subsystem_stats[i].name[len] == '\0')
+            return &subsystem_stats[i];
+    }
+
+    /* The last slot collects everything once the table is full. */
+    if (n == UEVENT_SUBSYSTEM_SLOTS)
+        return &subsystem_stats[n - 1];
+    if (n == UEVENT_SUBSYSTEM_SLOTS - 1) {
+        len = strlen("other");
+        name = "other";
+    }
+
+    memcpy(subsystem_stats[n].name, name, len);
+    subsystem_stats[n].name[len] = '\0';
+    __atomic_store_n(&subsystem_count, n + 1, __ATOMIC_RELEASE);
+    return &subsystem_stats[n];
+}
+
+static void uevent_account_event(const char *buffer, int count)
+{
+    struct uevent_subsystem_counters *slot;
+    const char *p = buffer;
+    const char *end = buffer + count;
+    const char *subsystem = "unknown";
+    size_t subsystem_len = strlen("unknown");
+
+    STAT_ADD(global_stats.events, 1);
+    STAT_ADD(global_stats.bytes, count);
+
+    while (p < end) {
+        size_t len = strnlen(p, end - p);
+        if (len > 10 && !memcmp(p, "SUBSYSTEM=", 10)) {
+            subsystem = p + 10;
+            subsystem_len = len - 10;
+            break;
+        }
+        p += len + 1;
+    }
+
+    slot = uevent_subsystem_slot(subsystem, subsystem_len);
+    STAT_ADD(slot->events, 1);
+    STAT_ADD(slot->bytes, count);
+}
+
+/*
+ * Receive one datagram, leaving room to NUL-terminate it. Oversized
+ * datagrams are reported through MSG_TRUNC; they are counted and clamped
+ * to the buffer size.
+ */
+static int uevent_recv(char *buffer, int buffer_length, int flags)
+{
+    int capacity = buffer_length - 1;
+    int count;
+
+    if (capacity <= 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    count = recv(fd, buffer, capacity, flags | MSG_TRUNC);
+    if (count > capacity) {
+        STAT_ADD(global_stats.truncated, 1);
+        count = capacity;
+    }
+    if (count >= 0) {
+        buffer[count] = '\0';
+    } else {
+        if (errno == ENOBUFS)
+            STAT_ADD(global_stats.overruns, 1);
+        else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            STAT_ADD(global_stats.recv_errors, 1);
+    }
+    return count;
+}
+
+static void uevent_coalesce_deliver(struct uevent_coalesce_slot *slot)
+{
+    /* msg_size always leaves room for the tag and terminator appended here */
+    int n = snprintf(slot->msg + slot->msg_len, slot->msg_size - slot->msg_len,
+                     "UEVENT_COALESCED=%d", slot->count);
+    slot->msg[slot->msg_len + n + 1] = '\0';
+    uevent_dispatch(slot->msg, slot->msg_len + n + 1);
+    slot->count = 0;
+}
+
+/*
+ * Deliver trailing events whose window has closed. A slot whose window
+ * closes without new events is released; otherwise the trailing delivery
+ * opens a new window so a steady storm yields one delivery per window.
+ */
+static void uevent_coalesce_flush(int64_t now, int window_ms)
+{
+    int i;
+
+    if (coalesce_slots_in_use == 0)
+        return;
+
+    for (i = 0; i < UEVENT_COALESCE_SLOTS; i++) {
+        struct uevent_coalesce_slot *slot = &coalesce_slots[i];
+
+        if (!slot->in_use || (window_ms > 0 && slot->deadline_ns > now))
+            continue;
+        if (slot->count > 0 && window_ms > 0) {
+            uevent_coalesce_deliver(slot);
+            slot->deadline_ns = now + window_ms * 1000000LL;
+        } else {
+            if (slot->count > 0)
+                uevent_coalesce_deliver(slot);
+            slot->in_use = 0;
+            coalesce_slots_in_use--;
+        }
+    }
+}
+
+/* Flush any pending change for the DEVPATH of a non-change event */
+static void uevent_coalesce_flush_devpath(const char *devpath)
+{
+    int i;
+
+    for (i = 0; i < UEVENT_COALESCE_SLOTS; i++) {
+        struct uevent_coalesce_slot *slot = &coalesce_slots[i];
+
+        if (slot->in_use && !strcmp(strchr(slot->key, '@') + 1, devpath)) {
+            if (slot->count > 0)
+                uevent_coalesce_deliver(slot);
+            slot->in_use = 0;
+            coalesce_slots_in_use--;
+        }
+    }
+}
+
+/* Returns 1 if the event was folded into a pending trailing delivery */
+static int uevent_coalesce(const char *buffer, int count, int window_ms)
+{
+    struct uevent_coalesce_slot *slot = NULL;
+    struct uevent_coalesce_slot *free_slot = NULL;
+    const char *devpath;
+    int64_t now = uevent_now_ns();
+    size_t key_len = strnlen(buffer, count);
+    int i;
+
+    uevent_coalesce_flush(now, window_ms);
+
+    devpath = memchr(buffer, '@', key_len);
+    if (devpath == NULL || key_len >= UEVENT_COALESCE_KEY_LEN)
+        return 0;
+
+    if (key_len <= 7 || memcmp(buffer, "change@", 7)) {
+        char path[UEVENT_COALESCE_KEY_LEN];
+
+        memcpy(path, devpath + 1, key_len - (devpath + 1 - buffer));
+        path[key_len - (devpath + 1 - buffer)] = '\0';
+        uevent_coalesce_flush_devpath(path);
+        return 0;
+    }
+
+    for (i = 0; i < UEVENT_COALESCE_SLOTS; i++) {
+        if (!coalesce_slots[i].in_use) {
+            if (free_slot == NULL)
+                free_slot = &coalesce_slots[i];
+        } else if (!strncmp(coalesce_slots[i].key, buffer, key_len) &&
+                   coalesce_slots[i].key[key_len] == '\0') {
+            slot = &coalesce_slots[i];
+            break;
+        }
+    }
+
+    if (slot == NULL) {
+        /* Leading edge: deliver now and open a window. */
+        if (free_slot != NULL) {
+            memcpy(free_slot->key, buffer, key_len);
+            free_slot->key[key_len] = '\0';
+            free_slot->deadline_ns = now + window_ms * 1000000LL;
+            free_slot->count = 0;
+            free_slot->in_use = 1;
+            coalesce_slots_in_use++;
+        }
+        return 0;
+    }
+
+    /* Inside the window: keep the latest payload, with room for the tag. */
+    if (slot->msg_size < count + 32) {
+        char *msg = realloc(slot->msg, count + 32);
+        if (msg == NULL)
+            return 0;
+        slot->msg = msg;
+        slot->msg_size = count + 32;
+    }
+    memcpy(slot->msg, buffer, count);
+    /* The tag must start after the payload's terminating NUL. */
+    if (buffer[count - 1] != '\0')
+        slot->msg[count++] = '\0';
+    slot->msg_len = count;
+    slot->count++;
+    STAT_ADD(global_stats.coalesced, 1);
+    return 1;
+}
+
+static void uevent_deliver(const char *buffer, int count)
+{
+    int window_ms = __atomic_load_n(&coalesce_window_ms, __ATOMIC_RELAXED);
+
+    uevent_account_event(buffer, count);
+
+    if (window_ms > 0) {
+        if (uevent_coalesce(buffer, count, window_ms))
+            return;
+    } else {
+        uevent_coalesce_flush(0, 0);
+    }
+    uevent_dispatch(buffer, count);
+}
+
+/* Returns the poll timeout until the next trailing delivery, -1 if none */
+int uevent_get_timeout_ms()
+{
+    int64_t next = INT64_MAX;
+    int64_t now;
+    int i;
+
+    if (coalesce_slots_in_use == 0)
+        return -1;
+
+    for (i = 0; i < UEVENT_COALESCE_SLOTS; i++) {
+        if (coalesce_slots[i].in_use && coalesce_slots[i].deadline_ns < next)
+            next = coalesce_slots[i].deadline_ns;
+    }
+    if (next == INT64_MAX)
+        return -1;
+
+    now = uevent_now_ns();
+    if (next <= now)
+        return 0;
+    return (int)((next - now + 999999) / 1000000);
+}
+
+void uevent_set_coalesce_window_ms(int window_ms)
+{
+    __atomic_store_n(&coalesce_window_ms, window_ms > 0 ? window_ms : 0, __ATOMIC_RELAXED);
+}
+
 int uevent_next_event(char* buffer, int buffer_length)
 {
+    /* uevent_recv() would refuse every read and poll() would spin */
+    if (buffer_length < 2) {
+        errno = EINVAL;
+        return -1;
+    }
+
     while (1) {
         struct pollfd fds;
         int nr;
@@ -80,19 +447,17 @@ int uevent_next_event(char* buffer, int buffer_length)
         fds.fd = fd;
         fds.events = POLLIN;
         fds.revents = 0;
-        nr = poll(&fds, 1, -1);
+        nr = poll(&fds, 1, uevent_get_timeout_ms());
      
         if(nr > 0 && (fds.revents & POLLIN)) {
-            int count = recv(fd, buffer, buffer_length, 0);
+            int count = uevent_recv(buffer, buffer_length, 0);
             if (count > 0) {
-                struct uevent_handler *h;
-                pthread_mutex_lock(&uevent_handler_list_lock);
-                LIST_FOREACH(h, &uevent_handler_list, list)
-                    h->handler(h->handler_data, buffer, buffer_length);
-                pthread_mutex_unlock(&uevent_handler_list_lock);
-
+                uevent_deliver(buffer, count);
                 return count;
             } 
+        } else if (nr == 0) {
+            uevent_coalesce_flush(uevent_now_ns(),
+                                  __atomic_load_n(&coalesce_window_ms, __ATOMIC_RELAXED));
         }
     }
     
@@ -100,12 +465,63 @@ int uevent_next_event(char* buffer, int buffer_length)
     return 0;
 }
 
+/* Returns the number of events received, or -1 on failure */
+int uevent_process_pending(char* buffer, int buffer_length)
+{
+    int processed = 0;
+
+    if (fd < 0)
+        return -1;
+
+    while (1) {
+        int count = uevent_recv(buffer, buffer_length, MSG_DONTWAIT);
+        if (count < 0) {
+            if (errno == EINTR || errno == ENOBUFS)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            return -1;
+        }
+        if (count == 0)
+            break;
+        uevent_deliver(buffer, count);
+        processed++;
+    }
+
+    uevent_coalesce_flush(uevent_now_ns(),
+                          __atomic_load_n(&coalesce_window_ms, __ATOMIC_RELAXED));
+    return processed;
+}
+
+/* Returns 0 on success, -1 on failure */
+int uevent_epoll_add(int epoll_fd, void *cookie)
+{
+    struct epoll_event ev;
+
+    if (fd < 0)
+        return -1;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = cookie;
+    return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+/* Returns 0 on success, -1 on failure */
+int uevent_epoll_del(int epoll_fd)
+{
+    if (fd < 0)
+        return -1;
+
+    return epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+}
+
 int uevent_add_native_handler(void (*handler)(void *data, const char *msg, int msg_len),
                              void *handler_data)
 {
     struct uevent_handler *h;
 
-    h = malloc(sizeof(struct uevent_handler));
+    h = calloc(1, sizeof(struct uevent_handler));
     if (h == NULL)
         return -1;
     h->handler = handler;
@@ -135,3 +551,98 @@ int uevent_remove_native_handler(void (*handler)(void *data, const char *msg, in
 
     return err;
 }
+
+void uevent_get_stats(struct uevent_stats *stats)
+{
+    stats->events = STAT_GET(global_stats.events);
+    stats->bytes = STAT_GET(global_stats.bytes);
+    stats->coalesced = STAT_GET(global_stats.coalesced);
+    stats->truncated = STAT_GET(global_stats.truncated);
+    stats->overruns = STAT_GET(global_stats.overruns);
+    stats->recv_errors = STAT_GET(global_stats.recv_errors);
+}
+
+int uevent_get_subsystem_stats(struct uevent_subsystem_stats *stats, int max_stats)
+{
+    int n = __atomic_load_n(&subsystem_count, __ATOMIC_ACQUIRE);
+    int i;
+
+    if (n > max_stats)
+        n = max_stats;
+    for (i = 0; i < n; i++) {
+        memcpy(stats[i].subsystem, subsystem_stats[i].name, UEVENT_SUBSYSTEM_NAME_LEN);
+        stats[i].events = STAT_GET(subsystem_stats[i].events);
+        stats[i].bytes = STAT_GET(subsystem_stats[i].bytes);
+    }
+    return n;
+}
+
+int uevent_get_handler_stats(void (*handler)(void *data, const char *msg, int msg_len),
+                             struct uevent_handler_stats *stats)
+{
+    struct uevent_handler *h;
+    int err = -1;
+    int i;
+
+    pthread_mutex_lock(&uevent_handler_list_lock);
+    LIST_FOREACH(h, &uevent_handler_list, list) {
+        if (h->handler == handler) {
+            stats->calls = STAT_GET(h->calls);
+            stats->total_ns = STAT_GET(h->total_ns);
+            stats->max_ns = STAT_GET(h->max_ns);
+            for (i = 0; i < UEVENT_LATENCY_BUCKETS; i++)
+                stats->latency_hist[i] = STAT_GET(h->latency_hist[i]);
+            err = 0;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&uevent_handler_list_lock);
+
+    return err;
+}
+
+int uevent_dump_stats(int out_fd)
+{
+    struct uevent_stats stats;
+    struct uevent_handler *h;
+    int64_t elapsed_ns = stats_start_ns ? uevent_now_ns() - stats_start_ns : 0;
+    double elapsed_s = elapsed_ns > 0 ? elapsed_ns / 1e9 : 1;
+    int n = __atomic_load_n(&subsystem_count, __ATOMIC_ACQUIRE);
+    int i;
+
+    uevent_get_stats(&stats);
+    dprintf(out_fd, "uevent stats over %.1fs:\n", elapsed_ns / 1e9);
+    dprintf(out_fd, "  events %llu (%.1f/s) bytes %llu coalesced %llu\n",
+            (unsigned long long)stats.events, stats.events / elapsed_s,
+            (unsigned long long)stats.bytes, (unsigned long long)stats.coalesced);
+    dprintf(out_fd, "  truncated %llu overruns %llu recv errors %llu\n",
+            (unsigned long long)stats.truncated, (unsigned long long)stats.overruns,
+            (unsigned long long)stats.recv_errors);
+
+    dprintf(out_fd, "  %-24s %12s %10s %14s\n", "subsystem", "events", "events/s", "bytes");
+    for (i = 0; i < n; i++) {
+        uint64_t events = STAT_GET(subsystem_stats[i].events);
+        dprintf(out_fd, "  %-24s %12llu %10.1f %14llu\n", subsystem_stats[i].name,
+                (unsigned long long)events, events / elapsed_s,
+                (unsigned long long)STAT_GET(subsystem_stats[i].bytes));
+    }
+
+    pthread_mutex_lock(&uevent_handler_list_lock);
+    LIST_FOREACH(h, &uevent_handler_list, list) {
+        uint64_t calls = STAT_GET(h->calls);
+        dprintf(out_fd, "  handler %p data %p: calls %llu avg %.1fus max %.1fus\n",
+                h->handler, h->handler_data, (unsigned long long)calls,
+                calls ? STAT_GET(h->total_ns) / 1e3 / calls : 0.0,
+                STAT_GET(h->max_ns) / 1e3);
+        dprintf(out_fd, "    latency:");
+        for (i = 0; i < UEVENT_LATENCY_BUCKETS; i++) {
+            uint64_t count = STAT_GET(h->latency_hist[i]);
+            if (count)
+                dprintf(out_fd, " <%lluus:%llu", 1ULL << i, (unsigned long long)count);
+        }
+        dprintf(out_fd, "\n");
+    }
+    pthread_mutex_unlock(&uevent_handler_list_lock);
+
+    return 0;
+}
@@ -0,0 +1,298 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <hardware_legacy/uevent.h>
+
+#include "uevent_trace.h"
+
+// Replays a storm trace through a socketpair into the uevent dispatch path.
+// Set UEVENT_BENCHMARK_TRACE to a file written by "uevent_trace record" to
+// benchmark a real capture; otherwise a synthetic power_supply/thermal storm
+// is used.
+
+static std::vector<UeventTraceRecord> makeSyntheticStorm() {
+    static const char* const kDevices[][2] = {
+            {"/devices/platform/battery/power_supply/battery", "power_supply"},
+            {"/devices/platform/battery/power_supply/usb", "power_supply"},
+            {"/devices/virtual/thermal/thermal_zone0", "thermal"},
+            {"/devices/virtual/thermal/thermal_zone1", "thermal"},
+    };
+    std::vector<UeventTraceRecord> records;
+    for (int seq = 0; seq < 1024; seq++) {
+        const auto& dev = kDevices[seq % 4];
+        std::string payload = std::string("change@") + dev[0];
+        payload += '\0';
+        payload += "ACTION=change";
+        payload += '\0';
+        payload += std::string("DEVPATH=") + dev[0];
+        payload += '\0';
+        payload += std::string("SUBSYSTEM=") + dev[1];
+        payload += '\0';
+        payload += "POWER_SUPPLY_CAPACITY=" + std::to_string(seq % 100);
+        payload += '\0';
+        payload += "SEQNUM=" + std::to_string(seq);
+        payload += '\0';
+        records.push_back({1000, payload});
+    }
+    return records;
+}
+
+static const std::vector<UeventTraceRecord>& stormTrace() {
+    static const std::vector<UeventTraceRecord>* trace = [] {
+        auto records = new std::vector<UeventTraceRecord>();
+        const char* path = getenv("UEVENT_BENCHMARK_TRACE");
+        if (path == nullptr || !uevent_trace_load(path, records) || records->empty()) {
+            *records = makeSyntheticStorm();
+        }
+        records->erase(std::remove_if(records->begin(), records->end(),
+                                      [](const auto& r) { return r.payload.empty(); }),
+                       records->end());
+        return records;
+    }();
+    return *trace;
+}
+
+static int64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+static int64_t gSendTimeNs;
+static std::vector<int64_t> gLatencies;
+
+static void countingHandler(void* data, const char*, int) {
+    (*static_cast<int64_t*>(data))++;
+}
+
+static void latencyHandler(void*, const char*, int) {
+    gLatencies.push_back(nowNs() - gSendTimeNs);
+}
+
+// The receiving end is handed to uevent, which closes it when the next
+// replay replaces it; only the sending end is closed here.
+class UeventReplay {
+  public:
+    UeventReplay() {
+        if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, mSv) < 0 || !uevent_init_fd(mSv[0])) {
+            mSv[0] = mSv[1] = -1;
+        }
+    }
+    ~UeventReplay() {
+        if (mSv[1] >= 0) close(mSv[1]);
+    }
+    bool ok() const { return mSv[1] >= 0; }
+    void inject(const UeventTraceRecord& r) { send(mSv[1], r.payload.data(), r.payload.size(), 0); }
+
+  private:
+    int mSv[2];
+};
+
+// Events/sec through uevent_process_pending() with state.range(0) handlers installed.
+static void BM_UeventReplayThroughput(benchmark::State& state) {
+    // Stay well under the default socket buffer so inject() never blocks.
+    constexpr size_t kBatch = 32;
+    const auto& trace = stormTrace();
+    UeventReplay replay;
+    if (!replay.ok()) {
+        state.SkipWithError("socketpair failed");
+        return;
+    }
+    std::vector<char> buffer(kUeventTraceMaxPayload);
+
+    std::vector<int64_t> counts(state.range(0));
+    for (auto& count : counts) {
+        uevent_add_native_handler(countingHandler, &count);
+    }
+
+    size_t next = 0;
+    int64_t events = 0;
+    for (auto _ : state) {
+        for (size_t i = 0; i < kBatch; i++) {
+            replay.inject(trace[next]);
+            next = (next + 1) % trace.size();
+        }
+        events += uevent_process_pending(buffer.data(), buffer.size());
+    }
+
+    for (size_t i = 0; i < counts.size(); i++) {
+        uevent_remove_native_handler(countingHandler);
+    }
+    state.SetItemsProcessed(events);
+}
+BENCHMARK(BM_UeventReplayThroughput)->Arg(1)->Arg(4)->Arg(16);
+
+// Handler invocations per received event for the storm trace with a
+// coalescing window of state.range(0) ms (0 = coalescing disabled).
+static void BM_UeventCoalescedStorm(benchmark::State& state) {
+    constexpr size_t kBatch = 32;
+    const auto& trace = stormTrace();
+    UeventReplay replay;
+    if (!replay.ok()) {
+        state.SkipWithError("socketpair failed");
+        return;
+    }
+    std::vector<char> buffer(kUeventTraceMaxPayload);
+
+    int64_t calls = 0;
+    int64_t events = 0;
+    uevent_add_native_handler(countingHandler, &calls);
+    uevent_set_coalesce_window_ms(state.range(0));
+
+    size_t next = 0;
+    for (auto _ : state) {
+        for (size_t i = 0; i < kBatch; i++) {
+            replay.inject(trace[next]);
+            next = (next + 1) % trace.size();
+        }
+        events += uevent_process_pending(buffer.data(), buffer.size());
+    }
+
+    // Deliver the trailing events so the final state is counted too.
+    uevent_set_coalesce_window_ms(0);
+    uevent_process_pending(buffer.data(), buffer.size());
+    uevent_remove_native_handler(countingHandler);
+
+    state.counters["handler_calls_per_event"] = events ? double(calls) / events : 0;
+    state.SetItemsProcessed(events);
+}
+BENCHMARK(BM_UeventCoalescedStorm)->Arg(0)->Arg(10)->Arg(100);
+
+// Typical handler: walk the NUL-separated variables looking for a key.
+// Its cost is proportional to the msg_len it is handed.
+static void parsingHandler(void* data, const char* msg, int msg_len) {
+    const char* end = msg + msg_len;
+    while (msg < end) {
+        size_t len = strnlen(msg, end - msg);
+        if (len > 22 && !memcmp(msg, "POWER_SUPPLY_CAPACITY=", 22)) {
+            (*static_cast<int64_t*>(data))++;
+        }
+        msg += len + 1;
+    }
+}
+
+// What handlers had to do when msg_len was the caller's buffer capacity:
+// walk all of it with strlen(), since nothing said where the event ended.
+// The receive buffer starts zeroed and its last byte is never received into,
+// so the walk always stops inside it.
+struct CapacityParseState {
+    int64_t matches;
+    size_t capacity;
+};
+
+static void capacityParsingHandler(void* data, const char* msg, int) {
+    auto* parse = static_cast<CapacityParseState*>(data);
+    const char* end = msg + parse->capacity;
+    while (msg < end) {
+        size_t len = strlen(msg);
+        if (len > 22 && !memcmp(msg, "POWER_SUPPLY_CAPACITY=", 22)) {
+            parse->matches++;
+        }
+        msg += len + 1;
+    }
+}
+
+static void runParsingHandler(benchmark::State& state, void (*handler)(void*, const char*, int),
+                              void* data, std::vector<char>& buffer) {
+    constexpr size_t kBatch = 32;
+    const auto& trace = stormTrace();
+    UeventReplay replay;
+    if (!replay.ok()) {
+        state.SkipWithError("socketpair failed");
+        return;
+    }
+
+    int64_t events = 0;
+    uevent_add_native_handler(handler, data);
+
+    size_t next = 0;
+    for (auto _ : state) {
+        for (size_t i = 0; i < kBatch; i++) {
+            replay.inject(trace[next]);
+            next = (next + 1) % trace.size();
+        }
+        events += uevent_process_pending(buffer.data(), buffer.size());
+    }
+
+    uevent_remove_native_handler(handler);
+    state.SetItemsProcessed(events);
+}
+
+static void BM_UeventParsingHandler(benchmark::State& state) {
+    std::vector<char> buffer(kUeventTraceMaxPayload);
+    int64_t matches = 0;
+    runParsingHandler(state, parsingHandler, &matches, buffer);
+}
+BENCHMARK(BM_UeventParsingHandler);
+
+// The same handler as it was written against the old capacity-length
+// contract, for comparison.
+static void BM_UeventParsingHandlerStrlenBaseline(benchmark::State& state) {
+    std::vector<char> buffer(kUeventTraceMaxPayload);
+    CapacityParseState parse = {0, buffer.size()};
+    runParsingHandler(state, capacityParsingHandler, &parse, buffer);
+}
+BENCHMARK(BM_UeventParsingHandlerStrlenBaseline);
+
+// Latency from injecting an event to its handler running, as percentiles.
+static void BM_UeventDispatchLatency(benchmark::State& state) {
+    const auto& trace = stormTrace();
+    UeventReplay replay;
+    if (!replay.ok()) {
+        state.SkipWithError("socketpair failed");
+        return;
+    }
+    std::vector<char> buffer(kUeventTraceMaxPayload);
+
+    gLatencies.clear();
+    gLatencies.reserve(1 << 20);
+    uevent_add_native_handler(latencyHandler, nullptr);
+
+    size_t next = 0;
+    for (auto _ : state) {
+        gSendTimeNs = nowNs();
+        replay.inject(trace[next]);
+        uevent_process_pending(buffer.data(), buffer.size());
+        next = (next + 1) % trace.size();
+    }
+
+    uevent_remove_native_handler(latencyHandler);
+    if (gLatencies.empty()) return;
+
+    std::sort(gLatencies.begin(), gLatencies.end());
+    auto percentile = [](double p) {
+        return double(gLatencies[size_t(p * (gLatencies.size() - 1))]);
+    };
+    state.counters["p50_ns"] = percentile(0.50);
+    state.counters["p90_ns"] = percentile(0.90);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["max_ns"] = double(gLatencies.back());
+    state.SetItemsProcessed(gLatencies.size());
+}
+BENCHMARK(BM_UeventDispatchLatency);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+#include <hardware_legacy/uevent.h>
+
+#include "uevent_trace.h"
+
+static volatile sig_atomic_t gStop = 0;
+
+static void usage() {
+    std::cout << "Usage: uevent_trace record <file> [max_events]\n"
+              << "       uevent_trace replay <file> [speed]\n"
+              << "Record the raw kernel uevent stream to a binary trace, or replay a trace\n"
+              << "through the libhardware_legacy dispatch path. speed scales the recorded\n"
+              << "inter-event delays (2 = twice as fast, 0 = as fast as possible).\n";
+}
+
+static uint64_t nowUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void printEvent(void* data, const char* msg, int msg_len) {
+    // The payload is the "ACTION@DEVPATH" header followed by NUL-separated
+    // KEY=VALUE variables; print one per line.
+    const char* end = msg + msg_len;
+    while (msg < end) {
+        size_t len = strnlen(msg, end - msg);
+        if (len) std::cout.write(msg, len) << '\n';
+        msg += len + 1;
+    }
+    std::cout << '\n';
+    (*static_cast<unsigned long*>(data))++;
+}
+
+static int record(const char* path, unsigned long maxEvents) {
+    if (!uevent_init()) {
+        std::cerr << "uevent_init failed: " << strerror(errno) << "\n";
+        return EXIT_FAILURE;
+    }
+
+    FILE* f = fopen(path, "wb");
+    if (f == nullptr || !uevent_trace_write_header(f)) {
+        std::cerr << "cannot write " << path << ": " << strerror(errno) << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<char> buffer(kUeventTraceMaxPayload);
+    unsigned long events = 0;
+    uint64_t last = nowUs();
+    while (!gStop && (maxEvents == 0 || events < maxEvents)) {
+        // Poll with a timeout so SIGINT can stop the recording between events.
+        struct pollfd pfd = {uevent_get_fd(), POLLIN, 0};
+        if (poll(&pfd, 1, 100) <= 0) continue;
+
+        int count = uevent_next_event(buffer.data(), buffer.size());
+        uint64_t now = nowUs();
+        if (!uevent_trace_write_record(f, uint32_t(now - last), buffer.data(), count)) {
+            std::cerr << "write failed: " << strerror(errno) << "\n";
+            break;
+        }
+        last = now;
+        events++;
+    }
+
+    fclose(f);
+    std::cerr << "recorded " << events << " events\n";
+    uevent_dump_stats(STDERR_FILENO);
+    return EXIT_SUCCESS;
+}
+
+static int replay(const char* path, double speed) {
+    std::vector<UeventTraceRecord> records;
+    if (!uevent_trace_load(path, &records)) {
+        std::cerr << "cannot load trace " << path << "\n";
+        return EXIT_FAILURE;
+    }
+
+    // SOCK_SEQPACKET keeps datagram boundaries like the netlink socket does.
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sv) < 0 || !uevent_init_fd(sv[0])) {
+        std::cerr << "socketpair failed: " << strerror(errno) << "\n";
+        return EXIT_FAILURE;
+    }
+
+    unsigned long delivered = 0;
+    uevent_add_native_handler(printEvent, &delivered);
+
+    // Deadlines are absolute so pacing error does not accumulate over long traces.
+    std::thread injector([&records, speed, out = sv[1]] {
+        uint64_t deadline = nowUs();
+        for (const auto& r : records) {
+            if (speed > 0) {
+                deadline += uint64_t(r.delay_us / speed);
+                uint64_t now = nowUs();
+                if (deadline > now) usleep(deadline - now);
+            }
+            if (send(out, r.payload.data(), r.payload.size(), 0) < 0) break;
+        }
+    });
+
+    // Empty datagrams are never handed to handlers.
+    size_t expected = std::count_if(records.begin(), records.end(),
+                                    [](const auto& r) { return !r.payload.empty(); });
+    std::vector<char> buffer(kUeventTraceMaxPayload);
+    while (!gStop && delivered < expected) {
+        struct pollfd pfd = {sv[0], POLLIN, 0};
+        if (poll(&pfd, 1, 100) > 0) {
+            uevent_process_pending(buffer.data(), buffer.size());
+        }
+    }
+
+    // Dump before unregistering so the handler's latency histogram is included.
+    std::cerr << "replayed " << delivered << " events\n";
+    uevent_dump_stats(STDERR_FILENO);
+
+    // Closing the receiving end unblocks the injector if it is stuck on a full socket.
+    uevent_remove_native_handler(printEvent);
+    close(sv[0]);
+    injector.join();
+    close(sv[1]);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, [](int) { gStop = 1; });
+    signal(SIGTERM, [](int) { gStop = 1; });
+
+    if (!strcmp(argv[1], "record")) {
+        return record(argv[2], argc > 3 ? strtoul(argv[3], nullptr, 0) : 0);
+    }
+    if (!strcmp(argv[1], "replay")) {
+        return replay(argv[2], argc > 3 ? strtod(argv[3], nullptr) : 1.0);
+    }
+
+    usage();
+    return EXIT_FAILURE;
+}
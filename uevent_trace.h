@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _HARDWARE_UEVENT_TRACE_H
+#define _HARDWARE_UEVENT_TRACE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+// Binary uevent trace written by "uevent_trace record":
+//
+//   header:  "UEVT" magic, uint32_t version
+//   records: uint32_t delay since previous record in microseconds,
+//            uint32_t payload length, payload bytes (raw netlink datagram)
+//
+// All integers are little-endian whatever the recording device, so a trace
+// replays on any host.
+
+static constexpr char kUeventTraceMagic[4] = {'U', 'E', 'V', 'T'};
+static constexpr uint32_t kUeventTraceVersion = 1;
+static constexpr uint32_t kUeventTraceMaxPayload = 64 * 1024;
+
+struct UeventTraceRecord {
+    uint32_t delay_us;
+    std::string payload;
+};
+
+static inline bool uevent_trace_write_u32(FILE* f, uint32_t value) {
+    const uint8_t bytes[4] = {uint8_t(value), uint8_t(value >> 8), uint8_t(value >> 16),
+                              uint8_t(value >> 24)};
+    return fwrite(bytes, sizeof(bytes), 1, f) == 1;
+}
+
+static inline bool uevent_trace_read_u32(FILE* f, uint32_t* value) {
+    uint8_t bytes[4];
+    if (fread(bytes, sizeof(bytes), 1, f) != 1) return false;
+    *value = bytes[0] | bytes[1] << 8 | bytes[2] << 16 | uint32_t(bytes[3]) << 24;
+    return true;
+}
+
+static inline bool uevent_trace_write_header(FILE* f) {
+    return fwrite(kUeventTraceMagic, sizeof(kUeventTraceMagic), 1, f) == 1 &&
+           uevent_trace_write_u32(f, kUeventTraceVersion);
+}
+
+static inline bool uevent_trace_write_record(FILE* f, uint32_t delay_us, const char* payload,
+                                             uint32_t length) {
+    return uevent_trace_write_u32(f, delay_us) && uevent_trace_write_u32(f, length) &&
+           fwrite(payload, length, 1, f) == 1;
+}
+
+// Loads a whole trace into memory. Returns false if the file is missing,
+// has a bad header or contains a truncated record.
+static inline bool uevent_trace_load(const char* path, std::vector<UeventTraceRecord>* records) {
+    FILE* f = fopen(path, "rb");
+    if (f == nullptr) return false;
+
+    char magic[sizeof(kUeventTraceMagic)];
+    uint32_t version;
+    bool ok = fread(magic, sizeof(magic), 1, f) == 1 &&
+              uevent_trace_read_u32(f, &version) &&
+              std::string(magic, sizeof(magic)) ==
+                      std::string(kUeventTraceMagic, sizeof(kUeventTraceMagic)) &&
+              version == kUeventTraceVersion;
+
+    while (ok) {
+        UeventTraceRecord record;
+        uint32_t length;
+        if (!uevent_trace_read_u32(f, &record.delay_us)) break;  // clean EOF
+        if (!uevent_trace_read_u32(f, &length) || length > kUeventTraceMaxPayload) {
+            ok = false;
+            break;
+        }
+        record.payload.resize(length);
+        if (length && fread(&record.payload[0], length, 1, f) != 1) {
+            ok = false;
+            break;
+        }
+        records->push_back(std::move(record));
+    }
+
+    fclose(f);
+    return ok;
+}
+
+#endif  // _HARDWARE_UEVENT_TRACE_H